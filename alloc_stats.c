@@ -0,0 +1,44 @@
+#include "alloc_stats.h"
+#include <stddef.h>
+
+#ifdef AYTDB_ALLOC_STATS
+
+static unsigned long long allocation_count = 0;
+
+// Linker --wrap=<sym> ile asıl fonksiyonlar __real_<sym> adıyla erişilebilir
+void* __real_malloc(size_t size);
+void* __real_calloc(size_t count, size_t size);
+void* __real_realloc(void* ptr, size_t size);
+char* __real_strdup(const char* str);
+
+void* __wrap_malloc(size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_malloc(size);
+}
+
+void* __wrap_calloc(size_t count, size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_calloc(count, size);
+}
+
+void* __wrap_realloc(void* ptr, size_t size) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_realloc(ptr, size);
+}
+
+char* __wrap_strdup(const char* str) {
+    __atomic_add_fetch(&allocation_count, 1, __ATOMIC_RELAXED);
+    return __real_strdup(str);
+}
+
+long long alloc_stats_count() {
+    return (long long)__atomic_load_n(&allocation_count, __ATOMIC_RELAXED);
+}
+
+#else
+
+long long alloc_stats_count() {
+    return -1;
+}
+
+#endif
@@ -0,0 +1,11 @@
+#ifndef ALLOC_STATS_H
+#define ALLOC_STATS_H
+
+// Sunucunun kendi kodundan yapılan heap allocation sayısı.
+// Linux'ta aytdb_server, malloc/calloc/realloc/strdup çağrılarını linker'ın
+// --wrap seçeneğiyle bu sayaçtan geçirir; diğer hedeflerde sayaç yoktur.
+
+// Toplam allocation sayısı, sayaç derlenmemişse -1
+long long alloc_stats_count();
+
+#endif // ALLOC_STATS_H
@@ -0,0 +1,592 @@
+#define _GNU_SOURCE
+#include "aytdb_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#define CLIENT_BUFFER_SIZE 16384  // Okuma/yazma tamponlarının başlangıç boyutu
+#define CLIENT_QUEUE_SIZE 64      // Bekleyen istek kuyruğunun başlangıç boyutu (2'nin kuvveti)
+#define CLIENT_NODE_SIZE 64       // Yanıt düğümü alanının başlangıç boyutu
+
+// Gönderilmiş isteğin yanıtı geldiğinde ne yapılacağı; callback NULL ise senkron istektir
+typedef struct {
+    AytdbCallback callback;
+    void* ctx;
+} PendingRequest;
+
+struct AytdbClient {
+    int fd;
+    bool failed;
+    char error[128];
+
+    char* out;
+    size_t out_len;
+    size_t out_cap;
+
+    char* in;
+    size_t in_len;
+    size_t in_cap;
+    size_t in_pos;          // Ayrıştırılıp tüketilen bayt sayısı; sıkıştırma bir sonraki okumada
+
+    PendingRequest* queue;  // Halka; gönderim sırasıyla
+    size_t queue_head;
+    size_t queue_count;
+    size_t queue_cap;
+    int sync_count;         // Kuyruktaki senkron istek sayısı
+
+    AytdbReply* nodes;      // Son yanıtın düğümleri (her yanıtta baştan kullanılır)
+    size_t node_cap;
+    size_t node_used;
+
+    AytdbCallback push_handler;
+    void* push_ctx;
+};
+
+static void fail_client(AytdbClient* client, const char* reason) {
+    if (client->failed) return;
+    client->failed = true;
+    snprintf(client->error, sizeof(client->error), "%s", reason);
+
+    // Yanıtı artık gelmeyecek asenkron isteklere haber ver
+    while (client->queue_count > 0) {
+        PendingRequest request = client->queue[client->queue_head];
+        client->queue_head = (client->queue_head + 1) & (client->queue_cap - 1);
+        client->queue_count--;
+        if (request.callback) request.callback(client, NULL, request.ctx);
+    }
+    client->sync_count = 0;
+}
+
+static AytdbClient* client_create(int fd) {
+    AytdbClient* client = calloc(1, sizeof(AytdbClient));
+    if (!client) {
+        close(fd);
+        return NULL;
+    }
+    client->fd = fd;
+    client->out_cap = CLIENT_BUFFER_SIZE;
+    client->in_cap = CLIENT_BUFFER_SIZE;
+    client->queue_cap = CLIENT_QUEUE_SIZE;
+    client->node_cap = CLIENT_NODE_SIZE;
+    client->out = malloc(client->out_cap);
+    client->in = malloc(client->in_cap);
+    client->queue = malloc(client->queue_cap * sizeof(PendingRequest));
+    client->nodes = malloc(client->node_cap * sizeof(AytdbReply));
+    if (!client->out || !client->in || !client->queue || !client->nodes) {
+        aytdb_close(client);
+        return NULL;
+    }
+    return client;
+}
+
+static AytdbClient* authenticate(AytdbClient* client, const char* password) {
+    if (!client || !password) return client;
+    const char* argv[] = { "AUTH", password };
+    const AytdbReply* reply = aytdb_command(client, 2, argv, NULL);
+    if (!reply || reply->type != AYTDB_REPLY_STATUS) {
+        aytdb_close(client);
+        return NULL;
+    }
+    return client;
+}
+
+AytdbClient* aytdb_connect(const char* host, int port, const char* password) {
+    char port_text[16];
+    snprintf(port_text, sizeof(port_text), "%d", port);
+    struct addrinfo hints = { .ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM };
+    struct addrinfo* addresses;
+    if (getaddrinfo(host, port_text, &hints, &addresses) != 0) return NULL;
+
+    int fd = -1;
+    for (struct addrinfo* addr = addresses; addr && fd < 0; addr = addr->ai_next) {
+        fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        if (fd >= 0 && connect(fd, addr->ai_addr, addr->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (fd < 0) return NULL;
+
+    // Pipeline'lar tek send ile çıktığı için Nagle yalnızca gecikme ekler
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    return authenticate(client_create(fd), password);
+}
+
+AytdbClient* aytdb_connect_unix(const char* path, const char* password) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) return NULL;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) return NULL;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        close(fd);
+        return NULL;
+    }
+    return authenticate(client_create(fd), password);
+}
+
+void aytdb_close(AytdbClient* client) {
+    if (!client) return;
+    fail_client(client, "Connection closed");
+    close(client->fd);
+    free(client->out);
+    free(client->in);
+    free(client->queue);
+    free(client->nodes);
+    free(client);
+}
+
+int aytdb_fd(const AytdbClient* client) {
+    return client->fd;
+}
+
+const char* aytdb_error(const AytdbClient* client) {
+    return client->failed ? client->error : NULL;
+}
+
+int aytdb_pending(const AytdbClient* client) {
+    return (int)client->queue_count;
+}
+
+void aytdb_set_push_handler(AytdbClient* client, AytdbCallback handler, void* ctx) {
+    client->push_handler = handler;
+    client->push_ctx = ctx;
+}
+
+// ---------------------------------------------------------------------------
+// İstek kodlama
+// ---------------------------------------------------------------------------
+
+static bool reserve_out(AytdbClient* client, size_t extra) {
+    if (client->out_len + extra <= client->out_cap) return true;
+    size_t new_cap = client->out_cap;
+    while (new_cap < client->out_len + extra) new_cap *= 2;
+    char* grown = realloc(client->out, new_cap);
+    if (!grown) return false;
+    client->out = grown;
+    client->out_cap = new_cap;
+    return true;
+}
+
+static bool push_request(AytdbClient* client, AytdbCallback callback, void* ctx) {
+    if (client->queue_count == client->queue_cap) {
+        // Halka iki katına çıkarken elemanlar sırayla yeni dizinin başına taşınır
+        PendingRequest* grown = malloc(client->queue_cap * 2 * sizeof(PendingRequest));
+        if (!grown) return false;
+        for (size_t i = 0; i < client->queue_count; i++) {
+            grown[i] = client->queue[(client->queue_head + i) & (client->queue_cap - 1)];
+        }
+        free(client->queue);
+        client->queue = grown;
+        client->queue_head = 0;
+        client->queue_cap *= 2;
+    }
+    size_t tail = (client->queue_head + client->queue_count) & (client->queue_cap - 1);
+    client->queue[tail].callback = callback;
+    client->queue[tail].ctx = ctx;
+    client->queue_count++;
+    if (!callback) client->sync_count++;
+    return true;
+}
+
+bool aytdb_append_async(AytdbClient* client, AytdbCallback callback, void* ctx,
+                        int argc, const char** argv, const size_t* argv_len) {
+    if (client->failed || argc <= 0) return false;
+
+    size_t needed = 16;
+    for (int i = 0; i < argc; i++) {
+        needed += 24 + (argv_len ? argv_len[i] : strlen(argv[i]));
+    }
+    if (!reserve_out(client, needed)) {
+        fail_client(client, "Out of memory");
+        return false;
+    }
+
+    char* out = client->out + client->out_len;
+    out += sprintf(out, "*%d\r\n", argc);
+    for (int i = 0; i < argc; i++) {
+        size_t len = argv_len ? argv_len[i] : strlen(argv[i]);
+        out += sprintf(out, "$%zu\r\n", len);
+        memcpy(out, argv[i], len);
+        memcpy(out + len, "\r\n", 2);
+        out += len + 2;
+    }
+    if (!push_request(client, callback, ctx)) {
+        fail_client(client, "Out of memory");
+        return false;
+    }
+    client->out_len = (size_t)(out - client->out);
+    return true;
+}
+
+bool aytdb_append(AytdbClient* client, int argc, const char** argv, const size_t* argv_len) {
+    return aytdb_append_async(client, NULL, NULL, argc, argv, argv_len);
+}
+
+// ---------------------------------------------------------------------------
+// Yanıt ayrıştırma
+// ---------------------------------------------------------------------------
+
+// Tampon başındaki tam yanıtın uzunluğu; tamamlanmadıysa 0, protokol hatasında -1.
+// nodes yanıtın ağacındaki düğüm sayısı kadar artırılır.
+static long scan_reply(const char* buf, size_t len, size_t* nodes) {
+    const char* end = len > 0 ? memmem(buf, len, "\r\n", 2) : NULL;
+    if (!end) return 0;
+    long line_len = (long)(end - buf) + 2;
+    (*nodes)++;
+
+    switch (buf[0]) {
+    case '+': case '-': case ':': case '_':
+        return line_len;
+    case '$': {
+        long bulk = atol(buf + 1);
+        if (bulk < 0) return line_len;
+        return (size_t)line_len + (size_t)bulk + 2 <= len ? line_len + bulk + 2 : 0;
+    }
+    case '*': case '%': case '>': {
+        long count = atol(buf + 1);
+        if (buf[0] == '%') count *= 2;
+        long pos = line_len;
+        for (long i = 0; i < count; i++) {
+            long child = scan_reply(buf + pos, len - (size_t)pos, nodes);
+            if (child <= 0) return child;
+            pos += child;
+        }
+        return pos;
+    }
+    default:
+        return -1;
+    }
+}
+
+// scan_reply'ın kabul ettiği yanıtı düğümlere açar. Metinler tamponda kalır; sonlarındaki
+// '\r' yerine '\0' yazılır. Döndürülen değer yanıtın uzunluğudur.
+static size_t build_reply(AytdbClient* client, char* buf, size_t len, AytdbReply* reply) {
+    char* end = memmem(buf, len, "\r\n", 2);
+    size_t line_len = (size_t)(end - buf) + 2;
+    memset(reply, 0, sizeof(*reply));
+
+    switch (buf[0]) {
+    case '+':
+    case '-':
+        reply->type = buf[0] == '+' ? AYTDB_REPLY_STATUS : AYTDB_REPLY_ERROR;
+        reply->str = buf + 1;
+        reply->len = (size_t)(end - buf) - 1;
+        *end = '\0';
+        return line_len;
+    case ':':
+        reply->type = AYTDB_REPLY_INTEGER;
+        reply->integer = atoll(buf + 1);
+        return line_len;
+    case '_':
+        reply->type = AYTDB_REPLY_NIL;
+        return line_len;
+    case '$': {
+        long bulk = atol(buf + 1);
+        if (bulk < 0) {
+            reply->type = AYTDB_REPLY_NIL;
+            return line_len;
+        }
+        reply->type = AYTDB_REPLY_STRING;
+        reply->str = buf + line_len;
+        reply->len = (size_t)bulk;
+        buf[line_len + (size_t)bulk] = '\0';
+        return line_len + (size_t)bulk + 2;
+    }
+    default: {
+        long count = atol(buf + 1);
+        if (count < 0) {
+            reply->type = AYTDB_REPLY_NIL;
+            return line_len;
+        }
+        reply->type = buf[0] == '*' ? AYTDB_REPLY_ARRAY : buf[0] == '%' ? AYTDB_REPLY_MAP : AYTDB_REPLY_PUSH;
+        reply->elements = (size_t)count * (buf[0] == '%' ? 2 : 1);
+        reply->element = client->nodes + client->node_used;
+        client->node_used += reply->elements;
+        size_t pos = line_len;
+        for (size_t i = 0; i < reply->elements; i++) {
+            pos += build_reply(client, buf + pos, len - pos, &reply->element[i]);
+        }
+        return pos;
+    }
+    }
+}
+
+// Tamamlanan yanıtları sırayla işler. Push yanıtları işleyiciye, asenkron isteklerin
+// yanıtları geri çağırmalarına gider. Sıradaki istek senkronsa sync_reply NULL değilse
+// yanıt oraya konup durulur, NULL ise yanıt tüketilmeden bırakılır.
+// Çalıştırılan geri çağırma sayısını, protokol hatasında -1 döner.
+static int process_replies(AytdbClient* client, const AytdbReply** sync_reply) {
+    int handled = 0;
+    while (!client->failed) {
+        char* buf = client->in + client->in_pos;
+        size_t nodes = 0;
+        long len = scan_reply(buf, client->in_len - client->in_pos, &nodes);
+        if (len == 0) break;
+        if (len < 0) {
+            fail_client(client, "Protocol error");
+            return -1;
+        }
+
+        bool push = buf[0] == '>';
+        if (!push && client->queue_count == 0) {
+            fail_client(client, "Unexpected reply");
+            return -1;
+        }
+        PendingRequest request = push ? (PendingRequest){ client->push_handler, client->push_ctx }
+                                      : client->queue[client->queue_head];
+        if (!push && !request.callback && !sync_reply) break;
+
+        if (nodes > client->node_cap) {
+            size_t new_cap = client->node_cap;
+            while (new_cap < nodes) new_cap *= 2;
+            AytdbReply* grown = realloc(client->nodes, new_cap * sizeof(AytdbReply));
+            if (!grown) {
+                fail_client(client, "Out of memory");
+                return -1;
+            }
+            client->nodes = grown;
+            client->node_cap = new_cap;
+        }
+        client->node_used = 1;
+        build_reply(client, buf, (size_t)len, &client->nodes[0]);
+        client->in_pos += (size_t)len;
+
+        if (!push) {
+            client->queue_head = (client->queue_head + 1) & (client->queue_cap - 1);
+            client->queue_count--;
+        }
+        if (request.callback) {
+            request.callback(client, &client->nodes[0], request.ctx);
+            handled++;
+        } else if (!push) {
+            client->sync_count--;
+            *sync_reply = &client->nodes[0];
+            break;
+        }
+    }
+    return handled;
+}
+
+// Soketten bloklamadan okur; okunacak veri yoksa 0, bağlantı koptuysa -1
+static ssize_t read_available(AytdbClient* client) {
+    // Önceki yanıtlar artık geçersiz, tüketilen kısım atılabilir
+    if (client->in_pos > 0) {
+        memmove(client->in, client->in + client->in_pos, client->in_len - client->in_pos);
+        client->in_len -= client->in_pos;
+        client->in_pos = 0;
+    }
+    if (client->in_len == client->in_cap) {
+        char* grown = realloc(client->in, client->in_cap * 2);
+        if (!grown) {
+            fail_client(client, "Out of memory");
+            return -1;
+        }
+        client->in = grown;
+        client->in_cap *= 2;
+    }
+
+    ssize_t n = recv(client->fd, client->in + client->in_len, client->in_cap - client->in_len, MSG_DONTWAIT);
+    if (n > 0) {
+        client->in_len += (size_t)n;
+        return n;
+    }
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) return 0;
+    fail_client(client, n == 0 ? "Connection closed by server" : strerror(errno));
+    return -1;
+}
+
+bool aytdb_flush(AytdbClient* client) {
+    size_t sent = 0;
+    while (!client->failed && sent < client->out_len) {
+        ssize_t n = send(client->fd, client->out + sent, client->out_len - sent, MSG_NOSIGNAL | MSG_DONTWAIT);
+        if (n > 0) {
+            sent += (size_t)n;
+            continue;
+        }
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            fail_client(client, strerror(errno));
+            break;
+        }
+
+        // Sunucu çıktı sınırına ulaşıp okumayı bırakmış olabilir; biz yazmayı beklerken
+        // yanıtları da okuruz ki iki taraf birbirini beklemesin
+        struct pollfd pfd = { .fd = client->fd, .events = POLLOUT | POLLIN };
+        int ready = poll(&pfd, 1, AYTDB_CLIENT_TIMEOUT_MS);
+        if (ready == 0) fail_client(client, "Timed out sending request");
+        else if (ready > 0 && (pfd.revents & POLLIN)) read_available(client);
+    }
+    memmove(client->out, client->out + sent, client->out_len - sent);
+    client->out_len -= sent;
+    return !client->failed;
+}
+
+const AytdbReply* aytdb_get_reply(AytdbClient* client) {
+    if (client->sync_count == 0) return NULL;
+    if (!aytdb_flush(client)) return NULL;
+
+    const AytdbReply* reply = NULL;
+    while (!client->failed) {
+        if (process_replies(client, &reply) < 0 || reply) return reply;
+        struct pollfd pfd = { .fd = client->fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, AYTDB_CLIENT_TIMEOUT_MS);
+        if (ready == 0) fail_client(client, "Timed out waiting for reply");
+        else if (ready > 0) read_available(client);
+    }
+    return NULL;
+}
+
+const AytdbReply* aytdb_command(AytdbClient* client, int argc, const char** argv, const size_t* argv_len) {
+    if (!aytdb_append(client, argc, argv, argv_len)) return NULL;
+    // Araya giren senkron istekler varsa onların yanıtları atlanır
+    while (client->sync_count > 1) {
+        if (!aytdb_get_reply(client)) return NULL;
+    }
+    return aytdb_get_reply(client);
+}
+
+int aytdb_read(AytdbClient* client) {
+    int handled = 0;
+    for (;;) {
+        ssize_t n = read_available(client);
+        if (n < 0) return -1;
+        int done = process_replies(client, NULL);
+        if (done < 0) return -1;
+        handled += done;
+        // Tampon dolmadıysa soket boşalmıştır; EAGAIN için ayrıca recv yapılmaz
+        if (n == 0 || client->in_len < client->in_cap) return handled;
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Toplu yardımcılar
+// ---------------------------------------------------------------------------
+
+bool aytdb_mget(AytdbClient* client, size_t count, const char** keys,
+                AytdbCallback callback, void* ctx) {
+    const char* argv[1 + AYTDB_BATCH_SIZE];
+    argv[0] = "MGET";
+    for (size_t start = 0; start < count; start += AYTDB_BATCH_SIZE) {
+        size_t batch = count - start < AYTDB_BATCH_SIZE ? count - start : AYTDB_BATCH_SIZE;
+        memcpy(argv + 1, keys + start, batch * sizeof(char*));
+        const AytdbReply* reply = aytdb_command(client, (int)batch + 1, argv, NULL);
+        if (!reply || reply->type != AYTDB_REPLY_ARRAY || reply->elements != batch) return false;
+        for (size_t i = 0; i < batch; i++) callback(client, &reply->element[i], ctx);
+    }
+    return true;
+}
+
+bool aytdb_mset(AytdbClient* client, size_t count, const char** keys, const char** values) {
+    const char* argv[1 + 2 * AYTDB_BATCH_SIZE];
+    argv[0] = "MSET";
+    for (size_t start = 0; start < count; start += AYTDB_BATCH_SIZE) {
+        size_t batch = count - start < AYTDB_BATCH_SIZE ? count - start : AYTDB_BATCH_SIZE;
+        for (size_t i = 0; i < batch; i++) {
+            argv[1 + 2 * i] = keys[start + i];
+            argv[2 + 2 * i] = values[start + i];
+        }
+        const AytdbReply* reply = aytdb_command(client, (int)(1 + 2 * batch), argv, NULL);
+        if (!reply || reply->type != AYTDB_REPLY_STATUS) return false;
+    }
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Bağlantı havuzu
+// ---------------------------------------------------------------------------
+
+struct AytdbPool {
+    pthread_mutex_t mutex;
+    pthread_cond_t available;
+    char* host;
+    char* password;
+    int port;
+    int size;
+    int open;               // Açık (boşta veya kullanımda) bağlantı sayısı
+    int idle_count;
+    AytdbClient** idle;
+};
+
+AytdbPool* aytdb_pool_create(const char* host, int port, const char* password, int size) {
+    if (size <= 0) return NULL;
+    AytdbPool* pool = calloc(1, sizeof(AytdbPool));
+    if (!pool) return NULL;
+    pool->host = strdup(host);
+    pool->password = password ? strdup(password) : NULL;
+    pool->idle = calloc((size_t)size, sizeof(AytdbClient*));
+    if (!pool->host || (password && !pool->password) || !pool->idle) {
+        free(pool->host);
+        free(pool->password);
+        free(pool->idle);
+        free(pool);
+        return NULL;
+    }
+    pool->port = port;
+    pool->size = size;
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->available, NULL);
+    return pool;
+}
+
+// Kullanımdaki tüm bağlantılar geri verilmiş olmalıdır
+void aytdb_pool_destroy(AytdbPool* pool) {
+    if (!pool) return;
+    for (int i = 0; i < pool->idle_count; i++) aytdb_close(pool->idle[i]);
+    pthread_mutex_destroy(&pool->mutex);
+    pthread_cond_destroy(&pool->available);
+    free(pool->host);
+    free(pool->password);
+    free(pool->idle);
+    free(pool);
+}
+
+AytdbClient* aytdb_pool_acquire(AytdbPool* pool) {
+    pthread_mutex_lock(&pool->mutex);
+    while (pool->idle_count == 0 && pool->open >= pool->size) {
+        pthread_cond_wait(&pool->available, &pool->mutex);
+    }
+    if (pool->idle_count > 0) {
+        AytdbClient* client = pool->idle[--pool->idle_count];
+        pthread_mutex_unlock(&pool->mutex);
+        return client;
+    }
+    pool->open++;
+    pthread_mutex_unlock(&pool->mutex);
+
+    // Bağlantı kurulurken havuz kilidi tutulmaz
+    AytdbClient* client = aytdb_connect(pool->host, pool->port, pool->password);
+    if (!client) {
+        pthread_mutex_lock(&pool->mutex);
+        pool->open--;
+        pthread_cond_signal(&pool->available);
+        pthread_mutex_unlock(&pool->mutex);
+    }
+    return client;
+}
+
+void aytdb_pool_release(AytdbPool* pool, AytdbClient* client) {
+    if (!client) return;
+    bool reusable = !client->failed && client->queue_count == 0 && client->out_len == 0;
+    if (!reusable) aytdb_close(client);
+
+    pthread_mutex_lock(&pool->mutex);
+    if (reusable) pool->idle[pool->idle_count++] = client;
+    else pool->open--;
+    pthread_cond_signal(&pool->available);
+    pthread_mutex_unlock(&pool->mutex);
+}
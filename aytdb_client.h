@@ -0,0 +1,107 @@
+#ifndef AYTDB_CLIENT_H
+#define AYTDB_CLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// aytdb_server için C istemci kütüphanesi (libaytdb-client).
+// Sunucuyla RESP konuşur. İstekler çıkış tamponunda biriktirilir ve tek send ile
+// gönderilir (pipelining); yanıtlar gönderim sırasıyla eşleşir.
+//   - Senkron: aytdb_command ya da aytdb_append + aytdb_get_reply
+//   - Asenkron: aytdb_append_async ile geri çağırma kaydedilir, aytdb_flush gönderir,
+//     soket okunabilir olunca aytdb_read gelen yanıtlar için geri çağırmaları çalıştırır.
+//     aytdb_fd epoll gibi bir olay döngüsüne eklenebilir.
+// Yanıtlar istemciye aittir ve aynı istemcide bir sonraki çağrıya kadar geçerlidir;
+// yanıt başına allocation yapılmaz. Bir AytdbClient aynı anda tek thread'den
+// kullanılmalıdır; thread'ler arası paylaşım için AytdbPool kullanılır.
+
+#define AYTDB_CLIENT_TIMEOUT_MS 5000
+#define AYTDB_BATCH_SIZE 256  // Toplu yardımcıların tek MGET/MSET komutunda gönderdiği anahtar sayısı
+
+typedef enum {
+    AYTDB_REPLY_STATUS,   // +OK
+    AYTDB_REPLY_ERROR,    // -ERR ..., -MOVED ...
+    AYTDB_REPLY_INTEGER,  // :n
+    AYTDB_REPLY_STRING,   // $n
+    AYTDB_REPLY_NIL,      // $-1, *-1, _
+    AYTDB_REPLY_ARRAY,    // *n
+    AYTDB_REPLY_MAP,      // %n (RESP3), elements = 2 * n
+    AYTDB_REPLY_PUSH      // >n (RESP3 invalidate bildirimleri)
+} AytdbReplyType;
+
+typedef struct AytdbReply {
+    AytdbReplyType type;
+    long long integer;            // INTEGER
+    const char* str;              // STATUS, ERROR ve STRING; '\0' ile biter
+    size_t len;
+    size_t elements;              // ARRAY, MAP, PUSH
+    struct AytdbReply* element;   // Ardışık alt yanıtlar
+} AytdbReply;
+
+typedef struct AytdbClient AytdbClient;
+
+// Asenkron yanıt geri çağırması; reply geri çağırma süresince geçerlidir (geri çağırma
+// içinde aytdb_flush çağrılacaksa reply ondan önce kullanılmalıdır).
+// Bağlantı koparsa bekleyen her istek için reply NULL ile çağrılır.
+typedef void (*AytdbCallback)(AytdbClient* client, const AytdbReply* reply, void* ctx);
+
+// TCP ya da Unix soketine bağlanır ve password NULL değilse AUTH gönderir
+AytdbClient* aytdb_connect(const char* host, int port, const char* password);
+AytdbClient* aytdb_connect_unix(const char* path, const char* password);
+void aytdb_close(AytdbClient* client);
+
+int aytdb_fd(const AytdbClient* client);
+
+// Son hatanın açıklaması; istemci sağlamsa NULL. Hatadan sonra istemci kapatılmalıdır.
+const char* aytdb_error(const AytdbClient* client);
+
+// Yanıtı beklenen istek sayısı (gönderilmiş ya da tamponda bekleyen)
+int aytdb_pending(const AytdbClient* client);
+
+// RESP3 push yanıtları (client tracking invalidate bildirimleri) için geri çağırma
+void aytdb_set_push_handler(AytdbClient* client, AytdbCallback handler, void* ctx);
+
+// Komutu çıkış tamponuna ekler; argv_len NULL ise argümanlar C string kabul edilir
+bool aytdb_append(AytdbClient* client, int argc, const char** argv, const size_t* argv_len);
+bool aytdb_append_async(AytdbClient* client, AytdbCallback callback, void* ctx,
+                        int argc, const char** argv, const size_t* argv_len);
+
+// Tamponu gönderir
+bool aytdb_flush(AytdbClient* client);
+
+// Tamponu gönderir ve sıradaki senkron isteğin yanıtını bekler; araya giren asenkron
+// isteklerin geri çağırmaları sırayla çalıştırılır. Hata veya zaman aşımında NULL.
+const AytdbReply* aytdb_get_reply(AytdbClient* client);
+
+// aytdb_append + aytdb_get_reply
+const AytdbReply* aytdb_command(AytdbClient* client, int argc, const char** argv, const size_t* argv_len);
+
+// Soketten bloklamadan okur ve tamamlanan yanıtların geri çağırmalarını çalıştırır.
+// Çalıştırılan geri çağırma sayısını, bağlantı koptuysa -1 döner.
+int aytdb_read(AytdbClient* client);
+
+// --- Toplu yardımcılar ---
+
+// Anahtarların değerlerini AYTDB_BATCH_SIZE anahtarlık MGET komutlarıyla okur.
+// callback her anahtar için sırayla çağrılır (yoksa reply NIL). Hata durumunda false.
+bool aytdb_mget(AytdbClient* client, size_t count, const char** keys,
+                AytdbCallback callback, void* ctx);
+
+// Tüm anahtarları AYTDB_BATCH_SIZE çiftlik MSET komutlarıyla yazar; hepsi +OK döndüyse true
+bool aytdb_mset(AytdbClient* client, size_t count, const char** keys, const char** values);
+
+// --- Bağlantı havuzu ---
+
+typedef struct AytdbPool AytdbPool;
+
+// size adet bağlantıya kadar büyüyen havuz; bağlantılar ilk ihtiyaçta açılır
+AytdbPool* aytdb_pool_create(const char* host, int port, const char* password, int size);
+void aytdb_pool_destroy(AytdbPool* pool);
+
+// Boş bağlantı yoksa biri geri verilene kadar bekler; bağlanılamazsa NULL
+AytdbClient* aytdb_pool_acquire(AytdbPool* pool);
+
+// Hatalı ya da yanıtı beklenen isteği olan bağlantı havuza alınmaz, kapatılır
+void aytdb_pool_release(AytdbPool* pool, AytdbClient* client);
+
+#endif // AYTDB_CLIENT_H
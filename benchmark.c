@@ -0,0 +1,488 @@
+// AytDB benchmark aracı - çok sayıda eşzamanlı bağlantı üzerinden get/set yükü üretir
+// ve saniyedeki istek sayısı ile gecikmeyi raporlar.
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <errno.h>
+#include <time.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/time.h>
+#include <arpa/inet.h>
+#include "aytdb_client.h"
+#include "shm_client.h"
+
+#define BENCH_MAX_EVENTS 1024
+#define BENCH_BUFFER_SIZE 4096   // Pipeline'daki her istek için ayrıca BENCH_REPLY_SIZE eklenir
+#define BENCH_REPLY_SIZE 128
+#define BENCH_REQUEST_SIZE 160
+#define BENCH_LATENCY_BUCKETS 1000000 // 1µs çözünürlükle 1 saniyeye kadar histogram
+
+typedef enum {
+    CLIENT_CONNECTING, // Bağlantının tamamlanması bekleniyor
+    CLIENT_AUTH,       // auth yanıtı bekleniyor
+    CLIENT_RUNNING,    // Yük komutlarının yanıtları bekleniyor
+    CLIENT_DONE
+} ClientState;
+
+typedef struct BenchConfig BenchConfig;
+
+typedef struct {
+    int fd;
+    AytdbClient* conn; // RESP modunda istemci kütüphanesinin bağlantısı
+    const BenchConfig* config;
+    ClientState state;
+    bool failed;
+    char* in;
+    size_t in_len;
+    int pending;      // Yanıtı beklenen istek sayısı
+    struct timespec sent_at;
+} BenchClient;
+
+struct BenchConfig {
+    const char* host;
+    int port;
+    const char* socket_path; // Verilirse TCP yerine Unix soketine bağlanılır
+    const char* shm_path;    // Verilirse paylaşımlı bellek taşıması kullanılır
+    int clients;
+    long requests;
+    int read_percent;
+    int keyspace;
+    const char* password;
+    bool resp;        // Telnet satırları yerine RESP komutları gönder
+    int pipeline;     // Bir turda gönderilen istek sayısı
+};
+
+static unsigned long latency_histogram[BENCH_LATENCY_BUCKETS + 1];
+static long issued = 0;
+static long completed = 0;
+
+static void show_usage(const char* program_name) {
+    printf("Usage: %s [options]\n", program_name);
+    printf("  -H <host>      : Server host (default: 127.0.0.1)\n");
+    printf("  -p <port>      : Server port (default: 6379)\n");
+    printf("  -s <socket>    : Connect to a Unix domain socket instead of TCP\n");
+    printf("  -m <socket>    : Use the shared-memory transport (one synchronous client, ns latencies)\n");
+    printf("  -c <clients>   : Number of parallel connections (default: 50)\n");
+    printf("  -n <requests>  : Total number of requests (default: 100000)\n");
+    printf("  -r <percent>   : Percentage of GET requests, the rest are SET (default: 90)\n");
+    printf("  -k <keyspace>  : Number of distinct keys (default: 10000)\n");
+    printf("  -a <password>  : Password sent with auth (default: password)\n");
+    printf("  -R             : Speak RESP through libaytdb-client instead of the telnet line protocol\n");
+    printf("  -P <requests>  : Pipeline <requests> commands per round trip (default: 1)\n");
+}
+
+static double elapsed_us(const struct timespec* start, const struct timespec* end) {
+    return (end->tv_sec - start->tv_sec) * 1e6 + (end->tv_nsec - start->tv_nsec) / 1e3;
+}
+
+// 10k bağlantı için varsayılan dosya tanımlayıcı sınırı yetmez
+static void raise_fd_limit() {
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+}
+
+static bool send_all(BenchClient* client, const char* data, size_t len) {
+    // İstekler küçük; boş bir sokete tek send ile sığar
+    ssize_t sent = send(client->fd, data, len, MSG_NOSIGNAL);
+    clock_gettime(CLOCK_MONOTONIC, &client->sent_at);
+    return sent == (ssize_t)len;
+}
+
+// Rastgele bir anahtar ve istek türü seçer; get ise true
+static bool next_request(const BenchConfig* config, char* key, char* value) {
+    int key_id = rand() % config->keyspace;
+    bool is_get = rand() % 100 < config->read_percent;
+    snprintf(key, 32, "bench:key:%d", key_id);
+    snprintf(value, 32, "value_%d", key_id);
+    return is_get;
+}
+
+static void on_resp_reply(AytdbClient* conn, const AytdbReply* reply, void* ctx);
+
+// Pipeline boyu kadar isteği tek send ile gönderir
+static bool send_next_batch(BenchClient* client, const BenchConfig* config) {
+    if (issued >= config->requests) {
+        client->state = CLIENT_DONE;
+        return true;
+    }
+    
+    char batch[BENCH_REQUEST_SIZE * 256];
+    size_t len = 0;
+    int count = 0;
+    while (count < config->pipeline && issued < config->requests) {
+        char key[32], value[32];
+        bool is_get = next_request(config, key, value);
+        if (client->conn) {
+            const char* argv[] = { is_get ? "GET" : "SET", key, value };
+            if (!aytdb_append_async(client->conn, on_resp_reply, client, is_get ? 2 : 3, argv, NULL)) return false;
+        } else if (is_get) {
+            len += (size_t)snprintf(batch + len, BENCH_REQUEST_SIZE, "get %s\r\n", key);
+        } else {
+            len += (size_t)snprintf(batch + len, BENCH_REQUEST_SIZE, "set %s %s\r\n", key, value);
+        }
+        issued++;
+        count++;
+    }
+    client->pending = count;
+    if (!client->conn) return send_all(client, batch, len);
+    bool sent = aytdb_flush(client->conn);
+    clock_gettime(CLOCK_MONOTONIC, &client->sent_at);
+    return sent;
+}
+
+// Telnet buffer'ının başındaki ilk tam yanıtın uzunluğu, yanıt tamamlanmadıysa 0.
+// İstem kapatılır ve her yanıt tek satırdır.
+static size_t reply_length(const char* buf, size_t buf_len, ClientState state) {
+    // Karşılama mesajı ve "prompt off" yanıtı auth yanıtıyla birlikte atlanır
+    const char* marker = state == CLIENT_AUTH ? "Authentication successful\r\n" : "\r\n";
+    const char* end = memmem(buf, buf_len, marker, strlen(marker));
+    return end ? (size_t)(end - buf) + strlen(marker) : 0;
+}
+
+static bool on_reply(BenchClient* client, const BenchConfig* config) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+
+    switch (client->state) {
+    case CLIENT_AUTH:
+        client->state = CLIENT_RUNNING;
+        return send_next_batch(client, config);
+    case CLIENT_RUNNING: {
+        // Pipeline'daki her istek için gecikme, toplu gönderimden itibaren ölçülür
+        long latency = (long)elapsed_us(&client->sent_at, &now);
+        latency_histogram[latency < BENCH_LATENCY_BUCKETS ? latency : BENCH_LATENCY_BUCKETS]++;
+        completed++;
+        return --client->pending > 0 || send_next_batch(client, config);
+    }
+    default:
+        return true;
+    }
+}
+
+// RESP modunda istemci kütüphanesi her yanıt için çağırır
+static void on_resp_reply(AytdbClient* conn, const AytdbReply* reply, void* ctx) {
+    (void)conn;
+    BenchClient* client = ctx;
+    if (!reply || client->failed) {
+        client->failed = true;
+        return;
+    }
+    if (!on_reply(client, client->config)) client->failed = true;
+}
+
+// Telnet bağlantısında okunan tüm tam yanıtları işler
+static bool read_telnet_replies(BenchClient* client, size_t buffer_size, const BenchConfig* config) {
+    ssize_t n = read(client->fd, client->in + client->in_len, buffer_size - client->in_len);
+    if (n < 0 && (errno == EAGAIN || errno == EINTR)) return true;
+    if (n <= 0) return false;
+
+    client->in_len += (size_t)n;
+    bool ok = true;
+    size_t consumed = 0, len;
+    while (ok && client->state != CLIENT_DONE) {
+        len = reply_length(client->in + consumed, client->in_len - consumed, client->state);
+        if (len == 0) break;
+        consumed += len;
+        ok = on_reply(client, config);
+    }
+    memmove(client->in, client->in + consumed, client->in_len - consumed);
+    client->in_len -= consumed;
+    return ok && client->in_len < buffer_size;
+}
+
+static double latency_percentile(double percentile) {
+    unsigned long target = (unsigned long)(completed * percentile);
+    unsigned long seen = 0;
+    for (int i = 0; i <= BENCH_LATENCY_BUCKETS; i++) {
+        seen += latency_histogram[i];
+        if (seen > target) return i / 1000.0;
+    }
+    return BENCH_LATENCY_BUCKETS / 1000.0;
+}
+
+static AytdbClient* connect_server(const BenchConfig* config) {
+    return config->socket_path ? aytdb_connect_unix(config->socket_path, config->password)
+                               : aytdb_connect(config->host, config->port, config->password);
+}
+
+// Sunucunun info komutundaki allocation sayacını ayrı bir bağlantıyla okur.
+// Sayaç yoksa veya okunamazsa -1 döner.
+static long long query_server_allocations(const BenchConfig* config) {
+    AytdbClient* conn = connect_server(config);
+    if (!conn) return -1;
+
+    const char* argv[] = { "INFO" };
+    const AytdbReply* reply = aytdb_command(conn, 1, argv, NULL);
+    const char* field = reply && reply->type == AYTDB_REPLY_STRING ? strstr(reply->str, "allocations:") : NULL;
+    long long count = field ? atoll(field + strlen("allocations:")) : -1;
+    aytdb_close(conn);
+    return count;
+}
+
+static int compare_latency(const void* a, const void* b) {
+    unsigned long x = *(const unsigned long*)a, y = *(const unsigned long*)b;
+    return x < y ? -1 : x > y;
+}
+
+// Paylaşımlı bellek taşıması tek, senkron bir istemciyle ölçülür; gecikmeler
+// mikrosaniyenin altında olduğu için histogram yerine ns cinsinden saklanır
+static int run_shm_benchmark(const BenchConfig* config) {
+    ShmClient* client = shm_client_connect(config->shm_path, config->password);
+    unsigned long* latencies = malloc((size_t)config->requests * sizeof(unsigned long));
+    if (!client || !latencies) {
+        fprintf(stderr, "Error: Could not connect to shared memory socket %s\n", config->shm_path);
+        shm_client_close(client);
+        free(latencies);
+        return 1;
+    }
+
+    printf("Benchmark: 1 client, %ld requests, %d%% GET, %d keys, shared memory\n",
+           config->requests, config->read_percent, config->keyspace);
+
+    struct timespec start, end, sent_at, now;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    char key[32], value[32], reply[BENCH_REPLY_SIZE];
+    bool found;
+    for (; completed < config->requests; completed++) {
+        bool is_get = next_request(config, key, value);
+
+        clock_gettime(CLOCK_MONOTONIC, &sent_at);
+        bool ok = is_get ? shm_client_get(client, key, reply, sizeof(reply), &found)
+                         : shm_client_set(client, key, value);
+        clock_gettime(CLOCK_MONOTONIC, &now);
+        if (!ok) {
+            fprintf(stderr, "Error: Request failed\n");
+            break;
+        }
+        latencies[completed] = (unsigned long)((now.tv_sec - sent_at.tv_sec) * 1000000000L +
+                                               (now.tv_nsec - sent_at.tv_nsec));
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = elapsed_us(&start, &end) / 1e6;
+
+    printf("Completed %ld requests in %.2f seconds\n", completed, seconds);
+    printf("Throughput: %.0f requests/sec\n", seconds > 0 ? completed / seconds : 0.0);
+    if (completed > 0) {
+        qsort(latencies, (size_t)completed, sizeof(unsigned long), compare_latency);
+        printf("Latency: p50 %.3f us, p99 %.3f us\n",
+               latencies[completed / 2] / 1000.0, latencies[(long)(completed * 0.99)] / 1000.0);
+    }
+
+    shm_client_close(client);
+    free(latencies);
+    return completed == config->requests ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    BenchConfig config = { "127.0.0.1", 6379, NULL, NULL, 50, 100000, 90, 10000, "password", false, 1 };
+
+    int opt;
+    while ((opt = getopt(argc, argv, "H:p:s:m:c:n:r:k:a:RP:h")) != -1) {
+        switch (opt) {
+        case 'H': config.host = optarg; break;
+        case 'p': config.port = atoi(optarg); break;
+        case 's': config.socket_path = optarg; break;
+        case 'm': config.shm_path = optarg; break;
+        case 'c': config.clients = atoi(optarg); break;
+        case 'n': config.requests = atol(optarg); break;
+        case 'r': config.read_percent = atoi(optarg); break;
+        case 'k': config.keyspace = atoi(optarg); break;
+        case 'a': config.password = optarg; break;
+        case 'R': config.resp = true; break;
+        case 'P': config.pipeline = atoi(optarg); break;
+        default:
+            show_usage(argv[0]);
+            return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (config.clients <= 0 || config.requests <= 0 || config.keyspace <= 0 ||
+        config.pipeline <= 0 || config.pipeline > 256) {
+        show_usage(argv[0]);
+        return 1;
+    }
+
+    srand(42);
+    if (config.shm_path) return run_shm_benchmark(&config);
+    raise_fd_limit();
+
+    struct sockaddr_storage addr_storage;
+    struct sockaddr* addr = (struct sockaddr*)&addr_storage;
+    socklen_t addr_len;
+    memset(&addr_storage, 0, sizeof(addr_storage));
+    if (config.socket_path) {
+        struct sockaddr_un* unix_addr = (struct sockaddr_un*)&addr_storage;
+        if (strlen(config.socket_path) >= sizeof(unix_addr->sun_path)) {
+            fprintf(stderr, "Error: Socket path is too long: %s\n", config.socket_path);
+            return 1;
+        }
+        unix_addr->sun_family = AF_UNIX;
+        strcpy(unix_addr->sun_path, config.socket_path);
+        addr_len = sizeof(*unix_addr);
+    } else {
+        struct sockaddr_in* tcp_addr = (struct sockaddr_in*)&addr_storage;
+        tcp_addr->sin_family = AF_INET;
+        tcp_addr->sin_port = htons(config.port);
+        if (inet_pton(AF_INET, config.host, &tcp_addr->sin_addr) != 1) {
+            struct hostent* host = gethostbyname(config.host);
+            if (!host) {
+                fprintf(stderr, "Error: Unknown host %s\n", config.host);
+                return 1;
+            }
+            memcpy(&tcp_addr->sin_addr, host->h_addr_list[0], sizeof(tcp_addr->sin_addr));
+        }
+        addr_len = sizeof(*tcp_addr);
+    }
+
+    long long allocations_before = query_server_allocations(&config);
+
+    int epfd = epoll_create1(0);
+    size_t buffer_size = BENCH_BUFFER_SIZE + (size_t)config.pipeline * BENCH_REPLY_SIZE;
+    BenchClient* clients = calloc(config.clients, sizeof(BenchClient));
+    if (epfd < 0 || !clients) {
+        perror("benchmark setup");
+        return 1;
+    }
+
+    // RESP bağlantıları istemci kütüphanesiyle sırayla açılır ve kimlik doğrular;
+    // telnet bağlantıları non-blocking başlatılır
+    int connected = 0;
+    for (int i = 0; i < config.clients; i++) {
+        clients[i].config = &config;
+        if (config.resp) {
+            clients[i].conn = connect_server(&config);
+            if (!clients[i].conn) {
+                fprintf(stderr, "Error: Could not connect to the server\n");
+                break;
+            }
+            clients[i].fd = aytdb_fd(clients[i].conn);
+            clients[i].state = CLIENT_RUNNING;
+            struct epoll_event ev = { .events = EPOLLIN, .data.ptr = &clients[i] };
+            epoll_ctl(epfd, EPOLL_CTL_ADD, clients[i].fd, &ev);
+            connected++;
+            continue;
+        }
+
+        int fd = socket(addr->sa_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (fd < 0) {
+            perror("socket");
+            break;
+        }
+        if (!config.socket_path) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+        if (connect(fd, addr, addr_len) < 0 && errno != EINPROGRESS) {
+            perror("connect");
+            close(fd);
+            break;
+        }
+
+        // Sunucu protokolü ilk komuttan anlar; bağlantı kurulunca auth gönderilir
+        clients[i].fd = fd;
+        clients[i].state = CLIENT_CONNECTING;
+        clients[i].in = malloc(buffer_size);
+        if (!clients[i].in) {
+            perror("malloc");
+            close(fd);
+            break;
+        }
+        struct epoll_event ev = { .events = EPOLLOUT, .data.ptr = &clients[i] };
+        epoll_ctl(epfd, EPOLL_CTL_ADD, fd, &ev);
+        connected++;
+    }
+    if (connected == 0) return 1;
+
+    printf("Benchmark: %d clients, %ld requests, %d%% GET, %d keys, pipeline %d, %s over %s\n",
+           connected, config.requests, config.read_percent, config.keyspace, config.pipeline,
+           config.resp ? "RESP" : "telnet", config.socket_path ? "unix socket" : "TCP");
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+
+    int active = connected;
+    for (int i = 0; i < connected; i++) {
+        if (clients[i].conn && !send_next_batch(&clients[i], &config)) {
+            fprintf(stderr, "Error: Connection %d failed\n", clients[i].fd);
+            clients[i].state = CLIENT_DONE;
+            active--;
+        }
+    }
+    struct epoll_event events[BENCH_MAX_EVENTS];
+    while (active > 0) {
+        int ready = epoll_wait(epfd, events, BENCH_MAX_EVENTS, 5000);
+        if (ready <= 0) {
+            if (ready < 0 && errno == EINTR) continue;
+            fprintf(stderr, "Error: Timed out waiting for replies\n");
+            break;
+        }
+
+        for (int i = 0; i < ready; i++) {
+            BenchClient* client = events[i].data.ptr;
+            if (client->state == CLIENT_DONE) continue;
+
+            if (client->state == CLIENT_CONNECTING) {
+                char line[160];
+                snprintf(line, sizeof(line), "prompt off\r\nauth %s\r\n", config.password);
+                struct epoll_event ev = { .events = EPOLLIN, .data.ptr = client };
+                bool connected_ok = !(events[i].events & (EPOLLERR | EPOLLHUP)) &&
+                                    epoll_ctl(epfd, EPOLL_CTL_MOD, client->fd, &ev) == 0 &&
+                                    send_all(client, line, strlen(line));
+                if (connected_ok) {
+                    client->state = CLIENT_AUTH;
+                } else {
+                    fprintf(stderr, "Error: Connection %d failed\n", client->fd);
+                    client->state = CLIENT_DONE;
+                    close(client->fd);
+                    active--;
+                }
+                continue;
+            }
+
+            bool ok = client->conn ? aytdb_read(client->conn) >= 0 && !client->failed
+                                   : read_telnet_replies(client, buffer_size, &config);
+            if (!ok || client->state == CLIENT_DONE) {
+                if (!ok) fprintf(stderr, "Error: Connection %d failed\n", client->fd);
+                client->state = CLIENT_DONE;
+                if (client->conn) epoll_ctl(epfd, EPOLL_CTL_DEL, client->fd, NULL);
+                else close(client->fd);
+                active--;
+            }
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    double seconds = elapsed_us(&start, &end) / 1e6;
+
+    printf("Completed %ld requests in %.2f seconds\n", completed, seconds);
+    printf("Throughput: %.0f requests/sec\n", seconds > 0 ? completed / seconds : 0.0);
+    printf("Latency: p50 %.3f ms, p99 %.3f ms\n", latency_percentile(0.50), latency_percentile(0.99));
+
+    // Bağlantı kurulumu dahil sunucuda yapılan heap allocation'lar
+    long long allocations_after = allocations_before >= 0 ? query_server_allocations(&config) : -1;
+    if (allocations_after >= 0 && completed > 0) {
+        long long allocations = allocations_after - allocations_before;
+        printf("Server allocations: %lld (%.4f per request)\n", allocations, (double)allocations / completed);
+    } else {
+        printf("Server allocations: n/a\n");
+    }
+
+    for (int i = 0; i < connected; i++) {
+        aytdb_close(clients[i].conn);
+        free(clients[i].in);
+    }
+    free(clients);
+    close(epfd);
+    return completed == config.requests ? 0 : 1;
+}
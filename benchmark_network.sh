@@ -0,0 +1,39 @@
+#!/bin/sh
+# epoll ve io_uring ağ döngülerini aynı yük altında art arda ölçer.
+# Kullanım: ./benchmark_network.sh [build dizini] [aytdb_benchmark seçenekleri]
+# Örnek:    ./benchmark_network.sh build -c 1000 -n 1000000 -R -P 16
+#
+# Her çalıştırma boş bir geçici dizinde yeni bir sunucu başlatır, böylece
+# önceki ölçümün verisi veya snapshot'ı sonucu etkilemez.
+
+BUILD_DIR=${1:-build}
+[ $# -gt 0 ] && shift
+PORT=${AYTDB_BENCH_PORT:-6390}
+
+SERVER="$(cd "$BUILD_DIR" && pwd)/aytdb_server"
+BENCHMARK="$(cd "$BUILD_DIR" && pwd)/aytdb_benchmark"
+if [ ! -x "$SERVER" ] || [ ! -x "$BENCHMARK" ]; then
+    echo "Error: aytdb_server and aytdb_benchmark not found in $BUILD_DIR" >&2
+    exit 1
+fi
+
+run_backend() {
+    name=$1
+    shift
+    workdir=$(mktemp -d)
+    (cd "$workdir" && exec "$SERVER" "$PORT" "$@" > server.log 2>&1) &
+    server_pid=$!
+    sleep 1
+
+    echo "== $name =="
+    grep -h "falling back" "$workdir/server.log"
+    "$BENCHMARK" -p "$PORT" $BENCH_ARGS | grep -E "Throughput|Latency|allocations"
+
+    kill -INT "$server_pid"
+    wait "$server_pid"
+    rm -rf "$workdir"
+}
+
+BENCH_ARGS="$*"
+run_backend epoll
+run_backend io_uring --io-uring-net
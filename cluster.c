@@ -0,0 +1,735 @@
+#define _GNU_SOURCE // pthread_rwlockattr_setkind_np için
+#include "cluster.h"
+#include "kv_store.h"
+#include "hash_util.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#define CLUSTER_NO_NODE (-1)
+#define CLUSTER_LOCK_STRIPES 64      // Slot kilitleri bu kadar şeride bölünür (slot % şerit)
+#define CLUSTER_MIGRATE_BATCH 64     // Taşımada tek gidiş-dönüşte hedefe gönderilen en fazla anahtar
+#define CLUSTER_MIGRATE_SCAN 1024    // Taşımada kilitsiz tek taramada kopyalanan entry
+#define CLUSTER_COMMAND_MAX (sizeof(((Entry*)0)->key) + sizeof(((Entry*)0)->value) + 128)
+#define CLUSTER_IO_TIMEOUT 5         // Düğümler arası bağlantıda okuma/yazma zaman aşımı (saniye)
+
+// Komutlar slotlarının şeridini okuma için, taşıma ve slot durumu değişiklikleri yazma için
+// kilitler. Böylece bir anahtar taşınırken ona dokunan komut yoktur; taşınmayan slotlardaki
+// komutlar birbirini beklemez. Şeritler ayrı önbellek satırlarında durur.
+typedef struct __attribute__((aligned(64))) {
+    pthread_rwlock_t lock;
+} SlotLock;
+
+typedef enum {
+    MIGRATION_NONE,
+    MIGRATION_RUNNING,
+    MIGRATION_DONE,
+    MIGRATION_FAILED
+} MigrationState;
+
+// Kilit sırası: cluster_mutex -> slot şeritleri -> storage
+static pthread_mutex_t cluster_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t locks_once = PTHREAD_ONCE_INIT;
+static SlotLock slot_locks[CLUSTER_LOCK_STRIPES];
+static Storage* storage = NULL;
+static bool enabled = false;                 // atomik
+static char config_path[PATH_MAX];
+static char auth[128] = "password";
+
+// Düğümler yalnızca eklenir, adresleri değişmez; kilitsiz okunabilir
+static char nodes[CLUSTER_MAX_NODES][CLUSTER_ADDR_SIZE];
+static int node_count = 0;
+static int myself = CLUSTER_NO_NODE;
+
+// Slot durumu: cluster_mutex ve slotun şeridi yazma için tutularak değişir
+static int16_t slot_owner[CLUSTER_SLOTS];
+static int16_t slot_migrating[CLUSTER_SLOTS]; // Kaynakta: taşınan hedef düğüm
+static int16_t slot_importing[CLUSTER_SLOTS]; // Hedefte: taşıyan kaynak düğüm
+
+// Taşıma durumu (cluster_mutex)
+static pthread_t migration_thread;
+static bool migration_joinable = false;
+static MigrationState migration_state = MIGRATION_NONE;
+static bool migration_stop = false;          // atomik
+static int migration_start = 0;
+static int migration_end = 0;
+static int migration_target = CLUSTER_NO_NODE;
+static unsigned long long migrated_keys = 0; // atomik
+
+static void init_locks() {
+    // Yazar öncelikli: sürekli okuma altında taşıma aç kalmaz
+    pthread_rwlockattr_t attr;
+    pthread_rwlockattr_init(&attr);
+    pthread_rwlockattr_setkind_np(&attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+    for (int i = 0; i < CLUSTER_LOCK_STRIPES; i++) pthread_rwlock_init(&slot_locks[i].lock, &attr);
+    pthread_rwlockattr_destroy(&attr);
+}
+
+// Aralığın dokunduğu şeritler, sıra ile kilitlenir (kilitlenme olmaması için)
+static uint64_t range_stripes(int start, int end) {
+    if (end - start + 1 >= CLUSTER_LOCK_STRIPES) return ~0ULL;
+    uint64_t mask = 0;
+    for (int slot = start; slot <= end; slot++) mask |= 1ULL << (slot % CLUSTER_LOCK_STRIPES);
+    return mask;
+}
+
+static void lock_range(int start, int end) {
+    uint64_t mask = range_stripes(start, end);
+    for (int i = 0; i < CLUSTER_LOCK_STRIPES; i++) {
+        if (mask & (1ULL << i)) pthread_rwlock_wrlock(&slot_locks[i].lock);
+    }
+}
+
+static void unlock_range(int start, int end) {
+    uint64_t mask = range_stripes(start, end);
+    for (int i = 0; i < CLUSTER_LOCK_STRIPES; i++) {
+        if (mask & (1ULL << i)) pthread_rwlock_unlock(&slot_locks[i].lock);
+    }
+}
+
+// "host:port" doğrulaması
+static bool valid_address(const char* addr) {
+    const char* colon = strrchr(addr, ':');
+    if (!colon || colon == addr || strlen(addr) >= CLUSTER_ADDR_SIZE) return false;
+    char* end = NULL;
+    long port = strtol(colon + 1, &end, 10);
+    return *end == '\0' && port > 0 && port <= 65535;
+}
+
+static int find_node_locked(const char* addr) {
+    for (int i = 0; i < node_count; i++) {
+        if (strcmp(nodes[i], addr) == 0) return i;
+    }
+    return CLUSTER_NO_NODE;
+}
+
+static int add_node_locked(const char* addr) {
+    int index = find_node_locked(addr);
+    if (index != CLUSTER_NO_NODE) return index;
+    if (node_count == CLUSTER_MAX_NODES || !valid_address(addr)) return CLUSTER_NO_NODE;
+    snprintf(nodes[node_count], CLUSTER_ADDR_SIZE, "%s", addr);
+    return node_count++;
+}
+
+bool cluster_parse_range(const char* text, int* start, int* end) {
+    char* rest = NULL;
+    long first = strtol(text, &rest, 10);
+    long last = first;
+    if (rest == text) return false;
+    if (*rest == '-') {
+        const char* second = rest + 1;
+        last = strtol(second, &rest, 10);
+        if (rest == second) return false;
+    }
+    if (*rest != '\0' || first < 0 || last < first || last >= CLUSTER_SLOTS) return false;
+    *start = (int)first;
+    *end = (int)last;
+    return true;
+}
+
+// Slot sahipliğini geçici dosyaya yazıp yerine taşır; taşıma durumları kaydedilmez
+static bool save_config_locked() {
+    char tmp_path[PATH_MAX + 8];
+    snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", config_path);
+    FILE* file = fopen(tmp_path, "w");
+    if (!file) {
+        perror("Failed to write cluster config");
+        return false;
+    }
+    fprintf(file, "# AytDB cluster slot table: node <host:port> [<start>-<end> ...]\n");
+    for (int node = 0; node < node_count; node++) {
+        fprintf(file, "node %s", nodes[node]);
+        for (int slot = 0; slot < CLUSTER_SLOTS; slot++) {
+            if (slot_owner[slot] != node) continue;
+            int end = slot;
+            while (end + 1 < CLUSTER_SLOTS && slot_owner[end + 1] == node) end++;
+            fprintf(file, " %d-%d", slot, end);
+            slot = end;
+        }
+        fprintf(file, "\n");
+    }
+    bool ok = fflush(file) == 0 && fsync(fileno(file)) == 0;
+    ok = fclose(file) == 0 && ok;
+    if (ok && rename(tmp_path, config_path) != 0) ok = false;
+    if (!ok) perror("Failed to write cluster config");
+    return ok;
+}
+
+static bool load_config_locked() {
+    FILE* file = fopen(config_path, "r");
+    if (!file) return errno == ENOENT; // Yeni düğüm: slotlar sonradan atanır
+
+    char line[4096];
+    int line_no = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), file)) {
+        line_no++;
+        char* save = NULL;
+        char* word = strtok_r(line, " \t\r\n", &save);
+        if (!word || word[0] == '#') continue;
+        char* addr = strtok_r(NULL, " \t\r\n", &save);
+        int node = strcmp(word, "node") == 0 && addr ? add_node_locked(addr) : CLUSTER_NO_NODE;
+        if (node == CLUSTER_NO_NODE) {
+            printf("Error: Invalid cluster config line %d in %s\n", line_no, config_path);
+            ok = false;
+            break;
+        }
+        char* range;
+        while ((range = strtok_r(NULL, " \t\r\n", &save))) {
+            int start, end;
+            if (!cluster_parse_range(range, &start, &end)) {
+                printf("Error: Invalid slot range '%s' in %s line %d\n", range, config_path, line_no);
+                ok = false;
+                break;
+            }
+            for (int slot = start; slot <= end; slot++) slot_owner[slot] = (int16_t)node;
+        }
+    }
+    fclose(file);
+    return ok;
+}
+
+static void reset_slots_locked() {
+    for (int slot = 0; slot < CLUSTER_SLOTS; slot++) {
+        slot_owner[slot] = CLUSTER_NO_NODE;
+        slot_migrating[slot] = CLUSTER_NO_NODE;
+        slot_importing[slot] = CLUSTER_NO_NODE;
+    }
+    node_count = 0;
+    myself = CLUSTER_NO_NODE;
+}
+
+void cluster_init(Storage* s) {
+    storage = s;
+    pthread_once(&locks_once, init_locks);
+}
+
+bool cluster_enable(const char* path, const char* me) {
+    pthread_once(&locks_once, init_locks);
+    if (strlen(path) >= sizeof(config_path) || !valid_address(me)) {
+        printf("Error: Invalid cluster config path or node address %s\n", me);
+        return false;
+    }
+
+    pthread_mutex_lock(&cluster_mutex);
+    lock_range(0, CLUSTER_SLOTS - 1);
+    snprintf(config_path, sizeof(config_path), "%s", path);
+    reset_slots_locked();
+    bool ok = load_config_locked();
+    if (ok) {
+        myself = add_node_locked(me);
+        ok = myself != CLUSTER_NO_NODE;
+    }
+    if (!ok) reset_slots_locked();
+    unlock_range(0, CLUSTER_SLOTS - 1);
+    pthread_mutex_unlock(&cluster_mutex);
+
+    __atomic_store_n(&enabled, ok, __ATOMIC_RELEASE);
+    return ok;
+}
+
+void cluster_shutdown() {
+    pthread_mutex_lock(&cluster_mutex);
+    bool joinable = migration_joinable;
+    migration_joinable = false;
+    __atomic_store_n(&migration_stop, true, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&cluster_mutex);
+    if (joinable) pthread_join(migration_thread, NULL);
+
+    __atomic_store_n(&enabled, false, __ATOMIC_RELEASE);
+    pthread_mutex_lock(&cluster_mutex);
+    lock_range(0, CLUSTER_SLOTS - 1);
+    reset_slots_locked();
+    unlock_range(0, CLUSTER_SLOTS - 1);
+    migration_state = MIGRATION_NONE;
+    __atomic_store_n(&migration_stop, false, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&cluster_mutex);
+}
+
+bool cluster_is_enabled() {
+    return __atomic_load_n(&enabled, __ATOMIC_ACQUIRE);
+}
+
+void cluster_set_auth(const char* password) {
+    pthread_mutex_lock(&cluster_mutex);
+    snprintf(auth, sizeof(auth), "%s", password);
+    pthread_mutex_unlock(&cluster_mutex);
+}
+
+int cluster_keyslot(const char* key) {
+    // {etiket} içeren anahtarlar aynı slota düşer; çok anahtarlı komutlar bununla gruplanır
+    const char* open = strchr(key, '{');
+    const char* close = open ? strchr(open + 1, '}') : NULL;
+    if (close && close > open + 1) {
+        char tag[sizeof(((Entry*)0)->key)];
+        size_t len = (size_t)(close - open - 1);
+        if (len >= sizeof(tag)) len = sizeof(tag) - 1;
+        memcpy(tag, open + 1, len);
+        tag[len] = '\0';
+        return (int)(hash(tag) & (CLUSTER_SLOTS - 1));
+    }
+    return (int)(hash(key) & (CLUSTER_SLOTS - 1));
+}
+
+// MOVED/ASK gibi hatalar RESP'te ERR öneki olmadan yazılır, istemciler kodu ilk kelimeden okur
+static void reply_cluster_error(CommandClient* client, const char* text) {
+    if (client->protocol == PROTOCOL_RESP) {
+        char line[160];
+        int len = snprintf(line, sizeof(line), "-%s\r\n", text);
+        reply_raw(client, line, (size_t)len);
+    } else {
+        reply_error(client, "%s", text);
+    }
+}
+
+int cluster_route(CommandClient* client, char** keys, int count, int step, bool asking) {
+    char text[128];
+    int slot = cluster_keyslot(keys[0]);
+    for (int i = 1; i < count; i++) {
+        if (cluster_keyslot(keys[i * step]) != slot) {
+            reply_cluster_error(client, "CROSSSLOT Keys in request don't hash to the same slot");
+            return -1;
+        }
+    }
+
+    pthread_rwlock_rdlock(&slot_locks[slot % CLUSTER_LOCK_STRIPES].lock);
+    int owner = slot_owner[slot];
+    if (owner != CLUSTER_NO_NODE && owner == myself) {
+        int target = slot_migrating[slot];
+        if (target == CLUSTER_NO_NODE) return slot;
+
+        // Slot taşınıyor: anahtarlar hâlâ buradaysa komut burada çalışır, hiçbiri yoksa
+        // (taşınmış ya da yeni) hedefe sorulur. Şerit kilidi tutulduğu için arada taşınamazlar.
+        int present = 0;
+        for (int i = 0; i < count; i++) {
+            if (kv_get(keys[i * step])) present++;
+        }
+        if (present == count) return slot;
+        cluster_release(slot);
+        if (present == 0) {
+            snprintf(text, sizeof(text), "ASK %d %s", slot, nodes[target]);
+        } else {
+            snprintf(text, sizeof(text), "TRYAGAIN Multiple keys request during slot %d migration", slot);
+        }
+        reply_cluster_error(client, text);
+        return -1;
+    }
+    if (asking && slot_importing[slot] != CLUSTER_NO_NODE) return slot;
+    cluster_release(slot);
+
+    if (owner == CLUSTER_NO_NODE) {
+        snprintf(text, sizeof(text), "CLUSTERDOWN Hash slot %d not served", slot);
+    } else {
+        snprintf(text, sizeof(text), "MOVED %d %s", slot, nodes[owner]);
+    }
+    reply_cluster_error(client, text);
+    return -1;
+}
+
+void cluster_release(int slot) {
+    pthread_rwlock_unlock(&slot_locks[slot % CLUSTER_LOCK_STRIPES].lock);
+}
+
+bool cluster_assign(int start, int end, const char* node) {
+    pthread_mutex_lock(&cluster_mutex);
+    int index = add_node_locked(node);
+    if (index == CLUSTER_NO_NODE) {
+        pthread_mutex_unlock(&cluster_mutex);
+        return false;
+    }
+    lock_range(start, end);
+    for (int slot = start; slot <= end; slot++) {
+        slot_owner[slot] = (int16_t)index;
+        slot_migrating[slot] = CLUSTER_NO_NODE;
+        slot_importing[slot] = CLUSTER_NO_NODE;
+    }
+    unlock_range(start, end);
+    bool saved = save_config_locked();
+    pthread_mutex_unlock(&cluster_mutex);
+    if (logging_enabled) printf("Slots %d-%d assigned to %s\n", start, end, node);
+    return saved;
+}
+
+// Taşıma durumunu aralığa yazar; state slot_migrating ya da slot_importing'dir
+static bool set_transfer_state(int16_t* state, int start, int end, const char* node) {
+    pthread_mutex_lock(&cluster_mutex);
+    int index = node ? add_node_locked(node) : CLUSTER_NO_NODE;
+    if (node && (index == CLUSTER_NO_NODE || index == myself)) {
+        pthread_mutex_unlock(&cluster_mutex);
+        return false;
+    }
+    lock_range(start, end);
+    for (int slot = start; slot <= end; slot++) state[slot] = (int16_t)index;
+    unlock_range(start, end);
+    pthread_mutex_unlock(&cluster_mutex);
+    return true;
+}
+
+bool cluster_set_migrating(int start, int end, const char* node) {
+    return set_transfer_state(slot_migrating, start, end, node);
+}
+
+bool cluster_set_importing(int start, int end, const char* node) {
+    return set_transfer_state(slot_importing, start, end, node);
+}
+
+void cluster_set_stable(int start, int end) {
+    set_transfer_state(slot_migrating, start, end, NULL);
+    set_transfer_state(slot_importing, start, end, NULL);
+}
+
+size_t cluster_count_keys_in_slot(int slot) {
+    Entry* batch = malloc(CLUSTER_MIGRATE_BATCH * sizeof(Entry));
+    if (!batch) return 0;
+    size_t cursor = 0;
+    size_t count;
+    size_t total = 0;
+    while ((count = kv_scan_entries(&cursor, batch, CLUSTER_MIGRATE_BATCH)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            if (cluster_keyslot(batch[i].key) == slot) total++;
+        }
+    }
+    free(batch);
+    return total;
+}
+
+// ---------------------------------------------------------------------------
+// Düğümler arası bağlantı (taşıma ve sahiplik bildirimi)
+// ---------------------------------------------------------------------------
+
+static int connect_node(const char* addr) {
+    char host[CLUSTER_ADDR_SIZE];
+    snprintf(host, sizeof(host), "%s", addr);
+    char* colon = strrchr(host, ':');
+    *colon = '\0';
+
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, colon + 1, &hints, &result) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo* ai = result; ai && fd < 0; ai = ai->ai_next) {
+        fd = socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd >= 0 && connect(fd, ai->ai_addr, ai->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+    if (fd >= 0) {
+        int one = 1;
+        struct timeval timeout = { .tv_sec = CLUSTER_IO_TIMEOUT };
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+static size_t encode_command(char* out, size_t cap, int argc, const char** argv) {
+    size_t len = (size_t)snprintf(out, cap, "*%d\r\n", argc);
+    for (int i = 0; i < argc && len < cap; i++) {
+        len += (size_t)snprintf(out + len, cap - len, "$%zu\r\n%s\r\n", strlen(argv[i]), argv[i]);
+    }
+    return len < cap ? len : 0;
+}
+
+// count adet tek satırlık yanıt okur; hepsi "+" ile başlamalıdır
+static bool read_ok_replies(int fd, int count) {
+    char buf[4096];
+    size_t len = 0;
+    while (count > 0) {
+        char* line_end = memchr(buf, '\n', len);
+        if (line_end) {
+            if (buf[0] != '+') {
+                if (logging_enabled) printf("Cluster peer replied: %.*s\n", (int)(line_end - buf), buf);
+                return false;
+            }
+            size_t used = (size_t)(line_end - buf) + 1;
+            memmove(buf, buf + used, len - used);
+            len -= used;
+            count--;
+            continue;
+        }
+        if (len == sizeof(buf)) return false;
+        ssize_t received = recv(fd, buf + len, sizeof(buf) - len, 0);
+        if (received < 0 && errno == EINTR) continue;
+        if (received <= 0) return false;
+        len += (size_t)received;
+    }
+    return true;
+}
+
+// Düğüme bağlanıp kimlik doğrular ve tek komut çalıştırır
+static bool run_on_node(const char* addr, int argc, const char** argv, int* fd_out) {
+    int fd = connect_node(addr);
+    if (fd < 0) return false;
+    char out[512];
+    char password[sizeof(auth)];
+    pthread_mutex_lock(&cluster_mutex);
+    snprintf(password, sizeof(password), "%s", auth);
+    pthread_mutex_unlock(&cluster_mutex);
+    const char* auth_argv[] = { "AUTH", password };
+    size_t len = encode_command(out, sizeof(out), 2, auth_argv);
+    size_t command_len = len ? encode_command(out + len, sizeof(out) - len, argc, argv) : 0;
+    bool ok = command_len > 0 && send_all(fd, out, len + command_len) && read_ok_replies(fd, 2);
+    if (!ok || !fd_out) {
+        close(fd);
+        fd = -1;
+    }
+    if (fd_out) *fd_out = fd;
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Çevrimiçi slot taşıma
+// ---------------------------------------------------------------------------
+
+// Aynı şeritteki anahtarları (en fazla CLUSTER_MIGRATE_BATCH) hedefe yazar ve yerelden
+// siler. Gidiş-dönüş boyunca yalnızca bu şerit kilitlidir; anahtarın kopyası yoldayken ona
+// komut dokunamaz, diğer şeritlerdeki komutlar beklemez. Taramadan sonra değişen ya da
+// silinen anahtarlar atlanır; *skipped artar ve sonraki turda yeniden taranır.
+static bool move_group(int fd, int stripe, const Entry* batch, const size_t* group, int count,
+                       char* out, size_t out_cap, unsigned long long* skipped) {
+    if (__atomic_load_n(&migration_stop, __ATOMIC_RELAXED)) return false;
+
+    pthread_rwlock_wrlock(&slot_locks[stripe].lock);
+    size_t len = 0;
+    size_t moving[CLUSTER_MIGRATE_BATCH];
+    int sent = 0;
+    time_t now = time(NULL);
+    for (int i = 0; i < count; i++) {
+        const Entry* entry = &batch[group[i]];
+        if (kv_get_version(entry->key) != entry->version) {
+            (*skipped)++;
+            continue;
+        }
+        const char* asking[] = { "ASKING" };
+        len += encode_command(out + len, out_cap - len, 1, asking);
+        if (entry->expire_at > 0) {
+            char ttl[24];
+            snprintf(ttl, sizeof(ttl), "%ld", entry->expire_at > now ? (long)(entry->expire_at - now) : 1L);
+            const char* setex[] = { "SETEX", entry->key, ttl, entry->value };
+            len += encode_command(out + len, out_cap - len, 4, setex);
+        } else {
+            const char* set[] = { "SET", entry->key, entry->value };
+            len += encode_command(out + len, out_cap - len, 3, set);
+        }
+        moving[sent++] = group[i];
+    }
+    bool ok = sent == 0 || (send_all(fd, out, len) && read_ok_replies(fd, sent * 2));
+    if (ok) {
+        for (int i = 0; i < sent; i++) storage_delete(storage, batch[moving[i]].key);
+    }
+    pthread_rwlock_unlock(&slot_locks[stripe].lock);
+
+    if (ok) __atomic_add_fetch(&migrated_keys, (unsigned long long)sent, __ATOMIC_RELAXED);
+    return ok;
+}
+
+// Aralıktaki anahtarları hedefe taşır. Tarama kilitsiz yapılır, anahtarlar şeritlerine göre
+// gruplanıp move_group ile küçük parçalar halinde gönderilir; şerit kilitleri parçalar
+// arasında bırakılır. Taşıma sürerken yeni anahtarlar ASK ile hedefe gittiği için tarama,
+// aralıkta anahtar kalmayana kadar tekrarlanır.
+static bool move_keys(int fd, int start, int end, Entry* batch, char* out, size_t out_cap) {
+    size_t in_range[CLUSTER_MIGRATE_SCAN];
+    size_t group[CLUSTER_MIGRATE_BATCH];
+    unsigned long long seen;
+    do {
+        seen = 0;
+        unsigned long long skipped = 0;
+        size_t cursor = 0;
+        size_t count;
+        while ((count = kv_scan_entries(&cursor, batch, CLUSTER_MIGRATE_SCAN)) > 0) {
+            size_t kept = 0;
+            for (size_t i = 0; i < count; i++) {
+                int slot = cluster_keyslot(batch[i].key);
+                if (slot >= start && slot <= end) in_range[kept++] = i;
+            }
+            seen += kept;
+
+            uint64_t stripes = range_stripes(start, end);
+            for (int stripe = 0; stripe < CLUSTER_LOCK_STRIPES; stripe++) {
+                if (!(stripes & (1ULL << stripe))) continue;
+                int grouped = 0;
+                for (size_t i = 0; i < kept; i++) {
+                    if (cluster_keyslot(batch[in_range[i]].key) % CLUSTER_LOCK_STRIPES != stripe) continue;
+                    group[grouped++] = in_range[i];
+                    if (grouped == CLUSTER_MIGRATE_BATCH) {
+                        if (!move_group(fd, stripe, batch, group, grouped, out, out_cap, &skipped)) return false;
+                        grouped = 0;
+                    }
+                }
+                if (grouped > 0 && !move_group(fd, stripe, batch, group, grouped, out, out_cap, &skipped)) return false;
+            }
+        }
+        if (logging_enabled && skipped > 0) printf("Migration rescans %llu keys changed while moving\n", skipped);
+    } while (seen > 0);
+    return true;
+}
+
+static void* migration_loop(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&cluster_mutex);
+    int start = migration_start;
+    int end = migration_end;
+    const char* target = nodes[migration_target];
+    const char* me = nodes[myself];
+    pthread_mutex_unlock(&cluster_mutex);
+
+    char range[32];
+    snprintf(range, sizeof(range), "%d-%d", start, end);
+    size_t out_cap = CLUSTER_MIGRATE_BATCH * (CLUSTER_COMMAND_MAX + 32);
+    char* out = malloc(out_cap);
+    Entry* batch = malloc(CLUSTER_MIGRATE_SCAN * sizeof(Entry));
+
+    // Önce hedef slotları almaya hazırlanır, sonra kaynak yeni anahtarları hedefe yönlendirir
+    int fd = -1;
+    const char* importing[] = { "CLUSTER", "SETSLOT", range, "IMPORTING", me };
+    bool ok = out && batch && run_on_node(target, 5, importing, &fd) &&
+              cluster_set_migrating(start, end, target) &&
+              move_keys(fd, start, end, batch, out, out_cap);
+
+    // Sahiplik önce hedefte değişir; arada kaynak kalan istekleri ASK ile hedefe yollar
+    const char* assign[] = { "CLUSTER", "SETSLOT", range, "NODE", target };
+    if (ok) {
+        size_t len = encode_command(out, out_cap, 5, assign);
+        ok = send_all(fd, out, len) && read_ok_replies(fd, 1) && cluster_assign(start, end, target);
+    }
+    if (fd >= 0) close(fd);
+    free(out);
+    free(batch);
+
+    if (ok) {
+        // Diğer düğümler en iyi çabayla bilgilendirilir; bilgisi eski olan düğüm de MOVED ile
+        // eski sahibe, o da yeni sahibe yönlendirir
+        pthread_mutex_lock(&cluster_mutex);
+        int count = node_count;
+        pthread_mutex_unlock(&cluster_mutex);
+        for (int node = 0; node < count; node++) {
+            if (node == myself || strcmp(nodes[node], target) == 0) continue;
+            if (!run_on_node(nodes[node], 5, assign, NULL) && logging_enabled) {
+                printf("Failed to notify %s about slots %s\n", nodes[node], range);
+            }
+        }
+        printf("Migrated slots %s to %s\n", range, target);
+    } else {
+        // Taşınmış anahtarlar hedefte kaldığı için slotlar MIGRATING kalır; komut tekrar
+        // çalıştırılınca taşıma kaldığı yerden devam eder
+        printf("Migration of slots %s to %s failed\n", range, target);
+    }
+
+    pthread_mutex_lock(&cluster_mutex);
+    migration_state = ok ? MIGRATION_DONE : MIGRATION_FAILED;
+    pthread_mutex_unlock(&cluster_mutex);
+    return NULL;
+}
+
+bool cluster_start_migration(int start, int end, const char* node) {
+    pthread_mutex_lock(&cluster_mutex);
+    int target = add_node_locked(node);
+    bool owned = target != CLUSTER_NO_NODE && target != myself;
+    for (int slot = start; owned && slot <= end; slot++) owned = slot_owner[slot] == myself;
+    if (!owned || migration_state == MIGRATION_RUNNING) {
+        pthread_mutex_unlock(&cluster_mutex);
+        return false;
+    }
+    if (migration_joinable) pthread_join(migration_thread, NULL);
+    migration_start = start;
+    migration_end = end;
+    migration_target = target;
+    migration_joinable = pthread_create(&migration_thread, NULL, migration_loop, NULL) == 0;
+    if (migration_joinable) migration_state = MIGRATION_RUNNING;
+    bool started = migration_joinable;
+    pthread_mutex_unlock(&cluster_mutex);
+    return started;
+}
+
+// ---------------------------------------------------------------------------
+// CLUSTER SLOTS / INFO
+// ---------------------------------------------------------------------------
+
+void cluster_reply_slots(CommandClient* client) {
+    pthread_mutex_lock(&cluster_mutex);
+    size_t ranges = 0;
+    for (int slot = 0; slot < CLUSTER_SLOTS; slot++) {
+        if (slot_owner[slot] != CLUSTER_NO_NODE && (slot == 0 || slot_owner[slot - 1] != slot_owner[slot])) ranges++;
+    }
+
+    if (client->protocol == PROTOCOL_RESP) reply_aggregate(client, '*', ranges);
+    for (int slot = 0; slot < CLUSTER_SLOTS; slot++) {
+        int owner = slot_owner[slot];
+        if (owner == CLUSTER_NO_NODE) continue;
+        int end = slot;
+        while (end + 1 < CLUSTER_SLOTS && slot_owner[end + 1] == owner) end++;
+        if (client->protocol == PROTOCOL_RESP) {
+            // [start, end, [host, port]]
+            const char* colon = strrchr(nodes[owner], ':');
+            reply_aggregate(client, '*', 3);
+            reply_integer(client, slot);
+            reply_integer(client, end);
+            reply_aggregate(client, '*', 2);
+            reply_bulk(client, nodes[owner], (size_t)(colon - nodes[owner]));
+            reply_integer(client, atoi(colon + 1));
+        } else {
+            char line[CLUSTER_ADDR_SIZE + 32];
+            snprintf(line, sizeof(line), "%d-%d %s", slot, end, nodes[owner]);
+            reply_status(client, line);
+        }
+        slot = end;
+    }
+    pthread_mutex_unlock(&cluster_mutex);
+}
+
+size_t cluster_info(char* buf, size_t size) {
+    static const char* const states[] = { "none", "running", "done", "failed" };
+    if (!cluster_is_enabled()) {
+        int len = snprintf(buf, size, "cluster_enabled:0");
+        return (size_t)len < size ? (size_t)len : size - 1;
+    }
+
+    pthread_mutex_lock(&cluster_mutex);
+    int assigned = 0, owned = 0, migrating = 0, importing = 0;
+    for (int slot = 0; slot < CLUSTER_SLOTS; slot++) {
+        if (slot_owner[slot] != CLUSTER_NO_NODE) assigned++;
+        if (slot_owner[slot] == myself) owned++;
+        if (slot_migrating[slot] != CLUSTER_NO_NODE) migrating++;
+        if (slot_importing[slot] != CLUSTER_NO_NODE) importing++;
+    }
+    int len = snprintf(buf, size,
+                       "cluster_enabled:1\r\ncluster_state:%s\r\ncluster_slots_assigned:%d\r\n"
+                       "cluster_slots_owned:%d\r\ncluster_known_nodes:%d\r\ncluster_myself:%s\r\n"
+                       "cluster_migrating_slots:%d\r\ncluster_importing_slots:%d\r\n"
+                       "cluster_migration:%s\r\ncluster_migrated_keys:%llu",
+                       assigned == CLUSTER_SLOTS ? "ok" : "fail", assigned, owned, node_count, nodes[myself],
+                       migrating, importing, states[migration_state],
+                       __atomic_load_n(&migrated_keys, __ATOMIC_RELAXED));
+    pthread_mutex_unlock(&cluster_mutex);
+    return (size_t)len < size ? (size_t)len : size - 1;
+}
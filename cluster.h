@@ -0,0 +1,68 @@
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "command.h"
+#include "storage.h"
+
+// Hash slot tabanlı küme modu.
+// Anahtar alanı CLUSTER_SLOTS sabit slota bölünür (hash(anahtar) % CLUSTER_SLOTS; anahtarda
+// {etiket} varsa yalnızca etiket hash'lenir) ve her slot tek bir aytdb_server sürecine aittir.
+// Düğüm kendisine ait olmayan slottaki anahtar için "MOVED <slot> <host:port>" döner.
+// Slot taşıma çevrimiçidir: kaynak slotu MIGRATING, hedef IMPORTING işaretler; taşıma
+// sürerken kaynakta bulunmayan anahtarlar için "ASK <slot> <host:port>" dönülür ve istemci
+// komutu ASKING ile hedefe gönderir. Tüm anahtarlar taşınınca slot hedefe geçer ve yeni
+// sahiplik bilinen düğümlere bildirilir. Slot sahipliği yapılandırma dosyasında saklanır.
+
+#define CLUSTER_SLOTS 16384
+#define CLUSTER_MAX_NODES 64
+#define CLUSTER_ADDR_SIZE 64  // "host:port"
+
+// Taşımada kullanılacak storage'ı kaydeder; command_init tarafından çağrılır
+void cluster_init(Storage* storage);
+
+// Küme modunu açar ve slot tablosunu dosyadan yükler (dosya yoksa hiçbir slot atanmamıştır).
+// myself bu düğümün diğer düğümlerce bilinen "host:port" adresidir
+bool cluster_enable(const char* config_path, const char* myself);
+
+// Süren taşımayı durdurur ve küme modunu kapatır
+void cluster_shutdown();
+
+bool cluster_is_enabled();
+
+// Taşıma bağlantılarında kullanılan parola (varsayılan: password)
+void cluster_set_auth(const char* password);
+
+// Anahtarın slotu ({etiket} kuralıyla)
+int cluster_keyslot(const char* key);
+
+// Komutun anahtarlarını bu düğümde çalıştırabilir mi? keys[0], keys[step], ... anahtarlardır.
+// Çalıştırılabilirse slot döner ve komut bitince cluster_release(slot) çağrılmalıdır;
+// aksi halde yönlendirme/hata yanıtı yazılmıştır ve -1 döner.
+int cluster_route(CommandClient* client, char** keys, int count, int step, bool asking);
+void cluster_release(int slot);
+
+// --- CLUSTER komutu ---
+
+// "<slot>" ya da "<başlangıç>-<bitiş>"
+bool cluster_parse_range(const char* text, int* start, int* end);
+
+// Slot aralığını düğüme atar (düğüm bilinmiyorsa eklenir); bu düğüm için yapılandırma kaydedilir
+bool cluster_assign(int start, int end, const char* node);
+bool cluster_set_migrating(int start, int end, const char* node);
+bool cluster_set_importing(int start, int end, const char* node);
+void cluster_set_stable(int start, int end);
+
+// Aralığı arka planda hedef düğüme taşır; taşıma zaten sürüyorsa false döner
+bool cluster_start_migration(int start, int end, const char* node);
+
+size_t cluster_count_keys_in_slot(int slot);
+
+// "CLUSTER SLOTS" yanıtı: sahibi olan ardışık slot aralıkları
+void cluster_reply_slots(CommandClient* client);
+
+// "CLUSTER INFO" metni; yazılan uzunluğu döner
+size_t cluster_info(char* buf, size_t size);
+
+#endif // CLUSTER_H
@@ -0,0 +1,1222 @@
+#include "command.h"
+#include "kv_store.h"
+#include "alloc_stats.h"
+#include "tracking.h"
+#include "replication.h"
+#include "cluster.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <ctype.h>
+#include <errno.h>
+#include <pthread.h>
+
+#define REPLY_LINE_SIZE MAX_LINE_SIZE
+#define COMMAND_INDEX_SIZE 128 // Komut sayısının en az iki katı, 2'nin kuvveti
+#define COMMAND_MAX_NAME 16
+#define DEFAULT_PASSWORD "password" // Varsayılan şifre
+
+static Storage* storage = NULL;
+static void (*on_shutdown)(void) = NULL;
+static int next_client_id = 0;           // Tüm ön yüzlerin bağlantı kimlikleri (atomik)
+static pthread_mutex_t password_mutex = PTHREAD_MUTEX_INITIALIZER;
+static char server_password[128] = DEFAULT_PASSWORD; // Sunucu şifresi
+
+// ---------------------------------------------------------------------------
+// Yanıt yardımcıları
+// ---------------------------------------------------------------------------
+
+void reply_raw(CommandClient* client, const char* data, size_t len) {
+    if (!client->failed && !client->write(client, data, len)) {
+        client->failed = true;
+    }
+}
+
+// Yanıtı ön yüzün çıkış buffer'ında doğrudan oluşturmak için yer ayırır.
+// Ön yüz bunu desteklemiyorsa çağıranın stack buffer'ı kullanılır ve write ile kopyalanır.
+static char* reply_begin(CommandClient* client, size_t max_len, char* scratch) {
+    if (!client->reserve || client->failed) return scratch;
+    char* buf = client->reserve(client, max_len);
+    if (!buf) client->failed = true;
+    return buf ? buf : scratch;
+}
+
+static void reply_end(CommandClient* client, char* buf, size_t len, const char* scratch) {
+    if (buf == scratch) reply_raw(client, buf, len);
+    else client->commit(client, len);
+}
+
+// Telnet: "OK" veya "OK: <detail>", RESP: +OK
+void reply_ok(CommandClient* client, const char* detail) {
+    char scratch[REPLY_LINE_SIZE];
+    char* line = reply_begin(client, sizeof(scratch), scratch);
+    int len;
+    if (client->protocol == PROTOCOL_RESP) {
+        len = snprintf(line, sizeof(scratch), "+OK\r\n");
+    } else if (detail) {
+        len = snprintf(line, sizeof(scratch), "OK: %s\r\n", detail);
+    } else {
+        len = snprintf(line, sizeof(scratch), "OK\r\n");
+    }
+    reply_end(client, line, (size_t)len, scratch);
+}
+
+// Tek satırlık durum metni (PONG gibi)
+void reply_status(CommandClient* client, const char* text) {
+    char scratch[REPLY_LINE_SIZE];
+    char* line = reply_begin(client, sizeof(scratch), scratch);
+    int len = snprintf(line, sizeof(scratch), "%s%s\r\n", client->protocol == PROTOCOL_RESP ? "+" : "", text);
+    reply_end(client, line, (size_t)len < sizeof(scratch) ? (size_t)len : sizeof(scratch) - 1, scratch);
+}
+
+void reply_error(CommandClient* client, const char* format, ...) {
+    char scratch[REPLY_LINE_SIZE];
+    char* line = reply_begin(client, sizeof(scratch), scratch);
+    int len = snprintf(line, sizeof(scratch), "%s", client->protocol == PROTOCOL_RESP ? "-ERR " : "ERROR: ");
+    va_list args;
+    va_start(args, format);
+    len += vsnprintf(line + len, sizeof(scratch) - (size_t)len - 2, format, args);
+    va_end(args);
+    if ((size_t)len > sizeof(scratch) - 3) len = (int)sizeof(scratch) - 3;
+    memcpy(line + len, "\r\n", 2);
+    reply_end(client, line, (size_t)len + 2, scratch);
+}
+
+// Değer yanıtı; RESP'te uzunluk önekli bulk string
+void reply_bulk(CommandClient* client, const char* value, size_t value_len) {
+    char scratch[REPLY_LINE_SIZE + 32];
+    size_t max_len = value_len + 32;
+    if (!client->reserve && max_len > sizeof(scratch)) {
+        // Sığmayan değeri parçalar halinde gönder
+        int len = client->protocol == PROTOCOL_RESP ? snprintf(scratch, sizeof(scratch), "$%zu\r\n", value_len) : 0;
+        reply_raw(client, scratch, (size_t)len);
+        reply_raw(client, value, value_len);
+        reply_raw(client, "\r\n", 2);
+        return;
+    }
+    
+    char* line = reply_begin(client, max_len, scratch);
+    if (line == scratch && max_len > sizeof(scratch)) return; // Yer ayrılamadı, bağlantı kapanacak
+    int len = 0;
+    if (client->protocol == PROTOCOL_RESP) {
+        len = snprintf(line, 32, "$%zu\r\n", value_len);
+    }
+    memcpy(line + len, value, value_len);
+    memcpy(line + len + value_len, "\r\n", 2);
+    reply_end(client, line, (size_t)len + value_len + 2, scratch);
+}
+
+void reply_null(CommandClient* client) {
+    if (client->protocol != PROTOCOL_RESP) reply_raw(client, "NULL\r\n", 6);
+    else if (client->resp_version >= 3) reply_raw(client, "_\r\n", 3);
+    else reply_raw(client, "$-1\r\n", 5);
+}
+
+void reply_integer(CommandClient* client, long long value) {
+    char scratch[32];
+    char* line = reply_begin(client, sizeof(scratch), scratch);
+    int len = snprintf(line, sizeof(scratch), "%s%lld\r\n", client->protocol == PROTOCOL_RESP ? ":" : "", value);
+    reply_end(client, line, (size_t)len, scratch);
+}
+
+// Dizi/map başlıkları yalnızca RESP modunda anlamlıdır
+void reply_aggregate(CommandClient* client, char type, size_t count) {
+    char scratch[32];
+    char* line = reply_begin(client, sizeof(scratch), scratch);
+    int len = snprintf(line, sizeof(scratch), "%c%zu\r\n", type, count);
+    reply_end(client, line, (size_t)len, scratch);
+}
+
+// ---------------------------------------------------------------------------
+// Komut işleyicileri
+// ---------------------------------------------------------------------------
+
+static bool check_password(const char* password) {
+    pthread_mutex_lock(&password_mutex);
+    bool matched = strcmp(password, server_password) == 0;
+    pthread_mutex_unlock(&password_mutex);
+    return matched;
+}
+
+static void command_auth(CommandClient* client, int argc, char** argv) {
+    // Redis istemcileri "AUTH <user> <password>" da gönderebilir
+    if (check_password(argv[argc >= 3 ? 2 : 1])) {
+        client->authenticated = true; // Kimlik doğrulama başarılı
+        reply_ok(client, "Authentication successful");
+    } else {
+        reply_error(client, "Invalid password");
+    }
+}
+
+static void command_ping(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    reply_status(client, "PONG");
+}
+
+static void command_help(CommandClient* client, int argc, char** argv);
+
+// HELLO [2|3] [AUTH <user> <password>] [SETNAME <name>] - RESP sürümünü seçer
+static void command_hello(CommandClient* client, int argc, char** argv) {
+    if (client->protocol != PROTOCOL_RESP) {
+        reply_error(client, "hello is only available to RESP clients");
+        return;
+    }
+
+    int version = client->resp_version;
+    if (argc >= 2) {
+        version = atoi(argv[1]);
+        if (version != 2 && version != 3) {
+            reply_raw(client, "-NOPROTO unsupported protocol version\r\n", 39);
+            return;
+        }
+    }
+
+    for (int i = 2; i < argc; i++) {
+        if (strcasecmp(argv[i], "auth") == 0 && i + 2 < argc) {
+            // Kullanıcı adı yok sayılır, tek şifre vardır
+            if (!check_password(argv[i + 2])) {
+                reply_error(client, "Invalid password");
+                return;
+            }
+            client->authenticated = true;
+            i += 2;
+        } else if (strcasecmp(argv[i], "setname") == 0 && i + 1 < argc) {
+            i++;
+        } else {
+            reply_error(client, "Syntax error in HELLO option '%s'", argv[i]);
+            return;
+        }
+    }
+
+    client->resp_version = version;
+    reply_aggregate(client, version >= 3 ? '%' : '*', version >= 3 ? 7 : 14);
+    const char* fields[] = { "server", "aytdb", "version", "1.0.0" };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        reply_bulk(client, fields[i], strlen(fields[i]));
+    }
+    reply_bulk(client, "proto", 5);
+    reply_integer(client, version);
+    reply_bulk(client, "id", 2);
+    reply_integer(client, client->id);
+    reply_bulk(client, "mode", 4);
+    reply_bulk(client, "standalone", 10);
+    reply_bulk(client, "role", 4);
+    if (replication_is_replica()) reply_bulk(client, "replica", 7);
+    else reply_bulk(client, "master", 6);
+    reply_bulk(client, "modules", 7);
+    reply_aggregate(client, '*', 0);
+}
+
+static void command_prompt(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    if (strcasecmp(argv[1], "on") == 0 || strcasecmp(argv[1], "off") == 0) {
+        client->prompt_disabled = strcasecmp(argv[1], "off") == 0;
+        reply_ok(client, client->prompt_disabled ? "Prompt disabled" : "Prompt enabled");
+    } else {
+        reply_error(client, "prompt command requires 'on' or 'off'");
+    }
+}
+
+static void command_set(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    if (storage_set(storage, argv[1], argv[2])) {
+        reply_ok(client, NULL);
+    } else {
+        reply_error(client, "Failed to set key %s", argv[1]);
+    }
+}
+
+static void command_setex(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    // RESP istemcileri Redis sırasını kullanır: SETEX <key> <ttl> <value>
+    bool resp = client->protocol == PROTOCOL_RESP;
+    const char* value = resp ? argv[3] : argv[2];
+    int ttl = atoi(resp ? argv[2] : argv[3]);
+    if (storage_set_with_ttl(storage, argv[1], value, ttl)) {
+        reply_ok(client, NULL);
+    } else {
+        reply_error(client, "Failed to set key %s with TTL", argv[1]);
+    }
+}
+
+static void command_get(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    // Yokluk da önbelleğe alınabilir, bu yüzden bulunmayan anahtar da takip edilir. Anahtar
+    // okumadan önce kaydedilir; okuma ile kayıt arasındaki bir yazmanın bildirimi kaçmaz
+    if (client->tracking) tracking_record_read(client, argv[1]);
+    // storage_get'in kopyası yerine thread-local değer buffer'ından doğrudan yanıtla
+    const char* val = kv_get(argv[1]);
+    if (val) {
+        reply_bulk(client, val, strlen(val));
+    } else {
+        reply_null(client);
+    }
+}
+
+static void command_del(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    // RESP istemcileri silinen anahtar sayısını bekler
+    bool resp = client->protocol == PROTOCOL_RESP;
+    bool existed = resp && kv_get(argv[1]) != NULL;
+    if (!storage_delete(storage, argv[1])) {
+        reply_error(client, "Failed to delete key %s", argv[1]);
+    } else if (resp) {
+        reply_integer(client, existed ? 1 : 0);
+    } else {
+        reply_ok(client, NULL);
+    }
+}
+
+// MGET yanıtı kv_get_many'nin kilidi altında doğrudan çıkış buffer'ında oluşturulur
+static void reply_mget_value(void* ctx, size_t index, const char* value) {
+    (void)index;
+    CommandClient* client = ctx;
+    if (value) reply_bulk(client, value, strlen(value));
+    else reply_null(client);
+}
+
+static void command_mget(CommandClient* client, int argc, char** argv) {
+    size_t count = (size_t)argc - 1;
+    // GET'teki gibi anahtarlar okumadan önce takibe alınır
+    if (client->tracking) {
+        for (int i = 1; i < argc; i++) tracking_record_read(client, argv[i]);
+    }
+    if (client->protocol == PROTOCOL_RESP) reply_aggregate(client, '*', count);
+    kv_get_many((const char* const*)argv + 1, count, reply_mget_value, client);
+}
+
+// MSET (step 2) ve MDEL (step 1) anahtarlarını tek storage_apply_batch ile uygular.
+// Değişen anahtar sayısını, bellek yetmezse -1 döner
+static long apply_key_ops(char** argv, size_t count, int step) {
+    KvBatchOp stack_ops[KV_BATCH_STACK];
+    bool stack_changed[KV_BATCH_STACK];
+    KvBatchOp* ops = stack_ops;
+    bool* changed = stack_changed;
+    if (count > KV_BATCH_STACK) {
+        ops = malloc(count * (sizeof(KvBatchOp) + sizeof(bool)));
+        if (!ops) return -1;
+        changed = (bool*)(ops + count);
+    }
+    for (size_t i = 0; i < count; i++) {
+        ops[i] = (KvBatchOp){ argv[1 + i * (size_t)step], step == 2 ? argv[2 + i * 2] : NULL, 0 };
+    }
+    
+    long changed_count = 0;
+    storage_apply_batch(storage, NULL, 0, ops, count, changed);
+    for (size_t i = 0; i < count; i++) changed_count += changed[i];
+    if (ops != stack_ops) free(ops);
+    return changed_count;
+}
+
+static void command_mset(CommandClient* client, int argc, char** argv) {
+    if (argc % 2 == 0) {
+        reply_error(client, "wrong number of arguments for 'mset' (usage: mset <key> <value> [<key> <value> ...])");
+        return;
+    }
+    // Havuz dolduğunda yazılamayan anahtarlar olabilir; uygulananlar geri alınmaz
+    long pairs = (argc - 1) / 2;
+    long stored = apply_key_ops(argv, (size_t)pairs, 2);
+    if (stored < 0) {
+        reply_error(client, "out of memory");
+    } else if (stored < pairs) {
+        reply_error(client, "Failed to set %ld of %ld keys", pairs - stored, pairs);
+    } else {
+        reply_ok(client, NULL);
+    }
+}
+
+static void command_mdel(CommandClient* client, int argc, char** argv) {
+    long deleted = apply_key_ops(argv, (size_t)argc - 1, 1);
+    if (deleted < 0) reply_error(client, "out of memory");
+    else reply_integer(client, deleted);
+}
+
+// Sürüm argümanı negatif olmayan bir tam sayıdır
+static bool parse_version(const char* text, uint64_t* version) {
+    if (!isdigit((unsigned char)text[0])) return false;
+    char* end;
+    errno = 0;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (*end != '\0' || errno == ERANGE) return false;
+    *version = value;
+    return true;
+}
+
+static void command_gets(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    uint64_t version;
+    if (client->tracking) tracking_record_read(client, argv[1]);
+    const char* val = kv_get_versioned(argv[1], &version);
+    if (!val) {
+        reply_null(client);
+        return;
+    }
+    // RESP: [değer, sürüm]; telnet: iki satır
+    if (client->protocol == PROTOCOL_RESP) reply_aggregate(client, '*', 2);
+    reply_bulk(client, val, strlen(val));
+    reply_integer(client, (long long)version);
+}
+
+static void command_cas(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    uint64_t expected, version;
+    if (!parse_version(argv[2], &expected)) {
+        reply_error(client, "version must be a non-negative integer");
+        return;
+    }
+    // Yazıldıysa yeni sürüm, anahtar bu arada değiştiyse null
+    if (storage_cas(storage, argv[1], expected, argv[3], &version)) {
+        reply_integer(client, (long long)version);
+    } else {
+        reply_null(client);
+    }
+}
+
+static void command_setnx(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    uint64_t version;
+    reply_integer(client, storage_cas(storage, argv[1], 0, argv[2], &version) ? 1 : 0);
+}
+
+static void command_getset(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    const char* old_value;
+    if (!storage_getset(storage, argv[1], argv[2], &old_value)) {
+        reply_error(client, "Failed to set key %s", argv[1]);
+    } else if (old_value) {
+        reply_bulk(client, old_value, strlen(old_value));
+    } else {
+        reply_null(client);
+    }
+}
+
+static void command_compact(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    storage_compact();
+    reply_ok(client, "Compaction process complete");
+}
+
+static void command_save(CommandClient* client, int argc, char** argv) {
+    if (argc >= 2 && strcasecmp(argv[1], "compress") != 0 && strcasecmp(argv[1], "plain") != 0) {
+        reply_error(client, "save accepts only 'compress' or 'plain'");
+        return;
+    }
+
+    // Biçim verilirse tam snapshot, verilmezse zamanlayıcının seçtiği (delta olabilir)
+    bool saved = argc >= 2
+        ? storage_save_snapshot_ex(strcasecmp(argv[1], "compress") == 0)
+        : storage_save_snapshot();
+    if (saved) {
+        reply_ok(client, "Snapshot saved successfully");
+    } else {
+        reply_error(client, "Failed to save snapshot");
+    }
+}
+
+static void command_interval(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    int interval = atoi(argv[1]);
+    if (interval > 0) {
+        char detail[64];
+        storage_schedule_snapshot(interval);
+        snprintf(detail, sizeof(detail), "Snapshot interval set to %d seconds", interval);
+        reply_ok(client, detail);
+    } else {
+        reply_error(client, "Invalid interval value");
+    }
+}
+
+static void command_schedule(CommandClient* client, int argc, char** argv) {
+    SnapshotRule rules[SNAPSHOT_MAX_RULES];
+    char detail[REPLY_LINE_SIZE];
+
+    if (argc == 1) {
+        // Mevcut kuralları listele
+        size_t count = storage_get_snapshot_rules(rules, SNAPSHOT_MAX_RULES);
+        strcpy(detail, "OK:");
+        for (size_t i = 0; i < count; i++) {
+            sprintf(detail + strlen(detail), " %d %lu", rules[i].seconds, rules[i].changes);
+        }
+        if (count == 0) strcat(detail, " automatic snapshots disabled");
+        reply_status(client, detail);
+    } else if (argc == 2 && strcasecmp(argv[1], "off") == 0) {
+        storage_set_snapshot_rules(NULL, 0);
+        reply_ok(client, "Automatic snapshots disabled");
+    } else if ((argc - 1) % 2 == 0 && (size_t)(argc - 1) / 2 <= SNAPSHOT_MAX_RULES) {
+        size_t count = (size_t)(argc - 1) / 2;
+        for (size_t i = 0; i < count; i++) {
+            rules[i].seconds = atoi(argv[1 + i * 2]);
+            rules[i].changes = strtoul(argv[2 + i * 2], NULL, 10);
+        }
+        if (storage_set_snapshot_rules(rules, count)) {
+            snprintf(detail, sizeof(detail), "%zu snapshot rules set", count);
+            reply_ok(client, detail);
+        } else {
+            reply_error(client, "Invalid snapshot rules");
+        }
+    } else {
+        reply_error(client, "schedule requires <seconds> <changes> pairs or 'off'");
+    }
+}
+
+static void command_quit(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    reply_ok(client, "Closing connection");
+    client->close_requested = true;
+}
+
+static void command_shutdown(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    reply_ok(client, "Server shutting down");
+    if (on_shutdown) on_shutdown();
+    else client->close_requested = true;
+}
+
+// CLIENT ID | CLIENT TRACKING on|off [BCAST] [PREFIX <prefix> ...]
+static void command_client(CommandClient* client, int argc, char** argv) {
+    if (strcasecmp(argv[1], "id") == 0 && argc == 2) {
+        reply_integer(client, client->id);
+        return;
+    }
+    if (strcasecmp(argv[1], "tracking") != 0 || argc < 3) {
+        reply_error(client, "client accepts 'id' or 'tracking on|off'");
+        return;
+    }
+    if (strcasecmp(argv[2], "off") == 0 && argc == 3) {
+        tracking_disable(client);
+        reply_ok(client, "Tracking disabled");
+        return;
+    }
+    if (strcasecmp(argv[2], "on") != 0) {
+        reply_error(client, "client tracking requires 'on' or 'off'");
+        return;
+    }
+
+    bool bcast = false;
+    char* prefixes[TRACKING_MAX_PREFIXES];
+    int prefix_count = 0;
+    for (int i = 3; i < argc; i++) {
+        if (strcasecmp(argv[i], "bcast") == 0) {
+            bcast = true;
+        } else if (strcasecmp(argv[i], "prefix") == 0 && i + 1 < argc && prefix_count < TRACKING_MAX_PREFIXES) {
+            prefixes[prefix_count++] = argv[++i];
+        } else {
+            reply_error(client, "Syntax error in CLIENT TRACKING option '%s'", argv[i]);
+            return;
+        }
+    }
+    if (prefix_count > 0 && !bcast) {
+        reply_error(client, "prefix requires bcast mode");
+        return;
+    }
+    // RESP2'de push mesajı yok; bildirimler yanıtlarla karışırdı
+    if (client->protocol == PROTOCOL_RESP && client->resp_version < 3) {
+        reply_error(client, "tracking requires RESP3 (use HELLO 3)");
+        return;
+    }
+    if (!tracking_enable(client, bcast, prefixes, prefix_count)) {
+        reply_error(client, "tracking is not supported on this connection");
+        return;
+    }
+    reply_ok(client, bcast ? "Tracking enabled in broadcast mode" : "Tracking enabled");
+}
+
+static void command_info(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    char info[4096];
+    int len = snprintf(info, sizeof(info),
+                       "# Stats\r\nkeys:%zu\r\nwrites:%llu\r\nallocations:%lld\r\n"
+                       "tracking_clients:%zu\r\ntracking_keys:%zu\r\n\r\n",
+                       kv_get_count(), kv_write_count(), alloc_stats_count(),
+                       tracking_client_count(), tracking_key_count());
+    len += (int)replication_info(info + len, sizeof(info) - (size_t)len);
+    reply_bulk(client, info, (size_t)len);
+}
+
+// PSYNC <replid> <offset> - replika bağlantısı; yanıt ve akış replikasyon katmanından gelir
+static void command_psync(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    replication_psync(client, argv[1], strtoll(argv[2], NULL, 10));
+}
+
+// REPLCONF ACK <offset> yanıtsızdır; diğer seçenekler kabul edilip yok sayılır
+static void command_replconf(CommandClient* client, int argc, char** argv) {
+    if (strcasecmp(argv[1], "ack") == 0) {
+        replication_ack(client, strtoll(argv[2], NULL, 10));
+        return;
+    }
+    (void)argc;
+    reply_ok(client, NULL);
+}
+
+// REPLICAOF <host> <port> | REPLICAOF NO ONE
+static void command_replicaof(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    if (strcasecmp(argv[1], "no") == 0 && strcasecmp(argv[2], "one") == 0) {
+        replication_stop_replica();
+        reply_ok(client, "Replication stopped, now a primary");
+        return;
+    }
+    int port = atoi(argv[2]);
+    if (port <= 0 || port > 65535) {
+        reply_error(client, "Invalid port: %s", argv[2]);
+    } else if (replication_start_replica(argv[1], port)) {
+        reply_ok(client, "Replicating from primary");
+    } else {
+        reply_error(client, "Failed to start replication");
+    }
+}
+
+// CLUSTER alt komutları; slot aralıkları "<slot>" ya da "<başlangıç>-<bitiş>" biçimindedir
+static void command_cluster(CommandClient* client, int argc, char** argv) {
+    int start, end;
+    if (strcasecmp(argv[1], "info") == 0) {
+        char info[512];
+        size_t len = cluster_info(info, sizeof(info));
+        reply_bulk(client, info, len);
+    } else if (strcasecmp(argv[1], "keyslot") == 0 && argc == 3) {
+        reply_integer(client, cluster_keyslot(argv[2]));
+    } else if (!cluster_is_enabled()) {
+        reply_error(client, "This instance has cluster support disabled");
+    } else if (strcasecmp(argv[1], "slots") == 0) {
+        cluster_reply_slots(client);
+    } else if (strcasecmp(argv[1], "countkeysinslot") == 0 && argc == 3) {
+        if (cluster_parse_range(argv[2], &start, &end) && start == end) {
+            reply_integer(client, (long long)cluster_count_keys_in_slot(start));
+        } else {
+            reply_error(client, "Invalid slot: %s", argv[2]);
+        }
+    } else if (strcasecmp(argv[1], "setslot") == 0 && argc >= 4) {
+        // SETSLOT <aralık> NODE|MIGRATING|IMPORTING <host:port> | SETSLOT <aralık> STABLE
+        bool ok = cluster_parse_range(argv[2], &start, &end);
+        if (ok && strcasecmp(argv[3], "stable") == 0 && argc == 4) {
+            cluster_set_stable(start, end);
+        } else if (ok && argc == 5 && strcasecmp(argv[3], "node") == 0) {
+            ok = cluster_assign(start, end, argv[4]);
+        } else if (ok && argc == 5 && strcasecmp(argv[3], "migrating") == 0) {
+            ok = cluster_set_migrating(start, end, argv[4]);
+        } else if (ok && argc == 5 && strcasecmp(argv[3], "importing") == 0) {
+            ok = cluster_set_importing(start, end, argv[4]);
+        } else {
+            ok = false;
+        }
+        if (ok) reply_ok(client, NULL);
+        else reply_error(client, "Invalid setslot request (usage: cluster setslot <slots> node|migrating|importing <host:port> | stable)");
+    } else if (strcasecmp(argv[1], "migrate") == 0 && argc == 4) {
+        if (!cluster_parse_range(argv[2], &start, &end)) {
+            reply_error(client, "Invalid slot range: %s", argv[2]);
+        } else if (cluster_start_migration(start, end, argv[3])) {
+            reply_ok(client, "Migration started, see 'cluster info'");
+        } else {
+            reply_error(client, "Cannot migrate: slots must be owned by this node, the target valid and no migration running");
+        }
+    } else {
+        reply_error(client, "Unknown cluster subcommand: %s", argv[1]);
+    }
+}
+
+// ASKING - taşıma sürerken ASK yanıtıyla hedefe gelen tek komuta izin verir
+static void command_asking(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    client->asking = true;
+    reply_ok(client, NULL);
+}
+
+// ---------------------------------------------------------------------------
+// MULTI/EXEC
+// ---------------------------------------------------------------------------
+
+// Kuyruklanan komut; argüman dizisi ve metinleri tek allocation'dadır
+typedef struct {
+    const Command* command;
+    int argc;
+    char** argv;
+} QueuedCommand;
+
+typedef struct Transaction {
+    QueuedCommand* commands;
+    int count;
+    int cap;
+    bool aborted;           // Kuyruklarken hata oldu, EXEC reddedilir
+} Transaction;
+
+// WATCH edilen anahtarlar ve o anki sürümleri; anahtar metinleri ayrı ayrı kopyalanır
+typedef struct WatchedKeys {
+    KvWatch* keys;
+    int count;
+    int cap;
+} WatchedKeys;
+
+static void transaction_free(Transaction* multi) {
+    if (!multi) return;
+    for (int i = 0; i < multi->count; i++) free(multi->commands[i].argv);
+    free(multi->commands);
+    free(multi);
+}
+
+static void watched_free(WatchedKeys* watched) {
+    if (!watched) return;
+    for (int i = 0; i < watched->count; i++) free((char*)watched->keys[i].key);
+    free(watched->keys);
+    free(watched);
+}
+
+int command_next_client_id(void) {
+    return __atomic_add_fetch(&next_client_id, 1, __ATOMIC_RELAXED);
+}
+
+void command_client_close(CommandClient* client) {
+    transaction_free(client->multi);
+    client->multi = NULL;
+    watched_free(client->watched);
+    client->watched = NULL;
+}
+
+// Argümanlar bağlantının okuma buffer'ını gösterir; EXEC'e kadar kopyalanır
+static void queue_command(CommandClient* client, const Command* command, int argc, char** argv) {
+    Transaction* multi = client->multi;
+    if (multi->count == MULTI_MAX_COMMANDS) {
+        multi->aborted = true;
+        reply_error(client, "too many commands in transaction (max %d)", MULTI_MAX_COMMANDS);
+        return;
+    }
+    if (multi->count == multi->cap) {
+        int new_cap = multi->cap ? multi->cap * 2 : 16;
+        QueuedCommand* grown = realloc(multi->commands, (size_t)new_cap * sizeof(QueuedCommand));
+        if (!grown) {
+            multi->aborted = true;
+            reply_error(client, "out of memory while queueing command");
+            return;
+        }
+        multi->commands = grown;
+        multi->cap = new_cap;
+    }
+    
+    size_t size = (size_t)argc * sizeof(char*);
+    for (int i = 0; i < argc; i++) size += strlen(argv[i]) + 1;
+    char** copy = malloc(size);
+    if (!copy) {
+        multi->aborted = true;
+        reply_error(client, "out of memory while queueing command");
+        return;
+    }
+    char* text = (char*)(copy + argc);
+    for (int i = 0; i < argc; i++) {
+        size_t len = strlen(argv[i]) + 1;
+        memcpy(text, argv[i], len);
+        copy[i] = text;
+        text += len;
+    }
+    multi->commands[multi->count++] = (QueuedCommand){ command, argc, copy };
+    reply_status(client, "QUEUED");
+}
+
+static void command_multi(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    if (client->multi) {
+        reply_error(client, "MULTI calls can not be nested");
+        return;
+    }
+    client->multi = calloc(1, sizeof(Transaction));
+    if (client->multi) reply_ok(client, NULL);
+    else reply_error(client, "out of memory");
+}
+
+static bool watch_key(WatchedKeys* watched, const char* key) {
+    // Aynı anahtar ikinci kez izlenirse ilk sürüm geçerli kalır
+    for (int i = 0; i < watched->count; i++) {
+        if (strcmp(watched->keys[i].key, key) == 0) return true;
+    }
+    if (watched->count == watched->cap) {
+        int new_cap = watched->cap ? watched->cap * 2 : 8;
+        KvWatch* grown = realloc(watched->keys, (size_t)new_cap * sizeof(KvWatch));
+        if (!grown) return false;
+        watched->keys = grown;
+        watched->cap = new_cap;
+    }
+    char* copy = strdup(key);
+    if (!copy) return false;
+    watched->keys[watched->count++] = (KvWatch){ copy, kv_get_version(key) };
+    return true;
+}
+
+static void command_watch(CommandClient* client, int argc, char** argv) {
+    if (client->multi) {
+        reply_error(client, "WATCH inside MULTI is not allowed");
+        return;
+    }
+    if (client->watched && client->watched->count + argc - 1 > WATCH_MAX_KEYS) {
+        reply_error(client, "too many watched keys (max %d)", WATCH_MAX_KEYS);
+        return;
+    }
+    if (!client->watched && !(client->watched = calloc(1, sizeof(WatchedKeys)))) {
+        reply_error(client, "out of memory");
+        return;
+    }
+    
+    bool ok = true;
+    for (int i = 1; ok && i < argc; i++) ok = watch_key(client->watched, argv[i]);
+    if (ok) reply_ok(client, NULL);
+    else reply_error(client, "out of memory");
+}
+
+static void command_unwatch(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    watched_free(client->watched);
+    client->watched = NULL;
+    reply_ok(client, NULL);
+}
+
+static void command_discard(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    if (!client->multi) {
+        reply_error(client, "DISCARD without MULTI");
+        return;
+    }
+    command_client_close(client);
+    reply_ok(client, NULL);
+}
+
+// Komutun anahtar sayısı; anahtarlar argv[1], argv[1 + key_step], ...
+static int command_key_count(const Command* command, int argc) {
+    if (!(command->flags & CMD_KEY)) return 0;
+    if (!command->key_step) return 1;
+    return (argc - 1 + command->key_step - 1) / command->key_step;
+}
+
+// set/setex/del kv_apply_batch ile birlikte uygulanabilir
+static bool batchable(const Command* command) {
+    return command->handler == command_set || command->handler == command_setex || command->handler == command_del;
+}
+
+static void fill_batch_ops(CommandClient* client, QueuedCommand* queued, int count, KvBatchOp* ops) {
+    bool resp = client->protocol == PROTOCOL_RESP;
+    for (int i = 0; i < count; i++) {
+        char** argv = queued[i].argv;
+        ops[i].key = argv[1];
+        ops[i].ttl = 0;
+        if (queued[i].command->handler == command_set) {
+            ops[i].value = argv[2];
+        } else if (queued[i].command->handler == command_setex) {
+            // RESP istemcileri Redis sırasını kullanır: SETEX <key> <ttl> <value>
+            ops[i].value = resp ? argv[3] : argv[2];
+            ops[i].ttl = atoi(resp ? argv[2] : argv[3]);
+        } else {
+            ops[i].value = NULL;
+        }
+    }
+}
+
+// Batch yanıtları komutların kendi yanıtlarıyla aynı biçimdedir
+static void reply_batch(CommandClient* client, const KvBatchOp* ops, int count, const bool* changed) {
+    bool resp = client->protocol == PROTOCOL_RESP;
+    for (int i = 0; i < count; i++) {
+        if (ops[i].value && !changed[i]) {
+            if (ops[i].ttl > 0) reply_error(client, "Failed to set key %s with TTL", ops[i].key);
+            else reply_error(client, "Failed to set key %s", ops[i].key);
+        } else if (ops[i].value || !resp) {
+            reply_ok(client, NULL);
+        } else {
+            reply_integer(client, changed[i] ? 1 : 0);
+        }
+    }
+}
+
+// Ardışık set/setex/del komutlarını tek storage_apply_batch çağrısıyla uygular
+static void exec_batch(CommandClient* client, QueuedCommand* queued, int count, KvBatchOp* ops, bool* changed) {
+    fill_batch_ops(client, queued, count, ops);
+    storage_apply_batch(storage, NULL, 0, ops, (size_t)count, changed);
+    reply_batch(client, ops, count, changed);
+}
+
+// Kuyruktaki komutları sırayla çalıştırır; ardışık yazmalar tek batch olarak uygulanır
+static void run_queued(CommandClient* client, Transaction* multi, KvBatchOp* ops, bool* changed) {
+    for (int i = 0; i < multi->count;) {
+        QueuedCommand* queued = &multi->commands[i];
+        if (!batchable(queued->command)) {
+            queued->command->handler(client, queued->argc, queued->argv);
+            i++;
+            continue;
+        }
+        int run = 1;
+        while (i + run < multi->count && batchable(multi->commands[i + run].command)) run++;
+        exec_batch(client, queued, run, ops, changed);
+        i += run;
+    }
+}
+
+static void command_exec(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    Transaction* multi = client->multi;
+    if (!multi) {
+        reply_error(client, "EXEC without MULTI");
+        return;
+    }
+    client->multi = NULL;
+    WatchedKeys* watched = client->watched;
+    client->watched = NULL;
+    int watch_count = watched ? watched->count : 0;
+    if (multi->aborted) {
+        if (client->protocol == PROTOCOL_RESP) {
+            static const char abort_reply[] = "-EXECABORT Transaction discarded because of previous errors.\r\n";
+            reply_raw(client, abort_reply, sizeof(abort_reply) - 1);
+        } else {
+            reply_error(client, "EXECABORT Transaction discarded because of previous errors.");
+        }
+        transaction_free(multi);
+        watched_free(watched);
+        return;
+    }
+    
+    // Okuma ya da diğer komutları içeren izlenen işlem yazma kilidi altında çalışır; snapshot,
+    // replicaof, shutdown gibi yönetim komutları o kilitle çalıştırılamaz
+    bool writes_only = true;
+    bool admin = false;
+    for (int i = 0; i < multi->count; i++) {
+        const Command* command = multi->commands[i].command;
+        writes_only = writes_only && batchable(command);
+        admin = admin || ((command->flags & CMD_ADMIN) && !(command->flags & CMD_READONLY));
+    }
+    bool locked = watch_count > 0 && !writes_only;
+    if (locked && admin) {
+        reply_error(client, "EXEC with WATCH cannot run admin commands");
+        transaction_free(multi);
+        watched_free(watched);
+        return;
+    }
+    
+    // Batch dizileri ve küme anahtarları için tek allocation
+    size_t count = (size_t)multi->count;
+    size_t key_total = (size_t)watch_count;
+    for (int i = 0; i < multi->count; i++) {
+        key_total += (size_t)command_key_count(multi->commands[i].command, multi->commands[i].argc);
+    }
+    void* scratch = malloc(count * (sizeof(KvBatchOp) + sizeof(bool)) + key_total * sizeof(char*) + 1);
+    if (!scratch) {
+        reply_error(client, "out of memory");
+        transaction_free(multi);
+        watched_free(watched);
+        return;
+    }
+    KvBatchOp* ops = scratch;
+    char** keys = (char**)(ops + count);
+    bool* changed = (bool*)(keys + key_total);
+    
+    // Küme modunda tüm anahtarlar aynı slotta olmalıdır; slot kilidi EXEC boyunca tutulur
+    int slot = -1;
+    if (cluster_is_enabled()) {
+        int key_count = 0;
+        for (int i = 0; i < multi->count; i++) {
+            QueuedCommand* queued = &multi->commands[i];
+            int step = queued->command->key_step ? queued->command->key_step : 1;
+            int n = command_key_count(queued->command, queued->argc);
+            for (int k = 0; k < n; k++) keys[key_count++] = queued->argv[1 + k * step];
+        }
+        for (int i = 0; i < watch_count; i++) keys[key_count++] = (char*)watched->keys[i].key;
+        if (key_count > 0 && (slot = cluster_route(client, keys, key_count, 1, false)) < 0) {
+            free(scratch);
+            transaction_free(multi);
+            watched_free(watched);
+            return;
+        }
+    }
+    
+    // İzlenen anahtarlardan biri WATCH'tan sonra değiştiyse işlem çalıştırılmaz. Yalnızca
+    // yazma içeren işlemde kontrol yazmalarla aynı batch'te yapılır; diğerlerinde kontrol ve
+    // komutlar boyunca başka yazma araya giremez
+    bool conflict = false;
+    if (writes_only) {
+        fill_batch_ops(client, multi->commands, multi->count, ops);
+        conflict = !storage_apply_batch(storage, watch_count ? watched->keys : NULL, (size_t)watch_count,
+                                        ops, count, changed);
+    } else {
+        if (locked) storage_lock_writes();
+        for (int i = 0; !conflict && i < watch_count; i++) {
+            conflict = kv_get_version(watched->keys[i].key) != watched->keys[i].version;
+        }
+    }
+    
+    if (conflict) {
+        if (client->protocol == PROTOCOL_RESP && client->resp_version < 3) reply_raw(client, "*-1\r\n", 5);
+        else reply_null(client);
+    } else {
+        if (client->protocol == PROTOCOL_RESP) reply_aggregate(client, '*', count);
+        if (writes_only) reply_batch(client, ops, multi->count, changed);
+        else run_queued(client, multi, ops, changed);
+    }
+    if (locked) storage_unlock_writes();
+    
+    if (slot >= 0) cluster_release(slot);
+    free(scratch);
+    transaction_free(multi);
+    watched_free(watched);
+}
+
+
+static void command_config(CommandClient* client, int argc, char** argv) {
+    (void)argc;
+    if (strcasecmp(argv[1], "password") != 0) {
+        reply_error(client, "Unknown config option: %s (available options: password)", argv[1]);
+    } else if (strlen(argv[2]) == 0) {
+        reply_error(client, "Password cannot be empty");
+    } else {
+        pthread_mutex_lock(&password_mutex);
+        strncpy(server_password, argv[2], sizeof(server_password) - 1);
+        server_password[sizeof(server_password) - 1] = '\0';
+        pthread_mutex_unlock(&password_mutex);
+        reply_ok(client, "Password changed successfully");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Komut tablosu
+// ---------------------------------------------------------------------------
+
+static const Command command_table[] = {
+    { "auth",     -2, CMD_NOAUTH,   command_auth,     "auth <password>",         "Authenticate with server", 0 },
+    { "set",      -3, CMD_WRITE | CMD_KEY, command_set,      "set <key> <value>",       "Store a key-value pair", 0 },
+    { "setex",    -4, CMD_WRITE | CMD_KEY, command_setex,    "setex <key> <value> <ttl>", "Store a key-value pair with expiration time in seconds", 0 },
+    { "get",      -2, CMD_READONLY | CMD_KEY, command_get,      "get <key>",               "Retrieve a value by key", 0 },
+    { "del",      -2, CMD_WRITE | CMD_KEY, command_del,      "del <key>",               "Delete a key-value pair", 0 },
+    { "mget",     -2, CMD_READONLY | CMD_KEY, command_mget,     "mget <key> [key ...]",    "Retrieve the values of several keys", 1 },
+    { "mset",     -3, CMD_WRITE | CMD_KEY, command_mset,     "mset <key> <value> [<key> <value> ...]", "Store several key-value pairs at once", 2 },
+    { "mdel",     -2, CMD_WRITE | CMD_KEY, command_mdel,     "mdel <key> [key ...]",    "Delete several keys and return how many existed", 1 },
+    { "gets",      2, CMD_READONLY | CMD_KEY, command_gets,     "gets <key>",              "Retrieve a value and its version", 0 },
+    { "cas",       4, CMD_WRITE | CMD_KEY, command_cas,      "cas <key> <version> <value>", "Store only if the key is still at <version> (0: absent)", 0 },
+    { "setnx",     3, CMD_WRITE | CMD_KEY, command_setnx,    "setnx <key> <value>",     "Store only if the key does not exist", 0 },
+    { "getset",    3, CMD_WRITE | CMD_KEY, command_getset,   "getset <key> <value>",    "Store a value and return the previous one", 0 },
+    { "save",     -1, CMD_ADMIN,    command_save,     "save [compress|plain]",   "Save a snapshot now (full snapshot if format given)", 0 },
+    { "interval",  2, CMD_ADMIN,    command_interval, "interval <seconds>",      "Snapshot every <seconds> if any key changed", 0 },
+    { "schedule", -1, CMD_ADMIN,    command_schedule, "schedule [<sec> <changes> ...]", "Snapshot after <sec> if at least <changes> writes", 0 },
+    { "compact",   1, CMD_ADMIN,    command_compact,  "compact",                 "Remove expired keys, save snapshot and rewrite log", 0 },
+    { "config",    3, CMD_ADMIN,    command_config,   "config password <value>", "Change server password", 0 },
+    { "hello",    -1, CMD_NOAUTH,   command_hello,    "hello [2|3]",             "Switch to RESP2/RESP3 replies (RESP clients)", 0 },
+    { "prompt",    2, CMD_NOAUTH,   command_prompt,   "prompt on|off",           "Show or hide the '> ' prompt (telnet clients)", 0 },
+    { "ping",     -1, CMD_NOAUTH | CMD_READONLY, command_ping, "ping",           "Test connection", 0 },
+    { "quit",     -1, CMD_NOAUTH | CMD_NOQUEUE, command_quit, "quit",           "Close connection", 0 },
+    { "exit",     -1, CMD_NOAUTH | CMD_NOQUEUE, command_quit, NULL,             NULL, 0 },
+    { "client",   -2, 0,            command_client,   "client tracking on|off [bcast] [prefix <p>]", "Get invalidation pushes for keys read (or matching prefixes)", 0 },
+    { "psync",     3, CMD_ADMIN,    command_psync,    "psync <replid> <offset>", "Start a replication stream (used by replicas)", 0 },
+    { "replconf", -3, CMD_ADMIN,    command_replconf, "replconf ack <offset>",   "Report replica progress (used by replicas)", 0 },
+    { "replicaof", 3, CMD_ADMIN,    command_replicaof, "replicaof <host> <port>|no one", "Replicate from a primary, or promote this replica", 0 },
+    { "cluster",  -2, CMD_ADMIN,    command_cluster,  "cluster info|slots|keyslot|countkeysinslot|setslot|migrate ...", "Inspect or change hash slot ownership (cluster mode)", 0 },
+    { "multi",     1, CMD_NOQUEUE,  command_multi,    "multi",                   "Queue the following commands until exec", 0 },
+    { "exec",      1, CMD_NOQUEUE,  command_exec,     "exec",                    "Run queued commands; writes are applied as one batch", 0 },
+    { "discard",   1, CMD_NOQUEUE,  command_discard,  "discard",                 "Drop the queued commands", 0 },
+    { "watch",    -2, CMD_NOQUEUE | CMD_KEY, command_watch, "watch <key> [key ...]", "Abort the next exec if any of the keys changes", 1 },
+    { "unwatch",   1, 0,            command_unwatch,  "unwatch",                 "Forget all watched keys", 0 },
+    { "asking",    1, 0,            command_asking,   "asking",                  "Run the next command against a slot being imported", 0 },
+    { "info",     -1, CMD_ADMIN | CMD_READONLY, command_info, "info",            "Show key, write and heap allocation counters", 0 },
+    { "shutdown", -1, CMD_ADMIN,    command_shutdown, "shutdown",                "Shutdown server", 0 },
+    { "help",     -1, CMD_NOAUTH,   command_help,     "help",                    "Show this help message", 0 },
+};
+
+#define COMMAND_COUNT (sizeof(command_table) / sizeof(command_table[0]))
+
+// Açık adresli indeks; tablo sabit olduğu için bir kez kurulur
+static const Command* command_index[COMMAND_INDEX_SIZE];
+static pthread_once_t command_index_once = PTHREAD_ONCE_INIT;
+
+// Büyük/küçük harf duyarsız FNV-1a
+static size_t command_hash(const char* name, size_t* length) {
+    size_t h = 2166136261u;
+    size_t len = 0;
+    for (; name[len] && len <= COMMAND_MAX_NAME; len++) {
+        h ^= (unsigned char)tolower((unsigned char)name[len]);
+        h *= 16777619u;
+    }
+    *length = len;
+    return h;
+}
+
+static void build_command_index() {
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        size_t len;
+        size_t slot = command_hash(command_table[i].name, &len) & (COMMAND_INDEX_SIZE - 1);
+        while (command_index[slot]) slot = (slot + 1) & (COMMAND_INDEX_SIZE - 1);
+        command_index[slot] = &command_table[i];
+    }
+}
+
+void command_init(Storage* s, void (*shutdown_handler)(void)) {
+    storage = s;
+    on_shutdown = shutdown_handler;
+    tracking_init();
+    replication_init(s);
+    cluster_init(s);
+    pthread_once(&command_index_once, build_command_index);
+}
+
+const Command* command_lookup(const char* name) {
+    pthread_once(&command_index_once, build_command_index);
+
+    size_t len;
+    size_t slot = command_hash(name, &len) & (COMMAND_INDEX_SIZE - 1);
+    if (len > COMMAND_MAX_NAME) return NULL;
+
+    // Tablo yarıdan az dolu, yoklama zinciri kısa kalır
+    while (command_index[slot]) {
+        if (strcasecmp(command_index[slot]->name, name) == 0) return command_index[slot];
+        slot = (slot + 1) & (COMMAND_INDEX_SIZE - 1);
+    }
+    return NULL;
+}
+
+static void command_help(CommandClient* client, int argc, char** argv) {
+    (void)argc; (void)argv;
+    char line[REPLY_LINE_SIZE];
+    size_t count = 0;
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        if (command_table[i].usage) count++;
+    }
+
+    if (client->protocol == PROTOCOL_RESP) {
+        reply_aggregate(client, '*', count);
+    } else {
+        reply_raw(client, "Available commands:\r\n", 21);
+    }
+    for (size_t i = 0; i < COMMAND_COUNT; i++) {
+        if (!command_table[i].usage) continue;
+        snprintf(line, sizeof(line), "  %-24s: %s", command_table[i].usage, command_table[i].summary);
+        reply_status(client, line);
+    }
+}
+
+// Komutu bulur ve çalıştırılabilir mi kontrol eder; değilse hata yanıtı yazılır ve NULL döner
+static const Command* check_command(CommandClient* client, int argc, char** argv) {
+    if (argc == 0) {
+        reply_error(client, "Command not found");
+        return NULL;
+    }
+
+    const Command* command = command_lookup(argv[0]);
+    if (!command) {
+        reply_error(client, "Unknown command: %s", argv[0]);
+        return NULL;
+    }
+    // Diğer komutlar için kimlik doğrulama kontrolü yap
+    if (!client->authenticated && !(command->flags & CMD_NOAUTH)) {
+        reply_error(client, "Authentication required. Use 'auth <password>' command");
+        return NULL;
+    }
+    if ((command->arity > 0 && argc != command->arity) || (command->arity < 0 && argc < -command->arity)) {
+        reply_error(client, "wrong number of arguments for '%s' (usage: %s)", command->name, command->usage);
+        return NULL;
+    }
+    // Entry'ye sığmayan anahtar/değer kesilip yazılmaz; log kaydı ve yeniden oynatma da
+    // bu sınırlara göre yapıldığı için burada reddedilir
+    int key_count = command_key_count(command, argc);
+    int key_step = command->key_step ? command->key_step : 1;
+    for (int i = 0; i < key_count; i++) {
+        if (strlen(argv[1 + i * key_step]) >= MAX_KEY_SIZE) {
+            reply_error(client, "key too long (max %d bytes)", MAX_KEY_SIZE - 1);
+            return NULL;
+        }
+    }
+    // Snapshot kayıtları satır tabanlıdır; satır sonu içeren anahtar/değer kayıt ekleyebilirdi
+    for (int i = 1; (command->flags & CMD_WRITE) && i < argc; i++) {
+        size_t len = strlen(argv[i]);
+        if (len >= MAX_VALUE_SIZE) {
+            reply_error(client, "value too long (max %d bytes)", MAX_VALUE_SIZE - 1);
+            return NULL;
+        }
+        if (strcspn(argv[i], "\r\n") != len) {
+            reply_error(client, "keys and values cannot contain CR or LF");
+            return NULL;
+        }
+    }
+    // Replikada veri yalnızca primary'den gelen akışla değişir
+    if ((command->flags & CMD_WRITE) && replication_is_replica()) {
+        if (client->protocol == PROTOCOL_RESP) reply_raw(client, "-READONLY You can't write against a read only replica\r\n", 55);
+        else reply_error(client, "READONLY You can't write against a read only replica");
+        return NULL;
+    }
+    if ((command->flags & CMD_READONLY) && !(command->flags & (CMD_NOAUTH | CMD_ADMIN)) && replication_is_stale()) {
+        reply_error(client, "replica data is stale (no data from primary for more than the maximum lag)");
+        return NULL;
+    }
+    return command;
+}
+
+void command_execute(CommandClient* client, int argc, char** argv) {
+    // ASKING yalnızca hemen ardından gelen komut için geçerlidir
+    bool asking = client->asking;
+    client->asking = false;
+
+    const Command* command = check_command(client, argc, argv);
+    if (!command) {
+        // Hatalı komut içeren işlem EXEC'te reddedilir
+        if (client->multi) client->multi->aborted = true;
+        return;
+    }
+    if (client->multi && !(command->flags & CMD_NOQUEUE)) {
+        queue_command(client, command, argc, argv);
+        return;
+    }
+
+    // Küme modunda anahtar başka düğümdeyse yönlendirilir; slot kilidi komut bitene kadar tutulur
+    int slot = -1;
+    if ((command->flags & CMD_KEY) && cluster_is_enabled()) {
+        int step = command->key_step ? command->key_step : 1;
+        slot = cluster_route(client, argv + 1, command_key_count(command, argc), step, asking);
+        if (slot < 0) return;
+    }
+
+    command->handler(client, argc, argv);
+    if (slot >= 0) cluster_release(slot);
+}
+
+void command_reject(CommandClient* client, const char* message) {
+    reply_error(client, "%s", message);
+    if (client->multi) client->multi->aborted = true;
+}
+
+// ---------------------------------------------------------------------------
+// Telnet satırı ayrıştırma
+// ---------------------------------------------------------------------------
+
+// Argümanlar satırın içinde ayrılır: ayırıcıların ve kapanış tırnaklarının yerine
+// '\0' yazılır, böylece kopya ya da heap allocation gerekmez
+int command_tokenize(char* line, char* tokens[], int max_tokens) {
+    char* current = line;
+    int count = 0;
+
+    while (*current && count < max_tokens) {
+        while (*current == ' ' || *current == '\t') current++;
+        if (!*current) break;
+
+        char* start = current;
+        char* end;
+        if (*current == '"') {
+            // Tırnaklı argüman boşluk içerebilir
+            start = ++current;
+            while (*current && *current != '"') current++;
+            end = current;
+            if (*current == '"') current++;
+        } else {
+            while (*current && *current != ' ' && *current != '\t') current++;
+            end = current;
+            if (*current) current++;
+        }
+
+        if (end - start >= MAX_VALUE_SIZE) end = start + MAX_VALUE_SIZE - 1;
+        *end = '\0';
+        tokens[count++] = start;
+    }
+
+    return count;
+}
+
+void command_execute_line(CommandClient* client, char* line) {
+    // Fazladan bir argüman yeri sınırın aşıldığını anlamak için; fazlası sessizce kesilmez
+    char* tokens[MAX_TOKENS + 1];
+    int token_count = command_tokenize(line, tokens, MAX_TOKENS + 1);
+    if (token_count > MAX_TOKENS) {
+        reply_error(client, "too many arguments (max %d)", MAX_TOKENS);
+        if (client->multi) client->multi->aborted = true;
+        return;
+    }
+    command_execute(client, token_count, tokens);
+}
@@ -0,0 +1,104 @@
+#ifndef COMMAND_H
+#define COMMAND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "storage.h"
+
+// Telnet sunucusu ve etkileşimli CLI'ın ortak komut tablosu.
+// Her komut adı, argüman sayısı, bayrakları ve işleyicisi ile tek yerde tanımlanır;
+// ön yüzler sadece satırı/RESP isteğini ayrıştırıp command_execute'u çağırır.
+
+#define MAX_TOKENS 2048 // Telnet satırındaki en fazla argüman sayısı (RESP_MAX_ARGS ile aynı)
+#define MULTI_MAX_COMMANDS 4096 // Bir MULTI işleminde kuyruklanabilecek en fazla komut
+#define WATCH_MAX_KEYS 1024     // Bir bağlantının izleyebileceği en fazla anahtar
+
+// Komut bayrakları
+#define CMD_READONLY 0x01 // Veriyi sadece okur
+#define CMD_WRITE    0x02 // Veriyi değiştirir
+#define CMD_ADMIN    0x04 // Sunucu/kalıcılık yönetimi
+#define CMD_NOAUTH   0x08 // Kimlik doğrulama olmadan çalışabilir
+#define CMD_KEY      0x10 // argv[1] (key_step ile sonrakiler de) anahtardır; küme modunda slotuna göre yönlendirilir
+#define CMD_NOQUEUE  0x20 // MULTI içinde kuyruklanmaz, hemen çalışır
+
+// Protokol bağlantının ilk baytından belirlenir: '*' ile başlayan RESP,
+// diğer her şey telnet tarzı satır protokolüdür
+typedef enum {
+    PROTOCOL_UNKNOWN,
+    PROTOCOL_TELNET,
+    PROTOCOL_RESP
+} Protocol;
+
+// Komutu çalıştıran istemcinin durumu; yanıtlar write ile ön yüze iletilir
+typedef struct CommandClient {
+    Protocol protocol;
+    int resp_version;       // HELLO ile seçilen RESP sürümü (2 veya 3)
+    int id;                 // HELLO yanıtındaki bağlantı kimliği
+    bool authenticated;     // Kimlik doğrulama durumu
+    bool close_requested;   // quit sonrası çıktı gönderilince kapatılır
+    bool prompt_disabled;   // Telnet modunda "> " istemi gönderilmez (betikler için)
+    bool failed;            // Yanıt gönderilemedi, bağlantı kapatılmalı
+    bool tracking;          // Okunan anahtarlar invalidation için takip ediliyor (bkz. tracking.h)
+    bool asking;            // Sonraki komut taşınmakta olan (IMPORTING) slota izinli (bkz. cluster.h)
+    struct Transaction* multi; // MULTI sonrası EXEC'e kadar kuyruklanan komutlar
+    struct WatchedKeys* watched; // WATCH ile sürümleri kaydedilen anahtarlar; EXEC'te kontrol edilir
+    struct ReplicaLink* replica; // Bağlantı bir replikaya akış gönderiyor (bkz. replication.h)
+    bool (*write)(struct CommandClient* client, const char* data, size_t len);
+    // İsteğe bağlı: yanıtı doğrudan ön yüzün çıkış buffer'ında oluşturmak için
+    // en az len baytlık yer döner (NULL: bellek yetmedi); commit yazılan baytları ekler
+    char* (*reserve)(struct CommandClient* client, size_t len);
+    void (*commit)(struct CommandClient* client, size_t len);
+    // İsteğe bağlı: başka bir thread'de değişen anahtarın bildirimini istemcinin thread'ine
+    // iletir (orada tracking_write_invalidation ile yazılır). key NULL ise replikasyon
+    // akışında yeni veri vardır (replication_fill). NULL ise tracking ve replikasyon desteklenmez
+    void (*notify)(struct CommandClient* client, const char* key);
+} CommandClient;
+
+typedef void (*CommandHandler)(CommandClient* client, int argc, char** argv);
+
+typedef struct {
+    const char* name;
+    int arity;              // Komut adı dahil; negatifse en az |arity| argüman
+    int flags;
+    CommandHandler handler;
+    const char* usage;      // help çıktısı için
+    const char* summary;
+    int key_step;           // CMD_KEY: 0 ise yalnızca argv[1], değilse argv[1], argv[1 + key_step], ...
+} Command;
+
+// Komutların çalışacağı depolama ve shutdown komutunun çağıracağı fonksiyon
+void command_init(Storage* storage, void (*shutdown_handler)(void));
+
+// Ada göre komutu sabit sürede bulur (büyük/küçük harf duyarsız), yoksa NULL
+const Command* command_lookup(const char* name);
+
+// Arity ve kimlik doğrulama kontrolünden sonra komutu çalıştırır
+void command_execute(CommandClient* client, int argc, char** argv);
+
+// Ayrıştırılan istek çalıştırılamıyorsa hata yazar; açık işlem EXEC'te reddedilir
+void command_reject(CommandClient* client, const char* message);
+
+// Yeni bağlantının kimliği; TCP, Unix soketi ve paylaşımlı bellek bağlantıları aynı sayacı
+// kullanır, böylece tracking gibi kimliğe göre tutulan durumlar çakışmaz
+int command_next_client_id(void);
+
+// Bağlantı kapanırken istemcinin komut katmanındaki durumunu (açık MULTI, WATCH) serbest bırakır
+void command_client_close(CommandClient* client);
+
+// Telnet satırını (tırnaklı argümanlar dahil) ayrıştırıp çalıştırır; satır yerinde değiştirilir
+void command_execute_line(CommandClient* client, char* line);
+
+// Satırı argümanlara ayırır; argümanlar satırın içini gösterir (satır yerinde değiştirilir)
+int command_tokenize(char* line, char* tokens[], int max_tokens);
+
+// Yanıt yardımcıları: telnet modunda düz metin, RESP modunda Redis yanıt türleri
+void reply_raw(CommandClient* client, const char* data, size_t len);
+void reply_ok(CommandClient* client, const char* detail);
+void reply_status(CommandClient* client, const char* text);
+void reply_error(CommandClient* client, const char* format, ...);
+void reply_bulk(CommandClient* client, const char* value, size_t len);
+void reply_null(CommandClient* client);
+void reply_integer(CommandClient* client, long long value);
+void reply_aggregate(CommandClient* client, char type, size_t count);
+
+#endif // COMMAND_H
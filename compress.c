@@ -0,0 +1,162 @@
+#include "compress.h"
+#include <stdint.h>
+#include <string.h>
+
+#define LZ_HASH_BITS 14
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_OFFSET 65535
+#define LZ_LAST_LITERALS 5   // Son baytlar her zaman literal yazılır
+#define LZ_MF_LIMIT 12       // Bloğun son 12 baytında eşleşme aranmaz
+
+// Token formatı (LZ4 ile aynı mantık):
+//   [token: 4 bit literal uzunluğu | 4 bit eşleşme uzunluğu - 4]
+//   [uzatılmış literal uzunluğu][literaller][2 bayt offset][uzatılmış eşleşme uzunluğu]
+// Son sekans sadece literal içerir.
+
+static inline uint32_t read32(const char* p) {
+    uint32_t value;
+    memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+static inline uint32_t lz_hash(uint32_t sequence) {
+    return (sequence * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+static char* write_length(char* op, char* op_end, size_t length) {
+    while (length >= 255) {
+        if (op >= op_end) return NULL;
+        *op++ = (char)255;
+        length -= 255;
+    }
+    if (op >= op_end) return NULL;
+    *op++ = (char)length;
+    return op;
+}
+
+static char* write_sequence(char* op, char* op_end, const char* literals, size_t literal_len,
+                            size_t offset, size_t match_len, int has_match) {
+    if (op >= op_end) return NULL;
+    char* token = op++;
+    
+    size_t match_code = has_match ? match_len - LZ_MIN_MATCH : 0;
+    *token = (char)(((literal_len >= 15 ? 15 : literal_len) << 4) | (match_code >= 15 ? 15 : match_code));
+    
+    if (literal_len >= 15) {
+        op = write_length(op, op_end, literal_len - 15);
+        if (!op) return NULL;
+    }
+    if ((size_t)(op_end - op) < literal_len) return NULL;
+    memcpy(op, literals, literal_len);
+    op += literal_len;
+    
+    if (!has_match) return op;
+    
+    if (op_end - op < 2) return NULL;
+    *op++ = (char)(offset & 0xFF);
+    *op++ = (char)(offset >> 8);
+    
+    if (match_code >= 15) {
+        op = write_length(op, op_end, match_code - 15);
+    }
+    return op;
+}
+
+size_t lz_compress(const char* src, size_t src_len, char* dst, size_t dst_cap) {
+    uint32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+    
+    const char* ip = src;
+    const char* anchor = src;
+    const char* src_end = src + src_len;
+    char* op = dst;
+    char* op_end = dst + dst_cap;
+    
+    if (src_len > LZ_MF_LIMIT) {
+        const char* match_limit = src_end - LZ_MF_LIMIT;
+        
+        while (ip < match_limit) {
+            uint32_t sequence = read32(ip);
+            uint32_t h = lz_hash(sequence);
+            const char* candidate = src + table[h];
+            table[h] = (uint32_t)(ip - src);
+            
+            if (candidate >= ip || ip - candidate > LZ_MAX_OFFSET || read32(candidate) != sequence) {
+                ip++;
+                continue;
+            }
+            
+            // Eşleşmeyi ileriye doğru uzat (son literaller hariç)
+            const char* match_end_limit = src_end - LZ_LAST_LITERALS;
+            size_t match_len = LZ_MIN_MATCH;
+            while (ip + match_len < match_end_limit && candidate[match_len] == ip[match_len]) {
+                match_len++;
+            }
+            
+            op = write_sequence(op, op_end, anchor, (size_t)(ip - anchor),
+                                (size_t)(ip - candidate), match_len, 1);
+            if (!op) return 0;
+            
+            ip += match_len;
+            anchor = ip;
+        }
+    }
+    
+    // Kalan baytlar literal olarak
+    op = write_sequence(op, op_end, anchor, (size_t)(src_end - anchor), 0, 0, 0);
+    if (!op) return 0;
+    
+    return (size_t)(op - dst);
+}
+
+static int read_length(const char** ip, const char* ip_end, size_t* length) {
+    unsigned char byte;
+    do {
+        if (*ip >= ip_end) return 0;
+        byte = (unsigned char)*(*ip)++;
+        *length += byte;
+    } while (byte == 255);
+    return 1;
+}
+
+size_t lz_decompress(const char* src, size_t src_len, char* dst, size_t dst_cap) {
+    const char* ip = src;
+    const char* ip_end = src + src_len;
+    char* op = dst;
+    char* op_end = dst + dst_cap;
+    
+    while (ip < ip_end) {
+        unsigned char token = (unsigned char)*ip++;
+        
+        size_t literal_len = token >> 4;
+        if (literal_len == 15 && !read_length(&ip, ip_end, &literal_len)) return 0;
+        if ((size_t)(ip_end - ip) < literal_len || (size_t)(op_end - op) < literal_len) return 0;
+        memcpy(op, ip, literal_len);
+        ip += literal_len;
+        op += literal_len;
+        
+        // Son sekansta eşleşme yok
+        if (ip == ip_end) break;
+        
+        if (ip_end - ip < 2) return 0;
+        size_t offset = (unsigned char)ip[0] | ((size_t)(unsigned char)ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - dst)) return 0;
+        
+        size_t match_len = token & 15;
+        if (match_len == 15 && !read_length(&ip, ip_end, &match_len)) return 0;
+        match_len += LZ_MIN_MATCH;
+        if ((size_t)(op_end - op) < match_len) return 0;
+        
+        // Örtüşen kopyalar için bayt bayt
+        const char* match = op - offset;
+        if (offset >= match_len) {
+            memcpy(op, match, match_len);
+            op += match_len;
+        } else {
+            for (size_t i = 0; i < match_len; i++) *op++ = *match++;
+        }
+    }
+    
+    return (size_t)(op - dst);
+}
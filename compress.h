@@ -0,0 +1,18 @@
+#ifndef COMPRESS_H
+#define COMPRESS_H
+
+#include <stddef.h>
+
+// Harici bağımlılık olmadan LZ4 benzeri blok sıkıştırma.
+// Her blok bağımsız çözülebilir, böylece snapshot blokları paralel açılabilir.
+
+// En kötü durumda (sıkıştırılamayan veri) gereken çıktı boyutu
+#define LZ_COMPRESS_BOUND(len) ((len) + (len) / 255 + 16)
+
+// Sıkıştırılmış boyutu döner, dst_cap yetmezse 0
+size_t lz_compress(const char* src, size_t src_len, char* dst, size_t dst_cap);
+
+// Açılmış boyutu döner, veri bozuksa veya dst_cap yetmezse 0
+size_t lz_decompress(const char* src, size_t src_len, char* dst, size_t dst_cap);
+
+#endif // COMPRESS_H
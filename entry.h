@@ -8,6 +8,9 @@
 #include <time.h>
 #include <stdint.h>
 
+// Entry flag'leri
+#define ENTRY_FLAG_DIRTY 0x01 // Son snapshot'tan beri değişti (delta snapshot için)
+
 typedef struct __attribute__((aligned(64))) {
     char key[256];
     char value[1024];
@@ -19,6 +22,8 @@ typedef struct __attribute__((aligned(64))) {
     
     // Memory pool işlemleri için gereken alanlar
     struct Entry* next; // Bağlı liste için sonraki entry
+    
+    uint64_t version; // Son yazmada verilen sürüm; tüm anahtarlarda tekrar etmez (cas/watch için)
 } Entry;
 
 #endif //ENTRY_H
@@ -0,0 +1,384 @@
+#define _GNU_SOURCE // O_DIRECT için
+#include "file_writer.h"
+#include "uring.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <sys/stat.h>
+
+#define FILE_WRITER_STDIO_BUFFER 32768
+#define FILE_WRITER_RING_ENTRIES 16
+
+struct FileWriter {
+    FileWriterBackend backend;
+    bool error;
+    long size;                 // Mantıksal dosya boyutu (buffer'daki veriler dahil)
+
+    // stdio backend
+    FILE* file;
+
+#ifdef AYTDB_HAVE_IO_URING
+    // io_uring backend
+    int fd;
+    bool direct;               // O_DIRECT ile açıldı mı
+    bool fixed_buffers;        // Buffer'lar kernel'e kaydedilebildi mi
+    Uring ring;
+    char* buffers[FILE_WRITER_BUFFER_COUNT];
+    size_t in_flight_len[FILE_WRITER_BUFFER_COUNT]; // 0 ise buffer boşta
+    unsigned pending;          // Tamamlanmayı bekleyen istek sayısı
+    size_t current;            // Doldurulan buffer
+    size_t fill;               // Doldurulan buffer'daki byte sayısı
+    long offset;               // Doldurulan buffer'ın dosyadaki başlangıcı
+#endif
+};
+
+static bool writer_use_uring = false;
+static bool writer_direct_io = false;
+
+void file_writer_configure(bool use_uring, bool direct_io) {
+    writer_use_uring = use_uring;
+    writer_direct_io = direct_io;
+}
+
+bool file_writer_uring_available() {
+#ifdef AYTDB_HAVE_IO_URING
+    static int available = -1;
+    if (available < 0) {
+        Uring ring;
+        available = uring_init(&ring, 2) ? 1 : 0;
+        uring_exit(&ring);
+    }
+    return available == 1;
+#else
+    return false;
+#endif
+}
+
+static FileWriter* open_stdio(FileWriter* writer, const char* path, bool append) {
+    writer->backend = FILE_WRITER_STDIO;
+    writer->file = fopen(path, append ? "a" : "w");
+    if (!writer->file) {
+        free(writer);
+        return NULL;
+    }
+
+    setvbuf(writer->file, NULL, _IOFBF, FILE_WRITER_STDIO_BUFFER);
+    fseek(writer->file, 0, SEEK_END);
+    writer->size = ftell(writer->file);
+    return writer;
+}
+
+#ifdef AYTDB_HAVE_IO_URING
+
+// Tamamlanan istekleri toplar; wait=true ise uçuştaki tüm istekler bitene kadar bekler
+static void reap_completions(FileWriter* writer, bool wait) {
+    while (writer->pending > 0) {
+        struct io_uring_cqe* cqe = uring_peek_cqe(&writer->ring);
+        if (!cqe) {
+            if (!wait) return;
+            if (uring_submit(&writer->ring, 1) < 0) {
+                writer->error = true;
+                return;
+            }
+            continue;
+        }
+
+        size_t index = (size_t)cqe->user_data;
+        if (index < FILE_WRITER_BUFFER_COUNT) {
+            // Normal dosyalarda kısa yazım beklenmez, olursa hata say
+            if (cqe->res < 0 || (size_t)cqe->res != writer->in_flight_len[index]) {
+                writer->error = true;
+            }
+            writer->in_flight_len[index] = 0;
+        } else if (cqe->res < 0) {
+            writer->error = true; // fsync
+        }
+
+        writer->pending--;
+        uring_cqe_seen(&writer->ring);
+    }
+}
+
+static struct io_uring_sqe* acquire_sqe(FileWriter* writer) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&writer->ring);
+    if (!sqe) {
+        reap_completions(writer, true);
+        sqe = uring_get_sqe(&writer->ring);
+    }
+    return sqe;
+}
+
+static void submit_current(FileWriter* writer, size_t len) {
+    struct io_uring_sqe* sqe = acquire_sqe(writer);
+    if (!sqe) {
+        writer->error = true;
+        return;
+    }
+
+    sqe->opcode = writer->fixed_buffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+    sqe->fd = writer->fd;
+    sqe->addr = (unsigned long)writer->buffers[writer->current];
+    sqe->len = (unsigned)len;
+    sqe->off = (unsigned long long)writer->offset;
+    sqe->buf_index = (unsigned short)writer->current;
+    sqe->user_data = writer->current;
+
+    writer->in_flight_len[writer->current] = len;
+    writer->pending++;
+
+    if (uring_submit(&writer->ring, 0) < 0) writer->error = true;
+}
+
+// Dolu buffer'ı gönderir ve bir sonraki boş buffer'a geçer
+static void rotate_buffer(FileWriter* writer) {
+    submit_current(writer, writer->fill);
+    writer->offset += writer->fill;
+    writer->fill = 0;
+    writer->current = (writer->current + 1) % FILE_WRITER_BUFFER_COUNT;
+
+    while (writer->in_flight_len[writer->current] != 0 && !writer->error) {
+        if (uring_submit(&writer->ring, 1) < 0) {
+            writer->error = true;
+            break;
+        }
+        reap_completions(writer, false);
+    }
+}
+
+static FileWriter* open_uring(FileWriter* writer, const char* path, bool append) {
+    int flags = O_RDWR | O_CREAT | (append ? 0 : O_TRUNC);
+
+    writer->fd = -1;
+    if (writer_direct_io) {
+        writer->fd = open(path, flags | O_DIRECT, 0644);
+        writer->direct = writer->fd >= 0;
+    }
+    if (writer->fd < 0) {
+        // Dosya sistemi O_DIRECT desteklemiyor olabilir (ör. tmpfs)
+        writer->fd = open(path, flags, 0644);
+    }
+    if (writer->fd < 0) return NULL;
+
+    if (!uring_init(&writer->ring, FILE_WRITER_RING_ENTRIES)) {
+        close(writer->fd);
+        return NULL;
+    }
+
+    struct iovec iovecs[FILE_WRITER_BUFFER_COUNT];
+    for (size_t i = 0; i < FILE_WRITER_BUFFER_COUNT; i++) {
+        void* buffer = NULL;
+        if (posix_memalign(&buffer, FILE_WRITER_BLOCK_SIZE, FILE_WRITER_BUFFER_SIZE) != 0) {
+            for (size_t j = 0; j < i; j++) free(writer->buffers[j]);
+            uring_exit(&writer->ring);
+            close(writer->fd);
+            return NULL;
+        }
+        writer->buffers[i] = buffer;
+        iovecs[i].iov_base = buffer;
+        iovecs[i].iov_len = FILE_WRITER_BUFFER_SIZE;
+    }
+
+    // RLIMIT_MEMLOCK yetmezse kayıtsız buffer'larla devam edilir
+    writer->fixed_buffers = uring_register_buffers(&writer->ring, iovecs, FILE_WRITER_BUFFER_COUNT) == 0;
+
+    struct stat st;
+    writer->size = fstat(writer->fd, &st) == 0 ? st.st_size : 0;
+    writer->offset = writer->size;
+
+    if (writer->direct && writer->size % FILE_WRITER_BLOCK_SIZE != 0) {
+        // Hizasız son bloğu buffer'a al, bir sonraki yazımda baştan yazılacak
+        long aligned = writer->size - writer->size % FILE_WRITER_BLOCK_SIZE;
+        ssize_t tail = pread(writer->fd, writer->buffers[0], FILE_WRITER_BLOCK_SIZE, aligned);
+        if (tail != writer->size - aligned) writer->error = true;
+        writer->offset = aligned;
+        writer->fill = (size_t)(writer->size - aligned);
+    }
+
+    writer->backend = FILE_WRITER_URING;
+    return writer;
+}
+
+static bool flush_uring(FileWriter* writer) {
+    if (writer->fill == 0) {
+        reap_completions(writer, true);
+        return !writer->error;
+    }
+
+    size_t fill = writer->fill;
+    size_t write_len = fill;
+    if (writer->direct) {
+        // O_DIRECT tam blok ister; son bloğu sıfırla doldurup sonra dosyayı kısaltıyoruz
+        write_len = (fill + FILE_WRITER_BLOCK_SIZE - 1) & ~(size_t)(FILE_WRITER_BLOCK_SIZE - 1);
+        memset(writer->buffers[writer->current] + fill, 0, write_len - fill);
+    }
+
+    submit_current(writer, write_len);
+    reap_completions(writer, true);
+
+    size_t tail = writer->direct ? fill % FILE_WRITER_BLOCK_SIZE : 0;
+    if (tail > 0) {
+        if (ftruncate(writer->fd, writer->size) != 0) writer->error = true;
+        // Yarım blok bellekte kalır ve bir sonraki flush'ta yeniden yazılır
+        memmove(writer->buffers[writer->current], writer->buffers[writer->current] + (fill - tail), tail);
+    }
+    writer->offset += (long)(fill - tail);
+    writer->fill = tail;
+
+    return !writer->error;
+}
+
+#endif // AYTDB_HAVE_IO_URING
+
+FileWriter* file_writer_open(const char* path, bool append) {
+    if (!path) return NULL;
+
+    FileWriter* writer = calloc(1, sizeof(FileWriter));
+    if (!writer) return NULL;
+
+#ifdef AYTDB_HAVE_IO_URING
+    if (writer_use_uring) {
+        if (open_uring(writer, path, append)) return writer;
+        // io_uring kullanılamıyor, stdio'ya düş
+        memset(writer, 0, sizeof(FileWriter));
+    }
+#endif
+
+    return open_stdio(writer, path, append);
+}
+
+bool file_writer_write(FileWriter* writer, const void* data, size_t len) {
+    if (!writer || writer->error) return false;
+
+    if (writer->backend == FILE_WRITER_STDIO) {
+        if (fwrite(data, 1, len, writer->file) != len) writer->error = true;
+        writer->size += (long)len;
+        return !writer->error;
+    }
+
+#ifdef AYTDB_HAVE_IO_URING
+    const char* src = data;
+    while (len > 0 && !writer->error) {
+        size_t space = FILE_WRITER_BUFFER_SIZE - writer->fill;
+        size_t chunk = len < space ? len : space;
+
+        memcpy(writer->buffers[writer->current] + writer->fill, src, chunk);
+        writer->fill += chunk;
+        writer->size += (long)chunk;
+        src += chunk;
+        len -= chunk;
+
+        if (writer->fill == FILE_WRITER_BUFFER_SIZE) rotate_buffer(writer);
+    }
+#endif
+
+    return !writer->error;
+}
+
+bool file_writer_puts(FileWriter* writer, const char* str) {
+    return file_writer_write(writer, str, strlen(str));
+}
+
+int file_writer_printf(FileWriter* writer, const char* format, ...) {
+    if (!writer || writer->error) return -1;
+
+    char stack_buffer[1024];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stack_buffer, sizeof(stack_buffer), format, args);
+    va_end(args);
+    if (len < 0) return -1;
+
+    if ((size_t)len < sizeof(stack_buffer)) {
+        return file_writer_write(writer, stack_buffer, (size_t)len) ? len : -1;
+    }
+
+    // Uzun satırlar için geçici alan
+    char* heap_buffer = malloc((size_t)len + 1);
+    if (!heap_buffer) return -1;
+    va_start(args, format);
+    vsnprintf(heap_buffer, (size_t)len + 1, format, args);
+    va_end(args);
+
+    bool ok = file_writer_write(writer, heap_buffer, (size_t)len);
+    free(heap_buffer);
+    return ok ? len : -1;
+}
+
+bool file_writer_flush(FileWriter* writer) {
+    if (!writer) return false;
+
+    if (writer->backend == FILE_WRITER_STDIO) {
+        if (fflush(writer->file) != 0) writer->error = true;
+        return !writer->error;
+    }
+
+#ifdef AYTDB_HAVE_IO_URING
+    return flush_uring(writer);
+#else
+    return false;
+#endif
+}
+
+bool file_writer_sync(FileWriter* writer) {
+    if (!file_writer_flush(writer)) return false;
+
+    if (writer->backend == FILE_WRITER_STDIO) {
+        if (fsync(fileno(writer->file)) != 0) writer->error = true;
+        return !writer->error;
+    }
+
+#ifdef AYTDB_HAVE_IO_URING
+    struct io_uring_sqe* sqe = acquire_sqe(writer);
+    if (!sqe) {
+        writer->error = true;
+        return false;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = writer->fd;
+    sqe->user_data = FILE_WRITER_BUFFER_COUNT; // Buffer dışı istek
+    writer->pending++;
+
+    if (uring_submit(&writer->ring, 0) < 0) writer->error = true;
+    reap_completions(writer, true);
+#endif
+
+    return !writer->error;
+}
+
+long file_writer_size(FileWriter* writer) {
+    return writer ? writer->size : 0;
+}
+
+bool file_writer_has_error(FileWriter* writer) {
+    return !writer || writer->error;
+}
+
+FileWriterBackend file_writer_backend(FileWriter* writer) {
+    return writer ? writer->backend : FILE_WRITER_STDIO;
+}
+
+bool file_writer_close(FileWriter* writer) {
+    if (!writer) return false;
+
+    bool ok = file_writer_flush(writer);
+
+    if (writer->backend == FILE_WRITER_STDIO) {
+        ok = fclose(writer->file) == 0 && ok;
+    }
+#ifdef AYTDB_HAVE_IO_URING
+    else {
+        uring_exit(&writer->ring);
+        ok = close(writer->fd) == 0 && ok;
+        for (size_t i = 0; i < FILE_WRITER_BUFFER_COUNT; i++) {
+            free(writer->buffers[i]);
+        }
+    }
+#endif
+
+    free(writer);
+    return ok;
+}
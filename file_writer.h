@@ -0,0 +1,37 @@
+#ifndef FILE_WRITER_H
+#define FILE_WRITER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define FILE_WRITER_BLOCK_SIZE 4096           // O_DIRECT hizalama birimi
+#define FILE_WRITER_BUFFER_SIZE (256 * 1024)  // io_uring kayıtlı buffer boyutu
+#define FILE_WRITER_BUFFER_COUNT 4            // Aynı anda uçuşta olabilecek buffer sayısı
+
+// Snapshot ve log yazımları için backend
+typedef enum {
+    FILE_WRITER_STDIO,  // Klasik FILE* + page cache
+    FILE_WRITER_URING   // io_uring + kayıtlı buffer'lar (isteğe bağlı O_DIRECT)
+} FileWriterBackend;
+
+typedef struct FileWriter FileWriter;
+
+// Global ayar - io_uring kullanılamıyorsa otomatik olarak stdio'ya düşülür
+void file_writer_configure(bool use_uring, bool direct_io);
+bool file_writer_uring_available();
+
+// append=false ise dosya sıfırlanır
+FileWriter* file_writer_open(const char* path, bool append);
+bool file_writer_write(FileWriter* writer, const void* data, size_t len);
+bool file_writer_puts(FileWriter* writer, const char* str);
+int file_writer_printf(FileWriter* writer, const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+// flush: veriyi kernel'e verir, sync: ayrıca diske kalıcı hale getirir
+bool file_writer_flush(FileWriter* writer);
+bool file_writer_sync(FileWriter* writer);
+long file_writer_size(FileWriter* writer);
+bool file_writer_has_error(FileWriter* writer);
+FileWriterBackend file_writer_backend(FileWriter* writer);
+bool file_writer_close(FileWriter* writer);
+
+#endif // FILE_WRITER_H
@@ -9,6 +9,9 @@
 #include <string.h>
 #include <time.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #ifdef __ARM_NEON
 #include <arm_neon.h>
@@ -29,8 +32,77 @@ EntryPool* entry_pool = NULL; // Entry pool
 static __thread char value_buffer[MAX_VALUE_SIZE]; // Thread-local buffer ekleyerek thread güvenliği sağlıyorum
 MemoryArena* global_arena = NULL; // Global arena allocator
 
+// Yazma sayacı - snapshot zamanlayıcısı son snapshot'tan beri kaç değişiklik
+// olduğunu buradan okur. table->mutex altında artırılır, kilitsiz okunur.
+static unsigned long long write_count = 0;
+
+// Her yazmada artan sürüm sayacı (table->mutex). Silinip yeniden yazılan anahtar da yeni
+// sürüm alır, böylece cas eski sürümle başarılı olamaz
+static uint64_t version_counter = 0;
+// Sayaç açılışta milisaniye cinsinden saatin bu kadar bit kaydırılmışıyla başlar: yeniden
+// başlatılan süreç, öncekinin verdiği sürümleri (ms başına 2^20 yazmaya kadar) tekrar vermez
+#define VERSION_EPOCH_SHIFT 20
+
+// Anahtar değiştiğinde (set/del/süre dolumu) çağrılır; istemci önbellek takibi için.
+// kv_purge_expired'da table->mutex tutulurken çağrıldığı için kv fonksiyonlarını çağırmamalı
+static void (*invalidation_hook)(const char* key) = NULL;
+
+// Değişiklik takibi: son snapshot'tan beri değişen entry'lerin havuz indeksleri
+// ve silinen anahtarlar. Kilit sırası: table->mutex -> change_mutex
+static bool change_tracking = false;
+static pthread_mutex_t change_mutex = PTHREAD_MUTEX_INITIALIZER;
+static size_t* dirty_indices = NULL;
+static size_t dirty_count = 0;
+static size_t dirty_cap = 0;
+static char** deleted_keys = NULL;
+static size_t deleted_count = 0;
+static size_t deleted_cap = 0;
+static bool changes_overflowed = false; // Liste sınırı aşıldı, tam snapshot gerekli
+
+// Kalıcı (mmap) tablo modu. Dosya düzeni:
+//   [başlık][serbest indeksler][entry havuzu][tablo indeksi]
+// Tablo indeksi Entry* yerine havuz indeksi + 1 (0: boş slot) tutar, böylece dosya
+// hangi adrese map edilirse edilsin geçerlidir. Havuz ve serbest liste doğrudan
+// map edilir; indeks düzgün kapanışta yazılır ve açılışta pointer'lara çevrilir.
+#define MAPPED_MAGIC "AYTDBMM1"
+#define MAPPED_VERSION 3
+#define MAPPED_PAGE 4096
+#define MAPPED_ALIGN(x) (((x) + MAPPED_PAGE - 1) & ~(size_t)(MAPPED_PAGE - 1))
+#define MAPPED_FREE_OFFSET MAPPED_PAGE
+#define MAPPED_ENTRIES_OFFSET (MAPPED_FREE_OFFSET + MAPPED_ALIGN(ENTRY_POOL_SIZE * sizeof(size_t)))
+#define MAPPED_INDEX_OFFSET (MAPPED_ENTRIES_OFFSET + MAPPED_ALIGN(ENTRY_POOL_SIZE * sizeof(Entry)))
+#define MAPPED_INDEX_CHUNK 65536 // İndeks okuma/yazma parça boyutu (slot)
+
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t entry_size;    // sizeof(Entry) - düzen değişirse dosya geçersiz
+    uint64_t pool_size;
+    uint64_t pool_used;
+    uint64_t free_count;
+    uint64_t table_size;
+    uint64_t table_count;
+    int64_t log_offset;     // Kapanışta log'un uygulandığı yer
+    uint32_t clean;         // Düzgün kapanışta 1, çalışırken 0
+    uint64_t max_version;   // Kapanıştaki sürüm sayacı; açılışta sayaç buradan devam eder
+} MappedHeader;
+
+static int mapped_fd = -1;
+static char* mapped_base = NULL;
+static size_t mapped_size = 0;
+
+// Silinen yuvalar NULL yapılırsa aynı probe zincirinde sonra gelen anahtarlar bulunamaz;
+// bu yüzden yuva, hiçbir anahtarla eşleşmeyen ve süresi çoktan dolmuş bu işarete döner.
+// Aramalar işaretin üzerinden devam eder, eklemeler onu yeniden kullanır, resize temizler.
+// Anahtarı boş, hash'i ise boş anahtarın hash'inden (FNV-1a başlangıç değeri) farklıdır.
+static Entry tombstone_entry = { .hash = 0x84222325u + 1, .expire_at = 1 };
+#define TOMBSTONE (&tombstone_entry)
+#define MAPPED_TOMBSTONE UINT32_MAX    // İndeks dosyasında işaretin değeri
+static size_t tombstone_count = 0;     // table->mutex
+
 // İleri tanımlamalar
 static void check_and_resize(void);
+static void resize_locked(size_t new_size);
 static size_t find_slot(const char* key, bool* found);
 
 // Memory pool işlemleri
@@ -61,8 +133,8 @@ void pool_init() {
         return;
     }
     
-    // Tüm entry'leri sıfırla
-    memset(entry_pool->entries, 0, ENTRY_POOL_SIZE * sizeof(Entry));
+    // Büyük alanlar calloc ile sıfırlanmış geliyor, ayrıca memset gerekmez
+    // (pool_alloc her entry'yi kullanıma verirken zaten sıfırlıyor)
     
     // Serbest indeks dizisi oluştur - arena allocator'dan
     entry_pool->free_indices = arena_alloc(ENTRY_POOL_SIZE * sizeof(size_t));
@@ -108,26 +180,106 @@ Entry* pool_alloc() {
     return result;
 }
 
-void pool_free(Entry* entry) {
+// Silinen anahtarı bir sonraki delta snapshot için kaydeder
+static void track_deleted(const char* key) {
+    pthread_mutex_lock(&change_mutex);
+    if (!changes_overflowed) {
+        if (deleted_count == deleted_cap) {
+            size_t new_cap = deleted_cap ? deleted_cap * 2 : 1024;
+            char** grown = new_cap <= CHANGE_MAX_DELETED ? realloc(deleted_keys, new_cap * sizeof(char*)) : NULL;
+            if (grown) {
+                deleted_keys = grown;
+                deleted_cap = new_cap;
+            }
+        }
+        char* copy = deleted_count < deleted_cap ? strdup(key) : NULL;
+        if (copy) {
+            deleted_keys[deleted_count++] = copy;
+        } else {
+            changes_overflowed = true;
+        }
+    }
+    pthread_mutex_unlock(&change_mutex);
+}
+
+// Entry'yi değişmiş olarak işaretler; table->mutex tutulurken çağrılır
+static inline void mark_dirty(Entry* entry) {
+    if (__builtin_expect(!change_tracking || (entry->flags & ENTRY_FLAG_DIRTY), 1)) return;
+    
+    entry->flags |= ENTRY_FLAG_DIRTY;
+    pthread_mutex_lock(&change_mutex);
+    if (!changes_overflowed) {
+        if (dirty_count == dirty_cap) {
+            size_t new_cap = dirty_cap ? dirty_cap * 2 : 4096;
+            size_t* grown = new_cap <= CHANGE_MAX_DIRTY ? realloc(dirty_indices, new_cap * sizeof(size_t)) : NULL;
+            if (grown) {
+                dirty_indices = grown;
+                dirty_cap = new_cap;
+            }
+        }
+        if (dirty_count < dirty_cap) {
+            dirty_indices[dirty_count++] = (size_t)(entry - entry_pool->entries);
+        } else {
+            changes_overflowed = true;
+        }
+    }
+    pthread_mutex_unlock(&change_mutex);
+}
+
+// pool_free'nin kilit gerektirmeyen kısmı: entry'yi kullanım dışı işaretler ve
+// havuz indeksini döner; havuza ait değilse false
+static bool retire_entry(Entry* entry, size_t* entry_index) {
     if (__builtin_expect(!entry_pool || !entry, 0)) {
-        return;
+        return false;
     }
     
     // Adres aralığında mı kontrol et
     if (entry < entry_pool->entries || 
         entry >= &entry_pool->entries[entry_pool->size]) {
-        return;
+        return false;
     }
     
     // Entry indeksini hesapla
-    size_t entry_index = entry - entry_pool->entries;
+    *entry_index = entry - entry_pool->entries;
+    if (change_tracking && entry->in_use) {
+        track_deleted(entry->key);
+    }
+    entry->in_use = 0; // Havuz taramaları (kv_scan_entries) bu entry'yi atlamalı
+    entry->flags = 0;
+    return true;
+}
+
+// Serbest bırakılan indeksleri tek kilitle serbest listeye ekler
+static void pool_release_indices(const size_t* indices, size_t count) {
+    if (count == 0) return;
+    pthread_mutex_lock(&entry_pool->mutex);
+    for (size_t i = 0; i < count && entry_pool->free_count < entry_pool->size; i++) {
+        entry_pool->free_indices[entry_pool->free_count++] = indices[i];
+    }
+    pthread_mutex_unlock(&entry_pool->mutex);
+}
+
+void pool_free(Entry* entry) {
+    size_t entry_index;
+    if (retire_entry(entry, &entry_index)) pool_release_indices(&entry_index, 1);
+}
+
+// En fazla count entry'yi tek kilitle ayırır; ayrılabilen sayıyı döner
+static size_t pool_alloc_many(Entry** out, size_t count) {
+    if (__builtin_expect(!entry_pool, 0)) return 0;
     
+    size_t allocated = 0;
     pthread_mutex_lock(&entry_pool->mutex);
-    // Serbest indeks listesine ekle
-    if (entry_pool->free_count < entry_pool->size) {
-        entry_pool->free_indices[entry_pool->free_count++] = entry_index;
+    while (allocated < count && entry_pool->free_count > 0) {
+        out[allocated++] = &entry_pool->entries[entry_pool->free_indices[--entry_pool->free_count]];
+    }
+    while (allocated < count && entry_pool->used < entry_pool->size) {
+        out[allocated++] = &entry_pool->entries[entry_pool->used++];
     }
     pthread_mutex_unlock(&entry_pool->mutex);
+    
+    for (size_t i = 0; i < allocated; i++) memset(out[i], 0, sizeof(Entry));
+    return allocated;
 }
 
 void pool_cleanup() {
@@ -236,6 +388,7 @@ static size_t find_slot(const char* key, bool* found) {
         return 0;
     }
     
+    *found = false;
     uint32_t key_hash = (uint32_t)hash(key);
     size_t original_index = key_hash % table->size;
     size_t index = original_index;
@@ -270,6 +423,9 @@ static size_t find_slot(const char* key, bool* found) {
                 *found = true;
                 return index;
             }
+        } else if (table->entries[index] == TOMBSTONE && !empty_found) {
+            first_empty = index;
+            empty_found = true;
         }
         index = (index + step) % table->size;
         
@@ -288,6 +444,9 @@ static size_t find_slot(const char* key, bool* found) {
                 *found = true;
                 return index;
             }
+        } else if (table->entries[index] == TOMBSTONE && !empty_found) {
+            first_empty = index;
+            empty_found = true;
         }
         index = (index + step) % table->size;
         
@@ -306,6 +465,9 @@ static size_t find_slot(const char* key, bool* found) {
                 *found = true;
                 return index;
             }
+        } else if (table->entries[index] == TOMBSTONE && !empty_found) {
+            first_empty = index;
+            empty_found = true;
         }
         index = (index + step) % table->size;
         
@@ -324,6 +486,9 @@ static size_t find_slot(const char* key, bool* found) {
                 *found = true;
                 return index;
             }
+        } else if (table->entries[index] == TOMBSTONE && !empty_found) {
+            first_empty = index;
+            empty_found = true;
         }
         index = (index + step) % table->size;
         
@@ -348,6 +513,9 @@ static size_t find_slot(const char* key, bool* found) {
                 *found = true;
                 return index;
             }
+        } else if (table->entries[index] == TOMBSTONE && !empty_found) {
+            first_empty = index;
+            empty_found = true;
         }
         
         probe_count++;
@@ -366,6 +534,31 @@ static size_t find_slot(const char* key, bool* found) {
     return empty_found ? first_empty : original_index;
 }
 
+// Silinen yuvaları aynı boyutta yeniden yerleştirerek temizler (resize'ın aksine yeni
+// tablo ayırmaz); table->mutex tutulurken çağrılır
+static void clear_tombstones_locked() {
+    Entry** live = table->count ? malloc(table->count * sizeof(Entry*)) : NULL;
+    if (table->count && !live) return;
+    
+    size_t live_count = 0;
+    for (size_t i = 0; i < table->size; i++) {
+        Entry* entry = table->entries[i];
+        if (entry && entry != TOMBSTONE) live[live_count++] = entry;
+    }
+    memset(table->entries, 0, table->size * sizeof(Entry*));
+    for (size_t i = 0; i < live_count; i++) {
+        size_t original_index = live[i]->hash % table->size;
+        size_t step = 1 + (live[i]->hash % (table->size - 1));
+        size_t index = original_index;
+        for (size_t probe = 1; table->entries[index] != NULL; probe++) {
+            index = (original_index + probe * step) % table->size;
+        }
+        table->entries[index] = live[i];
+    }
+    tombstone_count = 0;
+    free(live);
+}
+
 void kv_purge_expired() {
     if (__builtin_expect(!table, 0)) return;
     
@@ -374,11 +567,13 @@ void kv_purge_expired() {
     
     size_t purged = 0;
     for (size_t i = 0; i < table->size; i++) {
-        if (__builtin_expect(table->entries[i] != NULL, 0)) {
+        if (__builtin_expect(table->entries[i] != NULL && table->entries[i] != TOMBSTONE, 0)) {
             if (__builtin_expect(table->entries[i]->expire_at > 0 && now > table->entries[i]->expire_at, 0)) {
                 // Entry'yi pool'a geri ver
                 Entry* entry_to_free = table->entries[i];
-                table->entries[i] = NULL;
+                table->entries[i] = TOMBSTONE;
+                tombstone_count++;
+                if (invalidation_hook) invalidation_hook(entry_to_free->key);
                 pool_free(entry_to_free);
                 table->count--;
                 purged++;
@@ -395,156 +590,313 @@ void kv_purge_expired() {
     pthread_mutex_unlock(&table->mutex);
 }
 
-void kv_init() {
-    // İlk olarak memory pool'u başlat
-    pool_init();
-    
-    if (__builtin_expect(table != NULL, 0)) {
-        kv_cleanup();
-    }
-
+// Boş tabloyu arena'dan oluşturur (havuz hazır olmalı)
+static bool table_init(size_t size) {
     table = arena_alloc(sizeof(HashTable));
     if (__builtin_expect(!table, 0)) {
         if (logging_enabled) printf("ERROR: Failed to allocate hash table\n");
-        return;
+        return false;
     }
 
     // Şimdi pointer array olarak entries oluşturuyoruz
-    table->entries = arena_alloc(INITIAL_TABLE_SIZE * sizeof(Entry*));
+    table->entries = arena_alloc(size * sizeof(Entry*));
     if (__builtin_expect(!table->entries, 0)) {
         if (logging_enabled) printf("ERROR: Failed to allocate table entries\n");
         table = NULL;
-        return;
+        return false;
     }
     
     // Tüm entry'leri sıfırla
-    memset(table->entries, 0, INITIAL_TABLE_SIZE * sizeof(Entry*));
+    memset(table->entries, 0, size * sizeof(Entry*));
 
-    table->size = INITIAL_TABLE_SIZE;
+    table->size = size;
     table->count = 0;
+    tombstone_count = 0;
+    
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    uint64_t epoch = ((uint64_t)now.tv_sec * 1000 + (uint64_t)now.tv_nsec / 1000000) << VERSION_EPOCH_SHIFT;
+    if (epoch > version_counter) version_counter = epoch;
     
     if (__builtin_expect(pthread_mutex_init(&table->mutex, NULL) != 0, 0)) {
         if (logging_enabled) printf("ERROR: Failed to initialize mutex\n");
         table = NULL;
-        return;
+        return false;
     }
+    return true;
+}
 
+static void start_cleanup_thread() {
     cleanup_running = true;
     if (__builtin_expect(pthread_create(&cleanup_thread, NULL, cleanup_loop, NULL) != 0, 0)) {
         if (logging_enabled) printf("ERROR: Failed to create cleanup thread\n");
+        cleanup_running = false;
         pthread_mutex_destroy(&table->mutex);
         table = NULL;
-        return;
     }
 }
 
-void kv_set(const char* key, const char* value) {
-    if (__builtin_expect(!table || !key || !value, 0)) return;
+static void stop_cleanup_thread() {
+    if (!cleanup_running) return;
+    cleanup_running = false;
+    pthread_join(cleanup_thread, NULL);
+}
 
-    pthread_mutex_lock(&table->mutex);
-    
-    bool found;
-    size_t index = find_slot(key, &found);
-    
-    // Tablo doluluk oranını kontrol et
-    // Sonsuz döngüden kaçınmak için resize işlemini sınırla
-    static int resize_count = 0;
-    const int MAX_CONSECUTIVE_RESIZES = 3;
+void kv_init() {
+    // Önceki tabloyu temizle - pool_init arena'yı yeniden oluşturduğu için önce yapılmalı
+    if (__builtin_expect(table != NULL, 0)) {
+        kv_cleanup();
+    }
     
-    if (__builtin_expect(!found && (double)(table->count + 1) / table->size > 0.60, 0)) {
-        resize_count++;
-        if (resize_count <= MAX_CONSECUTIVE_RESIZES) {
-            pthread_mutex_unlock(&table->mutex);
-            kv_resize(table->size * GROWTH_FACTOR);
-            pthread_mutex_lock(&table->mutex);
-            index = find_slot(key, &found);
-        } else {
-            if (logging_enabled) printf("WARN: Too many consecutive resizes, skipping resize for key: %s\n", key);
-            resize_count = 0; // Sayacı sıfırla
+    // Memory pool'u başlat
+    pool_init();
+
+    if (!table_init(INITIAL_TABLE_SIZE)) return;
+    start_cleanup_thread();
+}
+
+static bool mapped_header_valid(const MappedHeader* header, size_t file_size) {
+    if (memcmp(header->magic, MAPPED_MAGIC, sizeof(header->magic)) != 0) return false;
+    if (header->version != MAPPED_VERSION || header->entry_size != sizeof(Entry)) return false;
+    if (header->pool_size != ENTRY_POOL_SIZE || !header->clean) return false;
+    if (header->pool_used > header->pool_size || header->free_count > header->pool_used) return false;
+    if (header->table_size < INITIAL_TABLE_SIZE || header->table_size > MAX_TABLE_SIZE) return false;
+    if (header->table_count > header->pool_used) return false;
+    return file_size >= MAPPED_INDEX_OFFSET + header->table_size * sizeof(uint32_t);
+}
+
+// Dosyadaki offset indeksini pointer tablosuna çevirir. Entry'lere dokunmaz,
+// bu yüzden açılış süresi veri boyutundan değil tablo boyutundan etkilenir.
+static bool mapped_load_index(const MappedHeader* header) {
+    uint32_t* chunk = malloc(MAPPED_INDEX_CHUNK * sizeof(uint32_t));
+    if (!chunk) return false;
+    
+    size_t count = 0;
+    bool ok = true;
+    for (size_t start = 0; ok && start < table->size; start += MAPPED_INDEX_CHUNK) {
+        size_t n = table->size - start < MAPPED_INDEX_CHUNK ? table->size - start : MAPPED_INDEX_CHUNK;
+        off_t offset = (off_t)(MAPPED_INDEX_OFFSET + start * sizeof(uint32_t));
+        if (pread(mapped_fd, chunk, n * sizeof(uint32_t), offset) != (ssize_t)(n * sizeof(uint32_t))) {
+            ok = false;
+            break;
+        }
+        for (size_t i = 0; i < n; i++) {
+            if (chunk[i] == 0) continue;
+            if (chunk[i] == MAPPED_TOMBSTONE) {
+                table->entries[start + i] = TOMBSTONE;
+                tombstone_count++;
+                continue;
+            }
+            if (chunk[i] > header->pool_used) {
+                ok = false;
+                break;
+            }
+            table->entries[start + i] = &entry_pool->entries[chunk[i] - 1];
+            count++;
         }
-    } else {
-        resize_count = 0; // Başarılı bir işlem olduğunda sayacı sıfırla
     }
+    free(chunk);
     
-    // Hash'i hesaplayalım (find_slot zaten hesaplıyor ama yine de)
-    uint32_t key_hash = (uint32_t)hash(key);
-    
-    // Değeri güvenli bir şekilde kopyala
-    if (__builtin_expect(found, 1)) {
-        // SIMD ile değeri kopyala
-        simd_strcpy(table->entries[index]->value, value, MAX_VALUE_SIZE - 1);
-        table->entries[index]->value[MAX_VALUE_SIZE - 1] = '\0';
-        table->entries[index]->expire_at = 0;
-        // Hash değeri zaten mevcut
-    } else {
-        // Memory pool'dan yeni bir entry al
-        Entry* new_entry = pool_alloc();
-        if (__builtin_expect(!new_entry, 0)) {
-            pthread_mutex_unlock(&table->mutex);
-            if (logging_enabled) printf("ERROR: Failed to allocate new entry from pool\n");
-            return;
+    table->count = count;
+    return ok && count == header->table_count;
+}
+
+static bool mapped_store_index() {
+    uint32_t* chunk = malloc(MAPPED_INDEX_CHUNK * sizeof(uint32_t));
+    if (!chunk) return false;
+    
+    bool ok = true;
+    for (size_t start = 0; ok && start < table->size; start += MAPPED_INDEX_CHUNK) {
+        size_t n = table->size - start < MAPPED_INDEX_CHUNK ? table->size - start : MAPPED_INDEX_CHUNK;
+        for (size_t i = 0; i < n; i++) {
+            Entry* entry = table->entries[start + i];
+            if (entry == TOMBSTONE) chunk[i] = MAPPED_TOMBSTONE;
+            else chunk[i] = entry ? (uint32_t)(entry - entry_pool->entries) + 1 : 0;
         }
-        
-        // SIMD ile anahtarı ve değeri kopyala
-        simd_strcpy(new_entry->key, key, MAX_KEY_SIZE - 1);
-        new_entry->key[MAX_KEY_SIZE - 1] = '\0';
-        simd_strcpy(new_entry->value, value, MAX_VALUE_SIZE - 1);
-        new_entry->value[MAX_VALUE_SIZE - 1] = '\0';
-        new_entry->expire_at = 0;
-        new_entry->hash = key_hash; // Hash değerini kaydet
-        
-        // Entry'yi tabloya ekle
-        table->entries[index] = new_entry;
-        table->count++;
+        off_t offset = (off_t)(MAPPED_INDEX_OFFSET + start * sizeof(uint32_t));
+        ok = pwrite(mapped_fd, chunk, n * sizeof(uint32_t), offset) == (ssize_t)(n * sizeof(uint32_t));
     }
+    free(chunk);
+    return ok;
+}
 
-    pthread_mutex_unlock(&table->mutex);
+static void mapped_unmap() {
+    if (mapped_base) munmap(mapped_base, mapped_size);
+    if (mapped_fd >= 0) close(mapped_fd);
+    mapped_base = NULL;
+    mapped_size = 0;
+    mapped_fd = -1;
 }
 
-void kv_set_with_ttl(const char* key, const char* value, int ttl_seconds) {
-    if (__builtin_expect(!table || !key || !value, 0)) return;
+bool kv_init_mapped(const char* path, bool* restored, long* log_offset) {
+    *restored = false;
+    *log_offset = 0;
+    if (__builtin_expect(table != NULL, 0)) {
+        kv_cleanup();
+    }
+    
+    arena_init();
+    entry_pool = arena_alloc(sizeof(EntryPool));
+    if (__builtin_expect(!entry_pool, 0)) return false;
+    
+    // Havuz ve serbest liste dosyadan map edilir; sparse dosya sadece kullanılan sayfalar kadar yer tutar
+    struct stat st;
+    mapped_fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (mapped_fd < 0 || fstat(mapped_fd, &st) != 0 ||
+        ((size_t)st.st_size < MAPPED_INDEX_OFFSET && ftruncate(mapped_fd, MAPPED_INDEX_OFFSET) != 0)) {
+        if (logging_enabled) printf("ERROR: Failed to open mapped table file %s\n", path);
+        mapped_unmap();
+        entry_pool = NULL;
+        return false;
+    }
+    
+    mapped_size = MAPPED_INDEX_OFFSET;
+    mapped_base = mmap(NULL, mapped_size, PROT_READ | PROT_WRITE, MAP_SHARED, mapped_fd, 0);
+    if (mapped_base == MAP_FAILED) {
+        if (logging_enabled) printf("ERROR: Failed to map table file %s\n", path);
+        mapped_base = NULL;
+        mapped_unmap();
+        entry_pool = NULL;
+        return false;
+    }
+    
+    MappedHeader* header = (MappedHeader*)mapped_base;
+    bool restore = mapped_header_valid(header, (size_t)st.st_size);
+    
+    entry_pool->entries = (Entry*)(mapped_base + MAPPED_ENTRIES_OFFSET);
+    entry_pool->free_indices = (size_t*)(mapped_base + MAPPED_FREE_OFFSET);
+    entry_pool->size = ENTRY_POOL_SIZE;
+    entry_pool->used = restore ? header->pool_used : 0;
+    entry_pool->free_count = restore ? header->free_count : 0;
+    pthread_mutex_init(&entry_pool->mutex, NULL);
+    
+    if (!table_init(restore ? header->table_size : INITIAL_TABLE_SIZE)) {
+        pool_cleanup();
+        mapped_unmap();
+        return false;
+    }
+    
+    if (restore && !mapped_load_index(header)) {
+        // İndeks bozuk: dosya boş havuz olarak yeniden kullanılır
+        if (logging_enabled) printf("WARN: Mapped table index is invalid, starting empty\n");
+        memset(table->entries, 0, table->size * sizeof(Entry*));
+        table->count = 0;
+        tombstone_count = 0;
+        entry_pool->used = 0;
+        entry_pool->free_count = 0;
+        restore = false;
+    }
+    
+    if (restore) {
+        *log_offset = (long)header->log_offset;
+        // Yeni yazmalar dosyadaki sürümleri tekrar kullanmamalı
+        if (header->max_version > version_counter) version_counter = header->max_version;
+    }
+    
+    // Çalışırken dosya kirli sayılır; kapanmadan çökerse bir sonraki açılış onu kullanmaz
+    memcpy(header->magic, MAPPED_MAGIC, sizeof(header->magic));
+    header->version = MAPPED_VERSION;
+    header->entry_size = sizeof(Entry);
+    header->pool_size = ENTRY_POOL_SIZE;
+    header->clean = 0;
+    msync(mapped_base, MAPPED_PAGE, MS_SYNC);
+    
+    *restored = restore;
+    if (logging_enabled) printf("DEBUG: Mapped table %s %s with %zu entries\n", path,
+                                restore ? "restored" : "initialized", table->count);
+    
+    start_cleanup_thread();
+    return table != NULL;
+}
 
+bool kv_close_mapped(long log_offset) {
+    if (!mapped_base || !table) return false;
+    
+    // Temizlik thread'i indeks yazılırken entry silmemeli
+    stop_cleanup_thread();
+    
     pthread_mutex_lock(&table->mutex);
+    MappedHeader* header = (MappedHeader*)mapped_base;
+    bool ok = mapped_store_index();
+    header->pool_used = entry_pool->used;
+    header->free_count = entry_pool->free_count;
+    header->table_size = table->size;
+    header->table_count = table->count;
+    header->log_offset = log_offset;
+    header->max_version = version_counter;
+    pthread_mutex_unlock(&table->mutex);
+    
+    // Önce veri, sonra temiz bayrağı diske inmeli
+    ok = ok && fsync(mapped_fd) == 0 && msync(mapped_base, mapped_size, MS_SYNC) == 0;
+    if (ok) {
+        header->clean = 1;
+        ok = msync(mapped_base, MAPPED_PAGE, MS_SYNC) == 0;
+    }
     
+    kv_cleanup();
+    return ok;
+}
+
+bool kv_is_mapped() {
+    return mapped_base != NULL;
+}
+
+// Toplu yazmada havuzdan önceden ayrılmış entry'ler; bitince pool_alloc'a düşülür
+typedef struct {
+    Entry** entries;
+    size_t count;
+} EntryReserve;
+
+// Anahtarı yazar; table->mutex tutulurken çağrılır ve kilidi bırakmaz (gerekirse tablo
+// kilit altında büyütülür). Entry ayrılamazsa false.
+static bool set_locked(const char* key, const char* value, time_t expire_at, EntryReserve* reserve) {
     bool found;
     size_t index = find_slot(key, &found);
     
+    // Doluluğu silinen yuvalar artırıyorsa tablo büyütülmeden temizlenir
+    if (__builtin_expect(!found && (double)(table->count + tombstone_count + 1) / table->size > 0.60 &&
+                         (double)(table->count + 1) / table->size <= 0.60, 0)) {
+        clear_tombstones_locked();
+        index = find_slot(key, &found);
+    }
+    
     // Tablo doluluk oranını kontrol et
     // Sonsuz döngüden kaçınmak için resize işlemini sınırla
     static int resize_count = 0;
     const int MAX_CONSECUTIVE_RESIZES = 3;
     
-    if (__builtin_expect(!found && (double)(table->count + 1) / table->size > 0.60, 0)) {
+    if (__builtin_expect(!found && (double)(table->count + 1) / table->size > 0.60 &&
+                         table->size < MAX_TABLE_SIZE, 0)) {
         resize_count++;
         if (resize_count <= MAX_CONSECUTIVE_RESIZES) {
-            pthread_mutex_unlock(&table->mutex);
-            kv_resize(table->size * GROWTH_FACTOR);
-            pthread_mutex_lock(&table->mutex);
+            resize_locked(table->size * GROWTH_FACTOR);
             index = find_slot(key, &found);
         } else {
-            if (logging_enabled) printf("WARN: Too many consecutive resizes, skipping resize for key with TTL: %s\n", key);
+            if (logging_enabled) printf("WARN: Too many consecutive resizes, skipping resize for key: %s\n", key);
             resize_count = 0; // Sayacı sıfırla
         }
     } else {
         resize_count = 0; // Başarılı bir işlem olduğunda sayacı sıfırla
     }
     
-    // Hash'i hesaplayalım
+    // Hash'i hesaplayalım (find_slot zaten hesaplıyor ama yine de)
     uint32_t key_hash = (uint32_t)hash(key);
     
+    // Değeri güvenli bir şekilde kopyala
     if (__builtin_expect(found, 1)) {
         // SIMD ile değeri kopyala
         simd_strcpy(table->entries[index]->value, value, MAX_VALUE_SIZE - 1);
         table->entries[index]->value[MAX_VALUE_SIZE - 1] = '\0';
-        table->entries[index]->expire_at = ttl_seconds > 0 ? time(NULL) + ttl_seconds : 0;
+        table->entries[index]->expire_at = expire_at;
+        table->entries[index]->version = ++version_counter;
+        mark_dirty(table->entries[index]);
         // Hash değeri zaten mevcut
     } else {
         // Memory pool'dan yeni bir entry al
-        Entry* new_entry = pool_alloc();
+        Entry* new_entry = reserve && reserve->count > 0 ? reserve->entries[--reserve->count] : pool_alloc();
         if (__builtin_expect(!new_entry, 0)) {
-            pthread_mutex_unlock(&table->mutex);
             if (logging_enabled) printf("ERROR: Failed to allocate new entry from pool\n");
-            return;
+            return false;
         }
         
         // SIMD ile anahtarı ve değeri kopyala
@@ -552,15 +904,65 @@ void kv_set_with_ttl(const char* key, const char* value, int ttl_seconds) {
         new_entry->key[MAX_KEY_SIZE - 1] = '\0';
         simd_strcpy(new_entry->value, value, MAX_VALUE_SIZE - 1);
         new_entry->value[MAX_VALUE_SIZE - 1] = '\0';
-        new_entry->expire_at = ttl_seconds > 0 ? time(NULL) + ttl_seconds : 0;
+        new_entry->expire_at = expire_at;
         new_entry->hash = key_hash; // Hash değerini kaydet
+        new_entry->in_use = 1;
+        new_entry->version = ++version_counter;
+        mark_dirty(new_entry);
         
         // Entry'yi tabloya ekle
+        if (table->entries[index] == TOMBSTONE) tombstone_count--;
         table->entries[index] = new_entry;
         table->count++;
     }
+    __atomic_add_fetch(&write_count, 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+// Yazılacak count yeni anahtar için tabloyu önceden büyütür; table->mutex tutulurken
+// çağrılır. Böylece sonraki yazmalar yarıda resize yapmaz
+static void grow_locked(size_t count) {
+    for (int attempt = 0; attempt < 3 && (double)(table->count + count) / table->size > 0.60 &&
+                          table->size < MAX_TABLE_SIZE; attempt++) {
+        resize_locked(table->size * GROWTH_FACTOR);
+    }
+}
+
+// Anahtarın süresi dolmamış entry'si; table->mutex tutulurken çağrılır
+static Entry* find_live_locked(const char* key) {
+    bool found;
+    size_t index = find_slot(key, &found);
+    if (!found) return NULL;
+    Entry* entry = table->entries[index];
+    if (entry->expire_at > 0 && time(NULL) > entry->expire_at) return NULL;
+    return entry;
+}
 
+static bool watches_hold_locked(const KvWatch* watches, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        Entry* entry = find_live_locked(watches[i].key);
+        if ((entry ? entry->version : 0) != watches[i].version) return false;
+    }
+    return true;
+}
+
+void kv_set(const char* key, const char* value) {
+    if (__builtin_expect(!table || !key || !value, 0)) return;
+
+    pthread_mutex_lock(&table->mutex);
+    bool stored = set_locked(key, value, 0, NULL);
     pthread_mutex_unlock(&table->mutex);
+    if (stored && invalidation_hook) invalidation_hook(key);
+}
+
+void kv_set_with_ttl(const char* key, const char* value, int ttl_seconds) {
+    if (__builtin_expect(!table || !key || !value, 0)) return;
+
+    time_t expire_at = ttl_seconds > 0 ? time(NULL) + ttl_seconds : 0;
+    pthread_mutex_lock(&table->mutex);
+    bool stored = set_locked(key, value, expire_at, NULL);
+    pthread_mutex_unlock(&table->mutex);
+    if (stored && invalidation_hook) invalidation_hook(key);
 }
 
 const char* kv_get(const char* key) {
@@ -584,7 +986,7 @@ const char* kv_get(const char* key) {
         bool manual_found = false;
         size_t manual_index = 0;
         for (size_t i = 0; i < table->size; i++) {
-            if (table->entries[i] != NULL && strcmp(table->entries[i]->key, key) == 0) {
+            if (table->entries[i] != NULL && table->entries[i] != TOMBSTONE && strcmp(table->entries[i]->key, key) == 0) {
                 manual_found = true;
                 manual_index = i;
                 printf("DEBUG: Manually found problem key at index %zu\n", i);
@@ -606,10 +1008,12 @@ const char* kv_get(const char* key) {
     if (__builtin_expect(table->entries[index]->expire_at > 0 && now > table->entries[index]->expire_at, 0)) {
         // Süresi dolmuş entry
         Entry* expired_entry = table->entries[index];
-        table->entries[index] = NULL;
+        table->entries[index] = TOMBSTONE;
+        tombstone_count++;
         pool_free(expired_entry);
         table->count--;
         pthread_mutex_unlock(&table->mutex);
+        if (invalidation_hook) invalidation_hook(key);
         return NULL;
     }
     
@@ -621,46 +1025,293 @@ const char* kv_get(const char* key) {
     return value_buffer;
 }
 
+// Anahtarı tablodan çıkarır; table->mutex tutulurken çağrılır. Entry kullanım dışı
+// işaretlenir, havuz indeksi serbest listeye eklenmek üzere *freed'e yazılır.
+static bool del_locked(const char* key, size_t* freed) {
+    bool found;
+    size_t index = find_slot(key, &found);
+    if (__builtin_expect(!found, 0)) return false;
+    
+    Entry* entry_to_free = table->entries[index];
+    table->entries[index] = TOMBSTONE;
+    tombstone_count++;
+    table->count--;
+    __atomic_add_fetch(&write_count, 1, __ATOMIC_RELAXED);
+    return retire_entry(entry_to_free, freed);
+}
+
 void kv_del(const char* key) {
     if (__builtin_expect(!table || !key, 0)) return;
 
     pthread_mutex_lock(&table->mutex);
+    size_t freed;
+    bool found = del_locked(key, &freed);
+    if (found) pool_release_indices(&freed, 1);
+    pthread_mutex_unlock(&table->mutex);
+    if (found && invalidation_hook) invalidation_hook(key);
+}
+
+// kv_get_many'de yürütülen tek aramanın durumu. find_slot ile aynı yoklama sırasını izler
+typedef struct {
+    size_t key;             // Penceredeki anahtar sırası
+    uint32_t hash;
+    size_t index;
+    size_t step;
+    size_t probes;
+    Entry* entry;           // Getirilmekte olan entry; NULL ise sıradaki adım yuva okumasıdır
+} LookupState;
+
+static inline void lookup_start(LookupState* state, const char* const* keys, size_t key) {
+    state->key = key;
+    state->hash = (uint32_t)hash(keys[key]);
+    state->index = state->hash % table->size;
+    state->step = 1 + (state->hash % (table->size - 1));
+    state->probes = 0;
+    state->entry = NULL;
+    __builtin_prefetch(&table->entries[state->index]);
+}
+
+// Sonraki yuvaya geçer ve onu önceden getirir; prob sınırı aşıldıysa false
+static inline bool lookup_advance(LookupState* state, size_t max_probes) {
+    if (++state->probes >= max_probes) return false;
+    state->index += state->step;
+    if (state->index >= table->size) state->index -= table->size;
+    state->entry = NULL;
+    __builtin_prefetch(&table->entries[state->index]);
+    return true;
+}
+
+// Anahtarları AMAC tarzında arar: KV_LOOKUP_GROUP arama aynı anda yürür, her adım
+// (yuva, sonra entry'nin hash ve anahtar satırları) okunmadan önce önceden getirilir ve
+// okuma diğer aramalar birer adım ilerledikten sonra yapılır. Biten aramanın yerine
+// hemen sıradaki anahtar başlar, böylece DRAM gecikmeleri üst üste biner.
+// table->mutex tutulurken çağrılır; results[i] keys[i]'nin entry'si ya da NULL olur
+static void lookup_window(const char* const* keys, size_t count, Entry** results) {
+    const size_t max_probes = table->size > 1000 ? 100 : table->size / 10;
+    LookupState states[KV_LOOKUP_GROUP];
+    size_t active = 0;
+    size_t next = 0;
+    while (active < KV_LOOKUP_GROUP && next < count) lookup_start(&states[active++], keys, next++);
+    
+    while (active > 0) {
+        for (size_t g = 0; g < active;) {
+            LookupState* state = &states[g];
+            Entry* entry = state->entry;
+            bool done;
+            if (!entry) {
+                entry = table->entries[state->index];
+                if (!entry) {
+                    done = true;
+                } else if (entry == TOMBSTONE) {
+                    entry = NULL;
+                    done = !lookup_advance(state, max_probes);
+                } else {
+                    state->entry = entry;
+                    __builtin_prefetch(&entry->hash);
+                    __builtin_prefetch(entry->key);
+                    done = false;
+                    entry = NULL;
+                }
+            } else if (entry->hash == state->hash && simd_strcmp(entry->key, keys[state->key]) == 0) {
+                // Değer geri çağırmada kopyalanacak
+                __builtin_prefetch(entry->value);
+                done = true;
+            } else {
+                entry = NULL;
+                done = !lookup_advance(state, max_probes);
+            }
+            
+            if (!done) {
+                g++;
+                continue;
+            }
+            results[state->key] = entry;
+            if (next < count) {
+                lookup_start(state, keys, next++);
+                g++;
+            } else {
+                *state = states[--active];
+            }
+        }
+    }
+}
+
+void kv_get_many(const char* const* keys, size_t count,
+                 void (*on_value)(void* ctx, size_t index, const char* value), void* ctx) {
+    if (__builtin_expect(!table || !keys, 0)) return;
+    
+    Entry* results[KV_LOOKUP_WINDOW];
+    time_t now = time(NULL);
+    pthread_mutex_lock(&table->mutex);
+    for (size_t start = 0; start < count; start += KV_LOOKUP_WINDOW) {
+        size_t n = count - start < KV_LOOKUP_WINDOW ? count - start : KV_LOOKUP_WINDOW;
+        lookup_window(keys + start, n, results);
+        // Süresi dolmuş entry'ler yok sayılır; silinmeleri temizlik thread'ine kalır
+        for (size_t i = 0; i < n; i++) {
+            Entry* entry = results[i];
+            if (entry && entry->expire_at > 0 && now > entry->expire_at) entry = NULL;
+            on_value(ctx, start + i, entry ? entry->value : NULL);
+        }
+    }
+    pthread_mutex_unlock(&table->mutex);
+}
+
+uint64_t kv_get_version(const char* key) {
+    if (__builtin_expect(!table || !key, 0)) return 0;
     
-    bool found;
-    size_t index = find_slot(key, &found);
+    pthread_mutex_lock(&table->mutex);
+    Entry* entry = find_live_locked(key);
+    uint64_t version = entry ? entry->version : 0;
+    pthread_mutex_unlock(&table->mutex);
+    return version;
+}
+
+const char* kv_get_versioned(const char* key, uint64_t* version) {
+    *version = 0;
+    if (__builtin_expect(!table || !key, 0)) return NULL;
     
-    if (__builtin_expect(found, 1)) {
-        Entry* entry_to_free = table->entries[index];
-        table->entries[index] = NULL;
-        pool_free(entry_to_free);
-        table->count--;
+    pthread_mutex_lock(&table->mutex);
+    Entry* entry = find_live_locked(key);
+    if (entry) {
+        simd_strcpy(value_buffer, entry->value, MAX_VALUE_SIZE - 1);
+        value_buffer[MAX_VALUE_SIZE - 1] = '\0';
+        *version = entry->version;
     }
+    pthread_mutex_unlock(&table->mutex);
+    return entry ? value_buffer : NULL;
+}
+
+bool kv_cas(const char* key, uint64_t expected_version, const char* value, uint64_t* version) {
+    *version = 0;
+    if (__builtin_expect(!table || !key || !value, 0)) return false;
+    
+    // Büyütme, kontrol ve yazma tek kilit süresindedir; arada başka yazma araya giremez
+    pthread_mutex_lock(&table->mutex);
+    grow_locked(1);
+    Entry* entry = find_live_locked(key);
+    uint64_t current = entry ? entry->version : 0;
+    bool stored = current == expected_version && set_locked(key, value, 0, NULL);
+    *version = stored ? version_counter : current;
+    pthread_mutex_unlock(&table->mutex);
     
+    if (stored && invalidation_hook) invalidation_hook(key);
+    return stored;
+}
+
+bool kv_getset(const char* key, const char* value, const char** old_value) {
+    *old_value = NULL;
+    if (__builtin_expect(!table || !key || !value, 0)) return false;
+    
+    pthread_mutex_lock(&table->mutex);
+    grow_locked(1);
+    Entry* entry = find_live_locked(key);
+    if (entry) {
+        simd_strcpy(value_buffer, entry->value, MAX_VALUE_SIZE - 1);
+        value_buffer[MAX_VALUE_SIZE - 1] = '\0';
+    }
+    bool stored = set_locked(key, value, 0, NULL);
     pthread_mutex_unlock(&table->mutex);
+    
+    if (stored) {
+        *old_value = entry ? value_buffer : NULL;
+        if (invalidation_hook) invalidation_hook(key);
+    }
+    return stored;
+}
+
+bool kv_apply_batch(const KvWatch* watches, size_t watch_count,
+                    const KvBatchOp* ops, size_t count, bool* changed) {
+    if (__builtin_expect(!table || (count > 0 && !ops), 0)) return false;
+    
+    // Yeni anahtarlar için entry'ler havuzdan tek seferde alınır; güncellenen anahtarlar
+    // için kullanılmayanlar ve silinenler sonda yine tek seferde geri verilir
+    Entry* reserve_stack[KV_BATCH_STACK];
+    size_t freed_stack[KV_BATCH_STACK];
+    size_t sets = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (ops[i].value) sets++;
+    }
+    Entry** reserved = sets <= KV_BATCH_STACK ? reserve_stack : malloc(sets * sizeof(Entry*));
+    size_t* freed = count <= KV_BATCH_STACK ? freed_stack : malloc(count * sizeof(size_t));
+    if (__builtin_expect(!reserved || !freed, 0)) {
+        // Bellek yoksa ön ayırma atlanır: entry'ler set_locked içinde tek tek alınır,
+        // silinenler hemen geri verilir; batch yine tek kilit süresinde uygulanır
+        if (reserved != reserve_stack) free(reserved);
+        if (freed != freed_stack) free(freed);
+        reserved = NULL;
+        freed = NULL;
+    }
+    EntryReserve reserve = { reserved, reserved ? pool_alloc_many(reserved, sets) : 0 };
+    size_t freed_count = 0;
+    time_t now = time(NULL);
+    
+    pthread_mutex_lock(&table->mutex);
+    
+    // Eklemeler ortada resize gerektirmesin diye tablo önceden büyütülür; böylece batch
+    // tek kilit süresinde uygulanır
+    grow_locked(sets);
+    
+    bool hold = watches_hold_locked(watches, watch_count);
+    for (size_t i = 0; hold && i < count; i++) {
+        bool applied;
+        if (ops[i].value) {
+            applied = set_locked(ops[i].key, ops[i].value, ops[i].ttl > 0 ? now + ops[i].ttl : 0, &reserve);
+        } else {
+            size_t freed_index;
+            if ((applied = del_locked(ops[i].key, &freed_index))) {
+                if (freed) freed[freed_count++] = freed_index;
+                else pool_release_indices(&freed_index, 1);
+            }
+        }
+        if (changed) changed[i] = applied;
+        // kv_purge_expired'daki gibi kilit tutulurken bildirilir (kilit sırası kancanın tarafında)
+        if (applied && invalidation_hook) invalidation_hook(ops[i].key);
+    }
+    if (!hold && changed) memset(changed, 0, count * sizeof(bool));
+    for (size_t i = 0; i < reserve.count; i++) {
+        freed[freed_count++] = (size_t)(reserve.entries[i] - entry_pool->entries);
+    }
+    pool_release_indices(freed, freed_count);
+    
+    pthread_mutex_unlock(&table->mutex);
+    
+    if (reserved && reserved != reserve_stack) free(reserved);
+    if (freed && freed != freed_stack) free(freed);
+    return hold;
 }
 
 void kv_cleanup() {
     if (__builtin_expect(!table, 0)) return;
     
-    cleanup_running = false;
-    pthread_join(cleanup_thread, NULL);
+    stop_cleanup_thread();
+    
+    // Tablo bütünüyle yok ediliyor; silinenleri tek tek kaydetmeye gerek yok
+    bool tracking = change_tracking;
+    change_tracking = false;
     
     // Tüm entry'leri serbest bırak
     // Not: Aslında entry'leri tek tek serbest bırakmaya gerek yok 
     // çünkü arena_reset/cleanup zaten tüm belleği temizleyecek, 
-    // ama pool'a ayrı ayrı free işaretliyoruz
-    for (size_t i = 0; i < table->size; i++) {
-        if (table->entries[i] != NULL) {
+    // ama pool'a ayrı ayrı free işaretliyoruz.
+    // Map edilmiş havuzda entry'ler dosyada kalmalı, bu yüzden dokunulmaz.
+    for (size_t i = 0; !mapped_base && i < table->size; i++) {
+        if (table->entries[i] != NULL && table->entries[i] != TOMBSTONE) {
             pool_free(table->entries[i]);
             table->entries[i] = NULL;
         }
     }
     
+    kv_reset_changes_locked();
+    change_tracking = tracking;
+    
     pthread_mutex_destroy(&table->mutex);
     table = NULL;
+    // Sonraki tablo sürümleri yeniden başlatılmış bir süreçteki gibi sıfırdan sayar
+    version_counter = 0;
     
     // Memory pool'u ve arena allocator'ı temizle
     pool_cleanup();
+    mapped_unmap();
     arena_reset(); // Tüm alanı sıfırla ancak belleği serbest bırakma
     
     // Programın sonunda çağrılacak - tüm belleği serbest bırak
@@ -669,6 +1320,16 @@ void kv_cleanup() {
 
 void kv_resize(size_t new_size) {
     if (__builtin_expect(!table, 0)) return;
+    
+    pthread_mutex_lock(&table->mutex);
+    resize_locked(new_size);
+    pthread_mutex_unlock(&table->mutex);
+}
+
+// Tabloyu yeniden boyutlandırır; table->mutex tutulurken çağrılır ve taşıma boyunca
+// bırakılmaz. Yeni dizi kilit altında doldurulduğu için diğer thread'ler yarı taşınmış
+// tabloyu görmez ve aynı anahtarı ikinci kez ekleyemez
+static void resize_locked(size_t new_size) {
     if (__builtin_expect(new_size < INITIAL_TABLE_SIZE, 0)) new_size = INITIAL_TABLE_SIZE;
     if (__builtin_expect(new_size > MAX_TABLE_SIZE, 0)) new_size = MAX_TABLE_SIZE;
     
@@ -681,18 +1342,13 @@ void kv_resize(size_t new_size) {
     
     if (logging_enabled) printf("INFO: Resizing table from %zu to %zu\n", table->size, new_size);
     
-    pthread_mutex_lock(&table->mutex);
-    
     Entry** old_entries = table->entries;
     size_t old_size = table->size;
     size_t old_count = table->count;
     
     // Arena allocator kullanarak yeni entries dizisi oluştur
     Entry** new_entries = arena_alloc(new_size * sizeof(Entry*));
-    if (__builtin_expect(!new_entries, 0)) {
-        pthread_mutex_unlock(&table->mutex);
-        return;
-    }
+    if (__builtin_expect(!new_entries, 0)) return;
     
     // Yeni diziyi sıfırla
     memset(new_entries, 0, new_size * sizeof(Entry*));
@@ -700,9 +1356,7 @@ void kv_resize(size_t new_size) {
     table->entries = new_entries;
     table->size = new_size;
     table->count = 0;
-    
-    // Kilidi geçici olarak serbest bırak - yeni boyut ayarlandı
-    pthread_mutex_unlock(&table->mutex);
+    tombstone_count = 0;
     
     // Eski değerleri yeni tabloya yükle
     time_t now = time(NULL);
@@ -712,7 +1366,7 @@ void kv_resize(size_t new_size) {
     bool problem_key_found = false; // resize_key_3205 için kontrol
     
     for (size_t i = 0; i < old_size; i++) {
-        if (__builtin_expect(old_entries[i] != NULL, 0)) {
+        if (__builtin_expect(old_entries[i] != NULL && old_entries[i] != TOMBSTONE, 0)) {
             // Özel anahtarı kontrol et (sorunlu anahtar)
             bool is_problem_key = strncmp(old_entries[i]->key, "resize_key_3205", 15) == 0;
             if (is_problem_key) {
@@ -723,8 +1377,6 @@ void kv_resize(size_t new_size) {
             // Süresi dolmamış olanları ekle
             if (__builtin_expect(old_entries[i]->expire_at == 0 || old_entries[i]->expire_at > now, 1)) {
                 // Doğrudan insert et, kv_set kullanma (recursive resize önlenir)
-                pthread_mutex_lock(&table->mutex);
-                
                 // Mevcut hash değerini kullan
                 uint32_t key_hash = old_entries[i]->hash;
                 
@@ -757,7 +1409,6 @@ void kv_resize(size_t new_size) {
                     if (logging_enabled || is_problem_key) {
                         printf("ERROR: Failed to find slot during resize for key: %s\n", old_entries[i]->key);
                     }
-                    pthread_mutex_unlock(&table->mutex);
                     pool_free(old_entries[i]);
                     continue;
                 }
@@ -772,8 +1423,6 @@ void kv_resize(size_t new_size) {
                     printf("DEBUG: Problem key placed at index %zu after %zu probes\n", 
                            index, probe_count);
                 }
-                
-                pthread_mutex_unlock(&table->mutex);
             } else {
                 // Süresi dolmuş entry'yi havuza geri ver
                 pool_free(old_entries[i]);
@@ -791,15 +1440,12 @@ void kv_resize(size_t new_size) {
         printf("DEBUG: After resize - problem key search result: found=%d, index=%zu\n", found, index);
     }
     
-    // Count değeri yeni taşınandan farklıysa, kilitle ve düzelt
-    pthread_mutex_lock(&table->mutex);
     if (__builtin_expect(table->count != old_count, 0)) {
         if (logging_enabled) {
             printf("INFO: Resize changed count from %zu to %zu (moved %zu entries)\n", 
                    old_count, table->count, successfully_moved);
         }
     }
-    pthread_mutex_unlock(&table->mutex);
     
     if (logging_enabled) {
         printf("INFO: Resize completed: %zu -> %zu, moved %zu / %zu entries\n", 
@@ -807,6 +1453,119 @@ void kv_resize(size_t new_size) {
     }
 }
 
+// Entry havuzunu parça parça kopyalar. Tablo indeksleri yerine havuz indeksleri
+// üzerinden ilerlendiği için tarama sırasında yapılan resize'lar imleci bozmaz;
+// kilit sadece bir parçanın kopyalanması süresince tutulur.
+size_t kv_scan_entries(size_t* cursor, Entry* out, size_t max) {
+    if (__builtin_expect(!table || !entry_pool || !cursor || !out, 0)) return 0;
+    
+    time_t now = time(NULL);
+    size_t copied = 0;
+    
+    pthread_mutex_lock(&table->mutex);
+    
+    size_t used = entry_pool->used;
+    size_t i = *cursor;
+    for (; i < used && copied < max; i++) {
+        Entry* entry = &entry_pool->entries[i];
+        if (!entry->in_use) continue;
+        if (entry->expire_at > 0 && now > entry->expire_at) continue;
+        memcpy(&out[copied++], entry, sizeof(Entry));
+    }
+    
+    pthread_mutex_unlock(&table->mutex);
+    
+    *cursor = i;
+    return copied;
+}
+
+unsigned long long kv_write_count() {
+    return __atomic_load_n(&write_count, __ATOMIC_RELAXED);
+}
+
+void kv_set_invalidation_hook(void (*hook)(const char* key)) {
+    invalidation_hook = hook;
+}
+
+void kv_set_change_tracking(bool enabled) {
+    if (table) pthread_mutex_lock(&table->mutex);
+    change_tracking = enabled;
+    kv_reset_changes_locked();
+    if (table) pthread_mutex_unlock(&table->mutex);
+}
+
+bool kv_changes_overflowed() {
+    pthread_mutex_lock(&change_mutex);
+    bool overflowed = changes_overflowed;
+    pthread_mutex_unlock(&change_mutex);
+    return overflowed;
+}
+
+size_t kv_change_count() {
+    pthread_mutex_lock(&change_mutex);
+    size_t count = dirty_count + deleted_count;
+    pthread_mutex_unlock(&change_mutex);
+    return count;
+}
+
+// Tüm değişiklik kayıtlarını unutur (tam snapshot alındığında).
+// Çağıran table->mutex'i tutmalı ki araya yazma girmesin.
+void kv_reset_changes_locked() {
+    pthread_mutex_lock(&change_mutex);
+    if (entry_pool) {
+        for (size_t i = 0; i < dirty_count; i++) {
+            entry_pool->entries[dirty_indices[i]].flags &= ~ENTRY_FLAG_DIRTY;
+        }
+    }
+    for (size_t i = 0; i < deleted_count; i++) {
+        free(deleted_keys[i]);
+    }
+    free(dirty_indices);
+    free(deleted_keys);
+    dirty_indices = NULL;
+    deleted_keys = NULL;
+    dirty_count = dirty_cap = 0;
+    deleted_count = deleted_cap = 0;
+    changes_overflowed = false;
+    pthread_mutex_unlock(&change_mutex);
+}
+
+// Son snapshot'tan beri yapılan değişiklikleri sırayla ziyaret eder ve sıfırlar:
+// önce silinen anahtarlar, sonra değişen entry'ler. Böylece sil-yeniden ekle
+// sırası uygulamada korunur. Ziyaret edilen entry sayısını döner.
+size_t kv_drain_changes(void (*on_set)(const Entry* entry, void* ctx),
+                        void (*on_del)(const char* key, void* ctx), void* ctx) {
+    if (__builtin_expect(!table || !entry_pool, 0)) return 0;
+    
+    time_t now = time(NULL);
+    size_t visited = 0;
+    
+    pthread_mutex_lock(&table->mutex);
+    pthread_mutex_lock(&change_mutex);
+    
+    for (size_t i = 0; i < deleted_count; i++) {
+        on_del(deleted_keys[i], ctx);
+        visited++;
+    }
+    
+    for (size_t i = 0; i < dirty_count; i++) {
+        Entry* entry = &entry_pool->entries[dirty_indices[i]];
+        // Silinmiş ya da aynı indeks iki kez listelenmiş olabilir
+        if (!entry->in_use || !(entry->flags & ENTRY_FLAG_DIRTY)) continue;
+        entry->flags &= ~ENTRY_FLAG_DIRTY;
+        // Süresi dolan anahtar silinmiş sayılır; atlanırsa önceki snapshot'taki değeri geri gelir
+        if (entry->expire_at > 0 && now > entry->expire_at) on_del(entry->key, ctx);
+        else on_set(entry, ctx);
+        visited++;
+    }
+    
+    pthread_mutex_unlock(&change_mutex);
+    kv_reset_changes_locked();
+    pthread_mutex_unlock(&table->mutex);
+    
+    return visited;
+}
+
 // Yardımcı fonksiyonlar
 size_t kv_get_size() {
     return table ? table->size : 0;
@@ -848,6 +1607,7 @@ void arena_init() {
     global_arena->block_count = 0;
     global_arena->current_block = 0;
     global_arena->current_offset = 0;
+    global_arena->large_count = 0;
     
     for (size_t i = 0; i < ARENA_MAX_BLOCKS; i++) {
         global_arena->blocks[i] = NULL;
@@ -880,9 +1640,18 @@ void* arena_alloc(size_t size) {
         if (!global_arena) return NULL;
     }
     
-    // Büyük allocationsları doğrudan işleyelim
+    // Büyük allocationsları doğrudan işleyelim - calloc sayfaları tembel sıfırlar,
+    // arena_cleanup'ta serbest bırakabilmek için de kaydını tutuyoruz
     if (__builtin_expect(size > ARENA_BLOCK_SIZE / 4, 0)) {
-        return malloc(size);
+        void* large = calloc(1, size);
+        if (large) {
+            pthread_mutex_lock(&global_arena->mutex);
+            if (global_arena->large_count < ARENA_MAX_LARGE_ALLOCS) {
+                global_arena->large_allocs[global_arena->large_count++] = large;
+            }
+            pthread_mutex_unlock(&global_arena->mutex);
+        }
+        return large;
     }
     
     pthread_mutex_lock(&global_arena->mutex);
@@ -942,9 +1711,15 @@ void arena_cleanup() {
         }
     }
     
+    for (size_t i = 0; i < global_arena->large_count; i++) {
+        free(global_arena->large_allocs[i]);
+        global_arena->large_allocs[i] = NULL;
+    }
+    
     global_arena->block_count = 0;
     global_arena->current_block = 0;
     global_arena->current_offset = 0;
+    global_arena->large_count = 0;
     
     pthread_mutex_unlock(&global_arena->mutex);
     pthread_mutex_destroy(&global_arena->mutex);
@@ -3,6 +3,7 @@
 //
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <pthread.h>
 
 #ifndef KV_STORE_H
@@ -16,6 +17,12 @@
 #define ENTRY_POOL_SIZE 1000000  // Entry pool boyutu - 1 milyon entry
 #define ARENA_BLOCK_SIZE (4 * 1024 * 1024)  // 4MB blok boyutu
 #define ARENA_MAX_BLOCKS 16     // Maksimum 16 blok (toplam 64MB)
+#define ARENA_MAX_LARGE_ALLOCS 64 // Arena dışında ayrılan büyük alanların takip sınırı
+#define CHANGE_MAX_DIRTY ENTRY_POOL_SIZE   // Takip edilen en fazla değişmiş entry
+#define CHANGE_MAX_DELETED 262144          // Takip edilen en fazla silinmiş anahtar
+#define KV_BATCH_STACK 64                  // kv_apply_batch'in heap kullanmadan işlediği işlem sayısı
+#define KV_LOOKUP_GROUP 16                 // kv_get_many'de iç içe yürütülen arama sayısı
+#define KV_LOOKUP_WINDOW 64                // kv_get_many'nin sonuçlarını toplayıp bildirdiği anahtar sayısı
 
 #include "entry.h"
 
@@ -25,6 +32,8 @@ typedef struct {
     size_t block_count;             // Toplam blok sayısı
     size_t current_offset;          // Şu anki blok içindeki pozisyon
     size_t current_block;           // Şu anki blok indeksi
+    void* large_allocs[ARENA_MAX_LARGE_ALLOCS]; // Blok boyutunu aşan doğrudan ayrılmış alanlar
+    size_t large_count;             // Takip edilen büyük alan sayısı
     pthread_mutex_t mutex;          // Eşzamanlılık kilidi
 } MemoryArena;
 
@@ -40,12 +49,25 @@ typedef struct {
 
 // Tablo yapısı
 typedef struct {
-    Entry** entries;          // Entry pointer array
+    Entry** entries;          // Entry pointer array (silinen yuvalar süresi dolmuş bir işareti gösterir)
     size_t size;              // Tablo boyutu
     size_t count;             // Kayıt sayısı
     pthread_mutex_t mutex;    // Tablo kilidi
 } HashTable;
 
+// kv_apply_batch'e verilen tek yazma işlemi
+typedef struct KvBatchOp {
+    const char* key;
+    const char* value;        // NULL: silme
+    int ttl;                  // > 0 ise saniye cinsinden yaşam süresi
+} KvBatchOp;
+
+// kv_apply_batch koşulu: anahtarın sürümü (yoksa 0) hâlâ version olmalı
+typedef struct KvWatch {
+    const char* key;
+    uint64_t version;
+} KvWatch;
+
 // Arena allocator işlemleri
 void arena_init();
 void* arena_alloc(size_t size);
@@ -64,6 +86,28 @@ void kv_set(const char *key, const char* value);
 void kv_set_with_ttl(const char* key, const char* value, int ttl_seconds);
 const char* kv_get(const char *key);
 void kv_del(const char *key);
+// Anahtarları tek table->mutex süresinde, aramaları iç içe yürüterek (yuva ve entry
+// önceden getirilir) arar ve her biri için sırayla on_value(ctx, index, value) çağırır
+// (yoksa value NULL). value yalnızca çağrı süresince geçerlidir; kilit tutulduğu için
+// geri çağırma kv fonksiyonlarını çağırmamalıdır
+void kv_get_many(const char* const* keys, size_t count,
+                 void (*on_value)(void* ctx, size_t index, const char* value), void* ctx);
+// Anahtarın sürümü; yoksa ya da süresi dolduysa 0
+uint64_t kv_get_version(const char* key);
+// kv_get gibi, ek olarak *version'a sürümü yazar (yoksa 0)
+const char* kv_get_versioned(const char* key, uint64_t* version);
+// Anahtarın sürümü expected_version ise (0: anahtar yoksa) yazar. *version'a yeni sürüm,
+// yazılmadıysa güncel sürüm yazılır
+bool kv_cas(const char* key, uint64_t expected_version, const char* value, uint64_t* version);
+// Yazar ve önceki değeri *old_value'ya verir (kv_get'in thread-local buffer'ı; yoksa NULL)
+bool kv_getset(const char* key, const char* value, const char** old_value);
+// İşlemleri sırayla, table->mutex ve havuz kilidini birer kez alarak uygular; diğer
+// thread'ler batch'in yarısını görmez (gerekirse resize de aynı kilit içinde yapılır).
+// watches'taki anahtarlardan biri değiştiyse hiçbir işlem uygulanmaz ve false döner.
+// changed NULL değilse her işlem için yazma yapıldı/silinecek anahtar vardı bilgisi yazılır;
+// havuz tükendiği için yazılamayan anahtarlarda false olur, diğer işlemler yine uygulanır
+bool kv_apply_batch(const KvWatch* watches, size_t watch_count,
+                    const KvBatchOp* ops, size_t count, bool* changed);
 void kv_load_from_file();
 void kv_purge_expired();
 void kv_cleanup();
@@ -74,6 +118,22 @@ size_t kv_get_size();
 size_t kv_get_count();
 double kv_get_load_factor();
 HashTable* kv_get_table();
+size_t kv_scan_entries(size_t* cursor, Entry* out, size_t max);
+unsigned long long kv_write_count();
+void kv_set_invalidation_hook(void (*hook)(const char* key)); // Değişen her anahtar için çağrılır
+
+// Kalıcı (mmap) tablo modu
+bool kv_init_mapped(const char* path, bool* restored, long* log_offset);
+bool kv_close_mapped(long log_offset);
+bool kv_is_mapped();
+
+// Snapshot'lar arası değişiklik takibi (delta snapshot için)
+void kv_set_change_tracking(bool enabled);
+bool kv_changes_overflowed();
+size_t kv_change_count();
+void kv_reset_changes_locked();
+size_t kv_drain_changes(void (*on_set)(const Entry* entry, void* ctx),
+                        void (*on_del)(const char* key, void* ctx), void* ctx);
 
 extern bool logging_enabled;
 extern pthread_t cleanup_thread;
@@ -0,0 +1,658 @@
+#include "replication.h"
+#include "kv_store.h"
+#include "resp.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <time.h>
+#include <unistd.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+#define REPL_SCAN_BATCH 64                   // Snapshot taramasında bir seferde kopyalanan entry
+#define REPL_COMMAND_MAX (MAX_LINE_SIZE + 96) // Tek SET/SETEX/DEL komutunun RESP kodlaması
+#define REPL_PING_INTERVAL 1                 // Saniye; replikalar bununla bağlantının canlı olduğunu bilir
+#define REPL_READ_BUFFER (256 * 1024)        // Replikanın okuma buffer'ı (en büyük komuttan çok büyük)
+#define REPL_RETRY_INTERVAL 1                // Bağlantı koparsa yeniden deneme aralığı (saniye)
+
+// Primary'de bir replika bağlantısının akış durumu
+typedef struct ReplicaLink {
+    struct ReplicaLink* next;
+    CommandClient* client;
+    unsigned long long offset;   // Replikaya gönderilecek sıradaki akış baytı
+    unsigned long long acked;    // Replikanın son bildirdiği uygulanmış offset
+    time_t ack_time;
+    bool syncing;                // Tam senkronizasyonun snapshot kısmı gönderiliyor
+    size_t cursor;               // kv_scan_entries konumu
+    Entry* batch;
+} ReplicaLink;
+
+// Kilit sırası: buffer_mutex (storage) -> repl_mutex -> ön yüzün bildirim kuyruğu
+static pthread_mutex_t repl_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t repl_cond = PTHREAD_COND_INITIALIZER; // Thread'leri kapanışta uyandırır
+static Storage* storage = NULL;
+
+// Primary durumu - repl_mutex ile korunur
+static char replid[REPL_ID_SIZE + 1];
+static char* backlog = NULL;              // İlk replika bağlanınca ayrılır (atomik okunur)
+static size_t backlog_size = REPL_BACKLOG_SIZE;
+static size_t backlog_len = 0;            // Halkadaki geçerli bayt
+static unsigned long long master_offset = 0; // Akışa eklenen toplam bayt (atomik okunur)
+static ReplicaLink* replicas = NULL;
+static size_t replica_count = 0;
+static unsigned long long full_syncs = 0;
+static unsigned long long partial_syncs = 0;
+static pthread_t ping_thread;
+static bool ping_running = false;
+
+// Replika durumu
+static pthread_t replica_thread;
+static bool replica_running = false;      // Thread çalışıyor (repl_mutex)
+static bool is_replica = false;           // atomik
+static char master_host[256];
+static int master_port = 0;
+static char master_auth[128] = "password";
+static char master_replid[REPL_ID_SIZE + 1] = "?"; // Sadece replika thread'i değiştirir
+static unsigned long long replica_offset = 0;      // Uygulanan akış baytı (atomik)
+static bool link_up = false;              // atomik
+static time_t last_io = 0;                // Senkronizasyondan sonra primary'den son veri (atomik)
+static int replica_fd = -1;               // Durdururken bloklanan okumayı kesmek için (repl_mutex)
+static int max_lag = REPL_MAX_LAG;
+
+// Rastgele 40 karakterlik replikasyon kimliği; primary her başladığında ve terfide değişir
+static void generate_replid(char* out) {
+    unsigned char bytes[REPL_ID_SIZE / 2];
+    int fd = open("/dev/urandom", O_RDONLY | O_CLOEXEC);
+    if (fd < 0 || read(fd, bytes, sizeof(bytes)) != (ssize_t)sizeof(bytes)) {
+        srand((unsigned)time(NULL) ^ (unsigned)getpid());
+        for (size_t i = 0; i < sizeof(bytes); i++) bytes[i] = (unsigned char)rand();
+    }
+    if (fd >= 0) close(fd);
+    for (size_t i = 0; i < sizeof(bytes); i++) sprintf(out + i * 2, "%02x", bytes[i]);
+    out[REPL_ID_SIZE] = '\0';
+}
+
+// SET key value, SETEX key ttl value (RESP sırası) veya DEL key
+static size_t encode_write(char* buf, const char* key, const char* value, int ttl) {
+    size_t key_len = strlen(key);
+    int len;
+    if (!value) {
+        len = snprintf(buf, REPL_COMMAND_MAX, "*2\r\n$3\r\nDEL\r\n$%zu\r\n%s\r\n", key_len, key);
+    } else if (ttl > 0) {
+        char ttl_text[16];
+        int ttl_len = snprintf(ttl_text, sizeof(ttl_text), "%d", ttl);
+        len = snprintf(buf, REPL_COMMAND_MAX, "*4\r\n$5\r\nSETEX\r\n$%zu\r\n%s\r\n$%d\r\n%s\r\n$%zu\r\n%s\r\n",
+                       key_len, key, ttl_len, ttl_text, strlen(value), value);
+    } else {
+        len = snprintf(buf, REPL_COMMAND_MAX, "*3\r\n$3\r\nSET\r\n$%zu\r\n%s\r\n$%zu\r\n%s\r\n",
+                       key_len, key, strlen(value), value);
+    }
+    return (size_t)len < REPL_COMMAND_MAX ? (size_t)len : REPL_COMMAND_MAX - 1;
+}
+
+// Akışa ekler ve snapshot'ı bitmiş replikaları uyandırır
+static void feed_locked(const char* data, size_t len) {
+    size_t pos = (size_t)(master_offset % backlog_size);
+    size_t first = backlog_size - pos < len ? backlog_size - pos : len;
+    memcpy(backlog + pos, data, first);
+    memcpy(backlog, data + first, len - first);
+    backlog_len = backlog_len + len > backlog_size ? backlog_size : backlog_len + len;
+    __atomic_store_n(&master_offset, master_offset + len, __ATOMIC_RELEASE);
+
+    for (ReplicaLink* link = replicas; link; link = link->next) {
+        if (!link->syncing) link->client->notify(link->client, NULL);
+    }
+}
+
+// Storage yazma kancası; buffer_mutex altında log sırasıyla çağrılır
+static void replication_write_hook(const char* key, const char* value, int ttl) {
+    // Henüz replika bağlanmadıysa yazma yolu kilit almaz
+    if (!__atomic_load_n(&backlog, __ATOMIC_ACQUIRE)) return;
+
+    char buf[REPL_COMMAND_MAX];
+    size_t len = encode_write(buf, key, value, ttl);
+    pthread_mutex_lock(&repl_mutex);
+    feed_locked(buf, len);
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+void replication_init(Storage* s) {
+    storage = s;
+    pthread_mutex_lock(&repl_mutex);
+    if (!replid[0]) generate_replid(replid);
+    pthread_mutex_unlock(&repl_mutex);
+    storage_set_write_hook(replication_write_hook);
+}
+
+void replication_set_backlog_size(size_t size) {
+    pthread_mutex_lock(&repl_mutex);
+    // Backlog ayrıldıktan sonra boyut değişmez
+    if (!backlog && size > 0) backlog_size = size;
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+// Boşta da bağlantının canlı olduğu anlaşılsın diye akışa düzenli PING eklenir
+static void* ping_loop(void* arg) {
+    (void)arg;
+    static const char ping[] = "*1\r\n$4\r\nPING\r\n";
+    pthread_mutex_lock(&repl_mutex);
+    while (ping_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += REPL_PING_INTERVAL;
+        pthread_cond_timedwait(&repl_cond, &repl_mutex, &deadline);
+        if (ping_running && replica_count > 0) feed_locked(ping, sizeof(ping) - 1);
+    }
+    pthread_mutex_unlock(&repl_mutex);
+    return NULL;
+}
+
+void replication_psync(CommandClient* client, const char* id, long long offset) {
+    if (!client->notify) {
+        reply_error(client, "replication is not supported on this connection");
+        return;
+    }
+    if (client->replica) {
+        reply_error(client, "connection is already a replica");
+        return;
+    }
+    if (replication_is_replica()) {
+        reply_error(client, "chained replication is not supported");
+        return;
+    }
+
+    ReplicaLink* link = calloc(1, sizeof(ReplicaLink));
+    if (!link) {
+        reply_error(client, "out of memory");
+        return;
+    }
+    link->client = client;
+    link->ack_time = time(NULL);
+
+    char line[128];
+    pthread_mutex_lock(&repl_mutex);
+    if (!backlog) {
+        char* ring = malloc(backlog_size);
+        if (!ring) {
+            pthread_mutex_unlock(&repl_mutex);
+            free(link);
+            reply_error(client, "failed to allocate replication backlog");
+            return;
+        }
+        __atomic_store_n(&backlog, ring, __ATOMIC_RELEASE);
+        ping_running = pthread_create(&ping_thread, NULL, ping_loop, NULL) == 0;
+    }
+
+    bool partial = strcmp(id, replid) == 0 && offset >= 0 &&
+                   (unsigned long long)offset >= master_offset - backlog_len &&
+                   (unsigned long long)offset <= master_offset;
+    if (partial) {
+        link->offset = (unsigned long long)offset;
+        partial_syncs++;
+        snprintf(line, sizeof(line), "+CONTINUE %s\r\n", replid);
+    } else {
+        link->batch = malloc(REPL_SCAN_BATCH * sizeof(Entry));
+        if (!link->batch) {
+            pthread_mutex_unlock(&repl_mutex);
+            free(link);
+            reply_error(client, "out of memory");
+            return;
+        }
+        // Bu andan sonraki tüm yazmalar tarama sonrası akışta tekrarlanır
+        link->syncing = true;
+        link->offset = master_offset;
+        full_syncs++;
+        snprintf(line, sizeof(line), "+FULLRESYNC %s %llu\r\n", replid, master_offset);
+    }
+    link->acked = link->offset;
+    link->next = replicas;
+    replicas = link;
+    replica_count++;
+    client->replica = link;
+    pthread_mutex_unlock(&repl_mutex);
+
+    if (logging_enabled) printf("Replica %d attached, %s sync from offset %llu\n",
+                                client->id, partial ? "partial" : "full", link->offset);
+    reply_raw(client, line, strlen(line));
+    client->notify(client, NULL);
+}
+
+void replication_ack(CommandClient* client, long long offset) {
+    ReplicaLink* link = client->replica;
+    if (!link || offset < 0) return;
+    pthread_mutex_lock(&repl_mutex);
+    link->acked = (unsigned long long)offset;
+    link->ack_time = time(NULL);
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+bool replication_pending(CommandClient* client) {
+    ReplicaLink* link = client->replica;
+    return link && (link->syncing || link->offset < __atomic_load_n(&master_offset, __ATOMIC_ACQUIRE));
+}
+
+void replication_fill(CommandClient* client, size_t budget) {
+    ReplicaLink* link = client->replica;
+    if (!link) return;
+
+    // Snapshot: tablo parça parça taranır, çıktı boşaldıkça devam edilir
+    size_t written = 0;
+    char buf[REPL_COMMAND_MAX];
+    time_t now = time(NULL);
+    while (link->syncing && written < budget && !client->failed) {
+        size_t count = kv_scan_entries(&link->cursor, link->batch, REPL_SCAN_BATCH);
+        for (size_t i = 0; i < count; i++) {
+            const Entry* entry = &link->batch[i];
+            int ttl = 0;
+            if (entry->expire_at > 0) ttl = entry->expire_at > now ? (int)(entry->expire_at - now) : 1;
+            size_t len = encode_write(buf, entry->key, entry->value, ttl);
+            reply_raw(client, buf, len);
+            written += len;
+        }
+        if (count == 0) {
+            link->syncing = false;
+            free(link->batch);
+            link->batch = NULL;
+            reply_raw(client, "+ENDSNAPSHOT\r\n", 14);
+            if (logging_enabled) printf("Snapshot sent to replica %d\n", client->id);
+        }
+    }
+    if (link->syncing || client->failed || written >= budget) return;
+
+    // Akış: backlog'dan replikanın kaldığı yerden itibaren
+    pthread_mutex_lock(&repl_mutex);
+    if (link->offset < master_offset - backlog_len) {
+        // Gönderilmemiş veri halkadan düştü; replika yeniden bağlanıp tam senkronizasyon yapar
+        pthread_mutex_unlock(&repl_mutex);
+        if (logging_enabled) printf("Replica %d fell behind the replication backlog, disconnecting\n", client->id);
+        client->failed = true;
+        return;
+    }
+    unsigned long long available = master_offset - link->offset;
+    size_t len = available < budget - written ? (size_t)available : budget - written;
+    size_t pos = (size_t)(link->offset % backlog_size);
+    size_t first = backlog_size - pos < len ? backlog_size - pos : len;
+    reply_raw(client, backlog + pos, first);
+    if (len > first) reply_raw(client, backlog, len - first);
+    link->offset += len;
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+void replication_detach(CommandClient* client) {
+    ReplicaLink* link = client->replica;
+    if (!link) return;
+
+    pthread_mutex_lock(&repl_mutex);
+    ReplicaLink** prev = &replicas;
+    while (*prev != link) prev = &(*prev)->next;
+    *prev = link->next;
+    replica_count--;
+    pthread_mutex_unlock(&repl_mutex);
+
+    if (logging_enabled) printf("Replica %d detached\n", client->id);
+    client->replica = NULL;
+    free(link->batch);
+    free(link);
+}
+
+// ---------------------------------------------------------------------------
+// Replika tarafı
+// ---------------------------------------------------------------------------
+
+void replication_set_master_auth(const char* password) {
+    pthread_mutex_lock(&repl_mutex);
+    snprintf(master_auth, sizeof(master_auth), "%s", password);
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+void replication_set_max_lag(int seconds) {
+    max_lag = seconds > 0 ? seconds : 0;
+}
+
+bool replication_is_replica() {
+    return __atomic_load_n(&is_replica, __ATOMIC_ACQUIRE);
+}
+
+bool replication_is_stale() {
+    if (!replication_is_replica() || max_lag == 0) return false;
+    time_t io = __atomic_load_n(&last_io, __ATOMIC_RELAXED);
+    return io == 0 || time(NULL) - io > max_lag;
+}
+
+// Durdurulana kadar en fazla seconds saniye bekler; false dönerse thread durmalı
+static bool replica_sleep(int seconds) {
+    pthread_mutex_lock(&repl_mutex);
+    if (replica_running) {
+        struct timespec deadline;
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        deadline.tv_sec += seconds;
+        pthread_cond_timedwait(&repl_cond, &repl_mutex, &deadline);
+    }
+    bool running = replica_running;
+    pthread_mutex_unlock(&repl_mutex);
+    return running;
+}
+
+static int connect_master() {
+    struct addrinfo hints, *result;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    char port[16];
+    snprintf(port, sizeof(port), "%d", master_port);
+    if (getaddrinfo(master_host, port, &hints, &result) != 0) return -1;
+
+    int fd = -1;
+    for (struct addrinfo* addr = result; addr && fd < 0; addr = addr->ai_next) {
+        fd = socket(addr->ai_family, addr->ai_socktype | SOCK_CLOEXEC, addr->ai_protocol);
+        if (fd >= 0 && connect(fd, addr->ai_addr, addr->ai_addrlen) < 0) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(result);
+    if (fd >= 0) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return fd;
+}
+
+static bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t sent = send(fd, data, len, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += sent;
+        len -= (size_t)sent;
+    }
+    return true;
+}
+
+// Tam senkronizasyondan önce replikanın tüm verisi silinir
+static void flush_dataset() {
+    Entry* batch = malloc(REPL_SCAN_BATCH * sizeof(Entry));
+    if (!batch) return;
+    size_t cursor = 0;
+    size_t count;
+    while ((count = kv_scan_entries(&cursor, batch, REPL_SCAN_BATCH)) > 0) {
+        for (size_t i = 0; i < count; i++) storage_delete(storage, batch[i].key);
+    }
+    free(batch);
+}
+
+// Primary'den gelen yazma komutunu uygular
+static void apply_command(int argc, char** argv) {
+    if (argc == 3 && strcasecmp(argv[0], "set") == 0) {
+        storage_set(storage, argv[1], argv[2]);
+    } else if (argc == 4 && strcasecmp(argv[0], "setex") == 0) {
+        storage_set_with_ttl(storage, argv[1], argv[3], atoi(argv[2]));
+    } else if (argc == 2 && strcasecmp(argv[0], "del") == 0) {
+        storage_delete(storage, argv[1]);
+    } else if (argc >= 1 && strcasecmp(argv[0], "ping") != 0) {
+        if (logging_enabled) printf("Ignoring unknown replication command: %s\n", argv[0]);
+    }
+}
+
+typedef struct {
+    bool auth_pending;   // AUTH yanıtı bekleniyor
+    bool streaming;      // Snapshot bitti; uygulanan komutlar offset'e eklenir
+} ReplicaSync;
+
+// Primary'nin durum satırını işler; false dönerse bağlantı bırakılır
+static bool handle_master_line(ReplicaSync* sync, char* line) {
+    if (line[0] == '-') {
+        fprintf(stderr, "Primary refused replication: %s\n", line + 1);
+        return false;
+    }
+    if (sync->auth_pending) {
+        sync->auth_pending = false;
+        return true;
+    }
+
+    char id[REPL_ID_SIZE + 1];
+    unsigned long long offset;
+    if (sscanf(line, "+FULLRESYNC %40s %llu", id, &offset) == 2) {
+        printf("Full resync from primary %s:%d\n", master_host, master_port);
+        // Veri silinip yeniden yüklenirken okumalar bayat sayılır
+        __atomic_store_n(&last_io, 0, __ATOMIC_RELAXED);
+        flush_dataset();
+        strcpy(master_replid, id);
+        __atomic_store_n(&replica_offset, offset, __ATOMIC_RELAXED);
+        sync->streaming = false;
+    } else if (sscanf(line, "+CONTINUE %40s", id) == 1) {
+        printf("Partial resync from primary %s:%d at offset %llu\n", master_host, master_port,
+               __atomic_load_n(&replica_offset, __ATOMIC_RELAXED));
+        sync->streaming = true;
+    } else if (strcmp(line, "+ENDSNAPSHOT") == 0) {
+        printf("Full sync complete, %zu keys loaded\n", kv_get_count());
+        sync->streaming = true;
+    }
+    if (sync->streaming) {
+        __atomic_store_n(&link_up, true, __ATOMIC_RELAXED);
+        __atomic_store_n(&last_io, time(NULL), __ATOMIC_RELAXED);
+    }
+    return true;
+}
+
+// Buffer'daki tamamlanmış satırları ve komutları işler, tüketilen bayt sayısını döner.
+// Protokol hatasında veya primary reddederse -1 döner.
+static long process_master_stream(ReplicaSync* sync, RespParser* parser, char* buf, size_t len) {
+    char* argv[RESP_MAX_ARGS];
+    size_t pos = 0;
+    while (pos < len) {
+        // Durum satırları yalnızca komut sınırında gelir
+        if (parser->expected < 0 && (buf[pos] == '+' || buf[pos] == '-')) {
+            char* end = memchr(buf + pos, '\n', len - pos);
+            if (!end) break;
+            *end = '\0';
+            if (end > buf + pos && end[-1] == '\r') end[-1] = '\0';
+            if (!handle_master_line(sync, buf + pos)) return -1;
+            pos = (size_t)(end - buf) + 1;
+            continue;
+        }
+
+        RespStatus status = resp_parse(parser, buf + pos, len - pos);
+        if (status == RESP_INCOMPLETE) break;
+        if (status == RESP_ERROR || parser->argc > RESP_MAX_ARGS) {
+            fprintf(stderr, "Protocol error in replication stream\n");
+            return -1;
+        }
+        resp_args(parser, buf + pos, argv);
+        apply_command(parser->argc, argv);
+        if (sync->streaming) __atomic_add_fetch(&replica_offset, parser->pos, __ATOMIC_RELAXED);
+        pos += parser->pos;
+        resp_parser_reset(parser);
+    }
+    return (long)pos;
+}
+
+static void send_command(int fd, char* out, size_t cap, int argc, const char** argv, bool* ok) {
+    size_t len = (size_t)snprintf(out, cap, "*%d\r\n", argc);
+    for (int i = 0; i < argc && len < cap; i++) {
+        len += (size_t)snprintf(out + len, cap - len, "$%zu\r\n%s\r\n", strlen(argv[i]), argv[i]);
+    }
+    if (*ok && (len >= cap || !send_all(fd, out, len))) *ok = false;
+}
+
+// Tek bağlantı boyunca el sıkışma ve akış; bağlantı koptuğunda döner
+static void sync_with_master(int fd, char* buf) {
+    char out[512];
+    char offset_text[32];
+    char auth[sizeof(master_auth)];
+    pthread_mutex_lock(&repl_mutex);
+    strcpy(auth, master_auth);
+    pthread_mutex_unlock(&repl_mutex);
+
+    // Primary değişmediyse kaldığı offset'ten devam etmeyi ister
+    bool known = strcmp(master_replid, "?") != 0;
+    snprintf(offset_text, sizeof(offset_text), "%lld",
+             known ? (long long)__atomic_load_n(&replica_offset, __ATOMIC_RELAXED) : -1LL);
+    const char* auth_argv[] = { "AUTH", auth };
+    const char* psync_argv[] = { "PSYNC", master_replid, offset_text };
+    bool ok = true;
+    send_command(fd, out, sizeof(out), 2, auth_argv, &ok);
+    send_command(fd, out, sizeof(out), 3, psync_argv, &ok);
+
+    ReplicaSync sync = { .auth_pending = true, .streaming = false };
+    RespParser parser;
+    resp_parser_reset(&parser);
+    size_t len = 0;
+    time_t last_ack = 0;
+
+    while (ok && __atomic_load_n(&replica_running, __ATOMIC_RELAXED)) {
+        struct pollfd pfd = { .fd = fd, .events = POLLIN };
+        int ready = poll(&pfd, 1, 1000);
+        if (ready < 0 && errno != EINTR) break;
+
+        if (ready > 0) {
+            ssize_t n = read(fd, buf + len, REPL_READ_BUFFER - len);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) break;
+            len += (size_t)n;
+            if (sync.streaming) __atomic_store_n(&last_io, time(NULL), __ATOMIC_RELAXED);
+
+            long consumed = process_master_stream(&sync, &parser, buf, len);
+            if (consumed < 0) break;
+            memmove(buf, buf + consumed, len - (size_t)consumed);
+            len -= (size_t)consumed;
+            if (len == REPL_READ_BUFFER) {
+                fprintf(stderr, "Replication message too large\n");
+                break;
+            }
+        }
+
+        // Primary replikanın ne kadar geride olduğunu ACK'lerden görür
+        time_t now = time(NULL);
+        if (sync.streaming && now != last_ack) {
+            last_ack = now;
+            snprintf(offset_text, sizeof(offset_text), "%llu", __atomic_load_n(&replica_offset, __ATOMIC_RELAXED));
+            const char* ack_argv[] = { "REPLCONF", "ACK", offset_text };
+            send_command(fd, out, sizeof(out), 3, ack_argv, &ok);
+        }
+    }
+}
+
+static void* replica_loop(void* arg) {
+    (void)arg;
+    char* buf = malloc(REPL_READ_BUFFER);
+    while (buf && __atomic_load_n(&replica_running, __ATOMIC_RELAXED)) {
+        int fd = connect_master();
+        if (fd < 0) {
+            if (logging_enabled) printf("Failed to connect to primary %s:%d\n", master_host, master_port);
+            if (!replica_sleep(REPL_RETRY_INTERVAL)) break;
+            continue;
+        }
+
+        pthread_mutex_lock(&repl_mutex);
+        replica_fd = fd;
+        pthread_mutex_unlock(&repl_mutex);
+
+        printf("Connected to primary %s:%d\n", master_host, master_port);
+        sync_with_master(fd, buf);
+        __atomic_store_n(&link_up, false, __ATOMIC_RELAXED);
+
+        pthread_mutex_lock(&repl_mutex);
+        replica_fd = -1;
+        pthread_mutex_unlock(&repl_mutex);
+        close(fd);
+
+        if (!replica_sleep(REPL_RETRY_INTERVAL)) break;
+        printf("Lost connection to primary, reconnecting\n");
+    }
+    free(buf);
+    return NULL;
+}
+
+// Replika thread'ini durdurur ve bekler
+static void stop_replica_thread() {
+    pthread_mutex_lock(&repl_mutex);
+    bool running = replica_running;
+    __atomic_store_n(&replica_running, false, __ATOMIC_RELAXED);
+    if (replica_fd >= 0) shutdown(replica_fd, SHUT_RDWR);
+    pthread_cond_broadcast(&repl_cond);
+    pthread_mutex_unlock(&repl_mutex);
+    if (running) pthread_join(replica_thread, NULL);
+}
+
+bool replication_start_replica(const char* host, int port) {
+    stop_replica_thread();
+
+    // Aynı primary'ye yeniden bağlanırken replid ve offset korunur (kısmi senkronizasyon)
+    if (strcmp(host, master_host) != 0 || port != master_port) {
+        snprintf(master_host, sizeof(master_host), "%s", host);
+        master_port = port;
+        strcpy(master_replid, "?");
+        __atomic_store_n(&replica_offset, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&last_io, 0, __ATOMIC_RELAXED);
+    }
+    __atomic_store_n(&is_replica, true, __ATOMIC_RELEASE);
+
+    pthread_mutex_lock(&repl_mutex);
+    replica_running = pthread_create(&replica_thread, NULL, replica_loop, NULL) == 0;
+    bool started = replica_running;
+    pthread_mutex_unlock(&repl_mutex);
+    if (!started) perror("Failed to start replication thread");
+    return started;
+}
+
+void replication_stop_replica() {
+    stop_replica_thread();
+    __atomic_store_n(&is_replica, false, __ATOMIC_RELEASE);
+    master_host[0] = '\0';
+    master_port = 0;
+    strcpy(master_replid, "?");
+
+    // Yeni primary'nin geçmişi eskisinden farklı; replikaları tam senkronizasyon yapar
+    pthread_mutex_lock(&repl_mutex);
+    generate_replid(replid);
+    pthread_mutex_unlock(&repl_mutex);
+}
+
+void replication_shutdown() {
+    stop_replica_thread();
+
+    pthread_mutex_lock(&repl_mutex);
+    bool running = ping_running;
+    ping_running = false;
+    pthread_cond_broadcast(&repl_cond);
+    pthread_mutex_unlock(&repl_mutex);
+    if (running) pthread_join(ping_thread, NULL);
+}
+
+size_t replication_info(char* buf, size_t size) {
+    int len;
+    if (replication_is_replica()) {
+        time_t io = __atomic_load_n(&last_io, __ATOMIC_RELAXED);
+        len = snprintf(buf, size,
+                       "# Replication\r\nrole:replica\r\nmaster_host:%s\r\nmaster_port:%d\r\n"
+                       "master_link_status:%s\r\nmaster_last_io_seconds_ago:%ld\r\nslave_repl_offset:%llu",
+                       master_host, master_port, __atomic_load_n(&link_up, __ATOMIC_RELAXED) ? "up" : "down",
+                       io ? (long)(time(NULL) - io) : -1L, __atomic_load_n(&replica_offset, __ATOMIC_RELAXED));
+        return (size_t)len < size ? (size_t)len : size - 1;
+    }
+
+    pthread_mutex_lock(&repl_mutex);
+    len = snprintf(buf, size,
+                   "# Replication\r\nrole:master\r\nconnected_replicas:%zu\r\nmaster_replid:%s\r\n"
+                   "master_repl_offset:%llu\r\nsync_full:%llu\r\nsync_partial_ok:%llu",
+                   replica_count, replid, master_offset, full_syncs, partial_syncs);
+    int index = 0;
+    time_t now = time(NULL);
+    for (ReplicaLink* link = replicas; link && (size_t)len < size; link = link->next, index++) {
+        len += snprintf(buf + len, size - (size_t)len, "\r\nreplica%d:id=%d,state=%s,offset=%llu,lag=%ld",
+                        index, link->client->id, link->syncing ? "sync" : "online", link->acked,
+                        (long)(now - link->ack_time));
+    }
+    pthread_mutex_unlock(&repl_mutex);
+    return (size_t)len < size ? (size_t)len : size - 1;
+}
@@ -0,0 +1,71 @@
+#ifndef REPLICATION_H
+#define REPLICATION_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "command.h"
+#include "storage.h"
+
+// Primary-replika replikasyonu.
+// Primary her yazmayı (set/setex/del) RESP komutu olarak replikasyon backlog'una
+// (sabit boyutlu halka) ekler; replika bağlantıları akışı bu halkadan kendi
+// worker'larında çeker. Replika PSYNC <replid> <offset> ile bağlanır:
+//   - offset backlog'daysa "+CONTINUE <replid>" ve akış kaldığı yerden devam eder
+//   - değilse "+FULLRESYNC <replid> <offset>", tablo taramasından SET/SETEX komutları,
+//     "+ENDSNAPSHOT" ve o offset'ten itibaren akış gelir. Tarama sırasında yapılan
+//     yazmalar akışta tekrarlandığı için sonuç tutarlıdır.
+// Primary her saniye akışa PING ekler; replika uygulanan offset'i REPLCONF ACK ile bildirir.
+// Replikalar salt okunurdur ve primary'den REPL_MAX_LAG saniyedir veri almadıysa okuma reddedilir.
+
+#define REPL_BACKLOG_SIZE (16 * 1024 * 1024) // Kısa kopmalarda kısmi senkronizasyon için
+#define REPL_MAX_LAG 10                      // Replika bu kadar saniye geride kalırsa okuma yapılmaz
+#define REPL_ID_SIZE 40
+
+// Yazma kancasını kurar; command_init tarafından çağrılır
+void replication_init(Storage* storage);
+
+// Sunucu kapanırken replika ve PING thread'lerini durdurur
+void replication_shutdown();
+
+// --- Primary tarafı ---
+
+void replication_set_backlog_size(size_t size);
+
+// PSYNC isteğini yanıtlar ve bağlantıyı replika akışına bağlar; bağlantının notify
+// fonksiyonu olmalıdır (yeni akış verisi için key NULL ile çağrılır)
+void replication_psync(CommandClient* client, const char* replid, long long offset);
+
+// Replikanın uyguladığı offset (REPLCONF ACK)
+void replication_ack(CommandClient* client, long long offset);
+
+// Gönderilecek snapshot veya akış verisi var mı (bağlantının thread'inde)
+bool replication_pending(CommandClient* client);
+
+// En fazla budget bayt (yaklaşık) snapshot/akış verisini bağlantının çıktısına yazar.
+// Replika backlog'un gerisinde kaldıysa client->failed işaretlenir.
+void replication_fill(CommandClient* client, size_t budget);
+
+// Bağlantı kapanırken çağrılır; döndükten sonra notify çağrılmaz
+void replication_detach(CommandClient* client);
+
+// --- Replika tarafı ---
+
+void replication_set_master_auth(const char* password);
+void replication_set_max_lag(int seconds); // 0: bayat veri de okunur
+
+// Arka plan thread'inde primary'ye bağlanır ve akışı uygular. Aynı primary'ye
+// yeniden bağlanılıyorsa kısmi senkronizasyon denenir.
+bool replication_start_replica(const char* host, int port);
+
+// Replikasyonu durdurur ve sunucuyu yeniden yazılabilir primary yapar
+void replication_stop_replica();
+
+bool replication_is_replica();
+
+// Replika primary'den REPL_MAX_LAG saniyedir veri almadı (veya hiç senkronize olmadı)
+bool replication_is_stale();
+
+// info komutu için "# Replication" bölümü; yazılan uzunluğu döner
+size_t replication_info(char* buf, size_t size);
+
+#endif // REPLICATION_H
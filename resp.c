@@ -0,0 +1,104 @@
+#include "resp.h"
+#include <stdbool.h>
+#include <string.h>
+
+#define RESP_MAX_HEADER 32 // "*<sayı>\r\n" veya "$<sayı>\r\n" satırının en büyük uzunluğu
+
+void resp_parser_reset(RespParser* parser) {
+    parser->expected = -1;
+    parser->bulk_len = -1;
+    parser->argc = 0;
+    parser->pos = 0;
+    parser->has_nul = false;
+}
+
+// buf[pos]'taki "<prefix><sayı>\r\n" satırını okur, başarılıysa pos satır sonrasına ilerler
+static RespStatus parse_header(const char* buf, size_t len, size_t* pos, char prefix, long* value) {
+    size_t start = *pos;
+    if (start >= len) return RESP_INCOMPLETE;
+    if (buf[start] != prefix) return RESP_ERROR;
+
+    size_t avail = len - start;
+    const char* cr = memchr(buf + start, '\r', avail < RESP_MAX_HEADER ? avail : RESP_MAX_HEADER);
+    if (!cr) return avail < RESP_MAX_HEADER ? RESP_INCOMPLETE : RESP_ERROR;
+
+    size_t cr_pos = (size_t)(cr - buf);
+    if (cr_pos + 1 >= len) return RESP_INCOMPLETE;
+    if (buf[cr_pos + 1] != '\n') return RESP_ERROR;
+
+    // İşaretli tam sayı; yalnızca rakam kabul edilir
+    const char* p = buf + start + 1;
+    bool negative = false;
+    if (p < cr && *p == '-') {
+        negative = true;
+        p++;
+    }
+    if (p == cr) return RESP_ERROR;
+
+    long result = 0;
+    for (; p < cr; p++) {
+        if (*p < '0' || *p > '9') return RESP_ERROR;
+        result = result * 10 + (*p - '0');
+        if (result > 1000000000L) return RESP_ERROR; // Taşmayı önle, sınırlar çağıranda kontrol edilir
+    }
+
+    *value = negative ? -result : result;
+    *pos = cr_pos + 2;
+    return RESP_OK;
+}
+
+RespStatus resp_parse(RespParser* parser, char* buf, size_t len) {
+    RespStatus status;
+
+    if (parser->expected < 0) {
+        long count;
+        status = parse_header(buf, len, &parser->pos, '*', &count);
+        if (status != RESP_OK) return status;
+        if (count > RESP_MAX_MULTIBULK) return RESP_ERROR;
+        // *-1 (boş dizi) ve *0 argümansız komut olarak döner
+        parser->expected = count > 0 ? count : 0;
+    }
+
+    while (parser->argc < parser->expected) {
+        if (parser->bulk_len < 0) {
+            long bulk_len;
+            status = parse_header(buf, len, &parser->pos, '$', &bulk_len);
+            if (status != RESP_OK) return status;
+            if (bulk_len < 0 || bulk_len > RESP_MAX_BULK_LEN) return RESP_ERROR;
+            parser->bulk_len = bulk_len;
+        }
+
+        // Veri ve sonundaki \r\n tamamen gelmeden argüman tamamlanmaz
+        size_t end = parser->pos + (size_t)parser->bulk_len;
+        if (end + 2 > len) return RESP_INCOMPLETE;
+        if (buf[end] != '\r' || buf[end + 1] != '\n') return RESP_ERROR;
+
+        if (parser->argc < RESP_INLINE_ARGS) {
+            parser->arg_offset[parser->argc] = parser->pos;
+            parser->arg_len[parser->argc] = (size_t)parser->bulk_len;
+        }
+        if (memchr(buf + parser->pos, '\0', (size_t)parser->bulk_len)) parser->has_nul = true;
+        buf[end] = '\0';
+        parser->argc++;
+        parser->pos = end + 2;
+        parser->bulk_len = -1;
+    }
+
+    return RESP_OK;
+}
+
+int resp_args(const RespParser* parser, char* buf, char** argv) {
+    int inline_count = parser->argc < RESP_INLINE_ARGS ? parser->argc : RESP_INLINE_ARGS;
+    for (int i = 0; i < inline_count; i++) argv[i] = buf + parser->arg_offset[i];
+    if (parser->argc == inline_count) return parser->argc;
+    
+    // Son saklanan argümanın "\0\n" sonlandırıcısından devam edilir
+    size_t pos = parser->arg_offset[inline_count - 1] + parser->arg_len[inline_count - 1] + 2;
+    for (int i = inline_count; i < parser->argc; i++) {
+        long bulk_len = 0;
+        parse_header(buf, parser->pos, &pos, '$', &bulk_len);
+        argv[i] = buf + pos;
+        pos += (size_t)bulk_len + 2;
+    }
+    return parser->argc;
+}
@@ -0,0 +1,47 @@
+#ifndef RESP_H
+#define RESP_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Redis istemcilerinin konuştuğu RESP istek formatı için artımlı ayrıştırıcı:
+//   *<argüman sayısı>\r\n $<uzunluk>\r\n<veri>\r\n ...
+// Argümanlar kopyalanmaz; bağlantının okuma buffer'ındaki konumları tutulur.
+// Buffer büyütülürken yer değiştirebileceği için pointer yerine offset saklanır.
+
+#define RESP_INLINE_ARGS 10              // Offseti parser'da saklanan argüman sayısı
+#define RESP_MAX_ARGS 2048               // Çalıştırılabilen komuttaki en fazla argüman sayısı
+#define RESP_MAX_BULK_LEN (1024 * 1024)  // Tek argümanın en büyük boyutu
+#define RESP_MAX_MULTIBULK (1024 * 1024) // Bir komuttaki en fazla argüman sayısı
+
+typedef enum {
+    RESP_OK,         // Komut tamamlandı
+    RESP_INCOMPLETE, // Daha fazla veri gerekli
+    RESP_ERROR       // Protokol hatası, bağlantı kapatılmalı
+} RespStatus;
+
+typedef struct {
+    long expected;      // Komuttaki argüman sayısı, -1: başlık bekleniyor
+    long bulk_len;      // Okunan argümanın uzunluğu, -1: $ başlığı bekleniyor
+    int argc;           // Tamamlanan argüman sayısı (RESP_MAX_ARGS'ı aşabilir)
+    size_t pos;         // Komut başından itibaren ayrıştırılan bayt sayısı
+    bool has_nul;       // Bir argüman NUL baytı içeriyor; C string olarak kesileceği için çalıştırılmamalı
+    size_t arg_offset[RESP_INLINE_ARGS];
+    size_t arg_len[RESP_INLINE_ARGS];
+} RespParser;
+
+void resp_parser_reset(RespParser* parser);
+
+// buf komutun ilk baytını gösterir, len o ana kadar okunan veridir.
+// RESP_INCOMPLETE dönerse daha fazla veri gelince aynı komut başıyla tekrar çağrılır;
+// ayrıştırma kaldığı yerden devam eder. RESP_OK dönerse parser->pos komutun
+// toplam uzunluğudur ve her argümanın sonundaki '\r' yerine '\0' yazılmıştır,
+// böylece buf + arg_offset[i] doğrudan C string olarak kullanılabilir.
+RespStatus resp_parse(RespParser* parser, char* buf, size_t len);
+
+// RESP_OK'tan sonra argümanların adreslerini argv'ye yazar ve argc'yi döner; argv en az
+// parser->argc elemanlı olmalıdır. İlk RESP_INLINE_ARGS argüman saklanan offsetlerden,
+// kalanlar (çok anahtarlı komutlar) doğrulanmış komutun başlıkları yeniden okunarak bulunur
+int resp_args(const RespParser* parser, char* buf, char** argv);
+
+#endif // RESP_H
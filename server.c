@@ -1,266 +1,678 @@
+#define _GNU_SOURCE // accept4 için
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <string.h>
 #include <unistd.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <sys/socket.h>
-#include <sys/select.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <poll.h>
 #include <arpa/inet.h>
 #include <pthread.h>
 #include <signal.h>
 #include <errno.h>
 #include "storage.h"
 #include "kv_store.h"
+#include "resp.h"
+#include "command.h"
+#include "uring.h"
+#include "shm_server.h"
+#include "tracking.h"
+#include "replication.h"
+#include "cluster.h"
 
 #define SERVER_PORT 6379 // Redis default port
-#define MAX_CLIENTS 64
 #define BUFFER_SIZE MAX_LINE_SIZE
-#define MAX_TOKENS 10
-#define DEFAULT_PASSWORD "password" // Varsayılan şifre
+#define MAX_EVENTS 256      // Bir epoll_wait çağrısında işlenen en fazla olay
+#define LISTEN_BACKLOG 4096 // Bağlantı patlamalarında SYN kuyruğu dolmasın
+#define MAX_WORKERS 64
+#define READ_BUFFER_SIZE 16384           // Bağlantı başına başlangıç okuma buffer'ı
+#define MAX_QUERY_SIZE (2 * 1024 * 1024) // Tamamlanmamış komut bu boyutu aşarsa bağlantı kapatılır
+#define OUTPUT_FLUSH_THRESHOLD 65536     // Döngü sonu beklenmeden gönderilecek çıktı miktarı
+#define OUTPUT_SOFT_LIMIT (1024 * 1024)       // Gönderilmemiş çıktı bunu aşınca istemci okunmaz
+#define OUTPUT_HARD_LIMIT (32 * 1024 * 1024)  // Bunu aşan istemcinin bağlantısı kesilir
+#define REPLICA_OUTPUT_TARGET (256 * 1024)    // Replika akışı gönderilmemiş çıktı bunun altındayken doldurulur
 
-static int server_socket = -1;
-static int client_sockets[MAX_CLIENTS];
-static int client_auth_status[MAX_CLIENTS]; // Kimlik doğrulama durumlarını saklar
+#ifdef AYTDB_HAVE_URING_NET
+#define URING_ENTRIES 4096       // Worker başına SQ boyutu (CQ iki katı)
+#define URING_BUFFER_COUNT 512   // Tüm bağlantıların paylaştığı okuma buffer'ı sayısı (2'nin kuvveti)
+#define URING_BUFFER_SIZE 8192
+#define URING_BUFFER_GROUP 0
+
+// user_data'nın alt iki biti isteğin türünü taşır; Connection hizalı olduğu için bu bitler boştur
+#define URING_OP_ACCEPT 0
+#define URING_OP_RECV   1
+#define URING_OP_SEND   2
+#define URING_OP_WAKEUP 3
+#define URING_OP_MASK   3
+#endif
+
+// Bağlantı başına durum - sadece bağlı istemci sayısı kadar bellek tutulur
+typedef struct Connection {
+    CommandClient client;   // Komut katmanının gördüğü durum (ilk üye olmalı)
+    int fd;
+    bool is_listener;       // Dinleyici soket (accept edilir)
+    bool is_unix;           // Unix domain soketi (TCP seçenekleri uygulanmaz)
+    bool write_pending;     // Döngü sonunda gönderilecek çıktısı var
+    RespParser parser;      // Yarım kalan RESP komutunun ayrıştırma durumu
+    char* in;               // Okunan ama henüz işlenmemiş veri
+    size_t in_len;
+    size_t in_cap;
+    char* out;              // Döngü sonunda tek send ile gönderilecek yanıtlar
+    size_t out_len;
+    size_t out_sent;
+    size_t out_cap;
+    char* sending;          // io_uring: kernel'in göndermekte olduğu yanıtlar (out ile takas edilir)
+    size_t sending_len;
+    size_t sending_sent;
+    size_t sending_cap;
+    int uring_ops;          // io_uring: bu bağlantı için kernel'de bekleyen istek sayısı
+    bool closing;           // io_uring: bekleyen istekler bitince serbest bırakılacak
+    bool recv_armed;        // io_uring: multishot recv kernel'de etkin (girdi durdurulunca iptal edilir)
+    bool input_paused;      // Çıktı yumuşak sınırı aştı; gönderim ilerleyene kadar komut okunmaz
+    bool input_closed;      // İstemci yazma yönünü kapattı (EOF); kalan komutlar yanıtlanıp kapatılır
+    bool stream_queued;     // Replikasyon akışı bildirimi worker kuyruğunda (atomik)
+    struct Worker* worker;
+    struct Connection* pending_next; // Worker'ın gönderim bekleyenler listesi
+    struct Connection* prev; // Kapanışta tüm bağlantıları kapatmak için liste
+    struct Connection* next;
+} Connection;
+
+// Başka thread'deki yazmanın ürettiği invalidation; bağlantının worker'ına kuyruklanır
+typedef struct Notification {
+    struct Notification* next;
+    Connection* conn;
+    bool stream;            // Anahtar yerine replikasyon akışında yeni veri var
+    char key[];
+} Notification;
+
+// Her worker kendi epoll döngüsünü ve SO_REUSEPORT ile açılmış kendi dinleyicisini
+// çalıştırır; çekirdek gelen bağlantıları dinleyiciler arasında dağıtır.
+// Bağlantılar worker'lar arasında taşınmaz, bu yüzden bağlantı durumu kilitsizdir.
+typedef struct Worker {
+    int id;
+    int epoll_fd;
+    Connection listener;
+    Connection unix_listener;   // Tüm worker'ların paylaştığı Unix soketi, yoksa fd -1
+    Connection* connections;
+    Connection* pending_writes; // Bu döngü turunda çıktı biriktiren bağlantılar
+    Connection notifier;        // Bildirim eventfd'si; kuyruk boşken gelen ilk bildirim yazar
+    pthread_mutex_t notify_mutex;
+    Notification* notifications; // Worker döngüsünde bağlantılara yazılacak invalidation'lar
+    Notification** notifications_tail;
+    pthread_t thread;
+#ifdef AYTDB_HAVE_URING_NET
+    Uring ring;                 // epoll yerine io_uring kullanılıyorsa
+    UringBufRing buffers;       // Multishot recv'in kullandığı ortak okuma buffer'ları
+#endif
+} Worker;
+
+static Worker workers[MAX_WORKERS];
+static int worker_count = 1;
+static int wakeup_fd = -1;               // Kapanışta tüm worker'ları uyandırır
+static size_t connection_count = 0;      // Tüm worker'lardaki bağlantılar (atomik)
 static Storage* storage = NULL;
 static volatile int running = 1;
-static char server_password[128] = DEFAULT_PASSWORD; // Sunucu şifresi
+static bool use_io_uring = false;        // Ağ döngüsü epoll yerine io_uring ile çalışır
+static const char* unix_socket_path = NULL; // TCP'nin yanında dinlenecek Unix soketi
+static mode_t unix_socket_perm = 0;      // 0 ise umask'a göre bırakılır
+static int unix_listener_fd = -1;
+static const char* shm_socket_path = NULL;  // Paylaşımlı bellek kanallarının dağıtıldığı soket
+static size_t output_soft_limit = OUTPUT_SOFT_LIMIT; // 0: sınır yok
+static size_t output_hard_limit = OUTPUT_HARD_LIMIT;
+static const char* replicaof_host = NULL;   // Başlangıçta replika olarak bağlanılacak primary
+static int replicaof_port = 0;
+static const char* cluster_config = NULL;   // Küme modunda slot tablosu dosyası
+static const char* cluster_announce = NULL; // Diğer düğümlerin bu düğüme ulaştığı host:port
 
-// Bu fonksiyon main.c'deki ile aynı
-static char* parse_quoted_string(char* str, char* result) {
-    if (*str != '"') return NULL;
-    str++;
-    
-    while (*str && *str != '"') {
-        *result++ = *str++;
+// Tüm worker'ları durdur; eventfd'ye yazmak sinyal işleyicide de güvenlidir
+static void request_shutdown() {
+    running = 0;
+    if (wakeup_fd != -1) {
+        uint64_t one = 1;
+        ssize_t ignored = write(wakeup_fd, &one, sizeof(one));
+        (void)ignored;
     }
-    if (*str == '"') str++;
-    *result = '\0';
-    
-    return str;
 }
 
-// Bu fonksiyon main.c'deki ile aynı
-static int parse_command(char* line, char* tokens[], int max_tokens) {
-    char* current = line;
-    int count = 0;
-    char temp[MAX_VALUE_SIZE];
-    
-    while (*current && count < max_tokens) {
-        while (*current == ' ' || *current == '\t') current++;
-        if (!*current) break;
-        
-        if (*current == '"') {
-            char* end = parse_quoted_string(current, temp);
-            if (end) {
-                tokens[count++] = strdup(temp);
-                current = end;
-                continue;
-            }
+// Sinyali yakala ve sunucuyu durdur
+void signal_handler(int signum) {
+    printf("\nSignal %d received, shutting down...\n", signum);
+    request_shutdown();
+}
+
+void server_set_threads(int count) {
+    if (count < 1) count = 1;
+    if (count > MAX_WORKERS) count = MAX_WORKERS;
+    worker_count = count;
+}
+
+void server_set_io_uring(bool enabled) {
+    use_io_uring = enabled;
+}
+
+void server_set_unix_socket(const char* path, int permissions) {
+    unix_socket_path = path;
+    unix_socket_perm = (mode_t)permissions;
+}
+
+void server_set_shm_socket(const char* path) {
+    shm_socket_path = path;
+}
+
+void server_set_output_limits(size_t soft_limit, size_t hard_limit) {
+    output_soft_limit = soft_limit;
+    output_hard_limit = hard_limit;
+}
+
+void server_set_replicaof(const char* host, int port) {
+    replicaof_host = host;
+    replicaof_port = port;
+}
+
+void server_set_cluster(const char* config_path, const char* announce) {
+    cluster_config = config_path;
+    cluster_announce = announce;
+}
+
+// Kapanan bağlantıya ait, henüz yazılmamış bildirimleri kuyruktan çıkarır
+static void drop_notifications(Worker* worker, Connection* conn) {
+    pthread_mutex_lock(&worker->notify_mutex);
+    Notification** link = &worker->notifications;
+    while (*link) {
+        Notification* notification = *link;
+        if (notification->conn == conn) {
+            *link = notification->next;
+            free(notification);
+        } else {
+            link = &notification->next;
         }
-        
-        char* start = current;
-        while (*current && *current != ' ' && *current != '\t') current++;
-        if (current > start) {
-            int len = current - start;
-            if (len >= MAX_VALUE_SIZE) len = MAX_VALUE_SIZE - 1;
-            strncpy(temp, start, len);
-            temp[len] = '\0';
-            tokens[count++] = strdup(temp);
+    }
+    worker->notifications_tail = link;
+    pthread_mutex_unlock(&worker->notify_mutex);
+}
+
+// İstemci bağlantısını kapat ve durumunu serbest bırak
+static void close_connection(Worker* worker, Connection* conn) {
+    // Takip ve akış kaldırıldıktan sonra yeni bildirim kuyruklanmaz. Kuyruk her durumda
+    // temizlenir: CLIENT TRACKING OFF'tan önce kuyruklanmış bildirimler de conn'u gösterir
+    if (conn->client.tracking || conn->client.replica) {
+        tracking_disable(&conn->client);
+        replication_detach(&conn->client);
+    }
+    drop_notifications(worker, conn);
+    command_client_close(&conn->client);
+    // close() soketi epoll kümesinden de çıkarır
+    close(conn->fd);
+    if (conn->prev) conn->prev->next = conn->next;
+    else worker->connections = conn->next;
+    if (conn->next) conn->next->prev = conn->prev;
+    __atomic_sub_fetch(&connection_count, 1, __ATOMIC_RELAXED);
+    free(conn->in);
+    free(conn->out);
+    free(conn->sending);
+    free(conn);
+}
+
+// Bekleyen çıktıyı soket kabul ettiği kadar gönderir; false dönerse bağlantı koptu.
+// Bir pipeline'ın tüm yanıtları tek buffer'da biriktiği için çoğu zaman tek send yeter.
+static bool flush_connection(Connection* conn) {
+    while (conn->out_sent < conn->out_len) {
+        ssize_t sent = send(conn->fd, conn->out + conn->out_sent, conn->out_len - conn->out_sent, MSG_NOSIGNAL);
+        if (sent < 0) {
+            if (errno == EINTR) continue;
+            // Soket dolu: EPOLLOUT (edge-triggered) gelince devam edilir
+            return errno == EAGAIN || errno == EWOULDBLOCK;
         }
+        conn->out_sent += (size_t)sent;
     }
+    conn->out_len = 0;
+    conn->out_sent = 0;
     
-    return count;
+    // Büyük bir yanıt için büyümüş buffer'ı boşta tutma
+    if (conn->out_cap > OUTPUT_FLUSH_THRESHOLD) {
+        free(conn->out);
+        conn->out = NULL;
+        conn->out_cap = 0;
+    }
+    return true;
 }
 
-// Sinyali yakala ve sunucuyu durdur
-void signal_handler(int signum) {
-    printf("\nSignal %d received, shutting down...\n", signum);
-    running = 0;
+// Henüz sokete yazılmamış çıktı (io_uring'de kernel'e verilmiş olan dahil)
+static size_t pending_output(const Connection* conn) {
+    return conn->out_len - conn->out_sent + conn->sending_len - conn->sending_sent;
+}
+
+// Yavaş okuyan istemcinin yeni komutları, çıktısı yumuşak sınırın altına inene kadar bekletilir
+static bool output_blocked(const Connection* conn) {
+    return output_soft_limit && pending_output(conn) >= output_soft_limit;
+}
+
+// Çıkış buffer'ında en az len baytlık boş yer açar, yazılacak konumu döner.
+// Sert sınırı aşacak çıktı için NULL döner ve bağlantı kapatılır.
+static char* connection_reserve(Connection* conn, size_t len) {
+    if (output_hard_limit && pending_output(conn) + len > output_hard_limit) {
+        if (logging_enabled) printf("Output buffer hard limit exceeded, closing socket fd: %d\n", conn->fd);
+        return NULL;
+    }
+    if (conn->out_len + len > conn->out_cap) {
+        size_t new_cap = conn->out_cap ? conn->out_cap : BUFFER_SIZE;
+        while (new_cap < conn->out_len + len) new_cap *= 2;
+        char* grown = realloc(conn->out, new_cap);
+        if (!grown) return NULL;
+        conn->out = grown;
+        conn->out_cap = new_cap;
+    }
+    return conn->out + conn->out_len;
+}
+
+#ifdef AYTDB_HAVE_URING_NET
+static bool uring_send_output(Connection* conn);
+static bool uring_arm_recv(struct Worker* worker, Connection* conn);
+#endif
+
+// Bağlantıyı döngü sonunda gönderilecekler listesine ekler
+static void mark_write_pending(Connection* conn) {
+    if (!conn->write_pending) {
+        conn->write_pending = true;
+        conn->pending_next = conn->worker->pending_writes;
+        conn->worker->pending_writes = conn;
+    }
+}
+
+// Ayrılan yere yazılmış len baytı çıktıya ekler; gönderim worker döngüsünün sonunda
+// flush_pending_writes ile yapılır, böylece komut başına send çağrısı olmaz
+static bool connection_commit(Connection* conn, size_t len) {
+    conn->out_len += len;
+    mark_write_pending(conn);
     
-    // Server socket'i kapat
-    if (server_socket != -1) {
-        close(server_socket);
-        server_socket = -1;
+    // Çok büyük pipeline yanıtlarını bellekte biriktirme
+    if (conn->out_len - conn->out_sent >= OUTPUT_FLUSH_THRESHOLD) {
+#ifdef AYTDB_HAVE_URING_NET
+        if (use_io_uring) return uring_send_output(conn);
+#endif
+        return flush_connection(conn);
     }
+    return true;
+}
+
+// Yanıtı bağlantının çıkış buffer'ına kopyalar
+static bool connection_send(Connection* conn, const char* data, size_t len) {
+    char* dest = connection_reserve(conn, len);
+    if (!dest) return false;
+    memcpy(dest, data, len);
+    return connection_commit(conn, len);
 }
 
-// İstemci soketi kapat
-void close_client_socket(int client_socket_index) {
-    close(client_sockets[client_socket_index]);
-    client_sockets[client_socket_index] = -1;
+// Komut katmanının yanıt yazma fonksiyonları; reserve/commit ile yanıtlar
+// ara buffer'a kopyalanmadan doğrudan çıkış buffer'ında oluşturulur
+static bool client_write(CommandClient* client, const char* data, size_t len) {
+    return connection_send((Connection*)client, data, len);
 }
 
-// Komutu işle ve yanıtı oluştur
-char* process_command(char* command, int client_socket) {
-    char* result = malloc(BUFFER_SIZE);
-    if (!result) return NULL;
-    result[0] = '\0';
+static char* client_reserve(CommandClient* client, size_t len) {
+    return connection_reserve((Connection*)client, len);
+}
 
-    char* tokens[MAX_TOKENS];
-    int token_count = 0;
-    char line[BUFFER_SIZE];
+static void client_commit(CommandClient* client, size_t len) {
+    if (!connection_commit((Connection*)client, len)) client->failed = true;
+}
+
+// Tracking bildirimi veya replikasyon akışı uyandırması (key NULL); herhangi bir
+// thread'den, tracking/replikasyon kilidi tutulurken çağrılır. Bağlantı durumu kilitsiz
+// olduğu için bildirim worker'a kuyruklanır ve orada yazılır.
+static void client_notify(CommandClient* client, const char* key) {
+    Connection* conn = (Connection*)client;
+    Worker* worker = conn->worker;
+    // Akış uyandırmaları birleştirilir; worker akışı çekerken o ana kadarki tüm veriyi alır
+    if (!key && __atomic_exchange_n(&conn->stream_queued, true, __ATOMIC_ACQ_REL)) return;
     
-    strncpy(line, command, BUFFER_SIZE);
-    line[BUFFER_SIZE - 1] = '\0';
+    size_t key_len = key ? strlen(key) : 0;
+    Notification* notification = malloc(sizeof(Notification) + key_len + 1);
+    if (!notification) {
+        if (logging_enabled) printf("Failed to queue notification for client %d\n", client->id);
+        if (!key) __atomic_store_n(&conn->stream_queued, false, __ATOMIC_RELEASE);
+        return;
+    }
+    notification->next = NULL;
+    notification->conn = conn;
+    notification->stream = !key;
+    if (key) memcpy(notification->key, key, key_len + 1);
     
-    token_count = parse_command(line, tokens, MAX_TOKENS);
+    pthread_mutex_lock(&worker->notify_mutex);
+    bool was_empty = worker->notifications == NULL;
+    *worker->notifications_tail = notification;
+    worker->notifications_tail = &notification->next;
+    pthread_mutex_unlock(&worker->notify_mutex);
     
-    if (token_count == 0) {
-        strcpy(result, "ERROR: Command not found\r\n");
-        return result;
+    // Kuyruk boş değilse worker zaten uyandırıldı
+    if (was_empty) {
+        uint64_t one = 1;
+        ssize_t ignored = write(worker->notifier.fd, &one, sizeof(one));
+        (void)ignored;
     }
+}
+
+// Replikanın gönderilmemiş çıktısı hedefin altındaysa snapshot/akıştan devamını ekler.
+// Büyük bir snapshot böylece parça parça, soketin hızında gönderilir.
+static void fill_replica_stream(Connection* conn) {
+    size_t pending = pending_output(conn);
+    if (pending < REPLICA_OUTPUT_TARGET) replication_fill(&conn->client, REPLICA_OUTPUT_TARGET - pending);
+}
+
+// Kuyruktaki bildirimleri bağlantıların çıkış buffer'larına yazar; gönderim döngü sonunda yapılır
+static void process_notifications(Worker* worker) {
+    // eventfd kuyruk alınmadan önce sıfırlanır, sonra gelen bildirim yeniden uyandırır
+    uint64_t count;
+    ssize_t ignored = read(worker->notifier.fd, &count, sizeof(count));
+    (void)ignored;
     
-    // AUTH komutu her zaman çalışabilir, kimlik doğrulama kontrolü yapılmaz
-    if (strcmp(tokens[0], "auth") == 0) {
-        if (token_count >= 2) {
-            if (strcmp(tokens[1], server_password) == 0) {
-                client_auth_status[client_socket] = 1; // Kimlik doğrulama başarılı
-                strcpy(result, "OK: Authentication successful\r\n");
-            } else {
-                strcpy(result, "ERROR: Invalid password\r\n");
-            }
-        } else {
-            strcpy(result, "ERROR: auth command requires password\r\n");
+    pthread_mutex_lock(&worker->notify_mutex);
+    Notification* notification = worker->notifications;
+    worker->notifications = NULL;
+    worker->notifications_tail = &worker->notifications;
+    pthread_mutex_unlock(&worker->notify_mutex);
+    
+    while (notification) {
+        Notification* next = notification->next;
+        Connection* conn = notification->conn;
+        if (notification->stream) {
+            __atomic_store_n(&conn->stream_queued, false, __ATOMIC_RELEASE);
+            if (!conn->closing && !conn->client.failed) fill_replica_stream(conn);
+        } else if (!conn->closing && !conn->client.failed) {
+            tracking_write_invalidation(&conn->client, notification->key);
         }
+        // Sert sınır aşıldıysa bağlantı döngü sonundaki gönderimde kapatılır
+        if (conn->client.failed) mark_write_pending(conn);
+        free(notification);
+        notification = next;
     }
-    // PING ve HELP komutları da kimlik doğrulama kontrolü olmadan çalışabilir
-    else if (strcmp(tokens[0], "ping") == 0) {
-        strcpy(result, "PONG\r\n");
-    } else if (strcmp(tokens[0], "help") == 0) {
-        strcpy(result, "Available commands:\r\n");
-        strcat(result, "  auth <password>         : Authenticate with server\r\n");
-        strcat(result, "  set <key> <value>       : Store a key-value pair\r\n");
-        strcat(result, "  setex <key> <value> <ttl>: Store a key-value pair with expiration time in seconds\r\n");
-        strcat(result, "  get <key>               : Retrieve a value by key\r\n");
-        strcat(result, "  del <key>               : Delete a key-value pair\r\n");
-        strcat(result, "  save                    : Save a snapshot immediately\r\n");
-        strcat(result, "  interval <seconds>      : Set automatic snapshot interval (default: 300 seconds)\r\n");
-        strcat(result, "  compact                 : Remove expired keys and save snapshot\r\n");
-        strcat(result, "  config password <value> : Change server password\r\n");
-        strcat(result, "  ping                    : Test connection\r\n");
-        strcat(result, "  quit                    : Close connection\r\n");
-        strcat(result, "  shutdown                : Shutdown server\r\n");
-        strcat(result, "  help                    : Show this help message\r\n");
-    } 
-    // Diğer komutlar için kimlik doğrulama kontrolü yap
-    else if (client_auth_status[client_socket] != 1) {
-        strcpy(result, "ERROR: Authentication required. Use 'auth <password>' command\r\n");
-    }
-    // Kimlik doğrulaması yapılmışsa diğer komutları işle
-    else if (strcmp(tokens[0], "set") == 0) {
-        if (token_count >= 3) {
-            if (storage_set(storage, tokens[1], tokens[2])) {
-                strcpy(result, "OK\r\n");
-            } else {
-                sprintf(result, "ERROR: Failed to set key %s\r\n", tokens[1]);
+}
+
+static bool resume_input(Connection* conn);
+
+// quit/protokol hatasından sonra ya da istemci yazma yönünü kapatıp buffer'daki komutlar
+// işlendikten sonra, tüm çıktı gönderilince bağlantı kapatılır
+static bool input_finished(const Connection* conn) {
+    return (conn->client.close_requested || (conn->input_closed && !conn->input_paused)) && conn->out_len == 0;
+}
+
+// Döngü turunda biriken tüm çıktıları gönderir, kapanması gereken bağlantıları kapatır.
+// Gönderimden sonra okuması devam eden bağlantılar yeni çıktı üretebileceği için liste boşalana kadar döner.
+static void flush_pending_writes(Worker* worker) {
+    while (worker->pending_writes) {
+        Connection* conn = worker->pending_writes;
+        worker->pending_writes = NULL;
+        
+        while (conn) {
+            Connection* next = conn->pending_next;
+            conn->pending_next = NULL;
+            conn->write_pending = false;
+            
+            bool alive = !conn->client.failed && flush_connection(conn) && resume_input(conn);
+            if (conn->write_pending) {
+                // Devam eden okuma yeni çıktı üretti; bir sonraki turda gönderilir
+                if (!alive) conn->client.failed = true;
+            } else if (!alive || input_finished(conn)) {
+                close_connection(worker, conn);
             }
-        } else {
-            strcpy(result, "ERROR: set command requires key and value\r\n");
+            conn = next;
         }
-    } else if (strcmp(tokens[0], "setex") == 0) {
-        if (token_count >= 4) {
-            int ttl = atoi(tokens[3]);
-            if (storage_set_with_ttl(storage, tokens[1], tokens[2], ttl)) {
-                sprintf(result, "OK\r\n");
-            } else {
-                sprintf(result, "ERROR: Failed to set key %s with TTL\r\n", tokens[1]);
-            }
-        } else {
-            strcpy(result, "ERROR: setex command requires key, value, and ttl\r\n");
+    }
+}
+
+// Okuma buffer'ındaki tüm tamamlanmış RESP komutlarını çalıştırır
+// ve işlenen bayt sayısını döner. Protokol hatasında false döner.
+static bool process_resp_commands(Connection* conn, size_t* consumed) {
+    char* argv[RESP_MAX_ARGS];
+    size_t start = 0;
+    
+    while (start < conn->in_len && !conn->client.close_requested && !conn->client.failed &&
+           !output_blocked(conn)) {
+        RespParser* parser = &conn->parser;
+        RespStatus status = resp_parse(parser, conn->in + start, conn->in_len - start);
+        if (status == RESP_INCOMPLETE) break;
+        if (status == RESP_ERROR) {
+            reply_raw(&conn->client, "-ERR Protocol error\r\n", 21);
+            *consumed = start;
+            return false;
         }
-    } else if (strcmp(tokens[0], "get") == 0) {
-        if (token_count >= 2) {
-            char* val = storage_get(storage, tokens[1]);
-            if (val) {
-                sprintf(result, "%s\r\n", val);
-                free(val);
-            } else {
-                strcpy(result, "NULL\r\n");
-            }
-        } else {
-            strcpy(result, "ERROR: get command requires key\r\n");
+        
+        if (parser->argc > RESP_MAX_ARGS) {
+            reply_error(&conn->client, "too many arguments (max %d)", RESP_MAX_ARGS);
+        } else if (parser->has_nul) {
+            command_reject(&conn->client, "arguments cannot contain NUL bytes");
+        } else if (parser->argc > 0) {
+            // Argümanlar buffer'ın içini gösterir, kopyalanmaz
+            resp_args(parser, conn->in + start, argv);
+            if (logging_enabled) printf("Command received from client: %s\n", argv[0]);
+            command_execute(&conn->client, parser->argc, argv);
         }
-    } else if (strcmp(tokens[0], "del") == 0) {
-        if (token_count >= 2) {
-            if (storage_delete(storage, tokens[1])) {
-                strcpy(result, "OK\r\n");
-            } else {
-                sprintf(result, "ERROR: Failed to delete key %s\r\n", tokens[1]);
-            }
-        } else {
-            strcpy(result, "ERROR: del command requires key\r\n");
+        
+        start += parser->pos;
+        resp_parser_reset(parser);
+    }
+    
+    *consumed = start;
+    return true;
+}
+
+// Kabul edilen soketi worker'a bağlar ve toplam bağlantı sayısını döner
+static size_t attach_connection(Worker* worker, Connection* listener, Connection* conn, int fd) {
+    // Yanıt ve istem ayrı paketlerde gittiği için Nagle gecikmesini kapat
+    if (!listener->is_unix) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    conn->is_unix = listener->is_unix;
+    
+    conn->fd = fd;
+    conn->worker = worker;
+    conn->client.id = command_next_client_id();
+    conn->client.resp_version = 2;
+    conn->client.write = client_write;
+    conn->client.reserve = client_reserve;
+    conn->client.commit = client_commit;
+    conn->client.notify = client_notify;
+    resp_parser_reset(&conn->parser);
+    conn->next = worker->connections;
+    if (worker->connections) worker->connections->prev = conn;
+    worker->connections = conn;
+    return __atomic_add_fetch(&connection_count, 1, __ATOMIC_RELAXED);
+}
+
+// Dinleyicideki tüm bekleyen bağlantıları kabul eder
+static void accept_connections(Worker* worker, Connection* listener) {
+    while (running) {
+        struct sockaddr_storage client_addr;
+        socklen_t addrlen = sizeof(client_addr);
+        int fd = accept4(listener->fd, (struct sockaddr*)&client_addr, &addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) perror("accept");
+            return;
         }
-    } else if (strcmp(tokens[0], "compact") == 0) {
-        storage_compact();
-        strcpy(result, "OK: Compaction process complete\r\n");
-    } else if (strcmp(tokens[0], "save") == 0) {
-        if (storage_save_snapshot()) {
-            strcpy(result, "OK: Snapshot saved successfully\r\n");
-        } else {
-            strcpy(result, "ERROR: Failed to save snapshot\r\n");
+        
+        Connection* conn = calloc(1, sizeof(Connection));
+        struct epoll_event ev;
+        ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        ev.data.ptr = conn;
+        if (!conn || epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+            // Kabul edilen soket her durumda ya servis edilir ya da kapatılır
+            perror("Failed to register connection");
+            free(conn);
+            close(fd);
+            continue;
         }
-    } else if (strcmp(tokens[0], "interval") == 0) {
-        if (token_count >= 2) {
-            int interval = atoi(tokens[1]);
-            if (interval > 0) {
-                storage_schedule_snapshot(interval);
-                sprintf(result, "OK: Snapshot interval set to %d seconds\r\n", interval);
-            } else {
-                strcpy(result, "ERROR: Invalid interval value\r\n");
-            }
-        } else {
-            strcpy(result, "ERROR: interval command requires seconds value\r\n");
+        
+        size_t clients = attach_connection(worker, listener, conn, fd);
+        if (logging_enabled && listener->is_unix) {
+            printf("New connection, socket fd: %d, unix socket, worker: %d, clients: %zu\n", fd, worker->id, clients);
+        } else if (logging_enabled) {
+            struct sockaddr_in* tcp_addr = (struct sockaddr_in*)&client_addr;
+            printf("New connection, socket fd: %d, ip: %s, port: %d, worker: %d, clients: %zu\n",
+                   fd, inet_ntoa(tcp_addr->sin_addr), ntohs(tcp_addr->sin_port), worker->id, clients);
         }
-    } else if (strcmp(tokens[0], "exit") == 0 || strcmp(tokens[0], "quit") == 0) {
-        strcpy(result, "OK: Closing connection\r\n");
-        close_client_socket(client_socket);
-    } else if (strcmp(tokens[0], "shutdown") == 0) {
-        strcpy(result, "OK: Server shutting down\r\n");
-        running = 0;
-    } else if (strcmp(tokens[0], "config") == 0) {
-        if (token_count >= 3) {
-            if (strcmp(tokens[1], "password") == 0) {
-                if (strlen(tokens[2]) > 0) {
-                    strncpy(server_password, tokens[2], sizeof(server_password) - 1);
-                    server_password[sizeof(server_password) - 1] = '\0';
-                    strcpy(result, "OK: Password changed successfully\r\n");
-                } else {
-                    strcpy(result, "ERROR: Password cannot be empty\r\n");
-                }
-            } else {
-                sprintf(result, "ERROR: Unknown config option: %s\r\n", tokens[1]);
-            }
-        } else {
-            strcpy(result, "ERROR: config command requires option and value\r\n");
-            strcat(result, "       Available options: password\r\n");
+        // Hoş geldin mesajı protokol belli olunca gönderilir; RESP istemcileri
+        // istenmeyen veri beklemez
+    }
+}
+
+// Telnet modunda ilk komuttan önce gönderilir
+static void send_welcome(Connection* conn) {
+    const char* welcome_message = "Welcome to AytDB!\r\nAuthentication required. Use 'auth <password>' command.\r\nType 'help' for available commands\r\n";
+    reply_raw(&conn->client, welcome_message, strlen(welcome_message));
+}
+
+// Telnet modu: buffer'daki tamamlanmış tüm satırları sırayla çalıştırır ve
+// işlenen bayt sayısını döner. Yarım kalan satır sonraki okumayı bekler.
+static size_t process_telnet_commands(Connection* conn) {
+    size_t start = 0;
+    
+    while (start < conn->in_len && !conn->client.close_requested && !conn->client.failed &&
+           !output_blocked(conn)) {
+        char* line = conn->in + start;
+        char* newline = memchr(line, '\n', conn->in_len - start);
+        if (!newline) break;
+        start = (size_t)(newline - conn->in) + 1;
+        
+        // Yeni satır karakterlerini kaldır
+        *newline = '\0';
+        if (newline > line && newline[-1] == '\r') newline[-1] = '\0';
+        
+        // Komutu işle
+        if (*line) {
+            if (logging_enabled) printf("Command received from client: %s\n", line);
+            command_execute_line(&conn->client, line);
+            // İstem sadece pipeline'ın son komutundan sonra gönderilir
+            bool more = memchr(conn->in + start, '\n', conn->in_len - start) != NULL;
+            if (!more && !conn->client.prompt_disabled) reply_raw(&conn->client, "> ", 2);
         }
-    } else {
-        sprintf(result, "ERROR: Unknown command: %s\r\n", tokens[0]);
     }
+    return start;
+}
+
+// Okuma buffer'ında en az needed bayt boş yer olmasını sağlar
+static bool reserve_input(Connection* conn, size_t needed) {
+    if (conn->in_cap - conn->in_len >= needed) return true;
     
-    // Belleği temizle
-    for (int i = 0; i < token_count; i++) {
-        free(tokens[i]);
+    size_t limit = MAX_QUERY_SIZE;
+#ifdef AYTDB_HAVE_URING_NET
+    // io_uring'de girdi durdurulurken recv iptalinden önce tamamlanmış okumalar da alınır;
+    // bunlar en fazla ortak buffer havuzu kadardır
+    if (conn->input_paused) limit += URING_BUFFER_COUNT * URING_BUFFER_SIZE;
+#endif
+    size_t new_cap = conn->in_cap ? conn->in_cap : READ_BUFFER_SIZE;
+    while (new_cap - conn->in_len < needed) new_cap *= 2;
+    if (new_cap > limit) {
+        new_cap = limit;
+        if (new_cap - conn->in_len < needed) return false;
+    }
+    char* grown = realloc(conn->in, new_cap);
+    if (!grown) return false;
+    conn->in = grown;
+    conn->in_cap = new_cap;
+    return true;
+}
+
+// Okuma buffer'ına yeni eklenen veriyle tamamlanan komutları çalıştırır
+static void process_input(Connection* conn) {
+    if (conn->client.protocol == PROTOCOL_UNKNOWN) {
+        conn->client.protocol = conn->in[0] == '*' ? PROTOCOL_RESP : PROTOCOL_TELNET;
+        if (conn->client.protocol == PROTOCOL_TELNET) send_welcome(conn);
     }
     
-    return result;
+    // Okunan tüm tamamlanmış komutlar (pipeline) sırayla çalıştırılır
+    size_t consumed;
+    bool ok = true;
+    if (conn->client.protocol == PROTOCOL_TELNET) {
+        consumed = process_telnet_commands(conn);
+    } else {
+        ok = process_resp_commands(conn, &consumed);
+    }
+    // İşlenen komutları at, yarım kalan komut buffer'ın başına taşınır
+    if (consumed > 0) {
+        memmove(conn->in, conn->in + consumed, conn->in_len - consumed);
+        conn->in_len -= consumed;
+    }
+    if (!ok) {
+        // Protokol hatası yanıtı gönderildikten sonra kapat
+        conn->client.close_requested = true;
+    }
+    
+    // Kalan komutlar ve soketteki veri çıktı gönderilince işlenir
+    if (!conn->input_paused && output_blocked(conn)) {
+        conn->input_paused = true;
+        if (logging_enabled) printf("Output buffer soft limit reached, pausing input, socket fd: %d\n", conn->fd);
+    }
 }
 
-// AytDB telnet sunucusunu başlat
-int start_server(int port) {
-    struct sockaddr_in server_addr;
+// Soketteki tüm veriyi okur (edge-triggered olduğu için EAGAIN'e kadar).
+// false dönerse bağlantı kapatılmalı.
+static bool handle_readable(Connection* conn) {
+    while (!conn->client.close_requested && !conn->client.failed && !conn->input_paused && !conn->input_closed) {
+        if (!reserve_input(conn, 1)) {
+            if (logging_enabled) printf("Query buffer limit exceeded, socket fd: %d\n", conn->fd);
+            return false;
+        }
+        
+        ssize_t valread = read(conn->fd, conn->in + conn->in_len, conn->in_cap - conn->in_len);
+        if (valread < 0) {
+            if (errno == EINTR) continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        if (valread == 0) {
+            // İstemci yazma yönünü kapattı (shutdown(SHUT_WR) ya da close). Okuma biter;
+            // buffer'daki komutların yanıtları gönderildikten sonra bağlantı kapatılır
+            if (logging_enabled) printf("Client disconnected, socket fd: %d\n", conn->fd);
+            conn->input_closed = true;
+            return true;
+        }
+        conn->in_len += (size_t)valread;
+        process_input(conn);
+    }
+    return !conn->client.failed;
+}
+
+// Çıktı yumuşak sınırın altına indiyse bekletilen komutları çalıştırır ve okumaya devam eder.
+// false dönerse bağlantı kapatılmalı.
+static bool resume_input(Connection* conn) {
+    // Replika akışının devamı diğer bağlantıları bekletmemek için sonraki döngü turunda eklenir
+    if (conn->client.replica && pending_output(conn) < REPLICA_OUTPUT_TARGET &&
+        replication_pending(&conn->client)) {
+        client_notify(&conn->client, NULL);
+    }
+    if (!conn->input_paused || output_blocked(conn)) return true;
+    conn->input_paused = false;
+    if (conn->in_len > 0) process_input(conn);
     
-    // Tüm istemci socketleri ve kimlik doğrulama durumlarını -1 ile başlat
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        client_sockets[i] = -1;
-        client_auth_status[i] = 0;
+#ifdef AYTDB_HAVE_URING_NET
+    // io_uring'de durdurulurken iptal edilen multishot recv yeniden kurulur; iptal henüz
+    // sonuçlanmadıysa recv tamamlanınca uring_handle_recv kurar
+    if (use_io_uring) {
+        if (conn->client.failed) return false;
+        if (conn->input_paused || conn->input_closed || conn->recv_armed || conn->closing) return true;
+        return uring_arm_recv(conn->worker, conn);
     }
+#endif
+    // Edge-triggered: bekleme sırasında gelen veri için yeni olay gelmez, EAGAIN'e kadar okunur
+    return handle_readable(conn);
+}
+
+// Worker için dinleyici soketi aç; birden çok worker varsa aynı porta SO_REUSEPORT ile bağlanır
+static int open_listener(int port) {
+    struct sockaddr_in server_addr;
     
     // TCP soketi oluştur
-    server_socket = socket(AF_INET, SOCK_STREAM, 0);
+    int server_socket = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
     if (server_socket == -1) {
         perror("Could not create socket");
-        return 1;
+        return -1;
     }
     
     // SO_REUSEADDR ayarla (port yeniden kullanımı için)
@@ -268,7 +680,14 @@ int start_server(int port) {
     if (setsockopt(server_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt)) < 0) {
         perror("setsockopt failed");
         close(server_socket);
-        return 1;
+        return -1;
+    }
+    
+    // Tek worker'da başka bir sürecin aynı porta bağlanmasına izin verme
+    if (worker_count > 1 && setsockopt(server_socket, SOL_SOCKET, SO_REUSEPORT, &opt, sizeof(opt)) < 0) {
+        perror("SO_REUSEPORT failed");
+        close(server_socket);
+        return -1;
     }
     
     // Sunucu adresini hazırla
@@ -281,129 +700,614 @@ int start_server(int port) {
     if (bind(server_socket, (struct sockaddr *)&server_addr, sizeof(server_addr)) < 0) {
         perror("Bind failed");
         close(server_socket);
-        return 1;
+        return -1;
     }
     
     // Dinlemeye başla
-    if (listen(server_socket, 5) < 0) {
+    if (listen(server_socket, LISTEN_BACKLOG) < 0) {
         perror("Listen failed");
         close(server_socket);
-        return 1;
+        return -1;
     }
     
-    printf("AytDB server started on port %d...\n", port);
-    printf("To connect: telnet localhost %d\n", port);
+    return server_socket;
+}
+
+// Yerel istemciler için Unix domain soketi aç. Unix soketlerinde SO_REUSEPORT
+// olmadığı için tek soket açılır ve tüm worker'lar aynı soketten accept eder.
+static int open_unix_listener(const char* path, mode_t permissions) {
+    struct sockaddr_un server_addr;
+    if (strlen(path) >= sizeof(server_addr.sun_path)) {
+        fprintf(stderr, "Unix socket path is too long: %s\n", path);
+        return -1;
+    }
     
-    fd_set readfds;
-    int max_sd, activity, new_socket, sd;
-    int addrlen = sizeof(server_addr);
-    char buffer[BUFFER_SIZE];
+    int server_socket = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (server_socket == -1) {
+        perror("Could not create unix socket");
+        return -1;
+    }
     
-    while (running) {
-        // fd_set'i temizle
-        FD_ZERO(&readfds);
+    memset(&server_addr, 0, sizeof(server_addr));
+    server_addr.sun_family = AF_UNIX;
+    strcpy(server_addr.sun_path, path);
+    
+    // Önceki çalışmadan kalan soket dosyası bind'ı engeller
+    unlink(path);
+    if (bind(server_socket, (struct sockaddr*)&server_addr, sizeof(server_addr)) < 0) {
+        perror("Unix socket bind failed");
+        close(server_socket);
+        return -1;
+    }
+    
+    if (permissions && chmod(path, permissions) < 0) {
+        perror("Unix socket chmod failed");
+        close(server_socket);
+        unlink(path);
+        return -1;
+    }
+    
+    if (listen(server_socket, LISTEN_BACKLOG) < 0) {
+        perror("Listen failed");
+        close(server_socket);
+        unlink(path);
+        return -1;
+    }
+    
+    return server_socket;
+}
+
+#ifdef AYTDB_HAVE_URING_NET
+
+// Kernel io_uring'i, provided buffer ring'leri ve multishot istekleri destekliyor mu
+static bool uring_network_available() {
+    Uring ring;
+    if (!uring_init(&ring, 2)) return false;
+    UringBufRing buffers;
+    bool available = uring_buf_ring_init(&ring, &buffers, 2, 64, URING_BUFFER_GROUP);
+    if (available) uring_buf_ring_free(&ring, &buffers);
+    uring_exit(&ring);
+    return available;
+}
+
+// Boş SQE döner; kuyruk doluysa bekleyenleri kernel'e verip tekrar dener
+static struct io_uring_sqe* uring_acquire_sqe(Worker* worker) {
+    struct io_uring_sqe* sqe = uring_get_sqe(&worker->ring);
+    if (!sqe && uring_submit(&worker->ring, 0) >= 0) {
+        sqe = uring_get_sqe(&worker->ring);
+    }
+    return sqe;
+}
+
+// Dinleyicide multishot accept: her yeni bağlantı ayrı bir CQE olarak gelir
+static bool uring_arm_accept(Worker* worker, Connection* listener) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(worker);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listener->fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = (uintptr_t)listener | URING_OP_ACCEPT;
+    return true;
+}
+
+// Kapanış eventfd'si için tek seferlik poll; okunmadığı için tüm worker'lar görür
+static bool uring_arm_wakeup(Worker* worker) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(worker);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = wakeup_fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = URING_OP_WAKEUP;
+    return true;
+}
+
+// Bildirim eventfd'si için tek seferlik poll; her tamamlanmadan sonra yeniden kurulur
+static bool uring_arm_notify(Worker* worker) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(worker);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = worker->notifier.fd;
+    sqe->poll32_events = POLLIN;
+    sqe->user_data = (uintptr_t)&worker->notifier | URING_OP_WAKEUP;
+    return true;
+}
+
+// Bağlantıda multishot recv: veri geldikçe ortak havuzdan bir buffer seçilir
+static bool uring_arm_recv(Worker* worker, Connection* conn) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(worker);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = conn->fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = (uintptr_t)conn | URING_OP_RECV;
+    conn->uring_ops++;
+    conn->recv_armed = true;
+    return true;
+}
+
+// Girdi durdurulunca multishot recv iptal edilir, böylece çıktı beklerken okuma buffer'ı
+// dolmaz; recv -ECANCELED ile sonlanır. İptal hemen kernel'e verilir ki kalan olaylar
+// işlenirken havuza dönen buffer'lar bu bağlantıya yeniden dolmasın. İptalin kendi sonucu
+// yalnızca hata olursa, bağlantısız (NULL) olay olarak gelir ve yok sayılır
+static void uring_cancel_recv(Worker* worker, Connection* conn) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(worker);
+    if (!sqe) return;
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->addr = (uintptr_t)conn | URING_OP_RECV;
+    sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+    sqe->user_data = URING_OP_WAKEUP;
+    uring_submit(&worker->ring, 0);
+}
+
+// sending buffer'ının kalan kısmı için send isteği hazırlar
+static bool uring_submit_send(Connection* conn) {
+    struct io_uring_sqe* sqe = uring_acquire_sqe(conn->worker);
+    if (!sqe) return false;
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->fd;
+    sqe->addr = (uintptr_t)(conn->sending + conn->sending_sent);
+    sqe->len = (unsigned)(conn->sending_len - conn->sending_sent);
+    sqe->msg_flags = MSG_NOSIGNAL;
+    sqe->user_data = (uintptr_t)conn | URING_OP_SEND;
+    conn->uring_ops++;
+    return true;
+}
+
+// Biriken çıktıyı gönderime verir. Kernel gönderim bitene kadar buffer'ı okuduğu için
+// out ile sending takas edilir; yeni yanıtlar realloc ile taşınabilecek out'a yazılmaya
+// devam eder ve önceki gönderim bitmeden yenisi başlatılmaz.
+static bool uring_send_output(Connection* conn) {
+    if (conn->sending_len > 0 || conn->out_len == 0 || conn->closing) return true;
+    
+    char* buffer = conn->sending;
+    size_t cap = conn->sending_cap;
+    conn->sending = conn->out;
+    conn->sending_cap = conn->out_cap;
+    conn->sending_len = conn->out_len;
+    conn->sending_sent = 0;
+    conn->out = buffer;
+    conn->out_cap = cap;
+    conn->out_len = 0;
+    conn->out_sent = 0;
+    return uring_submit_send(conn);
+}
+
+// Bağlantıyı kapatmaya başlar. Kernel'de bekleyen istekler Connection'ı gösterdiği
+// için bellek hepsi tamamlanınca serbest bırakılır; shutdown bu istekleri sonlandırır.
+static void uring_close_connection(Worker* worker, Connection* conn) {
+    if (!conn->closing) {
+        conn->closing = true;
+        shutdown(conn->fd, SHUT_RDWR);
+    }
+    if (conn->uring_ops == 0) close_connection(worker, conn);
+}
+
+// Olay sonrası bağlantının kapatılması gerekiyorsa kapatır
+static void uring_finish_event(Worker* worker, Connection* conn, bool alive) {
+    if (conn->write_pending) {
+        // Bağlantı bekleyen gönderim listesinde; kapatma döngü sonunda yapılır
+        if (!alive) conn->client.failed = true;
+    } else if (!alive || conn->closing ||
+               (input_finished(conn) && conn->sending_len == 0)) {
+        uring_close_connection(worker, conn);
+    }
+}
+
+static void uring_handle_accept(Worker* worker, Connection* listener, struct io_uring_cqe* cqe) {
+    // Multishot accept hata veya taşma nedeniyle sonlandıysa yeniden kur
+    if (!(cqe->flags & IORING_CQE_F_MORE) && running && !uring_arm_accept(worker, listener)) {
+        fprintf(stderr, "Failed to re-arm accept on worker %d\n", worker->id);
+    }
+    if (cqe->res < 0) {
+        if (cqe->res != -ECANCELED) fprintf(stderr, "accept: %s\n", strerror(-cqe->res));
+        return;
+    }
+    
+    int fd = cqe->res;
+    Connection* conn = calloc(1, sizeof(Connection));
+    if (!conn) {
+        perror("Failed to register connection");
+        close(fd);
+        return;
+    }
+    size_t clients = attach_connection(worker, listener, conn, fd);
+    if (!uring_arm_recv(worker, conn)) {
+        fprintf(stderr, "Failed to register connection, socket fd: %d\n", fd);
+        close_connection(worker, conn);
+        return;
+    }
+    if (logging_enabled) printf("New connection, socket fd: %d, %s, worker: %d, clients: %zu\n",
+                                fd, listener->is_unix ? "unix socket" : "tcp", worker->id, clients);
+}
+
+static void uring_handle_recv(Worker* worker, Connection* conn, struct io_uring_cqe* cqe) {
+    bool more = cqe->flags & IORING_CQE_F_MORE;
+    if (!more) {
+        conn->uring_ops--;
+        conn->recv_armed = false;
+    }
+    
+    bool alive = !conn->closing && !conn->client.failed;
+    if (cqe->res > 0) {
+        unsigned id = cqe->flags >> IORING_CQE_BUFFER_SHIFT;
+        size_t len = (size_t)cqe->res;
+        // quit sonrası gelen veri yok sayılır
+        if (alive && !conn->client.close_requested) {
+            if (reserve_input(conn, len)) {
+                memcpy(conn->in + conn->in_len, uring_buf_ring_buffer(&worker->buffers, id), len);
+                conn->in_len += len;
+                process_input(conn);
+                alive = !conn->client.failed;
+            } else {
+                if (logging_enabled) printf("Query buffer limit exceeded, socket fd: %d\n", conn->fd);
+                alive = false;
+            }
+        }
+        // Veri okuma buffer'ına kopyalandı, buffer hemen havuza döner
+        uring_buf_ring_recycle(&worker->buffers, id);
+    } else if (cqe->res == 0) {
+        // İstemci yazma yönünü kapattı; epoll'daki gibi yanıtlar gönderilince kapatılır
+        if (alive && logging_enabled) printf("Client disconnected, socket fd: %d\n", conn->fd);
+        conn->input_closed = true;
+    } else if (cqe->res != -ENOBUFS && cqe->res != -ECANCELED) {
+        // Okuma hatası
+        if (alive && logging_enabled) printf("Client disconnected, socket fd: %d\n", conn->fd);
+        alive = false;
+    }
+    
+    // Çıktı yumuşak sınırı aşıldı: gönderim ilerleyene kadar soketten okunmaz
+    if (alive && more && conn->input_paused) uring_cancel_recv(worker, conn);
+    // Havuz boşaldığında (ENOBUFS) multishot recv sonlanır; buffer'lar döndükçe yeniden kurulur.
+    // İptal edilen recv ise girdi devam ettirildiyse kurulur
+    if (alive && !more && !conn->input_closed && !conn->input_paused && !uring_arm_recv(worker, conn)) alive = false;
+    uring_finish_event(worker, conn, alive);
+}
+
+static void uring_handle_send(Worker* worker, Connection* conn, struct io_uring_cqe* cqe) {
+    conn->uring_ops--;
+    
+    bool alive = !conn->closing && !conn->client.failed && cqe->res >= 0;
+    if (alive) {
+        conn->sending_sent += (size_t)cqe->res;
+        if (conn->sending_sent < conn->sending_len) {
+            // Kısmi gönderim: kalan kısım için yeni istek
+            alive = uring_submit_send(conn);
+        } else {
+            conn->sending_len = 0;
+            conn->sending_sent = 0;
+            // Büyük bir yanıt için büyümüş buffer'ı boşta tutma
+            if (conn->sending_cap > OUTPUT_FLUSH_THRESHOLD) {
+                free(conn->sending);
+                conn->sending = NULL;
+                conn->sending_cap = 0;
+            }
+            // Gönderim sürerken biriken yanıtlar ve çıktı beklerken durdurulan komutlar
+            alive = resume_input(conn);
+            if (alive && !conn->write_pending) alive = uring_send_output(conn);
+        }
+    }
+    uring_finish_event(worker, conn, alive);
+}
+
+// Döngü turunda biriken çıktıları send isteği olarak sıraya koyar; hepsi bir sonraki
+// io_uring_enter çağrısında tek seferde kernel'e verilir
+static void uring_flush_pending_writes(Worker* worker) {
+    Connection* conn = worker->pending_writes;
+    worker->pending_writes = NULL;
+    
+    while (conn) {
+        Connection* next = conn->pending_next;
+        conn->pending_next = NULL;
+        conn->write_pending = false;
         
-        // Sunucu soketini ekle
-        FD_SET(server_socket, &readfds);
-        max_sd = server_socket;
+        bool alive = !conn->client.failed && uring_send_output(conn);
+        uring_finish_event(worker, conn, alive);
+        conn = next;
+    }
+}
+
+// Worker'ın io_uring halkasını ve ilk isteklerini hazırla
+static bool uring_worker_init(Worker* worker) {
+    if (!uring_init(&worker->ring, URING_ENTRIES)) {
+        perror("io_uring setup failed");
+        return false;
+    }
+    if (!uring_buf_ring_init(&worker->ring, &worker->buffers, URING_BUFFER_COUNT,
+                             URING_BUFFER_SIZE, URING_BUFFER_GROUP)) {
+        perror("io_uring buffer ring registration failed");
+        return false;
+    }
+    bool armed = uring_arm_accept(worker, &worker->listener) && uring_arm_wakeup(worker) &&
+                 uring_arm_notify(worker);
+    if (armed && worker->unix_listener.fd != -1) armed = uring_arm_accept(worker, &worker->unix_listener);
+    if (!armed) {
+        fprintf(stderr, "io_uring submission queue is full\n");
+        return false;
+    }
+    return true;
+}
+
+// io_uring olay döngüsü: her turda önceki turun gönderimleri ve yeniden kurulan
+// istekler tek io_uring_enter ile verilir ve en az bir tamamlanma beklenir
+static void* uring_worker_loop(Worker* worker) {
+    while (running) {
+        if (uring_submit(&worker->ring, 1) < 0 && errno != EBUSY && errno != EAGAIN) {
+            perror("io_uring_enter error");
+            request_shutdown();
+            break;
+        }
         
-        // İstemci soketlerini ekle
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            sd = client_sockets[i];
+        struct io_uring_cqe* cqe;
+        while ((cqe = uring_peek_cqe(&worker->ring))) {
+            struct io_uring_cqe event = *cqe;
+            uring_cqe_seen(&worker->ring);
             
-            // Geçerli bir soket ise fd_set'e ekle
-            if (sd > 0)
-                FD_SET(sd, &readfds);
-            
-            // En yüksek soket tanımlayıcısını güncelle
-            if (sd > max_sd)
-                max_sd = sd;
+            Connection* conn = (Connection*)(uintptr_t)(event.user_data & ~(uint64_t)URING_OP_MASK);
+            switch (event.user_data & URING_OP_MASK) {
+            case URING_OP_ACCEPT: uring_handle_accept(worker, conn, &event); break;
+            case URING_OP_RECV: uring_handle_recv(worker, conn, &event); break;
+            case URING_OP_SEND: uring_handle_send(worker, conn, &event); break;
+            default:
+                // Tracking bildirimi; kapanış uyandırmasında ve başarısız recv iptalinde conn NULL
+                if (conn) {
+                    process_notifications(worker);
+                    if (!uring_arm_notify(worker)) fprintf(stderr, "Failed to re-arm notifications on worker %d\n", worker->id);
+                }
+                break;
+            }
         }
         
-        // Soketleri bekle
-        activity = select(max_sd + 1, &readfds, NULL, NULL, NULL);
-        
-        if ((activity < 0) && (errno != EINTR)) {
-            if (!running) break; // Sinyal nedeniyle çıkıyorsa sessizce çık
-            perror("select error");
-            continue;
+        // Bu turda üretilen tüm yanıtlar için send istekleri
+        uring_flush_pending_writes(worker);
+    }
+    return NULL;
+}
+
+#endif // AYTDB_HAVE_URING_NET
+
+// Worker'ın dinleyicisini ve epoll kümesini (veya io_uring halkasını) hazırla
+static bool worker_init(Worker* worker, int id, int port) {
+    memset(worker, 0, sizeof(*worker));
+    worker->id = id;
+    worker->epoll_fd = -1;
+    pthread_mutex_init(&worker->notify_mutex, NULL);
+    worker->notifications_tail = &worker->notifications;
+    worker->notifier.fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (worker->notifier.fd < 0) {
+        perror("eventfd failed");
+        return false;
+    }
+#ifdef AYTDB_HAVE_URING_NET
+    worker->ring.fd = -1;
+#endif
+    worker->unix_listener.is_listener = true;
+    worker->unix_listener.is_unix = true;
+    worker->unix_listener.fd = unix_listener_fd;
+    worker->listener.is_listener = true;
+    worker->listener.fd = open_listener(port);
+    if (worker->listener.fd < 0) return false;
+    
+#ifdef AYTDB_HAVE_URING_NET
+    if (use_io_uring) return uring_worker_init(worker);
+#endif
+    
+    worker->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (worker->epoll_fd < 0) {
+        perror("epoll_create1 failed");
+        return false;
+    }
+    
+    struct epoll_event ev;
+    ev.events = EPOLLIN | EPOLLET;
+    ev.data.ptr = &worker->listener;
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->listener.fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        return false;
+    }
+    
+    // Paylaşılan Unix soketinde her bağlantı için sadece bir worker uyandırılır
+    if (worker->unix_listener.fd != -1) {
+        ev.events = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.ptr = &worker->unix_listener;
+        if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->unix_listener.fd, &ev) < 0) {
+            perror("epoll_ctl failed");
+            return false;
+        }
+    }
+    
+    // Uyandırma eventfd'si level-triggered: okunmadığı için tüm worker'lar görür
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, wakeup_fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        return false;
+    }
+    
+    ev.events = EPOLLIN;
+    ev.data.ptr = &worker->notifier;
+    if (epoll_ctl(worker->epoll_fd, EPOLL_CTL_ADD, worker->notifier.fd, &ev) < 0) {
+        perror("epoll_ctl failed");
+        return false;
+    }
+    return true;
+}
+
+// Worker'ın soketlerini ve bağlantılarını kapat
+static void worker_close(Worker* worker) {
+#ifdef AYTDB_HAVE_URING_NET
+    // Halka kapanınca kernel bekleyen istekleri iptal eder; bağlantılar ondan sonra serbest bırakılır
+    if (worker->ring.fd != -1) {
+        uring_buf_ring_free(&worker->ring, &worker->buffers);
+        uring_exit(&worker->ring);
+    }
+#endif
+    if (worker->listener.fd != -1) {
+        close(worker->listener.fd);
+        worker->listener.fd = -1;
+    }
+    while (worker->connections) {
+        close_connection(worker, worker->connections);
+    }
+    if (worker->epoll_fd != -1) {
+        close(worker->epoll_fd);
+        worker->epoll_fd = -1;
+    }
+    if (worker->notifier.fd != -1) {
+        close(worker->notifier.fd);
+        worker->notifier.fd = -1;
+    }
+    pthread_mutex_destroy(&worker->notify_mutex);
+}
+
+// Worker olay döngüsü
+static void* worker_loop(void* arg) {
+    Worker* worker = arg;
+#ifdef AYTDB_HAVE_URING_NET
+    if (use_io_uring) return uring_worker_loop(worker);
+#endif
+    struct epoll_event events[MAX_EVENTS];
+    
+    while (running) {
+        // Olayları bekle - sinyal gelirse EINTR ile döner
+        int ready = epoll_wait(worker->epoll_fd, events, MAX_EVENTS, -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait error");
+            request_shutdown();
+            break;
         }
         
-        // Yeni bağlantı var mı kontrol et
-        if (FD_ISSET(server_socket, &readfds)) {
-            if ((new_socket = accept(server_socket, (struct sockaddr *)&server_addr, (socklen_t*)&addrlen)) < 0) {
-                perror("accept");
+        for (int i = 0; i < ready; i++) {
+            Connection* conn = events[i].data.ptr;
+            
+            // Kapanış uyandırması
+            if (!conn) continue;
+            
+            if (conn == &worker->notifier) {
+                process_notifications(worker);
                 continue;
             }
             
-            printf("New connection, socket fd: %d, ip: %s, port: %d\n", 
-                new_socket, inet_ntoa(server_addr.sin_addr), ntohs(server_addr.sin_port));
+            // Yeni bağlantı var mı kontrol et
+            if (conn->is_listener) {
+                accept_connections(worker, conn);
+                continue;
+            }
             
-            // Hoş geldin mesajı gönder
-            char *welcome_message = "Welcome to AytDB!\r\nAuthentication required. Use 'auth <password>' command.\r\nType 'help' for available commands\r\n> ";
-            send(new_socket, welcome_message, strlen(welcome_message), 0);
+            bool alive = !(events[i].events & EPOLLERR);
+            // Soket yeniden yazılabilir oldu; döngü sonunu bekleyen çıktı orada gönderilir
+            if (alive && (events[i].events & EPOLLOUT) && !conn->write_pending) {
+                alive = flush_connection(conn) && resume_input(conn);
+            }
+            if (alive && (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP))) {
+                alive = handle_readable(conn);
+            }
             
-            // Soketi istemci soketi listesine ekle
-            for (int i = 0; i < MAX_CLIENTS; i++) {
-                if (client_sockets[i] == -1) {
-                    client_sockets[i] = new_socket;
-                    client_auth_status[i] = 0; // Yeni bağlantıyı kimlik doğrulaması yapılmamış olarak işaretle
-                    printf("Client added to list, index: %d\n", i);
-                    break;
-                }
+            if (conn->write_pending) {
+                // Bağlantı bekleyen gönderim listesinde; kapatma flush sırasında yapılır
+                if (!alive) conn->client.failed = true;
+            } else if (!alive || input_finished(conn)) {
+                // quit sonrası yanıt gönderildiyse ya da bağlantı koptuysa kapat
+                close_connection(worker, conn);
             }
         }
         
-        // İstemcilerden gelen verileri kontrol et
-        for (int i = 0; i < MAX_CLIENTS; i++) {
-            sd = client_sockets[i];
-            
-            if (FD_ISSET(sd, &readfds)) {
-                // İstemciden veri oku
-                int valread = read(sd, buffer, BUFFER_SIZE);
-                
-                if (valread == 0) {
-                    // İstemci bağlantıyı kapattı
-                    printf("Client disconnected, socket fd: %d\n", sd);
-                    close_client_socket(i);
-                    client_auth_status[i] = 0; // Bağlantı kapandığında kimlik doğrulama durumunu sıfırla
-                } else {
-                    // Veriyi terminat et (null-sonlandırma)
-                    buffer[valread] = '\0';
-                    
-                    // Yeni satır karakterlerini kaldır
-                    buffer[strcspn(buffer, "\r\n")] = 0;
-                    
-                    // Komutu işle
-                    if (strlen(buffer) > 0) {
-                        printf("Command received from client: %s\n", buffer);
-                        char* response = process_command(buffer, i);
-                        if (response) {
-                            send(sd, response, strlen(response), 0);
-                            // Komut işlendikten sonra yeni prompt gönder
-                            char *prompt = "> ";
-                            send(sd, prompt, strlen(prompt), 0);
-                            free(response);
-                        }
-                    }
-                }
+        // Bu turda üretilen tüm yanıtları bağlantı başına tek seferde gönder
+        flush_pending_writes(worker);
+    }
+    return NULL;
+}
+
+// AytDB telnet sunucusunu başlat
+int start_server(int port) {
+    wakeup_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeup_fd < 0) {
+        perror("eventfd failed");
+        return 1;
+    }
+    
+#ifdef AYTDB_HAVE_URING_NET
+    if (use_io_uring && !uring_network_available()) {
+        printf("io_uring networking is not supported by this kernel, falling back to epoll\n");
+        use_io_uring = false;
+    }
+#else
+    if (use_io_uring) {
+        printf("io_uring networking is not available in this build, falling back to epoll\n");
+        use_io_uring = false;
+    }
+#endif
+    
+    bool ok = true;
+    if (unix_socket_path) {
+        unix_listener_fd = open_unix_listener(unix_socket_path, unix_socket_perm);
+        ok = unix_listener_fd != -1;
+    }
+    if (ok && shm_socket_path) {
+        ok = shm_server_start(shm_socket_path, unix_socket_perm);
+    }
+    if (ok && replicaof_host) {
+        ok = replication_start_replica(replicaof_host, replicaof_port);
+    }
+    char announce[CLUSTER_ADDR_SIZE];
+    if (ok && cluster_config) {
+        snprintf(announce, sizeof(announce), "%s", cluster_announce ? cluster_announce : "127.0.0.1");
+        if (!strchr(announce, ':')) snprintf(announce + strlen(announce), sizeof(announce) - strlen(announce), ":%d", port);
+        ok = cluster_enable(cluster_config, announce);
+    }
+    
+    int ready_workers = 0;
+    for (int i = 0; i < worker_count && ok; i++) {
+        ok = worker_init(&workers[i], i, port);
+        ready_workers++;
+    }
+    
+    // İlk worker çağıran thread'de çalışır, diğerleri kendi thread'lerinde
+    int started = 1;
+    if (ok) {
+        printf("AytDB server started on port %d with %d %s worker thread(s)...\n", port, worker_count,
+               use_io_uring ? "io_uring" : "epoll");
+        printf("To connect: telnet localhost %d\n", port);
+        if (unix_socket_path) printf("Listening on unix socket %s\n", unix_socket_path);
+        if (shm_socket_path) printf("Shared memory clients connect through %s\n", shm_socket_path);
+        if (replicaof_host) printf("Replicating from primary %s:%d\n", replicaof_host, replicaof_port);
+        if (cluster_config) printf("Cluster mode enabled as %s (slot table: %s)\n", announce, cluster_config);
+        
+        for (; started < worker_count; started++) {
+            if (pthread_create(&workers[started].thread, NULL, worker_loop, &workers[started]) != 0) {
+                perror("Failed to start worker thread");
+                request_shutdown();
+                break;
             }
         }
+        worker_loop(&workers[0]);
+    }
+    
+    for (int i = 1; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
     }
     
     // Tüm soketleri kapat
     printf("Server shutting down...\n");
-    if (server_socket != -1) {
-        close(server_socket);
+    // Replika ve taşıma thread'leri storage'a yazar, storage kapanmadan önce durdurulur
+    replication_shutdown();
+    cluster_shutdown();
+    for (int i = 0; i < ready_workers; i++) {
+        worker_close(&workers[i]);
     }
-    
-    for (int i = 0; i < MAX_CLIENTS; i++) {
-        if (client_sockets[i] != -1) {
-            close(client_sockets[i]);
-        }
+    shm_server_stop();
+    if (unix_listener_fd != -1) {
+        close(unix_listener_fd);
+        unlink(unix_socket_path);
+        unix_listener_fd = -1;
     }
+    close(wakeup_fd);
+    wakeup_fd = -1;
     
-    return 0;
+    return ok ? 0 : 1;
 }
 
 // Telnet sunucusunu başlat
@@ -416,11 +1320,17 @@ int server_init(int port) {
     }
     
     printf("Storage initialized. Ready to process commands.\n");
+    command_init(storage, request_shutdown);
     
     // Sinyal işleyiciyi ayarla
     signal(SIGINT, signal_handler);
     signal(SIGTERM, signal_handler);
     
     // Sunucuyu başlat
-    return start_server(port);
+    int result = start_server(port);
+    
+    // Kapanışta son snapshot'ı al ve kalıcı tabloyu düzgün kapat
+    storage_free(storage);
+    storage = NULL;
+    return result;
 } 
\ No newline at end of file
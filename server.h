@@ -1,6 +1,9 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <stdbool.h>
+#include <stddef.h>
+
 /**
  * Starts a Redis-like telnet server on the specified port number.
  * This server allows clients to connect via telnet and process commands.
@@ -10,4 +13,87 @@
  */
 int server_init(int port);
 
+/**
+ * Sets the number of event-loop threads. Each thread accepts on its own
+ * SO_REUSEPORT listener and serves its connections independently.
+ * Must be called before server_init (default: 1).
+ *
+ * @param count Number of worker threads (clamped to 1..64)
+ */
+void server_set_threads(int count);
+
+/**
+ * Serves connections from an io_uring loop (multishot accept/recv with a
+ * shared provided-buffer ring, batched sends) instead of epoll. Falls back
+ * to epoll when the kernel or the build lacks support.
+ * Must be called before server_init (default: false).
+ *
+ * @param enabled true to use io_uring for networking
+ */
+void server_set_io_uring(bool enabled);
+
+/**
+ * Also listens on a Unix domain socket at the given path, next to the TCP
+ * port. Local clients skip the TCP stack; connections are served by the
+ * same workers and command handling as TCP connections. A stale socket
+ * file at the path is removed on startup and the file is removed on exit.
+ * Must be called before server_init (default: no Unix socket).
+ *
+ * @param path Socket file path, or NULL to disable
+ * @param permissions File mode for the socket (e.g. 0770), 0 keeps the umask default
+ */
+void server_set_unix_socket(const char* path, int permissions);
+
+/**
+ * Enables the shared-memory transport. Clients connect to the Unix socket at
+ * the given path once and receive a memfd-backed channel holding one request
+ * and one response ring; after that requests do not go through the kernel.
+ * Each shared-memory client is served by its own thread that busy-polls its
+ * request ring and sleeps on a futex when idle (see shm_client.h).
+ * The socket uses the permissions given to server_set_unix_socket.
+ * Must be called before server_init (default: disabled).
+ *
+ * @param path Socket file path, or NULL to disable
+ */
+void server_set_shm_socket(const char* path);
+
+/**
+ * Limits the reply bytes a connection may have queued but not yet sent.
+ * Above the soft limit the server stops executing the connection's commands
+ * and (with epoll) stops reading its socket until the client catches up, so
+ * TCP flow control pushes back on it. A connection whose queued output would
+ * exceed the hard limit is disconnected. Other connections are unaffected
+ * because sockets are non-blocking and each has its own buffer.
+ * Must be called before server_init (defaults: 1 MB soft, 32 MB hard).
+ *
+ * @param soft_limit Bytes of pending output that pause input, 0 to disable
+ * @param hard_limit Bytes of pending output that disconnect, 0 to disable
+ */
+void server_set_output_limits(size_t soft_limit, size_t hard_limit);
+
+/**
+ * Starts as a read-only replica of the given primary. The replica loads the
+ * primary's data from a snapshot stream, then applies its live write stream;
+ * after a brief disconnect it resumes from the primary's replication backlog.
+ * Reads are refused once no data has arrived for the maximum lag.
+ * Must be called before server_init (default: run as a primary).
+ *
+ * @param host Primary host name or address, NULL to run as a primary
+ * @param port Primary port
+ */
+void server_set_replicaof(const char* host, int port);
+
+/**
+ * Runs the server as one node of a hash-slot cluster. Keys whose slot is
+ * owned by another node are answered with a MOVED redirect, and slots can be
+ * moved between nodes online with "cluster migrate". Slot ownership is kept
+ * in the given file and rewritten when it changes.
+ * Must be called before server_init (default: cluster mode off).
+ *
+ * @param config_path Slot table file, NULL to disable cluster mode
+ * @param announce Address other nodes and clients use for this node
+ *                 ("host" or "host:port"; NULL means 127.0.0.1 and the listen port)
+ */
+void server_set_cluster(const char* config_path, const char* announce);
+
 #endif // SERVER_H 
\ No newline at end of file
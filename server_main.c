@@ -2,33 +2,217 @@
 #include <stdlib.h>
 #include <string.h>
 #include <signal.h>
+#include <stdbool.h>
+#include <sys/resource.h>
 #include "server.h"
+#include "storage.h"
+#include "tracking.h"
+#include "replication.h"
+#include "cluster.h"
+
+// Parse a byte count with an optional k/m/g suffix; returns false if invalid
+static bool parse_size(const char* text, size_t* size) {
+    char* end = NULL;
+    unsigned long long value = strtoull(text, &end, 10);
+    if (end == text) return false;
+    switch (*end) {
+    case 'k': case 'K': value *= 1024ULL; end++; break;
+    case 'm': case 'M': value *= 1024ULL * 1024; end++; break;
+    case 'g': case 'G': value *= 1024ULL * 1024 * 1024; end++; break;
+    default: break;
+    }
+    if (*end != '\0') return false;
+    *size = (size_t)value;
+    return true;
+}
 
 // Show usage for command line parameters
 void show_usage(const char* program_name) {
-    printf("Usage: %s [port]\n", program_name);
+    printf("Usage: %s [port] [options]\n", program_name);
     printf("  port: The port number on which the server will listen (default: 6379)\n");
+    printf("Options:\n");
+    printf("  --io-uring   : Write snapshots and the log through io_uring (falls back to stdio)\n");
+    printf("  --direct-io  : Open persistence files with O_DIRECT (requires --io-uring)\n");
+    printf("  --compress-snapshots : Write periodic snapshots as compressed blocks\n");
+    printf("  --delta-snapshots    : Write only changed keys between full snapshots\n");
+    printf("  --mapped-table       : Keep the table in a memory-mapped file for fast restarts\n");
+    printf("  --threads <n>        : Number of network worker threads (default: 1)\n");
+    printf("  --io-uring-net       : Serve connections with io_uring instead of epoll (falls back to epoll)\n");
+    printf("  --unix-socket <path> : Also listen on a Unix domain socket for local clients\n");
+    printf("  --unix-socket-perm <mode> : Octal permissions of the Unix socket files (e.g. 770)\n");
+    printf("  --shm-socket <path>  : Serve same-host clients over shared-memory rings set up through this socket\n");
+    printf("  --output-soft-limit <size> : Pause a client's input while this much output is unsent (default: 1m, 0 = off)\n");
+    printf("  --output-hard-limit <size> : Disconnect a client above this much unsent output (default: 32m, 0 = off)\n");
+    printf("  --tracking-max-keys <n>    : Keys remembered for client tracking before clients fall back to broadcast (default: %d)\n",
+           TRACKING_MAX_KEYS);
+    printf("  --replicaof <host> <port>  : Run as a read-only replica of the given primary\n");
+    printf("  --master-auth <password>   : Password used to authenticate to the primary (default: password)\n");
+    printf("  --replica-max-lag <sec>    : Refuse reads when no data came from the primary for this long (default: %d, 0 = off)\n",
+           REPL_MAX_LAG);
+    printf("  --repl-backlog-size <size> : Write stream kept for partial resync of replicas (default: 16m)\n");
+    printf("  --cluster-config <file>    : Run as a cluster node; hash slot ownership is kept in this file\n");
+    printf("  --cluster-announce <addr>  : Address of this node for other nodes and redirects (default: 127.0.0.1:<port>)\n");
+    printf("  --cluster-auth <password>  : Password used to connect to other nodes when migrating slots (default: password)\n");
 }
 
 int main(int argc, char* argv[]) {
     int port = 6379; // Default Redis port
+    bool use_uring = false;
+    bool direct_io = false;
+    bool compress_snapshots = false;
+    bool delta_snapshots = false;
+    bool mapped_table = false;
+    int threads = 1;
+    bool uring_net = false;
+    const char* unix_socket = NULL;
+    int unix_socket_perm = 0;
+    const char* shm_socket = NULL;
+    size_t output_soft_limit = 1024 * 1024;
+    size_t output_hard_limit = 32 * 1024 * 1024;
+    size_t tracking_max_keys = TRACKING_MAX_KEYS;
+    const char* replicaof_host = NULL;
+    int replicaof_port = 0;
+    size_t repl_backlog_size = REPL_BACKLOG_SIZE;
+    const char* cluster_config = NULL;
+    const char* cluster_announce = NULL;
     
     // Process command line parameters
-    if (argc > 1) {
-        if (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0) {
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             show_usage(argv[0]);
             return 0;
-        }
-        
-        port = atoi(argv[1]);
-        if (port <= 0 || port > 65535) {
-            fprintf(stderr, "Error: Invalid port number. Port must be between 1-65535.\n");
+        } else if (strcmp(argv[i], "--io-uring") == 0) {
+            use_uring = true;
+        } else if (strcmp(argv[i], "--direct-io") == 0) {
+            direct_io = true;
+        } else if (strcmp(argv[i], "--compress-snapshots") == 0) {
+            compress_snapshots = true;
+        } else if (strcmp(argv[i], "--delta-snapshots") == 0) {
+            delta_snapshots = true;
+        } else if (strcmp(argv[i], "--mapped-table") == 0) {
+            mapped_table = true;
+        } else if (strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --threads requires a positive number.\n");
+                return 1;
+            }
+            threads = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--io-uring-net") == 0) {
+            uring_net = true;
+        } else if (strcmp(argv[i], "--unix-socket") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --unix-socket requires a path.\n");
+                return 1;
+            }
+            unix_socket = argv[++i];
+        } else if (strcmp(argv[i], "--shm-socket") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --shm-socket requires a path.\n");
+                return 1;
+            }
+            shm_socket = argv[++i];
+        } else if (strcmp(argv[i], "--output-soft-limit") == 0 || strcmp(argv[i], "--output-hard-limit") == 0) {
+            size_t* limit = argv[i][9] == 's' ? &output_soft_limit : &output_hard_limit;
+            if (i + 1 >= argc || !parse_size(argv[i + 1], limit)) {
+                fprintf(stderr, "Error: %s requires a size such as 262144, 512k or 8m.\n", argv[i]);
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--tracking-max-keys") == 0) {
+            if (i + 1 >= argc || atol(argv[i + 1]) <= 0) {
+                fprintf(stderr, "Error: --tracking-max-keys requires a positive number.\n");
+                return 1;
+            }
+            tracking_max_keys = (size_t)atol(argv[++i]);
+        } else if (strcmp(argv[i], "--replicaof") == 0) {
+            if (i + 2 >= argc || atoi(argv[i + 2]) <= 0 || atoi(argv[i + 2]) > 65535) {
+                fprintf(stderr, "Error: --replicaof requires a host and a port.\n");
+                return 1;
+            }
+            replicaof_host = argv[i + 1];
+            replicaof_port = atoi(argv[i + 2]);
+            i += 2;
+        } else if (strcmp(argv[i], "--master-auth") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --master-auth requires a password.\n");
+                return 1;
+            }
+            replication_set_master_auth(argv[++i]);
+        } else if (strcmp(argv[i], "--replica-max-lag") == 0) {
+            if (i + 1 >= argc || atoi(argv[i + 1]) < 0) {
+                fprintf(stderr, "Error: --replica-max-lag requires a number of seconds.\n");
+                return 1;
+            }
+            replication_set_max_lag(atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--repl-backlog-size") == 0) {
+            if (i + 1 >= argc || !parse_size(argv[i + 1], &repl_backlog_size) || repl_backlog_size == 0) {
+                fprintf(stderr, "Error: --repl-backlog-size requires a size such as 1m or 64m.\n");
+                return 1;
+            }
+            i++;
+        } else if (strcmp(argv[i], "--cluster-config") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --cluster-config requires a file path.\n");
+                return 1;
+            }
+            cluster_config = argv[++i];
+        } else if (strcmp(argv[i], "--cluster-announce") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --cluster-announce requires a host or host:port.\n");
+                return 1;
+            }
+            cluster_announce = argv[++i];
+        } else if (strcmp(argv[i], "--cluster-auth") == 0) {
+            if (i + 1 >= argc) {
+                fprintf(stderr, "Error: --cluster-auth requires a password.\n");
+                return 1;
+            }
+            cluster_set_auth(argv[++i]);
+        } else if (strcmp(argv[i], "--unix-socket-perm") == 0) {
+            char* end = NULL;
+            long mode = i + 1 < argc ? strtol(argv[i + 1], &end, 8) : -1;
+            if (i + 1 >= argc || *end != '\0' || mode <= 0 || mode > 0777) {
+                fprintf(stderr, "Error: --unix-socket-perm requires an octal mode between 1 and 777.\n");
+                return 1;
+            }
+            unix_socket_perm = (int)mode;
+            i++;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Error: Unknown option: %s\n", argv[i]);
+            show_usage(argv[0]);
             return 1;
+        } else {
+            port = atoi(argv[i]);
+            if (port <= 0 || port > 65535) {
+                fprintf(stderr, "Error: Invalid port number. Port must be between 1-65535.\n");
+                return 1;
+            }
         }
     }
     
+    // Binlerce bağlantı için dosya tanımlayıcı sınırını izin verilen en üst değere çek
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) == 0 && limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limit);
+    }
+    
+    storage_configure_io(use_uring, direct_io);
+    storage_set_snapshot_compression(compress_snapshots);
+    storage_set_delta_snapshots(delta_snapshots);
+    storage_set_mapped_table(mapped_table);
+    server_set_threads(threads);
+    server_set_io_uring(uring_net);
+    server_set_unix_socket(unix_socket, unix_socket_perm);
+    server_set_shm_socket(shm_socket);
+    server_set_output_limits(output_soft_limit, output_hard_limit);
+    tracking_set_max_keys(tracking_max_keys);
+    server_set_replicaof(replicaof_host, replicaof_port);
+    replication_set_backlog_size(repl_backlog_size);
+    server_set_cluster(cluster_config, cluster_announce);
+    
     printf("Starting AytDB telnet server...\n");
     
     // Start the server on the specified port
     return server_init(port);
-} 
\ No newline at end of file
+}
@@ -0,0 +1,168 @@
+#include "shm_client.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "shm_ring.h"
+
+#define SHM_CLIENT_TIMEOUT_MS 5000
+#define SHM_CLIENT_WAIT_MS 100
+
+struct ShmClient {
+    int socket_fd;          // Açık kaldıkça sunucu kanalı servis eder
+    ShmChannel* channel;
+    int spin;
+};
+
+// Sunucunun SCM_RIGHTS ile gönderdiği memfd'yi alır
+static int receive_channel_fd(int socket_fd) {
+    char byte;
+    struct iovec iov = { &byte, 1 };
+    union {
+        struct cmsghdr header;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    
+    if (recvmsg(socket_fd, &msg, MSG_CMSG_CLOEXEC) != 1) return -1;
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS) return -1;
+    
+    int fd;
+    memcpy(&fd, CMSG_DATA(cmsg), sizeof(int));
+    return fd;
+}
+
+ShmClient* shm_client_connect(const char* socket_path, const char* password) {
+    struct sockaddr_un addr;
+    if (strlen(socket_path) >= sizeof(addr.sun_path)) return NULL;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, socket_path);
+    
+    ShmClient* client = calloc(1, sizeof(ShmClient));
+    if (!client) return NULL;
+    client->spin = shm_default_spin();
+    client->socket_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (client->socket_fd < 0 || connect(client->socket_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        shm_client_close(client);
+        return NULL;
+    }
+    
+    int memfd = receive_channel_fd(client->socket_fd);
+    if (memfd < 0) {
+        shm_client_close(client);
+        return NULL;
+    }
+    client->channel = mmap(NULL, sizeof(ShmChannel), PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+    close(memfd);
+    if (client->channel == MAP_FAILED) {
+        client->channel = NULL;
+        shm_client_close(client);
+        return NULL;
+    }
+    if (client->channel->magic != SHM_MAGIC || client->channel->version != SHM_VERSION) {
+        fprintf(stderr, "Error: Unsupported shared memory channel version\n");
+        shm_client_close(client);
+        return NULL;
+    }
+    
+    const char* auth[] = { "AUTH", password };
+    char reply[256];
+    if (shm_client_command(client, 2, auth, reply, sizeof(reply)) < 0 || reply[0] != '+') {
+        shm_client_close(client);
+        return NULL;
+    }
+    return client;
+}
+
+void shm_client_close(ShmClient* client) {
+    if (!client) return;
+    if (client->channel) munmap(client->channel, sizeof(ShmChannel));
+    if (client->socket_fd >= 0) close(client->socket_fd);
+    free(client);
+}
+
+// İsteği yazar ve yanıtı bekler; dönen slot okunduktan sonra serbest bırakılmalıdır
+static ShmSlot* send_command(ShmClient* client, int argc, const char** argv) {
+    // İstemci tek istek beklettiği için halkada her zaman yer vardır
+    ShmSlot* slot = shm_ring_reserve(&client->channel->request);
+    if (!slot) return NULL;
+    
+    // RESP isteği doğrudan slota yazılır
+    size_t len = (size_t)snprintf(slot->data, SHM_MAX_MESSAGE, "*%d\r\n", argc);
+    for (int i = 0; i < argc; i++) {
+        size_t arg_len = strlen(argv[i]);
+        if (len + arg_len + 32 > SHM_MAX_MESSAGE) return NULL;
+        len += (size_t)snprintf(slot->data + len, SHM_MAX_MESSAGE - len, "$%zu\r\n", arg_len);
+        memcpy(slot->data + len, argv[i], arg_len);
+        memcpy(slot->data + len + arg_len, "\r\n", 2);
+        len += arg_len + 2;
+    }
+    shm_ring_publish(&client->channel->request, slot, (uint32_t)len);
+    
+    ShmSlot* response = NULL;
+    for (int waited = 0; !response && waited < SHM_CLIENT_TIMEOUT_MS; waited += SHM_CLIENT_WAIT_MS) {
+        response = shm_ring_wait(&client->channel->response, client->spin, SHM_CLIENT_WAIT_MS);
+    }
+    if (response && response->len > SHM_MAX_MESSAGE) {
+        shm_ring_release(&client->channel->response);
+        return NULL;
+    }
+    return response;
+}
+
+long shm_client_command(ShmClient* client, int argc, const char** argv, char* reply, size_t reply_cap) {
+    ShmSlot* response = send_command(client, argc, argv);
+    if (!response) return -1;
+    
+    long reply_len = -1;
+    if (response->len < reply_cap) {
+        memcpy(reply, response->data, response->len);
+        reply[response->len] = '\0';
+        reply_len = (long)response->len;
+    }
+    shm_ring_release(&client->channel->response);
+    return reply_len;
+}
+
+bool shm_client_get(ShmClient* client, const char* key, char* value, size_t value_cap, bool* found) {
+    const char* argv[] = { "GET", key };
+    ShmSlot* response = send_command(client, 2, argv);
+    if (!response) return false;
+    
+    // Yanıt slotta yerinde ayrıştırılır: $<uzunluk>\r\n<veri>\r\n veya $-1\r\n
+    bool ok = false;
+    const char* data = memchr(response->data, '\n', response->len);
+    if (response->data[0] == '$' && data) {
+        long value_len = strtol(response->data + 1, NULL, 10);
+        *found = value_len >= 0;
+        data++;
+        if (!*found) {
+            ok = true;
+        } else if ((size_t)value_len < value_cap && data + value_len <= response->data + response->len) {
+            memcpy(value, data, (size_t)value_len);
+            value[value_len] = '\0';
+            ok = true;
+        }
+    }
+    shm_ring_release(&client->channel->response);
+    return ok;
+}
+
+bool shm_client_set(ShmClient* client, const char* key, const char* value) {
+    const char* argv[] = { "SET", key, value };
+    ShmSlot* response = send_command(client, 3, argv);
+    if (!response) return false;
+    bool ok = response->len > 0 && response->data[0] == '+';
+    shm_ring_release(&client->channel->response);
+    return ok;
+}
@@ -0,0 +1,29 @@
+#ifndef SHM_CLIENT_H
+#define SHM_CLIENT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// aytdb_server --shm-socket ile açılan paylaşımlı bellek taşımasının istemcisi.
+// Her istek kanalın istek halkasına RESP olarak yazılır ve yanıt beklenir;
+// istek başına sistem çağrısı yapılmaz (karşı taraf uyuyorsa futex hariç).
+// Bir ShmClient aynı anda tek thread'den kullanılmalıdır; zaman aşımı sonrası
+// geç gelen yanıt sonraki isteğe karışabileceği için istemci kapatılmalıdır.
+
+typedef struct ShmClient ShmClient;
+
+// Kanal soketine bağlanır, kanalı alır ve password ile kimlik doğrular
+ShmClient* shm_client_connect(const char* socket_path, const char* password);
+void shm_client_close(ShmClient* client);
+
+// Komutu gönderir ve ham RESP yanıtını reply'a kopyalar (sonuna '\0' eklenir).
+// Yanıt uzunluğunu döner; gönderilemediyse, zaman aşımında veya reply'a sığmazsa -1.
+long shm_client_command(ShmClient* client, int argc, const char** argv, char* reply, size_t reply_cap);
+
+// get: değer value'ya kopyalanır; anahtar yoksa *found false olur. Hata durumunda false.
+bool shm_client_get(ShmClient* client, const char* key, char* value, size_t value_cap, bool* found);
+
+// set: sunucu +OK döndüyse true
+bool shm_client_set(ShmClient* client, const char* key, const char* value);
+
+#endif // SHM_CLIENT_H
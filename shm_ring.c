@@ -0,0 +1,79 @@
+#define _GNU_SOURCE
+#include "shm_ring.h"
+#include <unistd.h>
+#include <time.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+#define SHM_RING_MASK (SHM_RING_SLOTS - 1)
+
+static inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+// Kanal süreçler arasında paylaşıldığı için FUTEX_PRIVATE_FLAG kullanılmaz
+static void futex_wait(uint32_t* word, uint32_t expected, int timeout_ms) {
+    struct timespec timeout = { timeout_ms / 1000, (long)(timeout_ms % 1000) * 1000000L };
+    syscall(SYS_futex, word, FUTEX_WAIT, expected, &timeout, NULL, 0);
+}
+
+static void futex_wake(uint32_t* word) {
+    syscall(SYS_futex, word, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+ShmSlot* shm_ring_reserve(ShmRing* ring) {
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED); // Sadece üretici yazar
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (tail - head >= SHM_RING_SLOTS) return NULL;
+    return &ring->slots[tail & SHM_RING_MASK];
+}
+
+void shm_ring_publish(ShmRing* ring, ShmSlot* slot, uint32_t len) {
+    slot->len = len;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_RELAXED);
+    
+    // tail yazımı ile waiting okuması sıralı olmalı (tüketicideki sıranın tersi),
+    // aksi halde uyumak üzere olan tüketicinin uyandırması kaçabilir
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->waiting, __ATOMIC_SEQ_CST)) futex_wake(&ring->tail);
+}
+
+ShmSlot* shm_ring_peek(ShmRing* ring) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED); // Sadece tüketici yazar
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head == tail) return NULL;
+    return &ring->slots[head & SHM_RING_MASK];
+}
+
+void shm_ring_release(ShmRing* ring) {
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+}
+
+ShmSlot* shm_ring_wait(ShmRing* ring, int spin, int timeout_ms) {
+    for (int i = 0; i < spin; i++) {
+        ShmSlot* slot = shm_ring_peek(ring);
+        if (slot) return slot;
+        cpu_relax();
+    }
+    ShmSlot* slot = shm_ring_peek(ring);
+    if (slot) return slot;
+    
+    // Uyumadan önce waiting işaretlenip tail tekrar okunur; arada yayınlanan mesaj
+    // ya burada görülür ya da üretici waiting'i görüp uyandırır
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_RELAXED);
+    __atomic_store_n(&ring->waiting, 1, __ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&ring->tail, __ATOMIC_SEQ_CST) == head) {
+        futex_wait(&ring->tail, head, timeout_ms);
+    }
+    __atomic_store_n(&ring->waiting, 0, __ATOMIC_RELAXED);
+    return shm_ring_peek(ring);
+}
+
+int shm_default_spin() {
+    return sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPIN_LIMIT : 0;
+}
@@ -0,0 +1,61 @@
+#ifndef SHM_RING_H
+#define SHM_RING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Aynı makinedeki istemciler için paylaşımlı bellek kanalı.
+// Sunucu her istemci için memfd ile bir ShmChannel oluşturup Unix soketi üzerinden
+// (SCM_RIGHTS) gönderir. Kanalda her yön için tek üretici/tek tüketici (SPSC) bir
+// mesaj halkası vardır; her slot tek bir RESP isteği veya yanıtı taşır.
+// Tüketici boşta kalınca önce busy-poll yapar, sonra tail üzerinde futex ile uyur;
+// üretici futex_wake sistem çağrısını sadece tüketici uyuyorsa yapar.
+
+#define SHM_MAGIC 0x41594453        // "AYDS"
+#define SHM_VERSION 1
+#define SHM_RING_SLOTS 16           // 2'nin kuvveti olmalı
+#define SHM_SLOT_SIZE 8192
+#define SHM_MAX_MESSAGE (SHM_SLOT_SIZE - sizeof(uint32_t))
+#define SHM_SPIN_LIMIT 2000         // futex'e geçmeden önceki boş yoklama sayısı (~100µs)
+
+typedef struct {
+    uint32_t len;
+    char data[SHM_MAX_MESSAGE];
+} ShmSlot;
+
+// head ve tail ayrı cache satırlarında; üretici ve tüketici birbirinin satırını kirletmez
+typedef struct {
+    _Alignas(64) uint32_t head;     // Tüketicinin okuyacağı sıradaki mesaj
+    _Alignas(64) uint32_t tail;     // Yayınlanan mesaj sayısı, aynı zamanda futex kelimesi
+    uint32_t waiting;               // Tüketici futex'te uyuyor
+    _Alignas(64) ShmSlot slots[SHM_RING_SLOTS];
+} ShmRing;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    ShmRing request;                // İstemci -> sunucu
+    ShmRing response;               // Sunucu -> istemci
+} ShmChannel;
+
+// Üretici: yazılacak boş slot, halka doluysa NULL
+ShmSlot* shm_ring_reserve(ShmRing* ring);
+
+// Üretici: reserve edilen slotu len baytlık mesaj olarak yayınlar
+void shm_ring_publish(ShmRing* ring, ShmSlot* slot, uint32_t len);
+
+// Tüketici: sıradaki mesaj, yoksa NULL
+ShmSlot* shm_ring_peek(ShmRing* ring);
+
+// Tüketici: okunan mesajın slotunu üreticiye geri verir
+void shm_ring_release(ShmRing* ring);
+
+// Tüketici: mesaj gelene kadar spin kez yoklar, sonra en fazla timeout_ms futex'te
+// bekler. Süre dolarsa NULL döner.
+ShmSlot* shm_ring_wait(ShmRing* ring, int spin, int timeout_ms);
+
+// Tek çekirdekli makinede busy-poll karşı tarafın çalışmasını geciktirir
+int shm_default_spin();
+
+#endif // SHM_RING_H
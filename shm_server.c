@@ -0,0 +1,300 @@
+#define _GNU_SOURCE // memfd_create ve accept4 için
+#include "shm_server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include "kv_store.h"
+#include "command.h"
+#include "resp.h"
+#include "shm_ring.h"
+
+#define SHM_MAX_CLIENTS 64
+#define SHM_IDLE_TIMEOUT_MS 100 // Boşta kalan thread bu aralıkla kapanış ve istemci kopması kontrol eder
+#define SHM_LISTEN_BACKLOG 64
+
+// Paylaşımlı bellek istemcisi; her biri kendi thread'inde servis edilir
+typedef struct ShmSession {
+    CommandClient client;       // Komut katmanının gördüğü durum (ilk üye olmalı)
+    int socket_fd;              // Kanalın gönderildiği soket; kapanması istemcinin çıktığını gösterir
+    ShmChannel* channel;
+    ShmSlot* reply;             // Yanıtın doğrudan yazıldığı, henüz yayınlanmamış slot
+    size_t reply_len;
+    RespParser parser;
+    pthread_t thread;
+    bool finished;              // Thread bitti, kabul thread'i kaynakları toplayabilir (atomik)
+    struct ShmSession* next;
+    char request[SHM_MAX_MESSAGE]; // İstek istemcinin değiştirebileceği bellekten buraya kopyalanır
+} ShmSession;
+
+static int listener_fd = -1;
+static char listener_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+static pthread_t accept_thread;
+static volatile int shm_running = 0;
+static ShmSession* sessions = NULL;     // Sadece kabul thread'i değiştirir
+static int session_count = 0;
+
+// Yanıtlar istemcinin yanıt halkasındaki slota doğrudan yazılır
+static char* session_reserve(CommandClient* client, size_t len) {
+    ShmSession* session = (ShmSession*)client;
+    if (session->reply_len + len > SHM_MAX_MESSAGE) return NULL;
+    return session->reply->data + session->reply_len;
+}
+
+static void session_commit(CommandClient* client, size_t len) {
+    ((ShmSession*)client)->reply_len += len;
+}
+
+static bool session_write(CommandClient* client, const char* data, size_t len) {
+    char* dest = session_reserve(client, len);
+    if (!dest) return false;
+    memcpy(dest, data, len);
+    session_commit(client, len);
+    return true;
+}
+
+// İstemci soketi kapattıysa veya soket hatalıysa true
+static bool peer_closed(int fd) {
+    char byte;
+    ssize_t n = recv(fd, &byte, 1, MSG_PEEK | MSG_DONTWAIT);
+    if (n == 0) return true;
+    return n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR;
+}
+
+// Tek RESP isteğini çalıştırır; yanıt session->reply slotunda oluşur
+static void session_execute(ShmSession* session, size_t len) {
+    RespParser* parser = &session->parser;
+    resp_parser_reset(parser);
+    RespStatus status = resp_parse(parser, session->request, len);
+    
+    if (status != RESP_OK || parser->pos != len) {
+        reply_raw(&session->client, "-ERR Protocol error\r\n", 21);
+    } else if (parser->argc > RESP_MAX_ARGS) {
+        reply_error(&session->client, "too many arguments (max %d)", RESP_MAX_ARGS);
+    } else if (parser->has_nul) {
+        command_reject(&session->client, "arguments cannot contain NUL bytes");
+    } else if (parser->argc > 0) {
+        char* argv[RESP_MAX_ARGS];
+        resp_args(parser, session->request, argv);
+        command_execute(&session->client, parser->argc, argv);
+    }
+    
+    // Slota sığmayan yanıt (örneğin uzun help çıktısı) hata ile değiştirilir
+    if (session->client.failed) {
+        session->client.failed = false;
+        session->reply_len = 0;
+        reply_error(&session->client, "reply too large for shared memory transport");
+    }
+}
+
+static void* session_loop(void* arg) {
+    ShmSession* session = arg;
+    ShmChannel* channel = session->channel;
+    int spin = shm_default_spin();
+    
+    while (shm_running && !session->client.close_requested) {
+        ShmSlot* slot = shm_ring_wait(&channel->request, spin, SHM_IDLE_TIMEOUT_MS);
+        if (!slot) {
+            if (peer_closed(session->socket_fd)) break;
+            continue;
+        }
+        
+        // Uzunluk istemciden geldiği için doğrulanır, veri paylaşılmayan belleğe kopyalanır
+        uint32_t len = slot->len;
+        if (len > SHM_MAX_MESSAGE) break;
+        memcpy(session->request, slot->data, len);
+        shm_ring_release(&channel->request);
+        
+        // İstemci yanıtları okumadan çok sayıda istek gönderdiyse yer açılmasını bekle
+        ShmSlot* reply;
+        while (!(reply = shm_ring_reserve(&channel->response))) {
+            if (!shm_running || peer_closed(session->socket_fd)) goto done;
+            sched_yield();
+        }
+        session->reply = reply;
+        session->reply_len = 0;
+        session_execute(session, len);
+        shm_ring_publish(&channel->response, reply, (uint32_t)session->reply_len);
+    }
+    
+done:
+    command_client_close(&session->client);
+    if (logging_enabled) printf("Shared memory client disconnected, socket fd: %d\n", session->socket_fd);
+    __atomic_store_n(&session->finished, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+// Kanal için memfd oluşturur, soket üzerinden istemciye gönderir ve eşler
+static ShmChannel* create_channel(int socket_fd) {
+    int memfd = memfd_create("aytdb-shm", MFD_CLOEXEC);
+    if (memfd < 0) {
+        perror("memfd_create failed");
+        return NULL;
+    }
+    
+    ShmChannel* channel = NULL;
+    if (ftruncate(memfd, sizeof(ShmChannel)) == 0) {
+        channel = mmap(NULL, sizeof(ShmChannel), PROT_READ | PROT_WRITE, MAP_SHARED, memfd, 0);
+        if (channel == MAP_FAILED) channel = NULL;
+    }
+    if (!channel) {
+        perror("Failed to map shared memory channel");
+        close(memfd);
+        return NULL;
+    }
+    channel->magic = SHM_MAGIC;
+    channel->version = SHM_VERSION;
+    
+    // Tek baytlık veriyle birlikte dosya tanımlayıcısı SCM_RIGHTS olarak gönderilir
+    char byte = 'S';
+    struct iovec iov = { &byte, 1 };
+    union {
+        struct cmsghdr header;
+        char buf[CMSG_SPACE(sizeof(int))];
+    } control;
+    memset(&control, 0, sizeof(control));
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control.buf;
+    msg.msg_controllen = sizeof(control.buf);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(int));
+    memcpy(CMSG_DATA(cmsg), &memfd, sizeof(int));
+    
+    bool sent = sendmsg(socket_fd, &msg, MSG_NOSIGNAL) == 1;
+    close(memfd); // Eşleme açık kaldıkça bellek yaşar
+    if (!sent) {
+        perror("Failed to send shared memory channel");
+        munmap(channel, sizeof(ShmChannel));
+        return NULL;
+    }
+    return channel;
+}
+
+static void open_session(int socket_fd) {
+    if (session_count >= SHM_MAX_CLIENTS) {
+        fprintf(stderr, "Shared memory client limit (%d) reached\n", SHM_MAX_CLIENTS);
+        close(socket_fd);
+        return;
+    }
+    
+    ShmSession* session = calloc(1, sizeof(ShmSession));
+    if (!session) {
+        close(socket_fd);
+        return;
+    }
+    session->socket_fd = socket_fd;
+    session->client.protocol = PROTOCOL_RESP;
+    session->client.resp_version = 2;
+    session->client.id = command_next_client_id();
+    session->client.write = session_write;
+    session->client.reserve = session_reserve;
+    session->client.commit = session_commit;
+    
+    session->channel = create_channel(socket_fd);
+    if (!session->channel || pthread_create(&session->thread, NULL, session_loop, session) != 0) {
+        if (session->channel) munmap(session->channel, sizeof(ShmChannel));
+        close(socket_fd);
+        free(session);
+        return;
+    }
+    
+    session->next = sessions;
+    sessions = session;
+    session_count++;
+    if (logging_enabled) printf("New shared memory client, socket fd: %d, clients: %d\n", socket_fd, session_count);
+}
+
+// Biten (ya da all true ise tüm) istemci thread'lerini bekler ve kaynaklarını bırakır
+static void reap_sessions(bool all) {
+    ShmSession** link = &sessions;
+    while (*link) {
+        ShmSession* session = *link;
+        if (!all && !__atomic_load_n(&session->finished, __ATOMIC_ACQUIRE)) {
+            link = &session->next;
+            continue;
+        }
+        pthread_join(session->thread, NULL);
+        munmap(session->channel, sizeof(ShmChannel));
+        close(session->socket_fd);
+        *link = session->next;
+        free(session);
+        session_count--;
+    }
+}
+
+static void* accept_loop(void* arg) {
+    (void)arg;
+    while (shm_running) {
+        struct pollfd pfd = { listener_fd, POLLIN, 0 };
+        int ready = poll(&pfd, 1, SHM_IDLE_TIMEOUT_MS);
+        reap_sessions(false);
+        if (ready <= 0) continue;
+        
+        int fd = accept4(listener_fd, NULL, NULL, SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno != EAGAIN && errno != EINTR) perror("accept");
+            continue;
+        }
+        open_session(fd);
+    }
+    reap_sessions(true);
+    return NULL;
+}
+
+bool shm_server_start(const char* path, mode_t permissions) {
+    struct sockaddr_un addr;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "Shared memory socket path is too long: %s\n", path);
+        return false;
+    }
+    
+    listener_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (listener_fd < 0) {
+        perror("Could not create shared memory socket");
+        return false;
+    }
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+    strcpy(listener_path, path);
+    
+    // Önceki çalışmadan kalan soket dosyası bind'ı engeller
+    unlink(path);
+    bool ok = bind(listener_fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 &&
+              (!permissions || chmod(path, permissions) == 0) &&
+              listen(listener_fd, SHM_LISTEN_BACKLOG) == 0;
+    if (ok) {
+        shm_running = 1;
+        ok = pthread_create(&accept_thread, NULL, accept_loop, NULL) == 0;
+    }
+    if (!ok) {
+        perror("Failed to start shared memory transport");
+        shm_running = 0;
+        close(listener_fd);
+        unlink(path);
+        listener_fd = -1;
+    }
+    return ok;
+}
+
+void shm_server_stop() {
+    if (listener_fd < 0) return;
+    shm_running = 0;
+    pthread_join(accept_thread, NULL);
+    close(listener_fd);
+    unlink(listener_path);
+    listener_fd = -1;
+}
@@ -0,0 +1,17 @@
+#ifndef SHM_SERVER_H
+#define SHM_SERVER_H
+
+#include <stdbool.h>
+#include <sys/types.h>
+
+// Paylaşımlı bellek taşıması (bkz. shm_ring.h): istemciler path'teki Unix soketine
+// bağlanıp kanallarını alır, her istemciye ayrılan bir thread istek halkasını yoklar.
+// Komutlar TCP bağlantılarıyla aynı komut tablosundan çalışır.
+
+// Kanal soketini açar ve kabul thread'ini başlatır; permissions 0 ise umask geçerlidir
+bool shm_server_start(const char* path, mode_t permissions);
+
+// Tüm istemci thread'lerini durdurur, kanalları ve soket dosyasını kaldırır
+void shm_server_stop();
+
+#endif // SHM_SERVER_H
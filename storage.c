@@ -1,5 +1,8 @@
+#define _GNU_SOURCE // PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP için
 #include "storage.h"
 #include "kv_store.h"
+#include "file_writer.h"
+#include "compress.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -8,94 +11,454 @@
 #include <sys/stat.h>
 #include <errno.h>
 #include <pthread.h>
+#include <stdint.h>
 
 #define STORAGE_FILE "storage.db"
+#define TEMP_STORAGE_FILE "storage.db.rewrite"
 #define SNAPSHOT_FILE "snapshot.db"
 #define TEMP_SNAPSHOT_FILE "snapshot.db.tmp"
+#define MAPPED_TABLE_FILE "table.db"      // Kalıcı (mmap) tablo dosyası
 #define BUFFER_SIZE 32768  // Buffer boyutunu 32KB'a çıkarıyorum
 #define SNAPSHOT_INTERVAL 300 // 5 dakikalık default snapshot aralığı
+#define SNAPSHOT_CHECK_INTERVAL 1 // Kuralların kontrol aralığı (saniye), I/O yapmaz
+#define SNAPSHOT_RETRY_MIN 5      // Başarısız otomatik snapshot'tan sonra ilk bekleme (saniye)
+#define SNAPSHOT_RETRY_MAX 300    // Her hatada ikiye katlanan beklemenin üst sınırı
+#define SNAPSHOT_HEADER "AYTDB_SNAPSHOT_V1"
+#define COMPRESSED_SNAPSHOT_HEADER "AYTDB_SNAPSHOT_Z1"
+#define SNAPSHOT_BLOCK_SIZE (256 * 1024)   // Sıkıştırılmış snapshot blok boyutu (ham)
+#define SNAPSHOT_LOAD_MAX_THREADS 8        // Blokları açan en fazla thread sayısı
+#define SNAPSHOT_LOAD_QUEUE 16             // Okuyucu ile worker'lar arasındaki blok kuyruğu
 
-static FILE* storage_file = NULL;
+// Delta snapshot ayarları
+#define SNAPSHOT_DELTA_HEADER "AYTDB_DELTA_V1"
+#define SNAPSHOT_DELTA_FILE "snapshot.db.delta.%d"   // Zincirdeki sıra numarası ile
+#define TEMP_SNAPSHOT_DELTA_FILE "snapshot.db.delta.tmp"
+#define SNAPSHOT_MAX_DELTAS 8             // Bu kadar delta birikince tam snapshot alınır
+
+// Append-only log ayarları
+#define LOG_HEADER "AYTDB_LOG_V1"
+#define LOG_BASE_SNAPSHOT "BASE:SNAPSHOT" // Log, snapshot.db'nin üzerine uygulanır
+#define LOG_BASE_INLINE "BASE:INLINE"     // Log kendi başına tam durumu içerir (rewrite sonrası)
+#define LOG_RECORD_SIZE (MAX_KEY_SIZE + MAX_VALUE_SIZE + 64)
+#define LOG_FLUSH_INTERVAL 1              // Log thread'inin flush/kontrol aralığı (saniye)
+#define LOG_REWRITE_MIN_SIZE (4 * 1024 * 1024) // Bu boyutun altındaki loglar rewrite edilmez
+#define LOG_REWRITE_PERCENTAGE 100        // Log, son rewrite boyutunun %100 üstüne çıkınca rewrite
+#define LOG_REWRITE_BATCH 1024            // Tablo kilidi başına kopyalanan entry sayısı
+#define LOG_REWRITE_MAX_DIFF (64 * 1024 * 1024) // Rewrite sırasında biriken kuyruk için üst sınır
+
+typedef enum {
+    LOG_BASE_NONE,     // Log dosyası yok veya geçersiz
+    LOG_BASE_ON_SNAPSHOT,
+    LOG_BASE_SELF
+} LogBase;
+
+static FileWriter* storage_file = NULL; // Log yazıcısı (stdio ya da io_uring)
+static Storage* active_storage = NULL;
 static char storage_path[256];
-static char write_buffer[BUFFER_SIZE];
-static size_t buffer_pos = 0;
-static pthread_mutex_t buffer_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Özyinelemeli: storage_lock_writes tutan thread yazma fonksiyonlarını çağırabilir
+static pthread_mutex_t buffer_mutex = PTHREAD_RECURSIVE_MUTEX_INITIALIZER_NP;
 static pthread_t snapshot_thread;
-static int snapshot_interval = SNAPSHOT_INTERVAL;
+// Snapshot thread'inin başlatılması/durdurulması - snapshot_thread_running'i de korur
+static pthread_mutex_t snapshot_thread_mutex = PTHREAD_MUTEX_INITIALIZER;
+// Snapshot kuralları ve son snapshot anındaki yazma sayacı - snapshot_mutex ile korunur
+static SnapshotRule snapshot_rules[SNAPSHOT_MAX_RULES] = {
+    { SNAPSHOT_INTERVAL, 1 },   // 5 dakikada en az 1 değişiklik
+    { 60, 10000 }               // Yoğun yazmada dakikada bir
+};
+static size_t snapshot_rule_count = 2;
+static time_t last_snapshot_time = 0;
+static unsigned long long last_snapshot_writes = 0;
 static bool snapshot_thread_running = false;
+static bool snapshot_compression = false; // Otomatik snapshot'lar için varsayılan
+static pthread_mutex_t snapshot_mutex = PTHREAD_MUTEX_INITIALIZER; // Snapshot yazımlarını sıralar
+
+// Delta snapshot zinciri - snapshot_mutex ile korunur
+static bool delta_snapshots = false;
+static bool mapped_table = false;     // Tablo ve havuz dosyaya map edilir
+static time_t snapshot_base_time = 0; // Diskteki tam snapshot'ın kimliği (0: zincir kurulamaz)
+static int delta_count = 0;           // Tabana bağlı delta dosyası sayısı
+static long base_snapshot_size = 0;
+static long delta_total_size = 0;
 static bool shutdown_requested = false;
 
-// Snapshot thread fonksiyonu - belirli aralıklarla snapshot oluşturur
+// Arka plan thread'lerini kapanışta beklemeden uyandırmak için
+static pthread_mutex_t wakeup_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t wakeup_cond = PTHREAD_COND_INITIALIZER;
+
+// Append-only log durumu - buffer_mutex ile korunur
+static bool log_enabled = true;
+static long log_size = 0;             // Şu anki log boyutu (buffer'daki dahil)
+static long log_base_size = 0;        // Son rewrite sonrası log boyutu
+static bool rewrite_in_progress = false;
+// Her yazma log'a eklendikten sonra aynı sırayla çağrılır (replikasyon akışı); value NULL ise silme
+static void (*write_hook)(const char* key, const char* value, int ttl) = NULL;
+static bool rewrite_requested = false;
+static char* rewrite_diff = NULL;     // Rewrite sürerken gelen kayıtlar
+static size_t rewrite_diff_len = 0;
+static size_t rewrite_diff_cap = 0;
+static bool rewrite_diff_overflow = false;
+static pthread_t log_thread;
+static bool log_thread_running = false;
+static bool log_stop_requested = false;
+
+static void* log_thread_func(void* arg);
+static void start_snapshot_thread();
+
+// Bayrak set edilene ya da süre dolana kadar bekler; bayrak set edildiyse true döner
+static bool wait_for_stop(const bool* stop_flag, int seconds) {
+    struct timespec deadline;
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += seconds;
+    
+    pthread_mutex_lock(&wakeup_mutex);
+    while (!*stop_flag) {
+        if (pthread_cond_timedwait(&wakeup_cond, &wakeup_mutex, &deadline) == ETIMEDOUT) break;
+    }
+    bool stopped = *stop_flag;
+    pthread_mutex_unlock(&wakeup_mutex);
+    return stopped;
+}
+
+static void request_stop(bool* stop_flag) {
+    pthread_mutex_lock(&wakeup_mutex);
+    *stop_flag = true;
+    pthread_cond_broadcast(&wakeup_cond);
+    pthread_mutex_unlock(&wakeup_mutex);
+}
+
+// Başarılı snapshot sonrası zamanlayıcının referansını günceller
+static void snapshot_completed_locked(unsigned long long writes) {
+    last_snapshot_time = time(NULL);
+    last_snapshot_writes = writes;
+}
+
+// Kurallardan biri sağlanıyorsa true döner; snapshot_mutex tutulurken çağrılır
+static bool snapshot_rule_matched(time_t now, unsigned long long changes) {
+    for (size_t i = 0; i < snapshot_rule_count; i++) {
+        if (now - last_snapshot_time >= snapshot_rules[i].seconds &&
+            changes >= snapshot_rules[i].changes) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Snapshot thread fonksiyonu - kurallardan biri sağlandığında snapshot oluşturur.
+// Değişiklik yoksa hiç I/O yapılmaz; kapanışta wait_for_stop hemen uyanır.
+// Kurallar her kontrolde yeniden okunur, değiştiklerinde thread'in yeniden başlaması gerekmez.
 static void* snapshot_thread_func(void* arg) {
-    if (logging_enabled) printf("DEBUG: Snapshot thread started with interval %d seconds\n", snapshot_interval);
+    (void)arg;
+    if (logging_enabled) printf("DEBUG: Snapshot thread started\n");
     
-    while (!shutdown_requested) {
-        sleep(snapshot_interval);
-        if (shutdown_requested) break;
+    // Disk dolu gibi kalıcı hatalarda her saniye tam snapshot denenmesin diye
+    // bekleme her başarısızlıkta ikiye katlanır
+    int retry_delay = 0;
+    time_t retry_at = 0;
+    while (!wait_for_stop(&shutdown_requested, SNAPSHOT_CHECK_INTERVAL)) {
+        time_t now = time(NULL);
+        if (now < retry_at) continue;
+        
+        pthread_mutex_lock(&snapshot_mutex);
+        unsigned long long changes = kv_write_count() - last_snapshot_writes;
+        bool matched = changes > 0 && snapshot_rule_matched(now, changes);
+        pthread_mutex_unlock(&snapshot_mutex);
         
-        if (logging_enabled) printf("DEBUG: Automatic snapshot triggered\n");
-        storage_save_snapshot();
+        if (!matched) continue;
+        if (logging_enabled) printf("DEBUG: Automatic snapshot triggered after %llu changes\n", changes);
+        if (storage_save_snapshot()) {
+            retry_delay = 0;
+            retry_at = 0;
+        } else {
+            retry_delay = retry_delay == 0 ? SNAPSHOT_RETRY_MIN
+                        : retry_delay * 2 > SNAPSHOT_RETRY_MAX ? SNAPSHOT_RETRY_MAX : retry_delay * 2;
+            retry_at = time(NULL) + retry_delay;
+            if (logging_enabled) printf("DEBUG: Automatic snapshot failed, retrying in %d seconds\n", retry_delay);
+        }
     }
     
     if (logging_enabled) printf("DEBUG: Snapshot thread exiting\n");
     return NULL;
 }
 
-// Buffer yönetimi - artık AOF için değil sadece snapshot yazma için kullanılacak
+// Buffer yönetimi - append-only log kayıtları FileWriter'ın buffer'larında birikir
+static void flush_buffer_locked() {
+    if (storage_file) {
+        if (!file_writer_flush(storage_file)) {
+            if (logging_enabled) printf("DEBUG: Warning - Failed to write all data to storage file\n");
+        }
+    }
+}
+
 static void flush_buffer() {
     pthread_mutex_lock(&buffer_mutex);
+    flush_buffer_locked();
+    pthread_mutex_unlock(&buffer_mutex);
+}
+
+// Rewrite sürerken gelen kayıtları kuyruğa ekler (buffer_mutex tutulurken çağrılır)
+static void append_to_rewrite_diff(const char* str, size_t len) {
+    if (rewrite_diff_overflow) return;
     
-    if (buffer_pos > 0 && storage_file) {
-        if (logging_enabled) printf("DEBUG: Flushing buffer with %zu bytes\n", buffer_pos);
-        size_t written = fwrite(write_buffer, 1, buffer_pos, storage_file);
-        if (written != buffer_pos) {
-            if (logging_enabled) printf("DEBUG: Warning - Failed to write all data to storage file\n");
+    if (rewrite_diff_len + len > rewrite_diff_cap) {
+        size_t new_cap = rewrite_diff_cap ? rewrite_diff_cap * 2 : BUFFER_SIZE;
+        while (new_cap < rewrite_diff_len + len) new_cap *= 2;
+        
+        char* new_diff = new_cap <= LOG_REWRITE_MAX_DIFF ? realloc(rewrite_diff, new_cap) : NULL;
+        if (!new_diff) {
+            // Kuyruk sınırı aşıldı, bu rewrite iptal edilecek
+            if (logging_enabled) printf("DEBUG: Rewrite diff too large, rewrite will be aborted\n");
+            rewrite_diff_overflow = true;
+            return;
         }
-        fflush(storage_file);
-        buffer_pos = 0;
-        if (logging_enabled) printf("DEBUG: Buffer flushed successfully\n");
+        rewrite_diff = new_diff;
+        rewrite_diff_cap = new_cap;
     }
     
-    pthread_mutex_unlock(&buffer_mutex);
+    memcpy(rewrite_diff + rewrite_diff_len, str, len);
+    rewrite_diff_len += len;
 }
 
-static void append_to_buffer(const char* str) {
+static void append_to_buffer_locked(const char* str) {
     if (!str || !storage_file) return;
     
+    size_t len = strlen(str);
+    log_size += len;
+    if (rewrite_in_progress) {
+        append_to_rewrite_diff(str, len);
+    }
+    
+    // Buffer dolduğunda yazıcı kendisi diske verir
+    if (!file_writer_write(storage_file, str, len) && logging_enabled) {
+        printf("DEBUG: Warning - Partial write to storage file\n");
+    }
+}
+
+// Log kayıt formatı (uzunluk önekli, böylece anahtar/değer boşluk içerebilir):
+//   SET <expire_at> <key_len> <value_len> <key> <value>\n
+//   DEL <key_len> <key>\n
+// Kayıtlar entry'ye sığan kısımla yazılır (kv de anahtar/değeri aynı sınırda keser); uzun bir
+// değer uzunluk önekini bozup replay_log'un sonraki kayıtları atlamasına yol açmaz
+static void format_set_record(char* record, size_t size, const char* key, const char* value, time_t expire_at) {
+    int key_len = (int)strnlen(key, MAX_KEY_SIZE - 1);
+    int value_len = (int)strnlen(value, MAX_VALUE_SIZE - 1);
+    snprintf(record, size, "SET %ld %d %d %.*s %.*s\n",
+             (long)expire_at, key_len, value_len, key_len, key, value_len, value);
+}
+
+static void format_del_record(char* record, size_t size, const char* key) {
+    int key_len = (int)strnlen(key, MAX_KEY_SIZE - 1);
+    snprintf(record, size, "DEL %d %.*s\n", key_len, key_len, key);
+}
+
+// Log dosyasının başlığını okur ve neyin üzerine uygulanacağını döner
+static LogBase read_log_header(FILE* f) {
+    char line[64];
+    if (!fgets(line, sizeof(line), f)) return LOG_BASE_NONE;
+    line[strcspn(line, "\n")] = 0;
+    if (strcmp(line, LOG_HEADER) != 0) return LOG_BASE_NONE;
+    
+    if (!fgets(line, sizeof(line), f)) return LOG_BASE_NONE;
+    line[strcspn(line, "\n")] = 0;
+    if (strcmp(line, LOG_BASE_SNAPSHOT) == 0) return LOG_BASE_ON_SNAPSHOT;
+    if (strcmp(line, LOG_BASE_INLINE) == 0) return LOG_BASE_SELF;
+    return LOG_BASE_NONE;
+}
+
+static LogBase probe_log_base() {
+    FILE* f = fopen(STORAGE_FILE, "r");
+    if (!f) return LOG_BASE_NONE;
+    LogBase base = read_log_header(f);
+    fclose(f);
+    return base;
+}
+
+// Log dosyasındaki kayıtları sırayla hafızaya uygular. start_offset sıfırdan
+// büyükse (map edilmiş tablo o noktaya kadar güncel) oradan devam edilir.
+static size_t replay_log(long start_offset) {
+    FILE* f = fopen(STORAGE_FILE, "r");
+    if (!f) return 0;
+    
+    if (read_log_header(f) == LOG_BASE_NONE) {
+        fclose(f);
+        return 0;
+    }
+    if (start_offset > ftell(f) && fseek(f, start_offset, SEEK_SET) != 0) {
+        fclose(f);
+        return 0;
+    }
+    
+    time_t now = time(NULL);
+    size_t applied = 0;
+    char op[4];
+    char key[MAX_KEY_SIZE];
+    char value[MAX_VALUE_SIZE];
+    
+    while (fscanf(f, "%3s", op) == 1) {
+        size_t key_len = 0;
+        size_t value_len = 0;
+        long expire_at = 0;
+        
+        if (strcmp(op, "SET") == 0) {
+            if (fscanf(f, "%ld %zu %zu", &expire_at, &key_len, &value_len) != 3) break;
+        } else if (strcmp(op, "DEL") == 0) {
+            if (fscanf(f, "%zu", &key_len) != 1) break;
+        } else {
+            if (logging_enabled) printf("DEBUG: Unknown log record: %s\n", op);
+            break;
+        }
+        
+        // Yarım kalmış (truncate olmuş) son kayıt burada yakalanır
+        if (key_len >= MAX_KEY_SIZE || value_len >= MAX_VALUE_SIZE) break;
+        if (fgetc(f) != ' ' || fread(key, 1, key_len, f) != key_len) break;
+        key[key_len] = '\0';
+        
+        if (op[0] == 'S') {
+            if (fgetc(f) != ' ' || fread(value, 1, value_len, f) != value_len) break;
+            value[value_len] = '\0';
+        }
+        if (fgetc(f) != '\n') break;
+        
+        if (op[0] == 'S') {
+            if (expire_at == 0) {
+                kv_set(key, value);
+            } else if (expire_at > now) {
+                kv_set_with_ttl(key, value, (int)(expire_at - now));
+            } else {
+                kv_del(key); // Süresi dolmuş, önceki değer de geçersiz
+            }
+        } else {
+            kv_del(key);
+        }
+        applied++;
+    }
+    
+    fclose(f);
+    if (logging_enabled) printf("DEBUG: Replayed %zu log records\n", applied);
+    return applied;
+}
+
+// Log dosyasını ekleme modunda açar, yoksa başlık ile oluşturur
+static FileWriter* open_log(LogBase base) {
+    FileWriter* writer = file_writer_open(STORAGE_FILE, true);
+    if (!writer) return NULL;
+    
+    if (file_writer_size(writer) == 0) {
+        file_writer_printf(writer, "%s\n%s\n", LOG_HEADER, base == LOG_BASE_SELF ? LOG_BASE_INLINE : LOG_BASE_SNAPSHOT);
+        file_writer_flush(writer);
+    }
+    return writer;
+}
+
+// Hafızadaki güncel durumu taban, rewrite sırasında gelen kayıtları kuyruk olarak
+// yeni bir log dosyasına yazar. Tablo kilidi sadece küçük parçalar için alınır,
+// yazarlar sadece son kuyruk yazımı ve dosya değişimi sırasında bekler.
+static bool rewrite_log() {
+    // Aynı anda tek bir rewrite çalışabilir
     pthread_mutex_lock(&buffer_mutex);
+    if (rewrite_in_progress || !storage_file) {
+        pthread_mutex_unlock(&buffer_mutex);
+        return false;
+    }
+    rewrite_in_progress = true;
+    pthread_mutex_unlock(&buffer_mutex);
     
-    size_t len = strlen(str);
-    if (buffer_pos + len >= BUFFER_SIZE) {
-        // Buffer doldu, hemen flush edelim
-        size_t written = fwrite(write_buffer, 1, buffer_pos, storage_file);
-        if (written != buffer_pos && logging_enabled) {
-            printf("DEBUG: Warning - Partial write to storage file\n");
+    FileWriter* f = file_writer_open(TEMP_STORAGE_FILE, false);
+    Entry* batch = malloc(LOG_REWRITE_BATCH * sizeof(Entry));
+    if (!f || !batch) {
+        if (logging_enabled) printf("DEBUG: Failed to prepare log rewrite\n");
+        if (f) file_writer_close(f);
+        free(batch);
+        remove(TEMP_STORAGE_FILE);
+        pthread_mutex_lock(&buffer_mutex);
+        rewrite_in_progress = false;
+        pthread_mutex_unlock(&buffer_mutex);
+        return false;
+    }
+    file_writer_printf(f, "%s\n%s\n", LOG_HEADER, LOG_BASE_INLINE);
+    
+    // Bu noktadan sonraki tüm kayıtlar kuyrukta da toplanır
+    pthread_mutex_lock(&buffer_mutex);
+    rewrite_diff_len = 0;
+    rewrite_diff_overflow = false;
+    pthread_mutex_unlock(&buffer_mutex);
+    
+    char record[LOG_RECORD_SIZE];
+    size_t cursor = 0;
+    size_t previous_cursor;
+    size_t base_entries = 0;
+    do {
+        previous_cursor = cursor;
+        size_t copied = kv_scan_entries(&cursor, batch, LOG_REWRITE_BATCH);
+        for (size_t i = 0; i < copied; i++) {
+            format_set_record(record, sizeof(record), batch[i].key, batch[i].value, batch[i].expire_at);
+            file_writer_puts(f, record);
         }
-        fflush(storage_file);
-        buffer_pos = 0;
+        base_entries += copied;
+    } while (cursor != previous_cursor);
+    free(batch);
+    
+    // Taban kilitsiz diske verilir; yazarlar yalnızca kuyruğun eklenip senkronlanmasını bekler
+    bool ok = file_writer_sync(f);
+    
+    pthread_mutex_lock(&buffer_mutex);
+    
+    ok = ok && !rewrite_diff_overflow && !file_writer_has_error(f);
+    if (ok) {
+        file_writer_write(f, rewrite_diff, rewrite_diff_len);
+        ok = file_writer_sync(f);
     }
+    ok = file_writer_close(f) && ok;
     
-    if (len < BUFFER_SIZE) {
-        memcpy(write_buffer + buffer_pos, str, len);
-        buffer_pos += len;
+    if (ok && rename(TEMP_STORAGE_FILE, STORAGE_FILE) == 0) {
+        // Eski yazıcıdaki kayıtlar ya tabanda ya kuyrukta mevcut
+        if (storage_file) file_writer_close(storage_file);
+        storage_file = open_log(LOG_BASE_SELF);
+        if (active_storage) active_storage->file = storage_file;
+        
+        log_size = file_writer_size(storage_file);
+        log_base_size = log_size;
     } else {
-        // Çok büyük string, doğrudan dosyaya yazalım
-        if (logging_enabled) printf("DEBUG: String too large for buffer, writing directly\n");
-        fwrite(str, 1, len, storage_file);
-        fflush(storage_file);
+        if (logging_enabled) printf("DEBUG: Log rewrite failed, keeping old log\n");
+        remove(TEMP_STORAGE_FILE);
+        ok = false;
     }
     
-    // Eğer buffer 3/4 dolduysa, flush yapalım
-    if (buffer_pos > (BUFFER_SIZE * 3) / 4) {
-        size_t written = fwrite(write_buffer, 1, buffer_pos, storage_file);
-        if (written != buffer_pos && logging_enabled) {
-            printf("DEBUG: Warning - Partial write to storage file\n");
-        }
-        fflush(storage_file);
-        buffer_pos = 0;
+    rewrite_in_progress = false;
+    rewrite_diff_len = 0;
+    if (rewrite_diff_cap > LOG_REWRITE_MAX_DIFF / 16) {
+        // Büyük kuyruk belleğini tutma
+        free(rewrite_diff);
+        rewrite_diff = NULL;
+        rewrite_diff_cap = 0;
     }
     
     pthread_mutex_unlock(&buffer_mutex);
+    
+    if (logging_enabled && ok) printf("DEBUG: Log rewritten with %zu base entries, new size %ld bytes\n",
+                                      base_entries, log_base_size);
+    return ok;
+}
+
+static bool log_rewrite_needed() {
+    pthread_mutex_lock(&buffer_mutex);
+    bool needed = rewrite_requested ||
+                  (log_size >= LOG_REWRITE_MIN_SIZE &&
+                   log_size > log_base_size + log_base_size * LOG_REWRITE_PERCENTAGE / 100);
+    rewrite_requested = false;
+    pthread_mutex_unlock(&buffer_mutex);
+    return needed;
+}
+
+// Log thread'i - her saniye buffer'ı diske verir ve gerekirse log'u yeniden yazar
+static void* log_thread_func(void* arg) {
+    (void)arg;
+    while (!wait_for_stop(&log_stop_requested, LOG_FLUSH_INTERVAL)) {
+        flush_buffer();
+        if (log_rewrite_needed()) {
+            rewrite_log();
+        }
+    }
+    return NULL;
 }
 
 // Storage yönetimi
@@ -115,41 +478,78 @@ Storage* storage_init(void) {
         return NULL;
     }
     
-    // Önce KV store'u başlat
-    kv_init();
+    storage->file = NULL;
     
-    // Snapshot dosyasını okuma için aç
-    storage->file = fopen(storage->file_path, "r");
-    if (!storage->file) {
-        if (logging_enabled) printf("DEBUG: No snapshot file found, starting fresh\n");
-    } else {
-        // Snapshot dosyasını oku
+    // Önce KV store'u başlat. Map edilmiş tablo düzgün kapatılmışsa olduğu gibi
+    // geri gelir; snapshot okunmaz, log sadece kapanıştan sonraki kısmıyla uygulanır.
+    bool restored = false;
+    long log_offset = 0;
+    if (!mapped_table || !kv_init_mapped(MAPPED_TABLE_FILE, &restored, &log_offset)) {
+        if (mapped_table && logging_enabled) printf("ERROR: Mapped table unavailable, using memory table\n");
+        kv_init();
+    }
+    
+    // Rewrite edilmiş bir log tam durumu içerir, bu durumda snapshot okunmaz
+    LogBase base = log_enabled ? probe_log_base() : LOG_BASE_NONE;
+    kv_set_change_tracking(false);
+    snapshot_base_time = 0;
+    if (restored) {
+        if (logging_enabled) printf("DEBUG: Restored %zu entries from mapped table\n", kv_get_count());
+    } else if (base != LOG_BASE_SELF) {
         if (logging_enabled) printf("DEBUG: Loading data from snapshot file\n");
-        storage_load_snapshot();
-        fclose(storage->file);
-        storage->file = NULL;
+        if (!storage_load_snapshot() && logging_enabled) {
+            printf("DEBUG: No snapshot data loaded, starting fresh\n");
+        }
     }
     
-    // Snapshot dosyasını yazma için aç
-    storage->file = fopen(storage->file_path, "w");
-    if (!storage->file) {
-        if (logging_enabled) printf("ERROR: Failed to open snapshot file for writing\n");
-        free(storage->file_path);
-        free(storage);
-        return NULL;
+    // Yüklenen durum taban + deltalara eşit; bundan sonraki değişiklikler takip edilir.
+    // Log kendi başına yüklendiyse diskteki zincir geçersizdir, ilk snapshot tam alınır.
+    if (delta_snapshots) {
+        if (base == LOG_BASE_SELF) snapshot_base_time = 0;
+        kv_set_change_tracking(true);
     }
     
-    // Global storage_file'ı güncelle
-    storage_file = storage->file;
+    if (log_enabled) {
+        if (base != LOG_BASE_NONE) {
+            if (logging_enabled) printf("DEBUG: Replaying append-only log\n");
+            replay_log(restored ? log_offset : 0);
+        } else {
+            // Geçersiz ya da olmayan log snapshot'ın üzerine yeniden başlatılır
+            remove(STORAGE_FILE);
+        }
+        
+        // Log dosyasını ekleme modunda aç
+        storage->file = open_log(base == LOG_BASE_SELF ? LOG_BASE_SELF : LOG_BASE_ON_SNAPSHOT);
+        if (!storage->file) {
+            if (logging_enabled) printf("ERROR: Failed to open log file for writing\n");
+            free(storage->file_path);
+            free(storage);
+            return NULL;
+        }
+        
+        pthread_mutex_lock(&buffer_mutex);
+        storage_file = storage->file;
+        log_size = file_writer_size(storage_file);
+        log_base_size = log_size;
+        rewrite_requested = false;
+        pthread_mutex_unlock(&buffer_mutex);
+        
+        log_stop_requested = false;
+        if (pthread_create(&log_thread, NULL, log_thread_func, NULL) == 0) {
+            log_thread_running = true;
+        } else if (logging_enabled) {
+            printf("ERROR: Failed to create log thread\n");
+        }
+    }
+    active_storage = storage;
     
-    // Buffer'ı sıfırla
-    pthread_mutex_lock(&buffer_mutex);
-    buffer_pos = 0;
-    memset(write_buffer, 0, BUFFER_SIZE);
-    pthread_mutex_unlock(&buffer_mutex);
+    // Açılıştaki durum diskteki ile aynı; zamanlayıcı buradan saymaya başlar
+    pthread_mutex_lock(&snapshot_mutex);
+    snapshot_completed_locked(kv_write_count());
+    pthread_mutex_unlock(&snapshot_mutex);
     
     // Snapshot thread'i başlat
-    storage_schedule_snapshot(SNAPSHOT_INTERVAL);
+    start_snapshot_thread();
     
     if (logging_enabled) printf("DEBUG: Storage initialization completed\n");
     return storage;
@@ -162,25 +562,49 @@ void storage_free(Storage* storage) {
     
     printf("Saving snapshot to disk...\n");
     
-    // Snapshot thread'i durdur
-    shutdown_requested = true;
+    // Snapshot ve log thread'lerini durdur
+    pthread_mutex_lock(&snapshot_thread_mutex);
+    request_stop(&shutdown_requested);
     if (snapshot_thread_running) {
         if (logging_enabled) printf("DEBUG: Waiting for snapshot thread to exit\n");
         pthread_join(snapshot_thread, NULL);
         snapshot_thread_running = false;
     }
+    shutdown_requested = false;
+    pthread_mutex_unlock(&snapshot_thread_mutex);
+    
+    request_stop(&log_stop_requested);
+    if (log_thread_running) {
+        pthread_join(log_thread, NULL);
+        log_thread_running = false;
+    }
 
     // Son bir snapshot al
     storage_save_snapshot();
+    kv_set_change_tracking(false);
 
-    // Dosyayı kapat
+    // Log buffer'ını diske ver ve dosyayı kapat
+    pthread_mutex_lock(&buffer_mutex);
+    flush_buffer_locked();
     if (storage->file) {
         if (logging_enabled) printf("DEBUG: Closing storage file\n");
-        if (fclose(storage->file) != 0) {
+        if (!file_writer_close(storage->file)) {
             if (logging_enabled) printf("DEBUG: Warning - Failed to close storage file\n");
         }
         storage->file = NULL;
     }
+    if (kv_is_mapped()) {
+        // Log'un bu noktaya kadarki hali tabloda; bir sonraki açılış buradan devam eder
+        if (!kv_close_mapped(log_size) && logging_enabled) {
+            printf("DEBUG: Warning - Failed to persist mapped table\n");
+        }
+    }
+    storage_file = NULL;
+    active_storage = NULL;
+    free(rewrite_diff);
+    rewrite_diff = NULL;
+    rewrite_diff_cap = 0;
+    pthread_mutex_unlock(&buffer_mutex);
 
     // Dosya yolunu temizle
     if (storage->file_path) {
@@ -197,21 +621,33 @@ void storage_free(Storage* storage) {
 }
 
 // Temel operasyonlar
+// Yazma işlemleri buffer_mutex altında yapılır; böylece log'daki kayıt sırası
+// hafızadaki uygulama sırasıyla aynı kalır
 bool storage_set(Storage* storage, const char* key, const char* value) {
     if (!storage || !key || !value) return false;
     
+    pthread_mutex_lock(&buffer_mutex);
+    
     // Key-value çiftini hafızaya kaydet
     kv_set(key, value);
+    storage_append_set(key, value, 0);
+    if (write_hook) write_hook(key, value, 0);
     
+    pthread_mutex_unlock(&buffer_mutex);
     return true;
 }
 
 bool storage_set_with_ttl(Storage* storage, const char* key, const char* value, int ttl) {
     if (!storage || !key || !value) return false;
     
+    pthread_mutex_lock(&buffer_mutex);
+    
     // Key-value çiftini hafızaya kaydet
     kv_set_with_ttl(key, value, ttl);
+    storage_append_set(key, value, ttl);
+    if (write_hook) write_hook(key, value, ttl);
     
+    pthread_mutex_unlock(&buffer_mutex);
     return true;
 }
 
@@ -235,45 +671,346 @@ char* storage_get(Storage* storage, const char* key) {
 bool storage_delete(Storage* storage, const char* key) {
     if (!storage || !key) return false;
     
+    pthread_mutex_lock(&buffer_mutex);
+    
     // Key'i hafızadan sil
     kv_del(key);
+    storage_append_del(key);
+    if (write_hook) write_hook(key, NULL, 0);
+    
+    pthread_mutex_unlock(&buffer_mutex);
+    return true;
+}
+
+bool storage_cas(Storage* storage, const char* key, uint64_t expected_version, const char* value, uint64_t* version) {
+    *version = 0;
+    if (!storage || !key || !value) return false;
+    
+    pthread_mutex_lock(&buffer_mutex);
+    
+    bool stored = kv_cas(key, expected_version, value, version);
+    if (stored) {
+        storage_append_set(key, value, 0);
+        if (write_hook) write_hook(key, value, 0);
+    }
+    
+    pthread_mutex_unlock(&buffer_mutex);
+    return stored;
+}
+
+bool storage_getset(Storage* storage, const char* key, const char* value, const char** old_value) {
+    *old_value = NULL;
+    if (!storage || !key || !value) return false;
+    
+    pthread_mutex_lock(&buffer_mutex);
+    
+    bool stored = kv_getset(key, value, old_value);
+    if (stored) {
+        storage_append_set(key, value, 0);
+        if (write_hook) write_hook(key, value, 0);
+    }
+    
+    pthread_mutex_unlock(&buffer_mutex);
+    return stored;
+}
+
+bool storage_apply_batch(Storage* storage, const KvWatch* watches, size_t watch_count,
+                         const KvBatchOp* ops, size_t count, bool* changed) {
+    if (!storage || (count > 0 && (!ops || !changed))) return false;
+    
+    pthread_mutex_lock(&buffer_mutex);
+    
+    if (!kv_apply_batch(watches, watch_count, ops, count, changed)) {
+        pthread_mutex_unlock(&buffer_mutex);
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        // Yazılamayan (havuz dolu) ya da silinecek anahtarı olmayan işlemler log'a ve
+        // replikalara gitmez
+        if (!changed[i]) continue;
+        if (ops[i].value) storage_append_set(ops[i].key, ops[i].value, ops[i].ttl);
+        else storage_append_del(ops[i].key);
+        if (write_hook) write_hook(ops[i].key, ops[i].value, ops[i].value ? ops[i].ttl : 0);
+    }
     
+    pthread_mutex_unlock(&buffer_mutex);
     return true;
 }
 
-// AOF fonksiyonları yerine boş fonksiyonlar (geriye dönük uyumluluk için)
+void storage_lock_writes() {
+    pthread_mutex_lock(&buffer_mutex);
+}
+
+void storage_unlock_writes() {
+    pthread_mutex_unlock(&buffer_mutex);
+}
+
+// Append-only log fonksiyonları - buffer_mutex tutulurken çağrılmalı
 void storage_append_set(const char* key, const char* value, const int ttl) {
-    // Artık AOF kullanmıyoruz, snapshot'a geçtik
-    return;
+    if (!log_enabled || !storage_file || !key || !value) return;
+    
+    char record[LOG_RECORD_SIZE];
+    time_t expire_at = ttl > 0 ? time(NULL) + ttl : 0;
+    format_set_record(record, sizeof(record), key, value, expire_at);
+    append_to_buffer_locked(record);
 }
 
 void storage_append_del(const char* key) {
-    // Artık AOF kullanmıyoruz, snapshot'a geçtik
-    return;
+    if (!log_enabled || !storage_file || !key) return;
+    
+    char record[LOG_RECORD_SIZE];
+    format_del_record(record, sizeof(record), key);
+    append_to_buffer_locked(record);
 }
 
 void storage_load() {
-    // Artık AOF kullanmıyoruz, snapshot'a geçtik
-    return;
+    // Log yeniden oynatımı storage_init içinde yapılıyor
+    if (log_enabled && probe_log_base() != LOG_BASE_NONE) {
+        replay_log(0);
+    }
 }
 
+void storage_configure_io(bool use_uring, bool direct_io) {
+    // storage_init'ten önce çağrılmalı; io_uring yoksa stdio kullanılmaya devam edilir
+    file_writer_configure(use_uring, direct_io);
+    if (use_uring && !file_writer_uring_available()) {
+        printf("io_uring is not available, falling back to buffered stdio\n");
+    }
+}
+
+void storage_set_log_enabled(bool enabled) {
+    // storage_init'ten önce çağrılmalı
+    log_enabled = enabled;
+}
+
+long storage_log_size() {
+    pthread_mutex_lock(&buffer_mutex);
+    long size = log_size;
+    pthread_mutex_unlock(&buffer_mutex);
+    return size;
+}
+
+bool storage_rewrite_log() {
+    if (!log_enabled) return false;
+    return rewrite_log();
+}
+
+// Snapshot kayıtlarını düz metin ya da sıkıştırılmış bloklar halinde yazan akış.
+// Sıkıştırılmış modda her blok sadece tam kayıtlar içerir, böylece bloklar
+// yüklemede birbirinden bağımsız açılıp işlenebilir.
+typedef struct {
+    FileWriter* writer;
+    bool compress;
+    char* block;          // Ham blok
+    size_t block_len;
+    char* packed;         // Sıkıştırılmış blok
+    size_t raw_bytes;     // Toplam ham bayt (oran hesabı için)
+    bool failed;
+} SnapshotStream;
+
+static bool snapshot_stream_init(SnapshotStream* stream, FileWriter* writer, bool compress) {
+    memset(stream, 0, sizeof(SnapshotStream));
+    stream->writer = writer;
+    stream->compress = compress;
+    if (!compress) return true;
+    
+    stream->block = malloc(SNAPSHOT_BLOCK_SIZE);
+    stream->packed = malloc(LZ_COMPRESS_BOUND(SNAPSHOT_BLOCK_SIZE));
+    if (!stream->block || !stream->packed) {
+        free(stream->block);
+        free(stream->packed);
+        return false;
+    }
+    return true;
+}
+
+static void snapshot_stream_flush_block(SnapshotStream* stream) {
+    if (stream->block_len == 0) return;
+    
+    uint32_t header[2];
+    size_t packed_len = lz_compress(stream->block, stream->block_len,
+                                    stream->packed, LZ_COMPRESS_BOUND(SNAPSHOT_BLOCK_SIZE));
+    
+    // Sıkıştırma kazandırmıyorsa blok ham saklanır (stored == raw)
+    const char* payload = stream->packed;
+    if (packed_len == 0 || packed_len >= stream->block_len) {
+        payload = stream->block;
+        packed_len = stream->block_len;
+    }
+    
+    header[0] = (uint32_t)stream->block_len;
+    header[1] = (uint32_t)packed_len;
+    if (!file_writer_write(stream->writer, header, sizeof(header)) ||
+        !file_writer_write(stream->writer, payload, packed_len)) {
+        stream->failed = true;
+    }
+    stream->block_len = 0;
+}
+
+static void snapshot_stream_write(SnapshotStream* stream, const char* data, size_t len) {
+    stream->raw_bytes += len;
+    
+    if (!stream->compress) {
+        if (!file_writer_write(stream->writer, data, len)) stream->failed = true;
+        return;
+    }
+    
+    if (stream->block_len + len > SNAPSHOT_BLOCK_SIZE) {
+        snapshot_stream_flush_block(stream);
+    }
+    memcpy(stream->block + stream->block_len, data, len);
+    stream->block_len += len;
+}
+
+static bool snapshot_stream_finish(SnapshotStream* stream) {
+    if (stream->compress) snapshot_stream_flush_block(stream);
+    free(stream->block);
+    free(stream->packed);
+    stream->block = NULL;
+    stream->packed = NULL;
+    return !stream->failed;
+}
+
+static double elapsed_seconds(const struct timespec* start) {
+    struct timespec end;
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return (end.tv_sec - start->tv_sec) + (end.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+static void remove_delta_snapshots() {
+    char path[64];
+    for (int i = 1; i <= SNAPSHOT_MAX_DELTAS; i++) {
+        snprintf(path, sizeof(path), SNAPSHOT_DELTA_FILE, i);
+        remove(path);
+    }
+}
+
+// Delta zincirine yeni halka eklenebilir mi? Zincir uzadıysa ya da deltalar
+// tabandan büyüdüyse tam snapshot ile birleştirilir.
+static bool delta_snapshot_possible() {
+    return snapshot_base_time != 0 &&
+           delta_count < SNAPSHOT_MAX_DELTAS &&
+           delta_total_size < base_snapshot_size &&
+           !kv_changes_overflowed();
+}
+
+typedef struct {
+    SnapshotStream* stream;
+    time_t now;
+    size_t sets;
+    size_t dels;
+} DeltaWriter;
+
+static void delta_write_del(const char* key, void* ctx);
+
+static void delta_write_set(const Entry* entry, void* ctx) {
+    DeltaWriter* delta = ctx;
+    // Tam snapshot süresi dolmuşları atlar; deltada tabandaki eski değer geri gelmesin
+    // diye silme kaydı yazılır
+    if (entry->expire_at != 0 && entry->expire_at <= delta->now) {
+        delta_write_del(entry->key, ctx);
+        return;
+    }
+    char record[LOG_RECORD_SIZE];
+    time_t ttl = entry->expire_at == 0 ? 0 : entry->expire_at - delta->now;
+    int len = snprintf(record, sizeof(record), "KEY:%s\nVALUE:%s\nTTL:%ld\n---\n",
+                       entry->key, entry->value, ttl);
+    snapshot_stream_write(delta->stream, record, (size_t)len);
+    delta->sets++;
+}
+
+static void delta_write_del(const char* key, void* ctx) {
+    DeltaWriter* delta = ctx;
+    char record[MAX_KEY_SIZE + 16];
+    int len = snprintf(record, sizeof(record), "DEL:%s\n---\n", key);
+    snapshot_stream_write(delta->stream, record, (size_t)len);
+    delta->dels++;
+}
+
+// Son snapshot'tan beri değişen girişleri zincirin sonuna yazar
+static bool save_delta_snapshot_locked() {
+    if (kv_change_count() == 0) {
+        if (logging_enabled) printf("DEBUG: No changes since last snapshot, delta skipped\n");
+        return true;
+    }
+    
+    FileWriter* f = file_writer_open(TEMP_SNAPSHOT_DELTA_FILE, false);
+    SnapshotStream stream;
+    if (!f || !snapshot_stream_init(&stream, f, false)) {
+        if (f) file_writer_close(f);
+        return false;
+    }
+    
+    DeltaWriter delta = { &stream, time(NULL), 0, 0 };
+    file_writer_printf(f, "%s\n", SNAPSHOT_DELTA_HEADER);
+    file_writer_printf(f, "BASE:%ld\n", snapshot_base_time);
+    file_writer_printf(f, "TIME:%ld\n", delta.now);
+    file_writer_printf(f, "---\n");
+    
+    // Değişiklik listesi burada boşaltılır; yazım başarısız olursa bir sonraki
+    // snapshot tam alınmalı
+    kv_drain_changes(delta_write_set, delta_write_del, &delta);
+    
+    bool stream_ok = snapshot_stream_finish(&stream);
+    long file_size = file_writer_size(f);
+    char path[64];
+    snprintf(path, sizeof(path), SNAPSHOT_DELTA_FILE, delta_count + 1);
+    
+    if (!file_writer_close(f) || !stream_ok || rename(TEMP_SNAPSHOT_DELTA_FILE, path) != 0) {
+        if (logging_enabled) printf("DEBUG: Failed to write delta snapshot\n");
+        remove(TEMP_SNAPSHOT_DELTA_FILE);
+        snapshot_base_time = 0;
+        return false;
+    }
+    
+    delta_count++;
+    delta_total_size += file_size;
+    if (logging_enabled) printf("DEBUG: Delta snapshot %d saved. Changed: %zu, Deleted: %zu, %ld bytes\n",
+                                delta_count, delta.sets, delta.dels, file_size);
+    return true;
+}
+
+static bool save_full_snapshot_locked(bool compress);
+
 // Snapshot işlemleri
 bool storage_save_snapshot() {
-    if (logging_enabled) printf("DEBUG: Saving snapshot\n");
+    pthread_mutex_lock(&snapshot_mutex);
+    unsigned long long writes = kv_write_count();
+    bool saved = delta_snapshots && delta_snapshot_possible()
+        ? save_delta_snapshot_locked()
+        : save_full_snapshot_locked(snapshot_compression);
+    if (saved) snapshot_completed_locked(writes);
+    pthread_mutex_unlock(&snapshot_mutex);
+    return saved;
+}
+
+bool storage_save_snapshot_ex(bool compress) {
+    pthread_mutex_lock(&snapshot_mutex);
+    unsigned long long writes = kv_write_count();
+    bool saved = save_full_snapshot_locked(compress);
+    if (saved) snapshot_completed_locked(writes);
+    pthread_mutex_unlock(&snapshot_mutex);
+    return saved;
+}
+
+static bool save_full_snapshot_locked(bool compress) {
+    if (logging_enabled) printf("DEBUG: Saving snapshot%s\n", compress ? " (compressed)" : "");
+    
+    struct timespec started;
+    clock_gettime(CLOCK_MONOTONIC, &started);
     
-    // Temporary dosya oluştur
-    FILE* f = fopen(TEMP_SNAPSHOT_FILE, "w");
+    // Temporary dosya oluştur - yazıcı kendi buffer'larını yönetir
+    FileWriter* f = file_writer_open(TEMP_SNAPSHOT_FILE, false);
     if (!f) {
         if (logging_enabled) printf("DEBUG: Failed to create temporary file for snapshot\n");
         return false;
     }
-    
-    // Daha verimli yazma için tampon boyutunu ayarla
-    setvbuf(f, NULL, _IOFBF, BUFFER_SIZE);
 
     HashTable* table = kv_get_table();
-    if (!table) {
-        fclose(f);
+    SnapshotStream stream;
+    if (!table || !snapshot_stream_init(&stream, f, compress)) {
+        file_writer_close(f);
+        remove(TEMP_SNAPSHOT_FILE);
         if (logging_enabled) printf("DEBUG: Failed to get hash table for snapshot\n");
         return false;
     }
@@ -281,13 +1018,18 @@ bool storage_save_snapshot() {
     time_t now = time(NULL);
     size_t total_entries = 0;
     size_t live_entries = 0;
+    // TIME satırı deltaların bağlandığı taban kimliğidir, her tam snapshot'ta artmalı
+    time_t base_time = now > snapshot_base_time ? now : snapshot_base_time + 1;
 
     // Verileri kilitle
     pthread_mutex_lock(&table->mutex);
     
-    // Başlık bilgisi yaz (format: AYTDB_SNAPSHOT_V1)
-    fprintf(f, "AYTDB_SNAPSHOT_V1\n");
-    fprintf(f, "TIME:%ld\n", now);
+    // Bu andan sonraki değişiklikler bir sonraki deltaya girer
+    kv_reset_changes_locked();
+    
+    // Başlık bilgisi yaz (format: AYTDB_SNAPSHOT_V1 ya da sıkıştırılmış AYTDB_SNAPSHOT_Z1)
+    file_writer_printf(f, "%s\n", compress ? COMPRESSED_SNAPSHOT_HEADER : SNAPSHOT_HEADER);
+    file_writer_printf(f, "TIME:%ld\n", base_time);
     
     // Toplam girdi sayısını hesapla
     for (int i = 0; i < table->size; i++) {
@@ -301,10 +1043,11 @@ bool storage_save_snapshot() {
     }
     
     // Toplam giriş sayısını yaz
-    fprintf(f, "ENTRIES:%zu\n", live_entries);
-    fprintf(f, "---\n"); // Başlık sonu ayracı
+    file_writer_printf(f, "ENTRIES:%zu\n", live_entries);
+    file_writer_printf(f, "---\n"); // Başlık sonu ayracı
     
     // Girişleri yaz - metin formatında, daha okunaklı
+    char record[LOG_RECORD_SIZE];
     for (int i = 0; i < table->size; i++) {
         if (table->entries[i] != NULL) {
             // Sadece yaşayan girişleri yaz
@@ -312,17 +1055,23 @@ bool storage_save_snapshot() {
                 time_t ttl = table->entries[i]->expire_at == 0 ? 0 : table->entries[i]->expire_at - now;
                 
                 // Anahtar değer çiftini ve TTL'i yaz
-                fprintf(f, "KEY:%s\n", table->entries[i]->key);
-                fprintf(f, "VALUE:%s\n", table->entries[i]->value);
-                fprintf(f, "TTL:%ld\n", ttl);
-                fprintf(f, "---\n"); // Ayraç
+                int len = snprintf(record, sizeof(record), "KEY:%s\nVALUE:%s\nTTL:%ld\n---\n",
+                                   table->entries[i]->key, table->entries[i]->value, ttl);
+                snapshot_stream_write(&stream, record, (size_t)len);
             }
         }
     }
     
     pthread_mutex_unlock(&table->mutex);
     
-    fclose(f);
+    bool stream_ok = snapshot_stream_finish(&stream);
+    long file_size = file_writer_size(f);
+    if (!file_writer_close(f) || !stream_ok) {
+        if (logging_enabled) printf("DEBUG: Failed to write snapshot file\n");
+        remove(TEMP_SNAPSHOT_FILE);
+        snapshot_base_time = 0;
+        return false;
+    }
     
     // Dosya değişimi
     if (remove(SNAPSHOT_FILE) != 0 && errno != ENOENT) {
@@ -331,15 +1080,310 @@ bool storage_save_snapshot() {
     
     if (rename(TEMP_SNAPSHOT_FILE, SNAPSHOT_FILE) != 0) {
         if (logging_enabled) printf("DEBUG: Failed to rename temporary file: %s\n", strerror(errno));
+        snapshot_base_time = 0;
         return false;
     }
     
-    if (logging_enabled) printf("DEBUG: Snapshot saved. Total entries: %zu, Live entries: %zu\n", 
-           total_entries, live_entries);
+    // Eski deltalar önceki tabana aittir; BASE kimliği uyuşmadığı için zaten
+    // uygulanmazlar ama yer kaplamasınlar
+    remove_delta_snapshots();
+    snapshot_base_time = base_time;
+    base_snapshot_size = file_size;
+    delta_count = 0;
+    delta_total_size = 0;
+    
+    double seconds = elapsed_seconds(&started);
+    if (logging_enabled) printf("DEBUG: Snapshot saved. Total entries: %zu, Live entries: %zu, "
+                                "%zu -> %ld bytes (ratio %.2fx), %.1f MB/s\n",
+                                total_entries, live_entries, stream.raw_bytes, file_size,
+                                file_size > 0 ? (double)stream.raw_bytes / file_size : 0.0,
+                                seconds > 0 ? stream.raw_bytes / seconds / (1024.0 * 1024.0) : 0.0);
     
     return true;
 }
 
+void storage_set_snapshot_compression(bool enabled) {
+    snapshot_compression = enabled;
+}
+
+void storage_set_delta_snapshots(bool enabled) {
+    delta_snapshots = enabled;
+}
+
+void storage_set_mapped_table(bool enabled) {
+    mapped_table = enabled;
+}
+
+void storage_set_write_hook(void (*hook)(const char* key, const char* value, int ttl)) {
+    pthread_mutex_lock(&buffer_mutex);
+    write_hook = hook;
+    pthread_mutex_unlock(&buffer_mutex);
+}
+
+// Bir snapshot kaydının satır satır toplanması
+typedef struct {
+    char key[MAX_KEY_SIZE];
+    char value[MAX_VALUE_SIZE];
+    time_t ttl;
+    bool has_key;
+    bool has_value;
+    bool has_ttl;
+} SnapshotRecord;
+
+// Tamamlanmış kaydı hafızaya ekler; eklendiyse 1 döner
+static size_t snapshot_record_commit(SnapshotRecord* record, time_t now) {
+    size_t applied = 0;
+    if (record->has_key && record->has_value && record->has_ttl) {
+        // TTL'i kontrol et ve girişi ekle
+        if (record->ttl == 0 || now + record->ttl > now) { // overflow kontrolü
+            kv_set_with_ttl(record->key, record->value, (int)record->ttl);
+            applied = 1;
+        } else if (logging_enabled) {
+            printf("DEBUG: Skipping expired key '%s' with TTL %ld\n", record->key, record->ttl);
+        }
+    }
+    
+    // Yeni kayıt için bayrakları sıfırla
+    record->has_key = false;
+    record->has_value = false;
+    record->has_ttl = false;
+    return applied;
+}
+
+// Snapshot gövdesindeki tek bir satırı işler, eklenen kayıt sayısını döner
+static size_t snapshot_record_line(SnapshotRecord* record, const char* line, time_t now) {
+    if (strcmp(line, "---") == 0) {
+        // Bir kayıt bitti, tamamlanmışsa kaydet
+        return snapshot_record_commit(record, now);
+    }
+    
+    // Anahtar satırı
+    if (strncmp(line, "KEY:", 4) == 0) {
+        strncpy(record->key, line + 4, MAX_KEY_SIZE - 1);
+        record->key[MAX_KEY_SIZE - 1] = '\0';
+        record->has_key = true;
+    }
+    // Değer satırı
+    else if (strncmp(line, "VALUE:", 6) == 0) {
+        strncpy(record->value, line + 6, MAX_VALUE_SIZE - 1);
+        record->value[MAX_VALUE_SIZE - 1] = '\0';
+        record->has_value = true;
+    }
+    // TTL satırı
+    else if (strncmp(line, "TTL:", 4) == 0) {
+        record->ttl = atol(line + 4);
+        record->has_ttl = true;
+    }
+    // Silme satırı (sadece delta dosyalarında)
+    else if (strncmp(line, "DEL:", 4) == 0) {
+        kv_del(line + 4);
+    }
+    return 0;
+}
+
+// Tablo büyümesini yükleme başında tek seferde yap
+static void reserve_table(size_t entry_count) {
+    size_t needed = kv_get_count() + entry_count;
+    size_t size = kv_get_size();
+    while (size > 0 && needed > size / 2 && size < MAX_TABLE_SIZE) {
+        size *= GROWTH_FACTOR;
+    }
+    if (size > kv_get_size()) {
+        kv_resize(size);
+    }
+}
+
+// Sıkıştırılmış snapshot bloklarının paralel yüklenmesi
+typedef struct {
+    char* data;
+    uint32_t raw_len;
+    uint32_t stored_len;
+} SnapshotBlock;
+
+typedef struct {
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    SnapshotBlock items[SNAPSHOT_LOAD_QUEUE];
+    size_t head;
+    size_t count;
+    bool done;
+    bool failed;
+    size_t loaded;
+    time_t now;
+} SnapshotBlockQueue;
+
+static void* snapshot_block_worker(void* arg) {
+    SnapshotBlockQueue* queue = arg;
+    char* raw = malloc(SNAPSHOT_BLOCK_SIZE + 1);
+    SnapshotRecord* record = calloc(1, sizeof(SnapshotRecord));
+    size_t loaded = 0;
+    bool failed = !raw || !record;
+    
+    while (true) {
+        pthread_mutex_lock(&queue->mutex);
+        while (queue->count == 0 && !queue->done) {
+            pthread_cond_wait(&queue->not_empty, &queue->mutex);
+        }
+        if (queue->count == 0) {
+            pthread_mutex_unlock(&queue->mutex);
+            break;
+        }
+        SnapshotBlock block = queue->items[queue->head];
+        queue->head = (queue->head + 1) % SNAPSHOT_LOAD_QUEUE;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+        pthread_mutex_unlock(&queue->mutex);
+        
+        if (!failed) {
+            size_t raw_len = block.raw_len;
+            if (block.stored_len == block.raw_len) {
+                memcpy(raw, block.data, raw_len);
+            } else if (lz_decompress(block.data, block.stored_len, raw, SNAPSHOT_BLOCK_SIZE) != raw_len) {
+                if (logging_enabled) printf("DEBUG: Corrupted snapshot block\n");
+                failed = true;
+            }
+            
+            if (!failed) {
+                // Blok tam kayıtlardan oluşur; satırlara böl ve uygula
+                raw[raw_len] = '\0';
+                char* line = raw;
+                while (line < raw + raw_len) {
+                    char* newline = memchr(line, '\n', (size_t)(raw + raw_len - line));
+                    if (newline) *newline = '\0';
+                    loaded += snapshot_record_line(record, line, queue->now);
+                    if (!newline) break;
+                    line = newline + 1;
+                }
+                loaded += snapshot_record_commit(record, queue->now);
+            }
+        }
+        free(block.data);
+    }
+    
+    pthread_mutex_lock(&queue->mutex);
+    queue->loaded += loaded;
+    queue->failed = queue->failed || failed;
+    pthread_mutex_unlock(&queue->mutex);
+    
+    free(raw);
+    free(record);
+    return NULL;
+}
+
+static size_t load_compressed_snapshot_body(FILE* f, time_t now, bool* ok) {
+    SnapshotBlockQueue queue;
+    memset(&queue, 0, sizeof(queue));
+    pthread_mutex_init(&queue.mutex, NULL);
+    pthread_cond_init(&queue.not_empty, NULL);
+    pthread_cond_init(&queue.not_full, NULL);
+    queue.now = now;
+    
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t worker_count = cpus < 1 ? 1 : (size_t)cpus;
+    if (worker_count > SNAPSHOT_LOAD_MAX_THREADS) worker_count = SNAPSHOT_LOAD_MAX_THREADS;
+    
+    pthread_t workers[SNAPSHOT_LOAD_MAX_THREADS];
+    size_t started = 0;
+    for (size_t i = 0; i < worker_count; i++) {
+        if (pthread_create(&workers[started], NULL, snapshot_block_worker, &queue) == 0) started++;
+    }
+    
+    // Blokları sırayla oku ve kuyruğa koy
+    bool read_failed = started == 0;
+    uint32_t header[2];
+    while (!read_failed && fread(header, sizeof(uint32_t), 2, f) == 2) {
+        if (header[0] == 0 || header[0] > SNAPSHOT_BLOCK_SIZE || header[1] > header[0]) {
+            read_failed = true;
+            break;
+        }
+        
+        SnapshotBlock block = { malloc(header[1]), header[0], header[1] };
+        if (!block.data || fread(block.data, 1, header[1], f) != header[1]) {
+            free(block.data);
+            read_failed = true;
+            break;
+        }
+        
+        pthread_mutex_lock(&queue.mutex);
+        while (queue.count == SNAPSHOT_LOAD_QUEUE) {
+            pthread_cond_wait(&queue.not_full, &queue.mutex);
+        }
+        queue.items[(queue.head + queue.count) % SNAPSHOT_LOAD_QUEUE] = block;
+        queue.count++;
+        pthread_cond_signal(&queue.not_empty);
+        pthread_mutex_unlock(&queue.mutex);
+    }
+    
+    pthread_mutex_lock(&queue.mutex);
+    queue.done = true;
+    pthread_cond_broadcast(&queue.not_empty);
+    pthread_mutex_unlock(&queue.mutex);
+    
+    for (size_t i = 0; i < started; i++) {
+        pthread_join(workers[i], NULL);
+    }
+    // Worker başlatılamadıysa kuyrukta kalan bloklar
+    while (queue.count > 0) {
+        free(queue.items[queue.head].data);
+        queue.head = (queue.head + 1) % SNAPSHOT_LOAD_QUEUE;
+        queue.count--;
+    }
+    
+    pthread_cond_destroy(&queue.not_full);
+    pthread_cond_destroy(&queue.not_empty);
+    pthread_mutex_destroy(&queue.mutex);
+    
+    *ok = !read_failed && !queue.failed;
+    if (logging_enabled) printf("DEBUG: Loaded compressed snapshot with %zu worker threads\n", started);
+    return queue.loaded;
+}
+
+// Tabana bağlı deltaları sırayla uygular; zincir ilk eksik ya da uyumsuz dosyada biter
+static size_t load_delta_snapshots(time_t base_time) {
+    size_t applied = 0;
+    char path[64];
+    char line[MAX_LINE_SIZE];
+    
+    delta_count = 0;
+    delta_total_size = 0;
+    
+    for (int i = 1; i <= SNAPSHOT_MAX_DELTAS; i++) {
+        snprintf(path, sizeof(path), SNAPSHOT_DELTA_FILE, i);
+        FILE* f = fopen(path, "r");
+        if (!f) break;
+        
+        // Başlık: AYTDB_DELTA_V1 / BASE:<taban> / TIME:<zaman> / ---
+        time_t delta_base = 0;
+        bool valid = fgets(line, sizeof(line), f) && strncmp(line, SNAPSHOT_DELTA_HEADER, strlen(SNAPSHOT_DELTA_HEADER)) == 0 &&
+                     fgets(line, sizeof(line), f) && sscanf(line, "BASE:%ld", &delta_base) == 1 &&
+                     delta_base == base_time &&
+                     fgets(line, sizeof(line), f) && strncmp(line, "TIME:", 5) == 0 &&
+                     fgets(line, sizeof(line), f) && strncmp(line, "---", 3) == 0;
+        if (!valid) {
+            if (logging_enabled) printf("DEBUG: Delta snapshot %s does not belong to the current base\n", path);
+            fclose(f);
+            break;
+        }
+        
+        time_t now = time(NULL);
+        SnapshotRecord record = {0};
+        while (fgets(line, sizeof(line), f)) {
+            line[strcspn(line, "\n")] = 0;
+            applied += snapshot_record_line(&record, line, now);
+        }
+        applied += snapshot_record_commit(&record, now);
+        
+        delta_total_size += ftell(f);
+        delta_count = i;
+        fclose(f);
+    }
+    
+    if (logging_enabled && delta_count > 0) printf("DEBUG: Applied %d delta snapshots, %zu entries\n",
+                                                   delta_count, applied);
+    return applied;
+}
+
 bool storage_load_snapshot() {
     if (logging_enabled) printf("DEBUG: Loading snapshot\n");
     
@@ -360,7 +1404,8 @@ bool storage_load_snapshot() {
     // Başlık satırındaki yeni satır karakterini kaldır
     header[strcspn(header, "\n")] = 0;
     
-    if (strcmp(header, "AYTDB_SNAPSHOT_V1") != 0) {
+    bool compressed = strcmp(header, COMPRESSED_SNAPSHOT_HEADER) == 0;
+    if (!compressed && strcmp(header, SNAPSHOT_HEADER) != 0) {
         if (logging_enabled) printf("DEBUG: Invalid snapshot header: %s\n", header);
         fclose(f);
         return false;
@@ -419,112 +1464,106 @@ bool storage_load_snapshot() {
     // Girişleri oku
     time_t now = time(NULL);
     size_t entries_loaded = 0;
-    char line[MAX_LINE_SIZE];
-    char key[MAX_KEY_SIZE] = "";
-    char value[MAX_VALUE_SIZE] = "";
-    time_t ttl = 0;
-    bool has_key = false;
-    bool has_value = false;
-    bool has_ttl = false;
     
     if (logging_enabled) printf("DEBUG: Loading %zu entries from snapshot created at %s", 
                                entry_count, ctime(&snapshot_time));
     
-    // Satır satır dosyayı oku ve key-value çiftlerini işle
-    while (fgets(line, sizeof(line), f)) {
-        line[strcspn(line, "\n")] = 0; // Yeni satır karakterini kaldır
-        
-        if (strcmp(line, "---") == 0) {
-            // Bir kayıt bitti, tamamlanmışsa kaydet
-            if (has_key && has_value && has_ttl) {
-                // TTL'i kontrol et ve girişi ekle
-                if (ttl == 0 || now + ttl > now) { // overflow kontrolü
-                    if (logging_enabled && entries_loaded < 5) {
-                        printf("DEBUG: Loading key '%s' with value '%s' and TTL %ld\n", key, value, ttl);
-                    }
-                    kv_set_with_ttl(key, value, ttl);
-                    entries_loaded++;
-                } else if (logging_enabled && entries_loaded < 5) {
-                    printf("DEBUG: Skipping expired key '%s' with TTL %ld\n", key, ttl);
-                }
-            }
-            
-            // Yeni kayıt için bayrakları sıfırla
-            has_key = false;
-            has_value = false;
-            has_ttl = false;
-            continue;
-        }
-        
-        // Anahtar satırı
-        if (strncmp(line, "KEY:", 4) == 0) {
-            strncpy(key, line + 4, MAX_KEY_SIZE - 1);
-            key[MAX_KEY_SIZE - 1] = '\0';
-            has_key = true;
-            continue;
-        }
+    // Tablo yükleme sırasında tekrar tekrar büyümesin
+    reserve_table(entry_count);
+    
+    if (compressed) {
+        bool ok = false;
+        entries_loaded = load_compressed_snapshot_body(f, now, &ok);
+        if (!ok && logging_enabled) printf("DEBUG: Compressed snapshot is truncated or corrupted\n");
+    } else {
+        char line[MAX_LINE_SIZE];
+        SnapshotRecord record = {0};
         
-        // Değer satırı
-        if (strncmp(line, "VALUE:", 6) == 0) {
-            strncpy(value, line + 6, MAX_VALUE_SIZE - 1);
-            value[MAX_VALUE_SIZE - 1] = '\0';
-            has_value = true;
-            continue;
+        // Satır satır dosyayı oku ve key-value çiftlerini işle
+        while (fgets(line, sizeof(line), f)) {
+            line[strcspn(line, "\n")] = 0; // Yeni satır karakterini kaldır
+            entries_loaded += snapshot_record_line(&record, line, now);
         }
         
-        // TTL satırı
-        if (strncmp(line, "TTL:", 4) == 0) {
-            ttl = atol(line + 4);
-            has_ttl = true;
-            continue;
-        }
-    }
-    
-    // Son kayıt için kontrol
-    if (has_key && has_value && has_ttl) {
-        if (ttl == 0 || now + ttl > now) { // overflow kontrolü
-            if (logging_enabled && entries_loaded < 5) {
-                printf("DEBUG: Loading key '%s' with value '%s' and TTL %ld\n", key, value, ttl);
-            }
-            kv_set_with_ttl(key, value, ttl);
-            entries_loaded++;
-        }
+        // Son kayıt için kontrol
+        entries_loaded += snapshot_record_commit(&record, now);
     }
     
+    base_snapshot_size = ftell(f);
     fclose(f);
     
     if (logging_enabled) printf("DEBUG: Snapshot load completed, loaded %zu/%zu entries\n", 
                                entries_loaded, entry_count);
     
+    // Taban üzerine delta zincirini uygula
+    snapshot_base_time = snapshot_time;
+    entries_loaded += load_delta_snapshots(snapshot_time);
+    
     return entries_loaded > 0;
 }
 
-void storage_schedule_snapshot(int interval_seconds) {
+static void start_snapshot_thread() {
+    pthread_mutex_lock(&snapshot_thread_mutex);
     // Eğer zaten çalışan bir thread varsa, onu durdur
     if (snapshot_thread_running) {
-        shutdown_requested = true;
+        request_stop(&shutdown_requested);
         pthread_join(snapshot_thread, NULL);
         snapshot_thread_running = false;
-        shutdown_requested = false;
     }
-    
-    // Yeni aralık değerini ayarla
-    snapshot_interval = interval_seconds > 0 ? interval_seconds : SNAPSHOT_INTERVAL;
+    shutdown_requested = false;
     
     // Yeni snapshot thread'i başlat
     if (pthread_create(&snapshot_thread, NULL, snapshot_thread_func, NULL) == 0) {
         snapshot_thread_running = true;
-        if (logging_enabled) printf("DEBUG: Snapshot thread scheduled with interval %d seconds\n", snapshot_interval);
     } else {
         if (logging_enabled) printf("ERROR: Failed to create snapshot thread\n");
     }
+    pthread_mutex_unlock(&snapshot_thread_mutex);
+}
+
+// Eski davranış: verilen aralıkta en az bir değişiklik varsa snapshot al
+void storage_schedule_snapshot(int interval_seconds) {
+    SnapshotRule rule = { interval_seconds > 0 ? interval_seconds : SNAPSHOT_INTERVAL, 1 };
+    storage_set_snapshot_rules(&rule, 1);
+    if (logging_enabled) printf("DEBUG: Snapshot thread scheduled with interval %d seconds\n", rule.seconds);
+}
+
+bool storage_set_snapshot_rules(const SnapshotRule* rules, size_t count) {
+    if (count > SNAPSHOT_MAX_RULES) return false;
+    for (size_t i = 0; i < count; i++) {
+        if (rules[i].seconds <= 0) return false;
+    }
+    
+    // Thread kuralları her kontrolde snapshot_mutex altında okur; yeniden başlatılmaz.
+    // Kural yoksa otomatik snapshot kapalıdır; thread yine de uyumakta kalır
+    pthread_mutex_lock(&snapshot_mutex);
+    if (count > 0) memcpy(snapshot_rules, rules, count * sizeof(SnapshotRule));
+    snapshot_rule_count = count;
+    pthread_mutex_unlock(&snapshot_mutex);
+    return true;
+}
+
+size_t storage_get_snapshot_rules(SnapshotRule* rules, size_t max) {
+    pthread_mutex_lock(&snapshot_mutex);
+    size_t count = snapshot_rule_count < max ? snapshot_rule_count : max;
+    memcpy(rules, snapshot_rules, count * sizeof(SnapshotRule));
+    pthread_mutex_unlock(&snapshot_mutex);
+    return count;
 }
 
 void storage_compact() {
-    // Artık compact yapmak yerine snapshot alıyoruz
-    if (logging_enabled) printf("DEBUG: Compaction requested, taking snapshot instead\n");
-    storage_save_snapshot();
+    // Süresi dolmuş kayıtları temizle, snapshot al ve log rewrite'ını arka plana bırak
+    if (logging_enabled) printf("DEBUG: Compaction requested\n");
+    kv_purge_expired();
+    storage_save_snapshot_ex(snapshot_compression); // Tam snapshot delta zincirini birleştirir
     printf("Snapshot saved successfully.\n");
+    
+    if (log_enabled && log_thread_running) {
+        pthread_mutex_lock(&buffer_mutex);
+        rewrite_requested = true;
+        pthread_mutex_unlock(&buffer_mutex);
+        if (logging_enabled) printf("DEBUG: Background log rewrite scheduled\n");
+    }
 }
 
 long storage_file_size() {
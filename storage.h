@@ -6,6 +6,7 @@
 #define STORAGE_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
 #include <stdio.h>
 
@@ -13,10 +14,22 @@
 #define MAX_VALUE_SIZE 1024
 #define MAX_LINE_SIZE (4 + MAX_KEY_SIZE + MAX_VALUE_SIZE + 4)
 #define MAX_STORAGE_SIZE 1024 * 1024 // 1 MB
+#define SNAPSHOT_MAX_RULES 8
+
+// Otomatik snapshot kuralı: son snapshot'tan en az `seconds` saniye geçtiyse ve
+// en az `changes` yazma olduysa snapshot alınır
+typedef struct {
+    int seconds;
+    unsigned long changes;
+} SnapshotRule;
+
+struct FileWriter;
+struct KvBatchOp;
+struct KvWatch;
 
 typedef struct {
     char* file_path;
-    FILE* file;
+    struct FileWriter* file; // Append-only log yazıcısı
 } Storage;
 
 // Storage yönetimi
@@ -28,6 +41,20 @@ bool storage_set(Storage* storage, const char* key, const char* value);
 bool storage_set_with_ttl(Storage* storage, const char* key, const char* value, int ttl);
 char* storage_get(Storage* storage, const char* key);
 bool storage_delete(Storage* storage, const char* key);
+// Koşullu yazmalar (bkz. kv_cas, kv_getset); yalnızca yazma yapıldıysa log'a eklenir
+bool storage_cas(Storage* storage, const char* key, uint64_t expected_version, const char* value, uint64_t* version);
+bool storage_getset(Storage* storage, const char* key, const char* value, const char** old_value);
+// Yazma/silme dizisini kv_apply_batch ile tek kilitte uygular ve log'a sırayla ekler.
+// watches'taki anahtarlardan biri değiştiyse hiçbir şey uygulanmaz ve false döner.
+// changed zorunludur; yalnızca uygulanan (changed[i] true) işlemler log'a ve kancaya verilir
+bool storage_apply_batch(Storage* storage, const struct KvWatch* watches, size_t watch_count,
+                         const struct KvBatchOp* ops, size_t count, bool* changed);
+// Diğer thread'lerin yazmalarını storage_unlock_writes'a kadar bekletir. Kilidi tutan thread
+// storage yazma fonksiyonlarını çağırabilir; snapshot/log rewrite gibi uzun işler çağrılmamalı
+void storage_lock_writes();
+void storage_unlock_writes();
+// Yazmalar log sırasıyla bu kancaya da verilir (value NULL: silme); kanca storage'ı çağırmamalı
+void storage_set_write_hook(void (*hook)(const char* key, const char* value, int ttl));
 
 // Dosya işlemleri
 void storage_append_set(const char* key, const char* value, const int ttl);
@@ -36,9 +63,21 @@ void storage_load();
 void storage_compact();
 long storage_file_size();
 
+// Append-only log işlemleri
+void storage_configure_io(bool use_uring, bool direct_io);
+void storage_set_log_enabled(bool enabled);
+long storage_log_size();
+bool storage_rewrite_log();
+
 // Snapshot işlemleri
 bool storage_save_snapshot();
+bool storage_save_snapshot_ex(bool compress);
+void storage_set_snapshot_compression(bool enabled);
+void storage_set_delta_snapshots(bool enabled);
+void storage_set_mapped_table(bool enabled);
 bool storage_load_snapshot();
 void storage_schedule_snapshot(int interval_seconds);
+bool storage_set_snapshot_rules(const SnapshotRule* rules, size_t count);
+size_t storage_get_snapshot_rules(SnapshotRule* rules, size_t max);
 
 #endif //STORAGE_H
@@ -1,9 +1,25 @@
 #include "test_runner.h"
 #include "storage.h"
 #include "kv_store.h"
+#include "resp.h"
+#include "command.h"
+#include "shm_ring.h"
+#include "tracking.h"
+#include "replication.h"
+#include "cluster.h"
+#include "hash_util.h"
+#include "aytdb_client.h"
 #include <stdio.h>
+#include <stdarg.h>
+#include <signal.h>
+#include <pthread.h>
 #include <time.h>
 #include <sys/time.h>
+#include <sys/wait.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
 
 // Performans metrikleri için yapı
 typedef struct {
@@ -41,6 +57,23 @@ double percentile(double* array, int size, double p) {
     return array[idx];
 }
 
+// Önceki testlerden kalan snapshot ve log dosyalarını sil
+static void remove_storage_files() {
+    char path[64];
+    remove("snapshot.db");
+    remove("storage.db");
+    for (int i = 1; i <= 8; i++) {
+        snprintf(path, sizeof(path), "snapshot.db.delta.%d", i);
+        remove(path);
+    }
+}
+
+static bool file_exists(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (f) fclose(f);
+    return f != NULL;
+}
+
 // Test fonksiyonları
 void test_storage_init(TestResults* results) {
     printf("DEBUG: Starting storage_init test\n");
@@ -111,6 +144,37 @@ void test_storage_delete(TestResults* results) {
         assert_true(results, true, "Deleted key should return NULL");
     }
     
+    // Silinen anahtar, aynı probe zincirinde kendisinden sonra yerleşmiş anahtarları gizlememeli
+    char chain_key[32];
+    for (int i = 0; i < 5000; i++) {
+        snprintf(chain_key, sizeof(chain_key), "chain_%d", i);
+        kv_set(chain_key, "v");
+    }
+    for (int i = 0; i < 5000; i += 2) {
+        snprintf(chain_key, sizeof(chain_key), "chain_%d", i);
+        kv_del(chain_key);
+    }
+    int missing = 0;
+    for (int i = 1; i < 5000; i += 2) {
+        snprintf(chain_key, sizeof(chain_key), "chain_%d", i);
+        if (!kv_get(chain_key)) missing++;
+    }
+    assert_true(results, missing == 0, "Deleting keys should not hide other keys in their probe chains");
+    
+    // Sürekli ekle/sil yükünde silinen yuvalar temizlenir, kalan anahtarlar kaybolmaz
+    size_t count_before = kv_get_count();
+    for (int i = 0; i < 100000; i++) {
+        snprintf(chain_key, sizeof(chain_key), "churn_%d", i);
+        kv_set(chain_key, "v");
+        kv_del(chain_key);
+    }
+    missing = 0;
+    for (int i = 1; i < 5000; i += 2) {
+        snprintf(chain_key, sizeof(chain_key), "chain_%d", i);
+        if (!kv_get(chain_key)) missing++;
+    }
+    assert_true(results, missing == 0 && kv_get_count() == count_before, "Churn should keep the remaining keys reachable");
+    
     storage_free(storage);
     printf("DEBUG: Completed storage_delete test\n");
     kv_cleanup();
@@ -119,6 +183,7 @@ void test_storage_delete(TestResults* results) {
 // Tablo genişleme testi
 void test_table_resize(TestResults* results) {
     printf("DEBUG: Starting table_resize test\n");
+    remove_storage_files();
     Storage* storage = storage_init();
     printf("DEBUG: storage_init returned: %p\n", (void*)storage);
     assert_not_null(results, storage, "Storage initialization should succeed");
@@ -185,6 +250,7 @@ void test_table_resize(TestResults* results) {
 // Yük faktörü testi
 void test_load_factor(TestResults* results) {
     printf("DEBUG: Starting load_factor test\n");
+    remove_storage_files();
     Storage* storage = storage_init();
     printf("DEBUG: storage_init returned: %p\n", (void*)storage);
     assert_not_null(results, storage, "Storage initialization should succeed");
@@ -215,6 +281,93 @@ void test_load_factor(TestResults* results) {
 }
 
 // Eşzamanlı erişim testi
+// Resize sürerken okuyan ve aynı anahtarları yazan thread'ler
+enum { RESIZE_BASE_KEYS = 2000, RESIZE_NEW_KEYS = 40000 };
+static volatile bool resize_writers_done = false;
+
+static void* resize_reader(void* arg) {
+    size_t* misses = arg;
+    char key[32];
+    while (!resize_writers_done) {
+        for (int i = 0; i < RESIZE_BASE_KEYS; i++) {
+            snprintf(key, sizeof(key), "rz_base_%d", i);
+            if (!kv_get(key)) (*misses)++;
+        }
+    }
+    return NULL;
+}
+
+static void* resize_writer(void* arg) {
+    (void)arg;
+    char key[32];
+    for (int i = 0; i < RESIZE_NEW_KEYS; i++) {
+        snprintf(key, sizeof(key), "rz_new_%d", i);
+        kv_set(key, "v");
+    }
+    return NULL;
+}
+
+static void* resize_getset_writer(void* arg) {
+    (void)arg;
+    char key[32];
+    const char* old_value;
+    for (int i = 0; i < RESIZE_NEW_KEYS; i++) {
+        snprintf(key, sizeof(key), "rz_new_%d", i);
+        kv_getset(key, "v", &old_value);
+    }
+    return NULL;
+}
+
+// Var olan anahtarlara SETNX (sürüm 0 ile CAS); hiçbiri yazılmamalı
+static void* resize_setnx(void* arg) {
+    size_t* stored = arg;
+    char key[32];
+    uint64_t version;
+    while (!resize_writers_done) {
+        for (int i = 0; i < RESIZE_BASE_KEYS; i++) {
+            snprintf(key, sizeof(key), "rz_base_%d", i);
+            if (kv_cas(key, 0, "nx", &version)) (*stored)++;
+        }
+    }
+    return NULL;
+}
+
+void test_concurrent_resize(TestResults* results) {
+    printf("DEBUG: Starting concurrent_resize test\n");
+    remove_storage_files();
+    kv_init();
+    
+    char key[32];
+    for (int i = 0; i < RESIZE_BASE_KEYS; i++) {
+        snprintf(key, sizeof(key), "rz_base_%d", i);
+        kv_set(key, "base");
+    }
+    size_t initial_size = kv_get_size();
+    
+    // Üç yazıcı (biri GETSET ile) aynı yeni anahtarları ekler ve tablo birkaç kez büyür
+    pthread_t readers[2], writers[3], setnx;
+    size_t misses[2] = {0, 0};
+    size_t setnx_stored = 0;
+    resize_writers_done = false;
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, resize_reader, &misses[i]);
+    pthread_create(&setnx, NULL, resize_setnx, &setnx_stored);
+    for (int i = 0; i < 3; i++) pthread_create(&writers[i], NULL, i < 2 ? resize_writer : resize_getset_writer, NULL);
+    for (int i = 0; i < 3; i++) pthread_join(writers[i], NULL);
+    resize_writers_done = true;
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+    pthread_join(setnx, NULL);
+    
+    printf("DEBUG: Table grew from %zu to %zu slots, reader misses: %zu\n", initial_size, kv_get_size(), misses[0] + misses[1]);
+    assert_true(results, kv_get_size() > initial_size, "Writers should trigger resizes");
+    assert_true(results, misses[0] + misses[1] == 0, "Readers should never miss existing keys during a resize");
+    assert_true(results, setnx_stored == 0, "SETNX should never overwrite an existing key during a resize");
+    assert_true(results, kv_get_count() == RESIZE_BASE_KEYS + RESIZE_NEW_KEYS,
+                "Concurrent writers of the same keys should not create duplicates");
+    
+    printf("DEBUG: Completed concurrent_resize test\n");
+    kv_cleanup();
+}
+
 void test_concurrent_access(TestResults* results) {
     printf("DEBUG: Starting concurrent_access test\n");
     Storage* storage = storage_init();
@@ -263,6 +416,1544 @@ void test_concurrent_access(TestResults* results) {
     kv_cleanup();
 }
 
+// Log rewrite testi
+void test_log_rewrite(TestResults* results) {
+    printf("DEBUG: Starting log_rewrite test\n");
+    remove_storage_files();
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    
+    // Aynı anahtarları defalarca yazarak log'u şişir
+    char key[32];
+    char value[32];
+    for (int round = 0; round < 10; round++) {
+        for (int i = 0; i < 1000; i++) {
+            snprintf(key, sizeof(key), "log_key_%d", i);
+            snprintf(value, sizeof(value), "log_value_%d_%d", i, round);
+            storage_set(storage, key, value);
+        }
+    }
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "log_key_%d", i);
+        storage_delete(storage, key);
+    }
+    
+    long size_before = storage_log_size();
+    assert_true(results, storage_rewrite_log(), "Log rewrite should succeed");
+    long size_after = storage_log_size();
+    printf("DEBUG: Log size before rewrite: %ld, after: %ld\n", size_before, size_after);
+    assert_true(results, size_after < size_before / 5, "Rewritten log should be much smaller");
+    
+    // Entry'ye sığmayan değer kesilmiş haliyle loglanır; sonraki kayıtlar yine okunur
+    char long_value[MAX_VALUE_SIZE + 16];
+    memset(long_value, 'x', sizeof(long_value) - 1);
+    long_value[sizeof(long_value) - 1] = '\0';
+    storage_set(storage, "log_key_long", long_value);
+    
+    // Rewrite sonrası yazılanlar da log'a eklenmeli
+    storage_set(storage, "log_key_after", "after_rewrite");
+    storage_free(storage);
+    kv_cleanup();
+    
+    // Snapshot olmadan sadece log'dan yükle
+    remove("snapshot.db");
+    storage = storage_init();
+    assert_not_null(results, storage, "Storage re-initialization should succeed");
+    
+    char* retrieved = storage_get(storage, "log_key_500");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "log_value_500_9") == 0,
+                "Value should be restored from rewritten log");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "log_key_50");
+    assert_null(results, retrieved, "Deleted key should stay deleted after log replay");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "log_key_after");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "after_rewrite") == 0,
+                "Writes after rewrite should be restored from log tail");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "log_key_long");
+    assert_true(results, retrieved != NULL && strlen(retrieved) == MAX_VALUE_SIZE - 1,
+                "Oversize value should be restored truncated without breaking the log");
+    free(retrieved);
+    
+    storage_free(storage);
+    printf("DEBUG: Completed log_rewrite test\n");
+    kv_cleanup();
+}
+
+// io_uring (O_DIRECT) yazıcı testi - io_uring yoksa stdio'ya düşer
+void test_uring_persistence(TestResults* results) {
+    printf("DEBUG: Starting uring_persistence test\n");
+    remove_storage_files();
+    storage_configure_io(true, true);
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization with io_uring should succeed");
+    
+    char key[32];
+    char value[32];
+    for (int i = 0; i < 2000; i++) {
+        snprintf(key, sizeof(key), "uring_key_%d", i);
+        snprintf(value, sizeof(value), "uring_value_%d", i);
+        storage_set(storage, key, value);
+    }
+    assert_true(results, storage_save_snapshot(), "Snapshot through io_uring writer should succeed");
+    storage_free(storage);
+    kv_cleanup();
+    
+    // Hizasız log sonuna ekleme yapılabilmeli
+    remove("snapshot.db");
+    storage = storage_init();
+    assert_not_null(results, storage, "Storage re-initialization with io_uring should succeed");
+    storage_set(storage, "uring_key_tail", "tail_value");
+    storage_free(storage);
+    kv_cleanup();
+    
+    // Klasik yol ile geri oku
+    storage_configure_io(false, false);
+    remove("snapshot.db");
+    storage = storage_init();
+    
+    char* retrieved = storage_get(storage, "uring_key_1999");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "uring_value_1999") == 0,
+                "Value written through io_uring log should be readable");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "uring_key_tail");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "tail_value") == 0,
+                "Value appended to an unaligned io_uring log should be readable");
+    free(retrieved);
+    
+    storage_free(storage);
+    printf("DEBUG: Completed uring_persistence test\n");
+    kv_cleanup();
+}
+
+// Sıkıştırılmış snapshot testi - bloklar paralel açılarak yüklenir
+void test_compressed_snapshot(TestResults* results) {
+    printf("DEBUG: Starting compressed_snapshot test\n");
+    remove_storage_files();
+    storage_set_log_enabled(false);
+    storage_set_snapshot_compression(true);
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    
+    // Birden fazla blok oluşacak kadar veri yaz
+    char key[32];
+    char value[64];
+    for (int i = 0; i < 20000; i++) {
+        snprintf(key, sizeof(key), "zkey_%d", i);
+        snprintf(value, sizeof(value), "compressed_value_%d_%d", i, i % 7);
+        storage_set(storage, key, value);
+    }
+    storage_set_with_ttl(storage, "zkey_ttl", "ttl_value", 3600);
+    storage_free(storage);
+    kv_cleanup();
+    
+    // Dosya sıkıştırılmış başlıkla yazılmış olmalı
+    char header[32] = {0};
+    FILE* f = fopen("snapshot.db", "r");
+    assert_not_null(results, f, "Snapshot file should exist");
+    if (f) {
+        if (!fgets(header, sizeof(header), f)) header[0] = '\0';
+        fclose(f);
+    }
+    assert_true(results, strncmp(header, "AYTDB_SNAPSHOT_Z1", 17) == 0,
+                "Snapshot should use the compressed format");
+    
+    storage_set_snapshot_compression(false);
+    storage = storage_init();
+    
+    bool all_found = true;
+    for (int i = 0; i < 20000; i += 97) {
+        snprintf(key, sizeof(key), "zkey_%d", i);
+        snprintf(value, sizeof(value), "compressed_value_%d_%d", i, i % 7);
+        char* retrieved = storage_get(storage, key);
+        if (!retrieved || strcmp(retrieved, value) != 0) all_found = false;
+        free(retrieved);
+    }
+    assert_true(results, all_found, "Values should survive a compressed snapshot");
+    assert_true(results, kv_get_count() == 20001, "All entries should be loaded from compressed blocks");
+    
+    char* retrieved = storage_get(storage, "zkey_ttl");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "ttl_value") == 0,
+                "TTL entry should survive a compressed snapshot");
+    free(retrieved);
+    
+    // Sıkıştırılmamış snapshot geri okunabilir kalmalı
+    assert_true(results, storage_save_snapshot_ex(false), "Plain snapshot should still be writable");
+    
+    storage_free(storage);
+    storage_set_log_enabled(true);
+    printf("DEBUG: Completed compressed_snapshot test\n");
+    kv_cleanup();
+}
+
+// Delta snapshot testi - taban + delta zinciri geri yüklenmeli
+void test_delta_snapshot(TestResults* results) {
+    printf("DEBUG: Starting delta_snapshot test\n");
+    remove_storage_files();
+    storage_set_log_enabled(false);
+    storage_set_delta_snapshots(true);
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    
+    char key[32];
+    char value[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "dkey_%d", i);
+        snprintf(value, sizeof(value), "dvalue_%d", i);
+        storage_set(storage, key, value);
+    }
+    assert_true(results, storage_save_snapshot(), "First snapshot should be saved");
+    assert_true(results, !file_exists("snapshot.db.delta.1"), "First snapshot should be a full snapshot");
+    
+    // Sadece değişenler deltaya yazılmalı
+    storage_set(storage, "dkey_5", "changed");
+    storage_delete(storage, "dkey_7");
+    storage_set(storage, "dkey_new", "new_value");
+    assert_true(results, storage_save_snapshot(), "Delta snapshot should be saved");
+    assert_true(results, file_exists("snapshot.db.delta.1"), "Delta file should be created");
+    
+    // Silinip yeniden eklenen anahtar ve silinen yeni anahtar
+    storage_set(storage, "dkey_7", "restored");
+    storage_delete(storage, "dkey_new");
+    // Deltaya yazılmadan önce süresi dolan anahtar tabandaki değeriyle geri gelmemeli
+    storage_set_with_ttl(storage, "dkey_9", "short_lived", 1);
+    sleep(2);
+    assert_true(results, storage_save_snapshot(), "Second delta snapshot should be saved");
+    assert_true(results, file_exists("snapshot.db.delta.2"), "Second delta file should be created");
+    
+    storage_free(storage);
+    kv_cleanup();
+    
+    storage = storage_init();
+    char* retrieved = storage_get(storage, "dkey_5");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "changed") == 0,
+                "Changed value should be restored from delta");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "dkey_7");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "restored") == 0,
+                "Deleted and re-added key should be restored from delta chain");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "dkey_new");
+    assert_true(results, retrieved == NULL, "Key deleted in a later delta should stay deleted");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "dkey_9");
+    assert_true(results, retrieved == NULL, "Key that expired before the delta should stay deleted");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "dkey_999");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "dvalue_999") == 0,
+                "Unchanged value should be restored from base snapshot");
+    free(retrieved);
+    assert_true(results, kv_get_count() == 999, "Entry count should match after base + deltas");
+    
+    // Compaction zinciri tam snapshot'ta birleştirir
+    storage_compact();
+    assert_true(results, !file_exists("snapshot.db.delta.1"), "Compaction should consolidate deltas");
+    
+    storage_free(storage);
+    storage_set_delta_snapshots(false);
+    storage_set_log_enabled(true);
+    printf("DEBUG: Completed delta_snapshot test\n");
+    kv_cleanup();
+}
+
+// Map edilmiş tablo testi - düzgün kapanış sonrası tablo dosyadan geri gelmeli
+void test_mapped_table(TestResults* results) {
+    printf("DEBUG: Starting mapped_table test\n");
+    remove_storage_files();
+    remove("table.db");
+    storage_set_mapped_table(true);
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization with mapped table should succeed");
+    assert_true(results, kv_is_mapped(), "Table should be mapped from file");
+    
+    char key[32];
+    char value[32];
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "mkey_%d", i);
+        snprintf(value, sizeof(value), "mvalue_%d", i);
+        storage_set(storage, key, value);
+    }
+    storage_set_with_ttl(storage, "mkey_ttl", "ttl_value", 3600);
+    storage_delete(storage, "mkey_3");
+    storage_free(storage);
+    kv_cleanup();
+    
+    // Snapshot ve log olmadan da tablo dosyadan gelmeli
+    remove("snapshot.db");
+    remove("storage.db");
+    storage = storage_init();
+    assert_true(results, kv_get_count() == 1000, "Mapped table should restore all entries");
+    
+    char* retrieved = storage_get(storage, "mkey_999");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "mvalue_999") == 0,
+                "Value should be restored from mapped table");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "mkey_3");
+    assert_true(results, retrieved == NULL, "Deleted key should stay deleted in mapped table");
+    free(retrieved);
+    
+    retrieved = storage_get(storage, "mkey_ttl");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "ttl_value") == 0,
+                "TTL entry should be restored from mapped table");
+    free(retrieved);
+    
+    // Geri yüklenen tablo üzerinde yazmaya devam edilebilmeli
+    storage_set(storage, "mkey_after_restart", "after");
+    uint64_t version = kv_get_version("mkey_after_restart");
+    storage_free(storage);
+    kv_cleanup();
+    
+    storage = storage_init();
+    retrieved = storage_get(storage, "mkey_after_restart");
+    assert_true(results, retrieved != NULL && strcmp(retrieved, "after") == 0,
+                "Writes after restore should survive the next restart");
+    free(retrieved);
+    assert_true(results, kv_get_version("mkey_after_restart") == version,
+                "Restored entries should keep their versions");
+    storage_set(storage, "mkey_after_restart", "again");
+    assert_true(results, kv_get_version("mkey_after_restart") > version,
+                "Versions should continue from the stored high-water mark after restart");
+    storage_free(storage);
+    kv_cleanup();
+    
+    storage_set_mapped_table(false);
+    remove("table.db");
+    printf("DEBUG: Completed mapped_table test\n");
+}
+
+// Değişiklik sayısına bağlı snapshot zamanlayıcısı testi
+void test_snapshot_rules(TestResults* results) {
+    printf("DEBUG: Starting snapshot_rules test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    
+    unsigned long long writes = kv_write_count();
+    storage_set(storage, "rule_key_0", "value");
+    storage_delete(storage, "rule_key_0");
+    assert_true(results, kv_write_count() == writes + 2, "kv_set and kv_del should bump the write counter");
+    
+    SnapshotRule rule = { 1, 5 };
+    assert_true(results, storage_set_snapshot_rules(&rule, 1), "Snapshot rule should be accepted");
+    
+    // Eşik altında kalan değişiklikler snapshot tetiklememeli
+    sleep(2);
+    assert_true(results, !file_exists("snapshot.db"), "Snapshot should not be taken below the change threshold");
+    
+    char key[32];
+    for (int i = 0; i < 5; i++) {
+        snprintf(key, sizeof(key), "rule_key_%d", i);
+        storage_set(storage, key, "value");
+    }
+    sleep(3);
+    assert_true(results, file_exists("snapshot.db"), "Snapshot should be taken once a rule matches");
+    
+    // Değişiklik olmadan yeni snapshot alınmamalı
+    remove("snapshot.db");
+    sleep(2);
+    assert_true(results, !file_exists("snapshot.db"), "Idle storage should not write snapshots");
+    
+    SnapshotRule invalid = { 0, 1 };
+    assert_true(results, !storage_set_snapshot_rules(&invalid, 1), "Rule with zero seconds should be rejected");
+    
+    storage_schedule_snapshot(300);
+    storage_free(storage);
+    printf("DEBUG: Completed snapshot_rules test\n");
+    kv_cleanup();
+}
+
+void test_resp_parser(TestResults* results) {
+    printf("DEBUG: Starting resp_parser test\n");
+    RespParser parser;
+    resp_parser_reset(&parser);
+    
+    // Komut parça parça gelir, ayrıştırma kaldığı yerden devam eder
+    char buf[128];
+    const char* command = "*3\r\n$3\r\nSET\r\n$3\r\nkey\r\n$5\r\nvalue\r\n*1\r\n$4\r\nPING\r\n";
+    size_t total = strlen(command);
+    memcpy(buf, command, total);
+    
+    RespStatus status = RESP_INCOMPLETE;
+    size_t fed;
+    for (fed = 1; fed <= total && status == RESP_INCOMPLETE; fed++) {
+        status = resp_parse(&parser, buf, fed);
+    }
+    assert_true(results, status == RESP_OK, "Fragmented command should parse once complete");
+    assert_true(results, parser.pos == fed - 1 && parser.pos == 33, "Parser should stop at the end of the first command");
+    assert_true(results, parser.argc == 3, "SET command should have three arguments");
+    assert_true(results, strcmp(buf + parser.arg_offset[1], "key") == 0, "Arguments should point into the buffer");
+    assert_true(results, strcmp(buf + parser.arg_offset[2], "value") == 0 && parser.arg_len[2] == 5,
+                "Arguments should be null-terminated in place");
+    
+    // Aynı buffer'daki ikinci (pipeline) komut
+    size_t next = parser.pos;
+    resp_parser_reset(&parser);
+    status = resp_parse(&parser, buf + next, total - next);
+    assert_true(results, status == RESP_OK && parser.argc == 1, "Pipelined command should parse");
+    assert_true(results, strcmp(buf + next + parser.arg_offset[0], "PING") == 0, "Pipelined argument should match");
+    assert_true(results, !parser.has_nul, "Plain arguments should not be flagged");
+    
+    // C string olarak kesilecek argüman işaretlenir
+    static const char nul_command[] = "*2\r\n$3\r\nGET\r\n$3\r\na\0b\r\n";
+    memcpy(buf, nul_command, sizeof(nul_command) - 1);
+    resp_parser_reset(&parser);
+    status = resp_parse(&parser, buf, sizeof(nul_command) - 1);
+    assert_true(results, status == RESP_OK && parser.has_nul, "An argument with a NUL byte should be flagged");
+    
+    const char* invalid[] = { "*1\r\n$x\r\n", "*1\r\n+PING\r\n", "*1\r\n$4\r\nPINGxx", "*99999999999\r\n" };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        resp_parser_reset(&parser);
+        strcpy(buf, invalid[i]);
+        status = resp_parse(&parser, buf, strlen(buf));
+        assert_true(results, status == RESP_ERROR, "Malformed command should be rejected");
+    }
+    printf("DEBUG: Completed resp_parser test\n");
+}
+
+// Komut yanıtlarını test buffer'ında toplar
+static char captured_reply[4096];
+static size_t captured_len = 0;
+
+static bool capture_write(CommandClient* client, const char* data, size_t len) {
+    (void)client;
+    if (captured_len + len >= sizeof(captured_reply)) return false;
+    memcpy(captured_reply + captured_len, data, len);
+    captured_len += len;
+    captured_reply[captured_len] = '\0';
+    return true;
+}
+
+static const char* run_command(CommandClient* client, const char* line) {
+    static char copy[8192];
+    strcpy(copy, line);
+    captured_len = 0;
+    captured_reply[0] = '\0';
+    command_execute_line(client, copy);
+    return captured_reply;
+}
+
+void test_command_registry(TestResults* results) {
+    printf("DEBUG: Starting command_registry test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    
+    const Command* set = command_lookup("SET");
+    assert_true(results, set && strcmp(set->name, "set") == 0, "Lookup should be case-insensitive");
+    assert_true(results, set && (set->flags & CMD_WRITE), "set should be flagged as a write command");
+    assert_true(results, command_lookup("get") && (command_lookup("get")->flags & CMD_READONLY), "get should be read-only");
+    assert_null(results, (void*)command_lookup("nosuchcommand"), "Unknown command should not be found");
+    assert_null(results, (void*)command_lookup("averyveryverylongcommandname"), "Overlong names should not be found");
+    
+    CommandClient client = { .protocol = PROTOCOL_TELNET, .write = capture_write };
+    assert_true(results, strstr(run_command(&client, "get key"), "Authentication required") != NULL,
+                "Data commands should require authentication");
+    assert_true(results, strcmp(run_command(&client, "ping"), "PONG\r\n") == 0, "ping should not require authentication");
+    
+    client.authenticated = true;
+    assert_true(results, strcmp(run_command(&client, "set cmd_key \"two words\""), "OK\r\n") == 0, "set should reply OK");
+    assert_true(results, strcmp(run_command(&client, "GET cmd_key"), "two words\r\n") == 0, "get should return the quoted value");
+    assert_true(results, strstr(run_command(&client, "set only_key"), "wrong number of arguments") != NULL,
+                "Arity should be checked before the handler runs");
+    
+    client.protocol = PROTOCOL_RESP;
+    assert_true(results, strcmp(run_command(&client, "get cmd_key"), "$9\r\ntwo words\r\n") == 0, "RESP get should reply a bulk string");
+    assert_true(results, strcmp(run_command(&client, "del cmd_key"), ":1\r\n") == 0, "RESP del should reply the removed count");
+    assert_true(results, strcmp(run_command(&client, "get cmd_key"), "$-1\r\n") == 0, "RESP get of a missing key should reply null");
+    
+    // RESP bulk string'leri entry sınırlarını aşabilir; kesilip yazılmak yerine reddedilir
+    static char long_arg[MAX_VALUE_SIZE + 1];
+    memset(long_arg, 'x', MAX_VALUE_SIZE);
+    char* long_value[] = { "set", "long_value_key", long_arg };
+    captured_len = 0;
+    command_execute(&client, 3, long_value);
+    assert_true(results, strstr(captured_reply, "value too long") != NULL && !kv_get("long_value_key"),
+                "Oversize values should be rejected");
+    long_arg[MAX_KEY_SIZE] = '\0';
+    char* long_key[] = { "mset", "short_key", "v", long_arg, "v" };
+    captured_len = 0;
+    command_execute(&client, 5, long_key);
+    assert_true(results, strstr(captured_reply, "key too long") != NULL && !kv_get("short_key"),
+                "Oversize keys should be rejected before any of them is written");
+    
+    // Snapshot kayıtları satır tabanlıdır; satır sonu içeren anahtar/değer kayıt ekleyemez
+    char* injected_value[] = { "set", "inject_key", "v\n---\nKEY:injected" };
+    captured_len = 0;
+    command_execute(&client, 3, injected_value);
+    assert_true(results, strstr(captured_reply, "cannot contain CR or LF") != NULL && !kv_get("inject_key"),
+                "Values with line breaks should be rejected");
+    char* injected_key[] = { "mset", "inject_key", "v", "bad\rkey", "v" };
+    captured_len = 0;
+    command_execute(&client, 5, injected_key);
+    assert_true(results, strstr(captured_reply, "cannot contain CR or LF") != NULL && !kv_get("inject_key"),
+                "Keys with line breaks should be rejected");
+    
+    storage_free(storage);
+    printf("DEBUG: Completed command_registry test\n");
+    kv_cleanup();
+}
+
+void test_shm_ring(TestResults* results) {
+    printf("DEBUG: Starting shm_ring test\n");
+    ShmRing* ring = calloc(1, sizeof(ShmRing));
+    
+    // Halka dolana kadar yaz, sonra sırayla oku; indeksler birkaç tur döner
+    bool ordered = true;
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < SHM_RING_SLOTS; i++) {
+            ShmSlot* slot = shm_ring_reserve(ring);
+            if (!slot) {
+                ordered = false;
+                break;
+            }
+            int len = snprintf(slot->data, SHM_MAX_MESSAGE, "msg-%d-%d", round, i);
+            shm_ring_publish(ring, slot, (uint32_t)len);
+        }
+        assert_true(results, shm_ring_reserve(ring) == NULL, "Full ring should refuse new messages");
+        
+        for (int i = 0; i < SHM_RING_SLOTS; i++) {
+            char expected[32];
+            snprintf(expected, sizeof(expected), "msg-%d-%d", round, i);
+            ShmSlot* slot = shm_ring_peek(ring);
+            if (!slot || slot->len != strlen(expected) || memcmp(slot->data, expected, slot->len) != 0) ordered = false;
+            shm_ring_release(ring);
+        }
+    }
+    assert_true(results, ordered, "Messages should arrive in order across wrap-around");
+    assert_true(results, shm_ring_peek(ring) == NULL, "Drained ring should be empty");
+    
+    // Boş halkada bekleme zaman aşımıyla döner, yayınlanmış mesaj hemen görülür
+    assert_true(results, shm_ring_wait(ring, 10, 5) == NULL, "Wait on empty ring should time out");
+    ShmSlot* slot = shm_ring_reserve(ring);
+    shm_ring_publish(ring, slot, 0);
+    assert_true(results, shm_ring_wait(ring, 0, 5) == slot, "Wait should return the published message");
+    assert_true(results, ring->waiting == 0, "Consumer should clear the waiting flag");
+    
+    free(ring);
+    printf("DEBUG: Completed shm_ring test\n");
+}
+
+// Tracking bildirimlerini hemen capture buffer'ına yazar (testte tek thread var)
+static int notified_count = 0;
+
+static void capture_notify(CommandClient* client, const char* key) {
+    notified_count++;
+    tracking_write_invalidation(client, key);
+}
+
+void test_client_tracking(TestResults* results) {
+    printf("DEBUG: Starting client_tracking test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    
+    CommandClient reader = { .protocol = PROTOCOL_TELNET, .id = 1, .authenticated = true,
+                             .write = capture_write, .notify = capture_notify };
+    CommandClient writer = { .protocol = PROTOCOL_TELNET, .id = 2, .authenticated = true, .write = capture_write };
+    assert_true(results, strstr(run_command(&writer, "client tracking on"), "not supported") != NULL,
+                "Tracking should need a frontend that can deliver pushes");
+    assert_true(results, strcmp(run_command(&reader, "client tracking on"), "OK: Tracking enabled\r\n") == 0,
+                "Tracking should be enabled");
+    
+    // Okunan anahtar değişince bir kez bildirilir, yeniden okunana kadar tekrar bildirilmez
+    run_command(&writer, "set tracked_key v1");
+    assert_true(results, notified_count == 0, "Unread keys should not be invalidated");
+    run_command(&reader, "get tracked_key");
+    run_command(&reader, "get missing_key");
+    assert_true(results, strcmp(run_command(&writer, "set tracked_key v2"), "INVALIDATE tracked_key\r\nOK\r\n") == 0,
+                "Writing a read key should push an invalidation");
+    run_command(&writer, "set tracked_key v3");
+    assert_true(results, notified_count == 1, "A key should be invalidated once until read again");
+    run_command(&writer, "set missing_key v1");
+    assert_true(results, notified_count == 2, "Reading a missing key should track it too");
+    run_command(&reader, "get tracked_key");
+    run_command(&writer, "del tracked_key");
+    assert_true(results, notified_count == 3, "Delete should invalidate");
+    
+    // Süresi dolan anahtar da bildirilir
+    storage_set_with_ttl(storage, "ttl_key", "v", 1);
+    run_command(&reader, "get ttl_key");
+    sleep(2);
+    kv_purge_expired();
+    assert_true(results, notified_count == 4, "Expiry should invalidate");
+    
+    // Tablo dolunca istemci broadcast moduna geçer ve hiçbir değişiklik kaçmaz
+    tracking_set_max_keys(2);
+    run_command(&reader, "get full_a");
+    run_command(&reader, "get full_b");
+    run_command(&reader, "get full_c");
+    assert_true(results, tracking_key_count() <= 2, "Tracking table should stay within its limit");
+    run_command(&writer, "set never_read v");
+    assert_true(results, notified_count == 5, "Overflowed client should fall back to broadcast");
+    tracking_set_max_keys(0);
+    
+    // Broadcast modunda yalnızca öneklerle eşleşen anahtarlar bildirilir
+    run_command(&reader, "client tracking on bcast prefix user:");
+    run_command(&writer, "set order:1 v");
+    run_command(&writer, "set user:1 v");
+    assert_true(results, notified_count == 6, "Broadcast should match prefixes only");
+    
+    reader.protocol = PROTOCOL_RESP;
+    reader.resp_version = 3;
+    assert_true(results, strcmp(run_command(&writer, "set user:2 v"), ">2\r\n$10\r\ninvalidate\r\n*1\r\n$6\r\nuser:2\r\nOK\r\n") == 0,
+                "RESP3 clients should get invalidate push messages");
+    reader.resp_version = 2;
+    assert_true(results, strstr(run_command(&reader, "client tracking on"), "RESP3") != NULL,
+                "RESP2 clients should be asked to switch to RESP3");
+    
+    run_command(&reader, "client tracking off");
+    run_command(&writer, "set user:3 v");
+    assert_true(results, notified_count == 7 && tracking_client_count() == 0 && tracking_key_count() == 0,
+                "Disabling tracking should stop pushes and release the tables");
+    
+    // Tracking istemcileri kimliğe göre tutar; tüm ön yüzler kimliği aynı sayaçtan alır
+    int first_id = command_next_client_id();
+    assert_true(results, command_next_client_id() == first_id + 1, "Client ids should come from one shared counter");
+    
+    storage_free(storage);
+    printf("DEBUG: Completed client_tracking test\n");
+    kv_cleanup();
+}
+
+// Replikasyon akışı bildirimlerini sayar; veri testte replication_fill ile çekilir
+static int stream_wakeups = 0;
+
+static void count_stream_notify(CommandClient* client, const char* key) {
+    (void)client;
+    if (!key) stream_wakeups++;
+}
+
+// Bekleyen snapshot/akış verisini küçük parçalarla capture buffer'ına çeker
+static const char* drain_replica(CommandClient* client) {
+    captured_len = 0;
+    captured_reply[0] = '\0';
+    while (replication_pending(client) && !client->failed) replication_fill(client, 64);
+    return captured_reply;
+}
+
+void test_replication_stream(TestResults* results) {
+    printf("DEBUG: Starting replication_stream test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    storage_set(storage, "repl_a", "1");
+    storage_set_with_ttl(storage, "repl_ttl", "2", 100);
+    
+    CommandClient plain = { .protocol = PROTOCOL_TELNET, .id = 1, .authenticated = true, .write = capture_write };
+    assert_true(results, strstr(run_command(&plain, "psync ? -1"), "not supported") != NULL,
+                "PSYNC should need a frontend that can stream");
+    
+    // Tam senkronizasyon: FULLRESYNC, tablo taraması ve ENDSNAPSHOT
+    CommandClient replica = { .protocol = PROTOCOL_RESP, .id = 2, .authenticated = true,
+                              .write = capture_write, .notify = count_stream_notify };
+    char id[REPL_ID_SIZE + 1] = "";
+    unsigned long long offset = 0;
+    const char* reply = run_command(&replica, "psync ? -1");
+    assert_true(results, sscanf(reply, "+FULLRESYNC %40s %llu\r\n", id, &offset) == 2 && strlen(id) == REPL_ID_SIZE,
+                "Unknown replica should get a full resync");
+    reply = drain_replica(&replica);
+    assert_true(results, strstr(reply, "*3\r\n$3\r\nSET\r\n$6\r\nrepl_a\r\n$1\r\n1\r\n") != NULL,
+                "Snapshot should contain existing keys");
+    assert_true(results, strstr(reply, "*4\r\n$5\r\nSETEX\r\n$8\r\nrepl_ttl\r\n") != NULL,
+                "Snapshot should keep TTLs");
+    assert_true(results, strlen(reply) >= 14 && strcmp(reply + strlen(reply) - 14, "+ENDSNAPSHOT\r\n") == 0,
+                "Snapshot should end with ENDSNAPSHOT");
+    
+    // Sonraki yazmalar akış olarak gelir
+    int wakeups = stream_wakeups;
+    storage_set(storage, "repl_b", "2");
+    storage_delete(storage, "repl_a");
+    assert_true(results, stream_wakeups > wakeups, "Writes should wake the replica connection");
+    assert_true(results, strcmp(drain_replica(&replica),
+                                "*3\r\n$3\r\nSET\r\n$6\r\nrepl_b\r\n$1\r\n2\r\n*2\r\n$3\r\nDEL\r\n$6\r\nrepl_a\r\n") == 0,
+                "Writes should be streamed as commands in order");
+    // Batch'te uygulanmayan işlemler (olmayan anahtarın silinmesi) akışa girmez
+    storage_set(storage, "repl_d", "4");
+    drain_replica(&replica);
+    run_command(&plain, "mdel repl_d repl_missing");
+    assert_true(results, strcmp(drain_replica(&replica), "*2\r\n$3\r\nDEL\r\n$6\r\nrepl_d\r\n") == 0,
+                "Only applied batch operations should be streamed");
+    assert_true(results, strcmp(run_command(&replica, "replconf ack 10"), "") == 0, "REPLCONF ACK should not reply");
+    assert_true(results, strstr(run_command(&plain, "info"), "connected_replicas:1") != NULL,
+                "info should list the replica");
+    
+    // Kopan replika backlog'daki offset'ten devam eder, bilinmeyen offset tam senkronizasyon alır
+    replication_detach(&replica);
+    char line[128];
+    snprintf(line, sizeof(line), "psync %s %llu", id, offset);
+    reply = run_command(&replica, line);
+    assert_true(results, strncmp(reply, "+CONTINUE ", 10) == 0, "Known offset should continue");
+    assert_true(results, strstr(drain_replica(&replica), "$6\r\nrepl_b\r\n") != NULL,
+                "Partial resync should replay the backlog from the offset");
+    replication_detach(&replica);
+    snprintf(line, sizeof(line), "psync %s %llu", id, offset + 1000000);
+    assert_true(results, strncmp(run_command(&replica, line), "+FULLRESYNC ", 12) == 0,
+                "Offset outside the backlog should fall back to a full resync");
+    replication_detach(&replica);
+    
+    // Replika salt okunurdur; primary'den veri gelmediyse okuma da reddedilir
+    replication_start_replica("127.0.0.1", 1);
+    assert_true(results, strstr(run_command(&plain, "set repl_c 3"), "READONLY") != NULL,
+                "Replica should refuse writes");
+    assert_true(results, strstr(run_command(&plain, "get repl_b"), "stale") != NULL,
+                "Replica without a primary should refuse stale reads");
+    assert_true(results, strstr(run_command(&plain, "info"), "role:replica") != NULL, "info should show the replica role");
+    run_command(&plain, "replicaof no one");
+    assert_true(results, strcmp(run_command(&plain, "get repl_b"), "2\r\n") == 0, "Promoted replica should serve reads");
+    assert_true(results, strcmp(run_command(&plain, "set repl_c 3"), "OK\r\n") == 0, "Promoted replica should accept writes");
+    
+    replication_shutdown();
+    storage_free(storage);
+    printf("DEBUG: Completed replication_stream test\n");
+    kv_cleanup();
+}
+
+// Verilen slot aralığına düşen, prefix ile başlayan ilk anahtarı bulur
+static void key_in_slots(char* out, size_t size, const char* prefix, int start, int end) {
+    for (int i = 0;; i++) {
+        snprintf(out, size, "%s%d", prefix, i);
+        int slot = cluster_keyslot(out);
+        if (slot >= start && slot <= end) return;
+    }
+}
+
+void test_cluster_routing(TestResults* results) {
+    printf("DEBUG: Starting cluster_routing test\n");
+    remove_storage_files();
+    remove("cluster_test_nodes.conf");
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    FILE* config = fopen("cluster_test_nodes.conf", "w");
+    fprintf(config, "node 127.0.0.1:7000 0-8191\nnode 127.0.0.1:7001 8192-16383\n");
+    fclose(config);
+    assert_true(results, cluster_enable("cluster_test_nodes.conf", "127.0.0.1:7000"), "Cluster config should load");
+    
+    // Etiketli anahtarlar aynı slota düşer
+    assert_true(results, cluster_keyslot("{user1}.name") == cluster_keyslot("{user1}.mail"), "Hash tags should share a slot");
+    assert_true(results, cluster_keyslot("user1") == cluster_keyslot("{user1}.name"), "Only the tag should be hashed");
+    assert_true(results, cluster_keyslot("{}.a") == (int)(hash("{}.a") % CLUSTER_SLOTS), "Empty tags should hash the whole key");
+    
+    char local[32], remote[32], line[128];
+    key_in_slots(local, sizeof(local), "local_", 0, 8191);
+    key_in_slots(remote, sizeof(remote), "remote_", 8192, 16383);
+    int remote_slot = cluster_keyslot(remote);
+    
+    CommandClient client = { .protocol = PROTOCOL_TELNET, .id = 1, .authenticated = true, .write = capture_write };
+    snprintf(line, sizeof(line), "set %s v", local);
+    assert_true(results, strcmp(run_command(&client, line), "OK\r\n") == 0, "Keys in owned slots should be served");
+    char expected[128];
+    snprintf(line, sizeof(line), "set %s v", remote);
+    snprintf(expected, sizeof(expected), "ERROR: MOVED %d 127.0.0.1:7001\r\n", remote_slot);
+    assert_true(results, strcmp(run_command(&client, line), expected) == 0, "Keys of other nodes should be redirected");
+    client.protocol = PROTOCOL_RESP;
+    snprintf(line, sizeof(line), "get %s", remote);
+    snprintf(expected, sizeof(expected), "-MOVED %d 127.0.0.1:7001\r\n", remote_slot);
+    assert_true(results, strcmp(run_command(&client, line), expected) == 0, "RESP redirects should not carry an ERR prefix");
+    client.protocol = PROTOCOL_TELNET;
+    
+    // Taşınan slot: burada olan anahtar burada, olmayan hedefte aranır
+    int local_slot = cluster_keyslot(local);
+    snprintf(line, sizeof(line), "cluster setslot %d migrating 127.0.0.1:7002", local_slot);
+    run_command(&client, line);
+    snprintf(line, sizeof(line), "get %s", local);
+    assert_true(results, strcmp(run_command(&client, line), "v\r\n") == 0, "Keys not yet migrated should be served locally");
+    char absent[64];
+    snprintf(absent, sizeof(absent), "{%s}absent", local);
+    snprintf(line, sizeof(line), "get %s", absent);
+    snprintf(expected, sizeof(expected), "ERROR: ASK %d 127.0.0.1:7002\r\n", local_slot);
+    assert_true(results, strcmp(run_command(&client, line), expected) == 0, "Missing keys of a migrating slot should be asked at the target");
+    snprintf(line, sizeof(line), "cluster setslot %d stable", local_slot);
+    run_command(&client, line);
+    
+    // İçe alınan slot yalnızca ASKING'den hemen sonraki komuta açıktır
+    snprintf(line, sizeof(line), "cluster setslot %d importing 127.0.0.1:7001", remote_slot);
+    run_command(&client, line);
+    snprintf(line, sizeof(line), "set %s v", remote);
+    assert_true(results, strncmp(run_command(&client, line), "ERROR: MOVED", 12) == 0, "Importing slots should need ASKING");
+    run_command(&client, "asking");
+    assert_true(results, strcmp(run_command(&client, line), "OK\r\n") == 0, "ASKING should allow one command");
+    assert_true(results, strncmp(run_command(&client, line), "ERROR: MOVED", 12) == 0, "ASKING should only last one command");
+    
+    // Sahiplik değişikliği yapılandırma dosyasına yazılır
+    run_command(&client, "cluster setslot 8192-16383 node 127.0.0.1:7000");
+    snprintf(line, sizeof(line), "get %s", remote);
+    assert_true(results, strcmp(run_command(&client, line), "v\r\n") == 0, "Assigned slots should be served");
+    char saved[256] = "";
+    config = fopen("cluster_test_nodes.conf", "r");
+    size_t saved_len = config ? fread(saved, 1, sizeof(saved) - 1, config) : 0;
+    saved[saved_len] = '\0';
+    if (config) fclose(config);
+    assert_true(results, strstr(saved, "node 127.0.0.1:7000 0-16383\n") != NULL, "Slot table should be saved");
+    assert_true(results, strstr(run_command(&client, "cluster info"), "cluster_slots_owned:16384") != NULL,
+                "cluster info should count owned slots");
+    
+    cluster_shutdown();
+    remove("cluster_test_nodes.conf");
+    storage_free(storage);
+    printf("DEBUG: Completed cluster_routing test\n");
+    kv_cleanup();
+}
+
+// --- Çok süreçli küme testi için yardımcılar ---
+
+// aytdb_server test ikilisinin yanında derlenir
+static bool server_binary(char* path, size_t size) {
+    ssize_t len = readlink("/proc/self/exe", path, size - 32);
+    if (len <= 0) return false;
+    path[len] = '\0';
+    char* slash = strrchr(path, '/');
+    if (!slash) return false;
+    strcpy(slash + 1, "aytdb_server");
+    return access(path, X_OK) == 0;
+}
+
+// config verilirse sunucu küme modunda o slot tablosuyla başlar
+static pid_t spawn_server_node(const char* binary, const char* dir, int port, const char* config) {
+    if (config) {
+        char path[512];
+        snprintf(path, sizeof(path), "%s/nodes.conf", dir);
+        FILE* file = fopen(path, "w");
+        if (!file) return -1;
+        fputs(config, file);
+        fclose(file);
+    }
+    
+    fflush(stdout); // Çocuk freopen ile stdout'u kapatırken tamponu ikinci kez yazmasın
+    pid_t pid = fork();
+    if (pid == 0) {
+        char port_text[16];
+        snprintf(port_text, sizeof(port_text), "%d", port);
+        if (chdir(dir) != 0 || !freopen("/dev/null", "w", stdout)) _exit(1);
+        if (config) execl(binary, "aytdb_server", port_text, "--cluster-config", "nodes.conf", (char*)NULL);
+        else execl(binary, "aytdb_server", port_text, (char*)NULL);
+        _exit(1);
+    }
+    return pid;
+}
+
+static void stop_server_node(pid_t pid, const char* dir) {
+    if (pid > 0) {
+        kill(pid, SIGINT);
+        waitpid(pid, NULL, 0);
+    }
+    char command[64];
+    snprintf(command, sizeof(command), "rm -rf %s", dir);
+    if (system(command) != 0) printf("DEBUG: Failed to remove %s\n", dir);
+}
+
+// Sunucu dinlemeye başlayana kadar yeniden dener
+static AytdbClient* connect_test_node(int port) {
+    for (int attempt = 0; attempt < 200; attempt++) {
+        AytdbClient* client = aytdb_connect("127.0.0.1", port, "password");
+        if (client) return client;
+        usleep(20000);
+    }
+    return NULL;
+}
+
+// Komutu çalıştırıp yanıtı metin olarak döndürür: durum ve hatalar "+OK"/"-ERR ..." gibi
+// ilk karakteriyle, değerler yalnızca içerikleriyle
+static const char* node_call(AytdbClient* client, int argc, ...) {
+    static char text[2048];
+    const char* argv[8];
+    va_list args;
+    va_start(args, argc);
+    for (int i = 0; i < argc; i++) argv[i] = va_arg(args, const char*);
+    va_end(args);
+    
+    const AytdbReply* reply = client ? aytdb_command(client, argc, argv, NULL) : NULL;
+    if (!reply) return "";
+    switch (reply->type) {
+    case AYTDB_REPLY_STATUS: snprintf(text, sizeof(text), "+%s", reply->str); break;
+    case AYTDB_REPLY_ERROR: snprintf(text, sizeof(text), "-%s", reply->str); break;
+    case AYTDB_REPLY_INTEGER: snprintf(text, sizeof(text), ":%lld", reply->integer); break;
+    case AYTDB_REPLY_STRING: snprintf(text, sizeof(text), "%s", reply->str); break;
+    case AYTDB_REPLY_NIL: return "(nil)";
+    default: return "";
+    }
+    return text;
+}
+
+// MOVED ve ASK yönlendirmelerini izleyerek komutu çalıştırır; nodes[i] port base+i'ye bağlıdır
+static const char* cluster_call(AytdbClient** nodes, int base_port, int node, const char* command, const char* key, const char* value) {
+    for (int hop = 0; hop < 4; hop++) {
+        const char* reply = value ? node_call(nodes[node], 3, command, key, value) : node_call(nodes[node], 2, command, key);
+        bool moved = strncmp(reply, "-MOVED ", 7) == 0;
+        if (!moved && strncmp(reply, "-ASK ", 5) != 0) return reply;
+        const char* colon = strrchr(reply, ':');
+        if (!colon) return reply;
+        node = atoi(colon + 1) - base_port;
+        if (!moved) node_call(nodes[node], 1, "ASKING");
+    }
+    return "";
+}
+
+void test_cluster_migration(TestResults* results) {
+    printf("DEBUG: Starting cluster_migration test\n");
+    char binary[512];
+    if (!server_binary(binary, sizeof(binary))) {
+        printf("DEBUG: aytdb_server not found next to the test binary, skipping\n");
+        return;
+    }
+    
+    // Üç süreç: A ve B slotları paylaşır, C boş başlar ve A'nın yarısını devralır
+    int base_port = 20000 + (int)(getpid() % 15000) * 3;
+    char config[256];
+    snprintf(config, sizeof(config), "node 127.0.0.1:%d 0-8191\nnode 127.0.0.1:%d 8192-16383\n", base_port, base_port + 1);
+    char dirs[3][32];
+    pid_t pids[3];
+    AytdbClient* nodes[3];
+    for (int i = 0; i < 3; i++) {
+        strcpy(dirs[i], "/tmp/aytdb_cluster_XXXXXX");
+        pids[i] = mkdtemp(dirs[i]) ? spawn_server_node(binary, dirs[i], base_port + i, config) : -1;
+        nodes[i] = pids[i] > 0 ? connect_test_node(base_port + i) : NULL;
+    }
+    bool started = nodes[0] && nodes[1] && nodes[2];
+    assert_true(results, started, "Cluster nodes should start");
+    
+    char key[32], value[32];
+    bool all_set = started;
+    for (int i = 0; all_set && i < 500; i++) {
+        snprintf(key, sizeof(key), "ckey_%d", i);
+        snprintf(value, sizeof(value), "v%d", i);
+        all_set = strcmp(cluster_call(nodes, base_port, 1, "SET", key, value), "+OK") == 0;
+    }
+    assert_true(results, all_set, "Writes should follow MOVED to the owning node");
+    
+    // Taşıma sürerken okuma ve yazmalar yönlendirmelerle doğru düğüme ulaşır
+    char target[32];
+    snprintf(target, sizeof(target), "127.0.0.1:%d", base_port + 2);
+    assert_true(results, started && strcmp(node_call(nodes[0], 4, "CLUSTER", "MIGRATE", "0-8191", target), "+OK") == 0,
+                "Migration should start");
+    bool consistent = started;
+    for (int round = 0; consistent && round < 200; round++) {
+        snprintf(key, sizeof(key), "ckey_%d", round % 500);
+        snprintf(value, sizeof(value), "w%d", round);
+        consistent = strcmp(cluster_call(nodes, base_port, 1, "SET", key, value), "+OK") == 0 &&
+                     strcmp(cluster_call(nodes, base_port, 1, "GET", key, NULL), value) == 0;
+    }
+    assert_true(results, consistent, "Keys should stay readable and writable during migration");
+    
+    bool done = false;
+    for (int wait = 0; started && !done && wait < 500; wait++) {
+        done = strstr(node_call(nodes[0], 2, "CLUSTER", "INFO"), "cluster_migration:done") != NULL;
+        if (!done) usleep(10000);
+    }
+    assert_true(results, done, "Migration should finish");
+    
+    bool readable = started;
+    for (int i = 0; readable && i < 500; i++) {
+        snprintf(key, sizeof(key), "ckey_%d", i);
+        snprintf(value, sizeof(value), "%c%d", i < 200 ? 'w' : 'v', i); // İlk 200 anahtar taşıma sırasında yazıldı
+        readable = strcmp(cluster_call(nodes, base_port, 0, "GET", key, NULL), value) == 0;
+    }
+    assert_true(results, readable, "All keys should be readable after migration");
+    key_in_slots(key, sizeof(key), "ckey_", 0, 8191);
+    assert_true(results, started && strncmp(node_call(nodes[1], 2, "GET", key), "-MOVED", 6) == 0 &&
+                strstr(node_call(nodes[1], 2, "GET", key), target) != NULL,
+                "Other nodes should learn the new slot owner");
+    assert_true(results, started && strstr(node_call(nodes[0], 2, "CLUSTER", "INFO"), "cluster_slots_owned:0") != NULL,
+                "Source should no longer own the migrated slots");
+    
+    for (int i = 0; i < 3; i++) {
+        aytdb_close(nodes[i]);
+        stop_server_node(pids[i], dirs[i]);
+    }
+    printf("DEBUG: Completed cluster_migration test\n");
+}
+
+// --- İstemci kütüphanesi testi ---
+
+typedef struct {
+    int seen;
+    int matched;
+    int missing;
+} ReplyCounter;
+
+// Yanıtlar "v<i>" değerleriyle sırayla gelmelidir
+static void count_reply(AytdbClient* client, const AytdbReply* reply, void* ctx) {
+    (void)client;
+    ReplyCounter* counter = ctx;
+    char expected[32];
+    snprintf(expected, sizeof(expected), "v%d", counter->seen++);
+    if (reply && reply->type == AYTDB_REPLY_NIL) counter->missing++;
+    else if (reply && reply->type == AYTDB_REPLY_STRING && strcmp(reply->str, expected) == 0) counter->matched++;
+}
+
+typedef struct {
+    AytdbPool* pool;
+    int id;
+    int ok;
+} PoolWorker;
+
+static void* pool_worker(void* arg) {
+    PoolWorker* worker = arg;
+    char key[32], value[32];
+    for (int i = 0; i < 100; i++) {
+        AytdbClient* client = aytdb_pool_acquire(worker->pool);
+        snprintf(key, sizeof(key), "pool_%d_%d", worker->id, i);
+        snprintf(value, sizeof(value), "p%d", i);
+        if (strcmp(node_call(client, 3, "SET", key, value), "+OK") == 0 &&
+            strcmp(node_call(client, 2, "GET", key), value) == 0) {
+            worker->ok++;
+        }
+        aytdb_pool_release(worker->pool, client);
+    }
+    return NULL;
+}
+
+void test_client_library(TestResults* results) {
+    printf("DEBUG: Starting client_library test\n");
+    char binary[512];
+    if (!server_binary(binary, sizeof(binary))) {
+        printf("DEBUG: aytdb_server not found next to the test binary, skipping\n");
+        return;
+    }
+    
+    int port = 20000 + (int)(getpid() % 15000) * 3;
+    char dir[32] = "/tmp/aytdb_client_XXXXXX";
+    pid_t pid = mkdtemp(dir) ? spawn_server_node(binary, dir, port, NULL) : -1;
+    AytdbClient* client = pid > 0 ? connect_test_node(port) : NULL;
+    assert_not_null(results, client, "Client should connect and authenticate");
+    
+    // Toplu yardımcılar birden fazla pipeline turuna bölünür
+    enum { BATCH_KEYS = AYTDB_BATCH_SIZE * 2 + 10 };
+    static char key_text[BATCH_KEYS + 1][32], value_text[BATCH_KEYS][32];
+    const char* keys[BATCH_KEYS + 1];
+    const char* values[BATCH_KEYS];
+    for (int i = 0; i < BATCH_KEYS; i++) {
+        snprintf(key_text[i], sizeof(key_text[i]), "lib_key_%d", i);
+        snprintf(value_text[i], sizeof(value_text[i]), "v%d", i);
+        keys[i] = key_text[i];
+        values[i] = value_text[i];
+    }
+    strcpy(key_text[BATCH_KEYS], "lib_missing");
+    keys[BATCH_KEYS] = key_text[BATCH_KEYS];
+    
+    assert_true(results, client && aytdb_mset(client, BATCH_KEYS, keys, values), "mset should write all keys");
+    ReplyCounter counter = {0};
+    assert_true(results, client && aytdb_mget(client, BATCH_KEYS + 1, keys, count_reply, &counter),
+                "mget should succeed");
+    assert_true(results, counter.matched == BATCH_KEYS && counter.missing == 1,
+                "mget should return every value in order and nil for the missing key");
+    
+    // Asenkron istekler araya giren senkron komuttan önce tamamlanır
+    memset(&counter, 0, sizeof(counter));
+    for (int i = 0; client && i < 500; i++) {
+        const char* argv[] = { "GET", keys[i] };
+        aytdb_append_async(client, count_reply, &counter, 2, argv, NULL);
+    }
+    assert_true(results, client && aytdb_pending(client) == 500, "Async requests should be queued");
+    assert_true(results, strcmp(node_call(client, 1, "PING"), "+PONG") == 0, "Sync reply should follow the pipeline");
+    assert_true(results, counter.matched == 500 && aytdb_pending(client) == 0,
+                "Async callbacks should run in order before the sync reply");
+    
+    // Olay döngüsü kullanımı: flush, soket okunabilir oldukça aytdb_read
+    memset(&counter, 0, sizeof(counter));
+    for (int i = 0; client && i < 200; i++) {
+        const char* argv[] = { "GET", keys[i] };
+        aytdb_append_async(client, count_reply, &counter, 2, argv, NULL);
+    }
+    bool flushed = client && aytdb_flush(client);
+    for (int wait = 0; flushed && aytdb_pending(client) > 0 && wait < 500; wait++) {
+        if (aytdb_read(client) < 0) break;
+        if (aytdb_pending(client) > 0) usleep(1000);
+    }
+    assert_true(results, flushed && counter.matched == 200, "aytdb_read should dispatch pipelined replies");
+    assert_true(results, strncmp(node_call(client, 1, "GET"), "-ERR", 4) == 0, "Errors should be reported as error replies");
+    
+    // Havuzdaki iki bağlantıyı dört thread paylaşır
+    AytdbPool* pool = aytdb_pool_create("127.0.0.1", port, "password", 2);
+    PoolWorker workers[4];
+    pthread_t threads[4];
+    for (int i = 0; i < 4; i++) {
+        workers[i] = (PoolWorker){ pool, i, 0 };
+        pthread_create(&threads[i], NULL, pool_worker, &workers[i]);
+    }
+    int pool_ok = 0;
+    for (int i = 0; i < 4; i++) {
+        pthread_join(threads[i], NULL);
+        pool_ok += workers[i].ok;
+    }
+    aytdb_pool_destroy(pool);
+    assert_true(results, client && pool_ok == 400, "Pooled connections should serve all threads");
+    
+    aytdb_close(client);
+    stop_server_node(pid, dir);
+    printf("DEBUG: Completed client_library test\n");
+}
+
+void test_server_half_close(TestResults* results) {
+    printf("DEBUG: Starting server_half_close test\n");
+    char binary[512];
+    if (!server_binary(binary, sizeof(binary))) {
+        printf("DEBUG: aytdb_server not found next to the test binary, skipping\n");
+        return;
+    }
+    
+    int port = 20000 + (int)(getpid() % 15000) * 3 + 1;
+    char dir[32] = "/tmp/aytdb_halfclose_XXXXXX";
+    pid_t pid = mkdtemp(dir) ? spawn_server_node(binary, dir, port, NULL) : -1;
+    AytdbClient* probe = pid > 0 ? connect_test_node(port) : NULL;
+    assert_not_null(results, probe, "Server should start");
+    aytdb_close(probe);
+    
+    // Komutlar gönderilip yazma yönü kapatılır; yanıtlar yine de okunabilmeli
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(port) };
+    inet_pton(AF_INET, "127.0.0.1", &addr.sin_addr);
+    struct timeval timeout = { .tv_sec = 5 };
+    bool connected = fd >= 0 && setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) == 0 &&
+                     connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+    assert_true(results, connected, "Raw socket should connect");
+    
+    const char* request = "*2\r\n$4\r\nAUTH\r\n$8\r\npassword\r\n"
+                          "*3\r\n$3\r\nSET\r\n$9\r\nhalfclose\r\n$5\r\nvalue\r\n"
+                          "*2\r\n$3\r\nGET\r\n$9\r\nhalfclose\r\n"
+                          "*1\r\n$4\r\nPING\r\n";
+    bool sent = connected && send(fd, request, strlen(request), 0) == (ssize_t)strlen(request) &&
+                shutdown(fd, SHUT_WR) == 0;
+    assert_true(results, sent, "Request should be sent before the half-close");
+    
+    char reply[256];
+    size_t len = 0;
+    while (sent && len < sizeof(reply) - 1) {
+        ssize_t n = recv(fd, reply + len, sizeof(reply) - 1 - len, 0);
+        if (n <= 0) break;
+        len += (size_t)n;
+    }
+    reply[len] = '\0';
+    assert_true(results, strcmp(reply, "+OK\r\n+OK\r\n$5\r\nvalue\r\n+PONG\r\n") == 0,
+                "All replies should arrive before the server closes a half-closed connection");
+    
+    if (fd >= 0) close(fd);
+    stop_server_node(pid, dir);
+    printf("DEBUG: Completed server_half_close test\n");
+}
+
+void test_transactions(TestResults* results) {
+    printf("DEBUG: Starting transactions test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    
+    // Yığın sınırını aşan batch: yazmalar, TTL'li yazmalar ve silmeler tek kilitle
+    enum { OPS = KV_BATCH_STACK * 2 };
+    static char keys[OPS][32], values[OPS][32];
+    KvBatchOp ops[OPS];
+    bool changed[OPS];
+    for (int i = 0; i < OPS; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "batch_%d", i % (OPS / 2));
+        snprintf(values[i], sizeof(values[i]), "bv%d", i);
+        ops[i] = (KvBatchOp){ keys[i], values[i], i % 3 == 0 ? 100 : 0 };
+    }
+    // İkinci yarı ilk yarının anahtarlarını günceller, çift olanları ise siler
+    for (int i = OPS / 2; i < OPS; i += 2) ops[i].value = NULL;
+    size_t count_before = kv_get_count();
+    kv_apply_batch(NULL, 0, ops, OPS, changed);
+    
+    bool applied = kv_get_count() == count_before + OPS / 4;
+    for (int i = OPS / 2; i < OPS; i++) {
+        const char* value = kv_get(keys[i]);
+        applied = applied && changed[i] && (i % 2 == 0 ? value == NULL : value && strcmp(value, values[i]) == 0);
+    }
+    assert_true(results, applied, "Batch should apply writes and deletes in order");
+    KvBatchOp missing = { "batch_missing", NULL, 0 };
+    kv_apply_batch(NULL, 0, &missing, 1, changed);
+    assert_true(results, !changed[0], "Deleting a missing key should not be reported as a change");
+    
+    CommandClient client = { .protocol = PROTOCOL_RESP, .authenticated = true, .write = capture_write };
+    assert_true(results, strcmp(run_command(&client, "multi"), "+OK\r\n") == 0, "multi should start a transaction");
+    assert_true(results, strcmp(run_command(&client, "set tx_a 1"), "+QUEUED\r\n") == 0, "Commands should be queued");
+    run_command(&client, "setex tx_b 100 two");
+    run_command(&client, "get tx_a");
+    run_command(&client, "del tx_a");
+    run_command(&client, "del tx_missing");
+    assert_true(results, kv_get("tx_a") == NULL, "Queued writes should not run before exec");
+    assert_true(results, strcmp(run_command(&client, "exec"), "*5\r\n+OK\r\n+OK\r\n$1\r\n1\r\n:1\r\n:0\r\n") == 0,
+                "exec should reply every queued command in order");
+    assert_true(results, kv_get("tx_b") && strcmp(kv_get("tx_b"), "two") == 0, "setex in a transaction should be applied");
+    
+    run_command(&client, "multi");
+    run_command(&client, "set tx_c 3");
+    assert_true(results, strcmp(run_command(&client, "discard"), "+OK\r\n") == 0 && kv_get("tx_c") == NULL,
+                "discard should drop queued commands");
+    assert_true(results, strstr(run_command(&client, "exec"), "EXEC without MULTI") != NULL, "exec needs multi");
+    
+    run_command(&client, "multi");
+    run_command(&client, "set tx_c 3");
+    assert_true(results, strstr(run_command(&client, "set tx_d"), "wrong number of arguments") != NULL,
+                "Invalid commands should be rejected while queueing");
+    assert_true(results, strncmp(run_command(&client, "exec"), "-EXECABORT", 10) == 0 && kv_get("tx_c") == NULL,
+                "A transaction with errors should be discarded");
+    
+    client.protocol = PROTOCOL_TELNET;
+    run_command(&client, "multi");
+    run_command(&client, "set tx_e five");
+    assert_true(results, strcmp(run_command(&client, "exec"), "OK\r\n") == 0, "Telnet exec should reply each command");
+    command_client_close(&client);
+    
+    storage_free(storage);
+    printf("DEBUG: Completed transactions test\n");
+    kv_cleanup();
+}
+
+// Her thread sayacı oku-artır-cas döngüsüyle artırır; çakışan thread yeniden dener
+static void* cas_increment_worker(void* arg) {
+    int* retries = arg;
+    for (int i = 0; i < 2000; i++) {
+        for (;;) {
+            uint64_t version, stored;
+            const char* value = kv_get_versioned("cas_counter", &version);
+            char next[32];
+            snprintf(next, sizeof(next), "%d", atoi(value ? value : "0") + 1);
+            if (kv_cas("cas_counter", version, next, &stored)) break;
+            (*retries)++;
+        }
+    }
+    return NULL;
+}
+
+// WATCH'lı işlemle yarışan yazar: durdurulana kadar storage_cas ile (yazma kilidinden geçerek) artırır
+typedef struct {
+    Storage* storage;
+    volatile bool stop;
+    int increments;
+} WatchRace;
+
+static void* watch_race_writer(void* arg) {
+    WatchRace* race = arg;
+    while (!race->stop) {
+        uint64_t version, stored;
+        const char* value = kv_get_versioned("race_counter", &version);
+        char next[32];
+        snprintf(next, sizeof(next), "%d", atoi(value ? value : "0") + 1);
+        if (storage_cas(race->storage, "race_counter", version, next, &stored)) race->increments++;
+    }
+    return NULL;
+}
+
+void test_versioned_writes(TestResults* results) {
+    printf("DEBUG: Starting versioned writes test\n");
+    remove_storage_files();
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    
+    assert_true(results, kv_get_version("ver_key") == 0, "A missing key should have version 0");
+    kv_set("ver_key", "a");
+    uint64_t v1 = kv_get_version("ver_key");
+    kv_set("ver_key", "b");
+    uint64_t v2 = kv_get_version("ver_key");
+    kv_del("ver_key");
+    kv_set("ver_key", "c");
+    uint64_t v3 = kv_get_version("ver_key");
+    assert_true(results, v1 > 0 && v2 > v1 && v3 > v2, "Every write, including a re-create, should get a new version");
+    
+    uint64_t version;
+    assert_true(results, !kv_cas("ver_key", v2, "stale", &version) && version == v3 &&
+                strcmp(kv_get("ver_key"), "c") == 0, "cas with a stale version should fail and report the current one");
+    assert_true(results, kv_cas("ver_key", v3, "d", &version) && version > v3 && version == kv_get_version("ver_key"),
+                "cas with the current version should store and return the new version");
+    assert_true(results, !kv_cas("ver_key", 0, "e", &version), "cas with version 0 should only create");
+    kv_set_with_ttl("ver_expired", "x", 1);
+    sleep(2);
+    assert_true(results, kv_get_version("ver_expired") == 0 && kv_cas("ver_expired", 0, "y", &version),
+                "An expired key should count as absent");
+    
+    // Eşzamanlı oku-değiştir-yaz: kilit olmadan artırma kaybolmamalı
+    pthread_t threads[4];
+    int retries[4] = {0};
+    for (int i = 0; i < 4; i++) pthread_create(&threads[i], NULL, cas_increment_worker, &retries[i]);
+    for (int i = 0; i < 4; i++) pthread_join(threads[i], NULL);
+    printf("DEBUG: cas counter retries: %d %d %d %d\n", retries[0], retries[1], retries[2], retries[3]);
+    assert_true(results, kv_get("cas_counter") && atoi(kv_get("cas_counter")) == 8000,
+                "Concurrent cas increments should not lose updates");
+    
+    CommandClient client = { .protocol = PROTOCOL_RESP, .authenticated = true, .write = capture_write };
+    char expected[128];
+    snprintf(expected, sizeof(expected), "*2\r\n$1\r\nd\r\n:%llu\r\n", (unsigned long long)kv_get_version("ver_key"));
+    assert_true(results, strcmp(run_command(&client, "gets ver_key"), expected) == 0, "gets should reply value and version");
+    assert_true(results, strcmp(run_command(&client, "gets ver_missing"), "$-1\r\n") == 0, "gets on a missing key is null");
+    assert_true(results, strcmp(run_command(&client, "cas ver_key 1 z"), "$-1\r\n") == 0, "A failed cas should reply null");
+    assert_true(results, strstr(run_command(&client, "cas ver_key -1 z"), "non-negative integer") != NULL,
+                "cas should reject an invalid version");
+    assert_true(results, strcmp(run_command(&client, "setnx nx_key 1"), ":1\r\n") == 0 &&
+                strcmp(run_command(&client, "setnx nx_key 2"), ":0\r\n") == 0 && strcmp(kv_get("nx_key"), "1") == 0,
+                "setnx should only store a missing key");
+    assert_true(results, strcmp(run_command(&client, "getset gs_key one"), "$-1\r\n") == 0 &&
+                strcmp(run_command(&client, "getset gs_key two"), "$3\r\none\r\n") == 0 && strcmp(kv_get("gs_key"), "two") == 0,
+                "getset should return the previous value");
+    
+    // WATCH: izlenen anahtar başka bir bağlantıdan değişirse EXEC hiçbir şey uygulamaz
+    CommandClient other = client;
+    run_command(&client, "watch w_key w_other");
+    run_command(&client, "multi");
+    run_command(&client, "set w_key mine");
+    run_command(&other, "set w_other theirs");
+    assert_true(results, strcmp(run_command(&client, "exec"), "*-1\r\n") == 0 && kv_get("w_key") == NULL,
+                "exec should abort when a watched key changed");
+    run_command(&client, "watch w_key");
+    run_command(&client, "multi");
+    run_command(&client, "set w_key mine");
+    assert_true(results, strcmp(run_command(&client, "exec"), "*1\r\n+OK\r\n") == 0 && kv_get("w_key") != NULL,
+                "exec should apply when watched keys are unchanged");
+    run_command(&client, "watch w_key");
+    run_command(&client, "multi");
+    assert_true(results, strstr(run_command(&client, "watch w_key"), "inside MULTI") != NULL, "watch is not allowed in multi");
+    run_command(&client, "get w_key");
+    run_command(&other, "del w_key");
+    assert_true(results, strcmp(run_command(&client, "exec"), "*-1\r\n") == 0,
+                "A deleted watched key should abort a transaction with reads");
+    run_command(&client, "watch w_key");
+    run_command(&other, "set w_key again");
+    run_command(&client, "unwatch");
+    run_command(&client, "multi");
+    run_command(&client, "set w_key after");
+    assert_true(results, strcmp(run_command(&client, "exec"), "*1\r\n+OK\r\n") == 0, "unwatch should forget watched keys");
+    run_command(&client, "watch w_key");
+    run_command(&client, "multi");
+    run_command(&client, "get w_key");
+    run_command(&client, "schedule 60 1");
+    assert_true(results, strstr(run_command(&client, "exec"), "cannot run admin commands") != NULL,
+                "A watched transaction with reads should reject admin commands");
+    
+    // Okuma içeren işlemde WATCH kontrolü ile komutlar arasına başka yazma girmemeli:
+    // oku-artır işlemleri yarışan yazarın artırmalarını ezmez
+    WatchRace race = { storage, false, 0 };
+    pthread_t writer;
+    pthread_create(&writer, NULL, watch_race_writer, &race);
+    char line[64];
+    int applied = 0;
+    for (int attempt = 0; applied < 2000 && attempt < 200000; attempt++) {
+        run_command(&client, "watch race_counter");
+        const char* value = kv_get("race_counter");
+        snprintf(line, sizeof(line), "set race_counter %d", atoi(value ? value : "0") + 1);
+        run_command(&client, "multi");
+        for (int i = 0; i < 16; i++) run_command(&client, "get race_counter");
+        run_command(&client, line);
+        if (strcmp(run_command(&client, "exec"), "*-1\r\n") != 0) applied++;
+    }
+    race.stop = true;
+    pthread_join(writer, NULL);
+    const char* total = kv_get("race_counter");
+    assert_true(results, applied == 2000 && total && atoi(total) == race.increments + applied,
+                "No increment should be lost between the WATCH check and a transaction with reads");
+    command_client_close(&client);
+    
+    // Yeniden başlatılan tablo önceki sürümleri tekrar vermemeli (cas/WATCH için ABA)
+    storage_free(storage);
+    uint64_t before_restart = kv_get_version("ver_key");
+    kv_cleanup();
+    usleep(2000);
+    kv_init();
+    kv_set("ver_key", "restarted");
+    assert_true(results, kv_get_version("ver_key") > before_restart,
+                "Versions should keep increasing across a restart");
+    
+    printf("DEBUG: Completed versioned writes test\n");
+    kv_cleanup();
+}
+
+void test_multi_key_commands(TestResults* results) {
+    printf("DEBUG: Starting multi-key commands test\n");
+    remove_storage_files();
+    
+    // Parser'da saklanan offsetleri aşan komut: kalan argümanlar başlıklardan bulunur
+    enum { ARGS = 300 };
+    static char buf[ARGS * 16];
+    static char* argv[RESP_MAX_ARGS];
+    size_t len = (size_t)sprintf(buf, "*%d\r\n$4\r\nMGET\r\n", ARGS + 1);
+    for (int i = 0; i < ARGS; i++) {
+        char key[16];
+        int key_len = snprintf(key, sizeof(key), "k%d", i);
+        len += (size_t)sprintf(buf + len, "$%d\r\n%s\r\n", key_len, key);
+    }
+    RespParser parser;
+    resp_parser_reset(&parser);
+    bool parsed = resp_parse(&parser, buf, len) == RESP_OK && parser.pos == len &&
+                  resp_args(&parser, buf, argv) == ARGS + 1;
+    assert_true(results, parsed && strcmp(argv[0], "MGET") == 0 && strcmp(argv[RESP_INLINE_ARGS], "k9") == 0 &&
+                strcmp(argv[ARGS], "k299") == 0, "resp_args should return every argument of a long command");
+    
+    Storage* storage = storage_init();
+    assert_not_null(results, storage, "Storage initialization should succeed");
+    command_init(storage, NULL);
+    
+    CommandClient client = { .protocol = PROTOCOL_TELNET, .authenticated = true, .write = capture_write };
+    assert_true(results, strcmp(run_command(&client, "mset ma 1 mb \"two words\" mc 3"), "OK\r\n") == 0,
+                "mset should store every pair");
+    assert_true(results, strcmp(run_command(&client, "mget ma mb mx mc"), "1\r\ntwo words\r\nNULL\r\n3\r\n") == 0,
+                "Telnet mget should reply one line per key");
+    assert_true(results, strstr(run_command(&client, "mset ma 1 mb"), "wrong number of arguments") != NULL,
+                "mset needs a value for every key");
+    
+    client.protocol = PROTOCOL_RESP;
+    assert_true(results, strcmp(run_command(&client, "mget ma mx"), "*2\r\n$1\r\n1\r\n$-1\r\n") == 0,
+                "RESP mget should reply an array with nulls for missing keys");
+    assert_true(results, strcmp(run_command(&client, "mdel ma mx mc"), ":2\r\n") == 0 && kv_get("ma") == NULL &&
+                kv_get("mb") != NULL, "mdel should delete the keys and count the existing ones");
+    
+    // Bir sayfada 200 anahtar: tek komut, tek yanıt
+    static char line[8192];
+    len = (size_t)sprintf(line, "mset");
+    for (int i = 0; i < 200; i++) len += (size_t)sprintf(line + len, " page_%d v%d", i, i);
+    assert_true(results, strcmp(run_command(&client, line), "+OK\r\n") == 0 && kv_get("page_199") != NULL,
+                "mset should accept hundreds of arguments");
+    len = (size_t)sprintf(line, "mget");
+    for (int i = 0; i < 200; i++) len += (size_t)sprintf(line + len, " page_%d", i);
+    const char* reply = run_command(&client, line);
+    assert_true(results, strncmp(reply, "*200\r\n$2\r\nv0\r\n", 14) == 0 && strstr(reply, "$4\r\nv199\r\n") != NULL,
+                "mget should return 200 values in one reply");
+    
+    len = (size_t)sprintf(line, "mget");
+    for (int i = 0; i <= MAX_TOKENS; i++) len += (size_t)sprintf(line + len, " k");
+    assert_true(results, strstr(run_command(&client, line), "too many arguments") != NULL,
+                "Lines over the argument limit should be rejected, not truncated");
+    command_client_close(&client);
+    
+    storage_free(storage);
+    printf("DEBUG: Completed multi-key commands test\n");
+    kv_cleanup();
+}
+
+static void collect_value(void* ctx, size_t index, const char* value) {
+    ((const char**)ctx)[index] = value;
+}
+
+static void count_found(void* ctx, size_t index, const char* value) {
+    (void)index;
+    if (value) (*(size_t*)ctx)++;
+}
+
+// Entry havuzunu dolduran tabloda rastgele anahtarlar: tek tek kv_get ile
+// 256'lık kv_get_many çağrıları karşılaştırılır. ~1.3GB ayırıp birkaç saniye sürdüğü için
+// yalnızca AYTDB_BENCH_LOOKUP ortam değişkeni verildiğinde çalışır
+static void bench_batched_lookup(TestResults* results) {
+    kv_init();
+    
+    enum { KEYS = ENTRY_POOL_SIZE, LOOKUPS = 2000000, BATCH = 256 };
+    char (*key_text)[16] = malloc((size_t)KEYS * sizeof(*key_text));
+    const char** lookups = malloc(LOOKUPS * sizeof(char*));
+    assert_true(results, key_text && lookups, "Benchmark buffers should be allocated");
+    if (!key_text || !lookups) {
+        free(key_text);
+        free(lookups);
+        kv_cleanup();
+        return;
+    }
+    for (size_t i = 0; i < KEYS; i++) {
+        snprintf(key_text[i], sizeof(key_text[i]), "lk_%zu", i);
+        kv_set(key_text[i], key_text[i] + 3);
+    }
+    printf("DEBUG: Lookup table has %zu keys in %zu slots\n", kv_get_count(), kv_get_size());
+    
+    srand(42);
+    for (size_t i = 0; i < LOOKUPS; i++) lookups[i] = key_text[rand() % KEYS];
+    double start = get_time_usec();
+    size_t single_found = 0;
+    for (size_t i = 0; i < LOOKUPS; i++) single_found += kv_get(lookups[i]) != NULL;
+    double single_time = get_time_usec() - start;
+    
+    start = get_time_usec();
+    size_t batched_found = 0;
+    for (size_t i = 0; i < LOOKUPS; i += BATCH) {
+        kv_get_many(lookups + i, LOOKUPS - i < BATCH ? LOOKUPS - i : BATCH, count_found, &batched_found);
+    }
+    double batched_time = get_time_usec() - start;
+    printf("DEBUG: %d random lookups: single %.2f M/s, batched %.2f M/s (%.2fx)\n", LOOKUPS,
+           LOOKUPS / single_time, LOOKUPS / batched_time, single_time / batched_time);
+    assert_true(results, single_found == batched_found && batched_found == LOOKUPS,
+                "Single and batched lookups should find the same keys");
+    
+    free(key_text);
+    free(lookups);
+    kv_cleanup();
+}
+
+// kv_get_many, eksik ve süresi dolmuş anahtarlar dahil kv_get ile aynı sonuçları vermeli;
+// örnek KV_LOOKUP_WINDOW'dan büyük olduğu için birden fazla pencere işlenir
+void test_batched_lookup(TestResults* results) {
+    printf("DEBUG: Starting batched lookup test\n");
+    remove_storage_files();
+    kv_init();
+    
+    enum { KEYS = 20000, SAMPLE = 1000 };
+    static char key_text[KEYS][16];
+    for (int i = 0; i < KEYS; i++) {
+        snprintf(key_text[i], sizeof(key_text[i]), "lk_%d", i);
+        kv_set(key_text[i], key_text[i] + 3);
+    }
+    
+    srand(42);
+    const char* sample[SAMPLE];
+    const char* values[SAMPLE];
+    for (int i = 0; i < SAMPLE; i++) sample[i] = key_text[rand() % KEYS];
+    // Her on anahtardan biri tabloda yok
+    char missing[SAMPLE / 10][16];
+    for (int i = 0; i < SAMPLE / 10; i++) {
+        snprintf(missing[i], sizeof(missing[i]), "lk_missing_%d", i);
+        sample[i * 10] = missing[i];
+    }
+    kv_set_with_ttl(key_text[7], "old", 1);
+    sample[21] = key_text[7];
+    kv_del(key_text[8]);
+    sample[33] = key_text[8];
+    sleep(2);
+    
+    kv_get_many(sample, SAMPLE, collect_value, values);
+    bool same = true;
+    size_t found = 0;
+    for (int i = 0; i < SAMPLE; i++) {
+        const char* single = kv_get(sample[i]);
+        same = same && (single ? values[i] && strcmp(single, values[i]) == 0 : values[i] == NULL);
+        found += single != NULL;
+    }
+    assert_true(results, same && found > 0, "kv_get_many should return the same values as kv_get");
+    assert_true(results, values[0] == NULL && values[21] == NULL && values[33] == NULL,
+                "Missing, expired and deleted keys should be reported as NULL");
+    
+    // Pencerenin katı olmayan ve tek anahtarlık çağrılar
+    size_t counted = 0;
+    kv_get_many(sample + 1, KV_LOOKUP_WINDOW + 3, count_found, &counted);
+    size_t expected = 0;
+    for (int i = 1; i <= KV_LOOKUP_WINDOW + 3; i++) expected += kv_get(sample[i]) != NULL;
+    kv_get_many(sample + 1, 1, collect_value, values);
+    const char* single = kv_get(sample[1]);
+    assert_true(results, counted == expected && (single ? values[0] && strcmp(values[0], single) == 0 : values[0] == NULL),
+                "Partial windows and single-key calls should match kv_get");
+    kv_cleanup();
+    
+    if (getenv("AYTDB_BENCH_LOOKUP")) bench_batched_lookup(results);
+    printf("DEBUG: Completed batched lookup test\n");
+}
+
 // Stres test fonksiyonu
 void stress_test_storage(TestResults* results) {
     printf("DEBUG: Starting stress test\n");
@@ -459,6 +2150,26 @@ int main() {
         {"Table Resize Test", test_table_resize, false, 0},
         {"Load Factor Test", test_load_factor, false, 0},
         {"Concurrent Access Test", test_concurrent_access, false, 0},
+        {"Concurrent Resize Test", test_concurrent_resize, false, 0},
+        {"Log Rewrite Test", test_log_rewrite, false, 0},
+        {"io_uring Persistence Test", test_uring_persistence, false, 0},
+        {"Compressed Snapshot Test", test_compressed_snapshot, false, 0},
+        {"Delta Snapshot Test", test_delta_snapshot, false, 0},
+        {"Mapped Table Test", test_mapped_table, false, 0},
+        {"Snapshot Rules Test", test_snapshot_rules, false, 0},
+        {"RESP Parser Test", test_resp_parser, false, 0},
+        {"Command Registry Test", test_command_registry, false, 0},
+        {"Shared Memory Ring Test", test_shm_ring, false, 0},
+        {"Client Tracking Test", test_client_tracking, false, 0},
+        {"Replication Stream Test", test_replication_stream, false, 0},
+        {"Cluster Routing Test", test_cluster_routing, false, 0},
+        {"Cluster Migration Test", test_cluster_migration, false, 0},
+        {"Client Library Test", test_client_library, false, 0},
+        {"Server Half-Close Test", test_server_half_close, false, 0},
+        {"Transactions Test", test_transactions, false, 0},
+        {"Versioned Writes Test", test_versioned_writes, false, 0},
+        {"Multi-Key Commands Test", test_multi_key_commands, false, 0},
+        {"Batched Lookup Test", test_batched_lookup, false, 0},
         {"Storage Stress Test", stress_test_storage, true, 1}
     };
     
@@ -0,0 +1,274 @@
+#include "tracking.h"
+#include "kv_store.h"
+#include "hash_util.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#define TRACKING_CLIENT_BUCKETS 256  // İstemci kimliği tablosu (2'nin kuvveti)
+#define TRACKING_INITIAL_BUCKETS 1024 // Anahtar tablosu başlangıç boyutu (2'nin kuvveti)
+
+// Okunan anahtar ve onu okuyan istemcilerin kimlikleri
+typedef struct TrackedKey {
+    struct TrackedKey* next;
+    uint32_t hash;
+    int* clients;
+    int client_count;
+    int client_cap;
+    char key[];
+} TrackedKey;
+
+typedef struct TrackingClient {
+    struct TrackingClient* next;       // Kimlik kovası zinciri
+    struct TrackingClient* all_next;   // Broadcast taraması için tüm istemciler
+    CommandClient* client;
+    int id;
+    bool bcast;                        // Anahtar tutulmaz, önekler eşleşirse bildirilir
+    int prefix_count;                  // 0: tüm anahtarlar
+    char* prefixes[TRACKING_MAX_PREFIXES];
+} TrackingClient;
+
+// Tek kilit tüm tabloları korur; notify bu kilit tutulurken çağrılır.
+// Kilit sırası: table->mutex -> tracking_mutex -> ön yüzün bildirim kuyruğu
+static pthread_mutex_t tracking_mutex = PTHREAD_MUTEX_INITIALIZER;
+static TrackingClient* client_buckets[TRACKING_CLIENT_BUCKETS];
+static TrackingClient* all_clients = NULL;
+static size_t client_count = 0;   // Kilitsiz hızlı yol için atomik okunur
+static size_t bcast_count = 0;
+static TrackedKey** key_buckets = NULL;
+static size_t key_bucket_count = 0;
+static size_t key_count = 0;
+static size_t max_keys = TRACKING_MAX_KEYS;
+
+void tracking_init() {
+    kv_set_invalidation_hook(tracking_invalidate);
+}
+
+void tracking_set_max_keys(size_t limit) {
+    pthread_mutex_lock(&tracking_mutex);
+    max_keys = limit ? limit : TRACKING_MAX_KEYS;
+    pthread_mutex_unlock(&tracking_mutex);
+}
+
+size_t tracking_client_count() {
+    return __atomic_load_n(&client_count, __ATOMIC_RELAXED);
+}
+
+size_t tracking_key_count() {
+    pthread_mutex_lock(&tracking_mutex);
+    size_t count = key_count;
+    pthread_mutex_unlock(&tracking_mutex);
+    return count;
+}
+
+static TrackingClient* find_client(int id) {
+    TrackingClient* c = client_buckets[(unsigned)id & (TRACKING_CLIENT_BUCKETS - 1)];
+    while (c && c->id != id) c = c->next;
+    return c;
+}
+
+static TrackedKey** find_key(const char* key, uint32_t key_hash) {
+    TrackedKey** link = &key_buckets[key_hash & (key_bucket_count - 1)];
+    while (*link && ((*link)->hash != key_hash || strcmp((*link)->key, key) != 0)) link = &(*link)->next;
+    return link;
+}
+
+static void free_key(TrackedKey* tracked) {
+    free(tracked->clients);
+    free(tracked);
+}
+
+// Son istemci ayrılınca tutulan anahtarların hiçbiri bildirilmeyecek
+static void clear_keys() {
+    for (size_t i = 0; i < key_bucket_count; i++) {
+        while (key_buckets[i]) {
+            TrackedKey* tracked = key_buckets[i];
+            key_buckets[i] = tracked->next;
+            free_key(tracked);
+        }
+    }
+    key_count = 0;
+}
+
+// Zincirler kısa kalsın diye anahtar sayısı kova sayısını geçince iki katına çıkar
+static void grow_keys() {
+    size_t new_count = key_bucket_count ? key_bucket_count * 2 : TRACKING_INITIAL_BUCKETS;
+    TrackedKey** grown = calloc(new_count, sizeof(TrackedKey*));
+    if (!grown) return;
+    for (size_t i = 0; i < key_bucket_count; i++) {
+        while (key_buckets[i]) {
+            TrackedKey* tracked = key_buckets[i];
+            key_buckets[i] = tracked->next;
+            tracked->next = grown[tracked->hash & (new_count - 1)];
+            grown[tracked->hash & (new_count - 1)] = tracked;
+        }
+    }
+    free(key_buckets);
+    key_buckets = grown;
+    key_bucket_count = new_count;
+}
+
+static void remove_client_locked(TrackingClient* c) {
+    TrackingClient** link = &client_buckets[(unsigned)c->id & (TRACKING_CLIENT_BUCKETS - 1)];
+    while (*link != c) link = &(*link)->next;
+    *link = c->next;
+    link = &all_clients;
+    while (*link != c) link = &(*link)->all_next;
+    *link = c->all_next;
+
+    if (c->bcast) bcast_count--;
+    for (int i = 0; i < c->prefix_count; i++) free(c->prefixes[i]);
+    free(c);
+    __atomic_sub_fetch(&client_count, 1, __ATOMIC_RELAXED);
+    // Ayrılan istemcinin kimlikleri anahtarlarda kalır, bildirim sırasında atlanır
+    if (client_count == 0) clear_keys();
+}
+
+bool tracking_enable(CommandClient* client, bool bcast, char** prefixes, int prefix_count) {
+    if (!client->notify || prefix_count > TRACKING_MAX_PREFIXES) return false;
+
+    TrackingClient* c = calloc(1, sizeof(TrackingClient));
+    if (!c) return false;
+    c->client = client;
+    c->id = client->id;
+    c->bcast = bcast;
+    for (int i = 0; i < prefix_count; i++) {
+        c->prefixes[i] = strdup(prefixes[i]);
+        if (!c->prefixes[i]) {
+            for (int j = 0; j < i; j++) free(c->prefixes[j]);
+            free(c);
+            return false;
+        }
+    }
+    c->prefix_count = prefix_count;
+
+    pthread_mutex_lock(&tracking_mutex);
+    TrackingClient* old = find_client(client->id);
+    if (old) remove_client_locked(old);
+    TrackingClient** bucket = &client_buckets[(unsigned)c->id & (TRACKING_CLIENT_BUCKETS - 1)];
+    c->next = *bucket;
+    *bucket = c;
+    c->all_next = all_clients;
+    all_clients = c;
+    if (bcast) bcast_count++;
+    __atomic_add_fetch(&client_count, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&tracking_mutex);
+
+    client->tracking = true;
+    return true;
+}
+
+void tracking_disable(CommandClient* client) {
+    if (!client->tracking) return;
+    client->tracking = false;
+
+    pthread_mutex_lock(&tracking_mutex);
+    TrackingClient* c = find_client(client->id);
+    if (c) remove_client_locked(c);
+    pthread_mutex_unlock(&tracking_mutex);
+}
+
+void tracking_record_read(CommandClient* client, const char* key) {
+    if (!client->tracking) return;
+
+    pthread_mutex_lock(&tracking_mutex);
+    TrackingClient* c = find_client(client->id);
+    if (!c || c->bcast) {
+        pthread_mutex_unlock(&tracking_mutex);
+        return;
+    }
+
+    uint32_t key_hash = (uint32_t)hash(key);
+    TrackedKey* tracked = key_bucket_count ? *find_key(key, key_hash) : NULL;
+    if (!tracked) {
+        if (key_count >= max_keys) {
+            // Tablo dolu: istemci tüm anahtarlar için broadcast'e geçer. Önceden okuduğu
+            // anahtarlar da bundan sonra her değişiklikte bildirildiği için flush gerekmez.
+            c->bcast = true;
+            bcast_count++;
+            pthread_mutex_unlock(&tracking_mutex);
+            if (logging_enabled) printf("Tracking table full, client %d switched to broadcast mode\n", c->id);
+            return;
+        }
+        if (key_count >= key_bucket_count) grow_keys();
+        size_t key_len = strlen(key);
+        tracked = key_bucket_count ? calloc(1, sizeof(TrackedKey) + key_len + 1) : NULL;
+        if (!tracked) {
+            pthread_mutex_unlock(&tracking_mutex);
+            return;
+        }
+        memcpy(tracked->key, key, key_len + 1);
+        tracked->hash = key_hash;
+        TrackedKey** bucket = &key_buckets[key_hash & (key_bucket_count - 1)];
+        tracked->next = *bucket;
+        *bucket = tracked;
+        key_count++;
+    }
+
+    for (int i = 0; i < tracked->client_count; i++) {
+        if (tracked->clients[i] == c->id) {
+            pthread_mutex_unlock(&tracking_mutex);
+            return;
+        }
+    }
+    if (tracked->client_count == tracked->client_cap) {
+        int new_cap = tracked->client_cap ? tracked->client_cap * 2 : 2;
+        int* grown = realloc(tracked->clients, (size_t)new_cap * sizeof(int));
+        if (!grown) {
+            pthread_mutex_unlock(&tracking_mutex);
+            return;
+        }
+        tracked->clients = grown;
+        tracked->client_cap = new_cap;
+    }
+    tracked->clients[tracked->client_count++] = c->id;
+    pthread_mutex_unlock(&tracking_mutex);
+}
+
+static bool prefix_matches(const TrackingClient* c, const char* key) {
+    if (c->prefix_count == 0) return true;
+    for (int i = 0; i < c->prefix_count; i++) {
+        if (strncmp(key, c->prefixes[i], strlen(c->prefixes[i])) == 0) return true;
+    }
+    return false;
+}
+
+void tracking_invalidate(const char* key) {
+    // Takip eden istemci yoksa yazma yolu kilit almaz
+    if (__atomic_load_n(&client_count, __ATOMIC_RELAXED) == 0) return;
+
+    pthread_mutex_lock(&tracking_mutex);
+    if (bcast_count > 0) {
+        for (TrackingClient* c = all_clients; c; c = c->all_next) {
+            if (c->bcast && prefix_matches(c, key)) c->client->notify(c->client, key);
+        }
+    }
+
+    if (key_count > 0) {
+        TrackedKey** link = find_key(key, (uint32_t)hash(key));
+        TrackedKey* tracked = *link;
+        if (tracked) {
+            // Bildirilen anahtar unutulur; istemci yeniden okuyunca tekrar kaydedilir
+            *link = tracked->next;
+            key_count--;
+            for (int i = 0; i < tracked->client_count; i++) {
+                TrackingClient* c = find_client(tracked->clients[i]);
+                if (c && !c->bcast) c->client->notify(c->client, key);
+            }
+            free_key(tracked);
+        }
+    }
+    pthread_mutex_unlock(&tracking_mutex);
+}
+
+void tracking_write_invalidation(CommandClient* client, const char* key) {
+    static const char push_header[] = ">2\r\n$10\r\ninvalidate\r\n*1\r\n";
+    if (client->protocol == PROTOCOL_RESP) {
+        reply_raw(client, push_header, sizeof(push_header) - 1);
+    } else {
+        reply_raw(client, "INVALIDATE ", 11);
+    }
+    reply_bulk(client, key, strlen(key));
+}
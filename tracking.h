@@ -0,0 +1,44 @@
+#ifndef TRACKING_H
+#define TRACKING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include "command.h"
+
+// İstemci tarafı önbellek için sunucu destekli invalidation takibi.
+// Varsayılan modda sunucu her istemcinin okuduğu anahtarları hatırlar; anahtar
+// set/del/süre dolumu ile değişince okuyan istemcilere bir kez bildirim gönderilir
+// ve istemci anahtarı yeniden okuyana kadar tekrar bildirilmez.
+// Broadcast modunda anahtar tutulmaz, öneklerden biriyle eşleşen her değişiklik bildirilir.
+// Anahtar tablosu sınırlıdır: dolduğunda yeni anahtar okuyan istemci tüm anahtarlar
+// için broadcast moduna geçer, böylece bellek artmadan hiçbir değişiklik kaçırılmaz.
+
+#define TRACKING_MAX_KEYS 1000000 // Varsayılan anahtar tablosu sınırı
+#define TRACKING_MAX_PREFIXES 8   // Broadcast modunda istemci başına en fazla önek
+
+// kv değişiklik kancasını kurar
+void tracking_init();
+
+// Takibi açar (zaten açıksa modu değiştirir). İstemcinin notify fonksiyonu yoksa false döner
+bool tracking_enable(CommandClient* client, bool bcast, char** prefixes, int prefix_count);
+
+// Takibi kapatır; döndükten sonra istemci için notify çağrılmaz
+void tracking_disable(CommandClient* client);
+
+// İstemcinin anahtarı okuduğunu kaydeder (broadcast modunda bir şey yapmaz)
+void tracking_record_read(CommandClient* client, const char* key);
+
+// Anahtarı takip eden istemcilere notify ile bildirir; kv kancası olarak çağrılır
+void tracking_invalidate(const char* key);
+
+// Bildirimi istemcinin protokolünde yazar; istemcinin kendi thread'inde çağrılmalı.
+// Telnet: "INVALIDATE <key>", RESP3: ["invalidate", [key]] push mesajı
+void tracking_write_invalidation(CommandClient* client, const char* key);
+
+// Anahtar tablosu sınırı (0: varsayılan)
+void tracking_set_max_keys(size_t max_keys);
+
+size_t tracking_client_count();
+size_t tracking_key_count();
+
+#endif // TRACKING_H
@@ -0,0 +1,222 @@
+#include "uring.h"
+
+#ifdef AYTDB_HAVE_IO_URING
+
+#include <string.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+static int sys_io_uring_setup(unsigned entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int sys_io_uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+bool uring_init(Uring* ring, unsigned entries) {
+    memset(ring, 0, sizeof(Uring));
+    ring->fd = -1;
+    
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    
+    int fd = sys_io_uring_setup(entries, &params);
+    if (fd < 0) return false; // Kernel desteklemiyor veya seccomp engelliyor
+    
+    ring->fd = fd;
+    ring->features = params.features;
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    
+    // Yeni kernellerde SQ ve CQ tek bir mmap bölgesini paylaşır
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        if (ring->cq_ring_size > ring->sq_ring_size) ring->sq_ring_size = ring->cq_ring_size;
+        ring->cq_ring_size = ring->sq_ring_size;
+    }
+    
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    if (ring->sq_ring == MAP_FAILED) {
+        close(fd);
+        ring->fd = -1;
+        return false;
+    }
+    
+    if (params.features & IORING_FEAT_SINGLE_MMAP) {
+        ring->cq_ring = ring->sq_ring;
+    } else {
+        ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+                             MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+        if (ring->cq_ring == MAP_FAILED) {
+            munmap(ring->sq_ring, ring->sq_ring_size);
+            close(fd);
+            ring->fd = -1;
+            return false;
+        }
+    }
+    
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sqes == MAP_FAILED) {
+        if (ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+        munmap(ring->sq_ring, ring->sq_ring_size);
+        close(fd);
+        ring->fd = -1;
+        return false;
+    }
+    
+    char* sq = ring->sq_ring;
+    ring->sq_head = (unsigned*)(sq + params.sq_off.head);
+    ring->sq_tail = (unsigned*)(sq + params.sq_off.tail);
+    ring->sq_mask = (unsigned*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (unsigned*)(sq + params.sq_off.array);
+    ring->sqe_tail = *ring->sq_tail;
+    ring->sqe_submitted = ring->sqe_tail;
+    
+    char* cq = ring->cq_ring;
+    ring->cq_head = (unsigned*)(cq + params.cq_off.head);
+    ring->cq_tail = (unsigned*)(cq + params.cq_off.tail);
+    ring->cq_mask = (unsigned*)(cq + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+    
+    return true;
+}
+
+void uring_exit(Uring* ring) {
+    if (ring->fd < 0) return;
+    
+    munmap(ring->sqes, ring->sqes_size);
+    if (ring->cq_ring != ring->sq_ring) munmap(ring->cq_ring, ring->cq_ring_size);
+    munmap(ring->sq_ring, ring->sq_ring_size);
+    close(ring->fd);
+    ring->fd = -1;
+}
+
+struct io_uring_sqe* uring_get_sqe(Uring* ring) {
+    unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+    unsigned mask = *ring->sq_mask;
+    
+    if (ring->sqe_tail - head > mask) return NULL; // Kuyruk dolu
+    
+    unsigned index = ring->sqe_tail & mask;
+    struct io_uring_sqe* sqe = &ring->sqes[index];
+    ring->sq_array[index] = index;
+    ring->sqe_tail++;
+    
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+int uring_submit(Uring* ring, unsigned wait_nr) {
+    unsigned to_submit = ring->sqe_tail - ring->sqe_submitted;
+    
+    // Yeni SQE'leri kernel'e görünür yap
+    __atomic_store_n(ring->sq_tail, ring->sqe_tail, __ATOMIC_RELEASE);
+    
+    if (to_submit == 0 && wait_nr == 0) return 0;
+    
+    int ret;
+    do {
+        ret = sys_io_uring_enter(ring->fd, to_submit, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0);
+    } while (ret < 0 && errno == EINTR);
+    
+    if (ret > 0) ring->sqe_submitted += ret;
+    return ret;
+}
+
+struct io_uring_cqe* uring_peek_cqe(Uring* ring) {
+    unsigned head = *ring->cq_head;
+    unsigned tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+    
+    if (head == tail) return NULL;
+    return &ring->cqes[head & *ring->cq_mask];
+}
+
+void uring_cqe_seen(Uring* ring) {
+    __atomic_store_n(ring->cq_head, *ring->cq_head + 1, __ATOMIC_RELEASE);
+}
+
+int uring_register(Uring* ring, unsigned opcode, const void* arg, unsigned nr_args) {
+    return (int)syscall(__NR_io_uring_register, ring->fd, opcode, arg, nr_args);
+}
+
+int uring_register_buffers(Uring* ring, const struct iovec* iovecs, unsigned count) {
+    return uring_register(ring, IORING_REGISTER_BUFFERS, iovecs, count);
+}
+
+#ifdef AYTDB_HAVE_URING_NET
+
+bool uring_buf_ring_init(Uring* ring, UringBufRing* buf_ring, unsigned entries,
+                         unsigned buffer_size, unsigned short group) {
+    memset(buf_ring, 0, sizeof(UringBufRing));
+    buf_ring->entries = entries;
+    buf_ring->buffer_size = buffer_size;
+    buf_ring->group = group;
+    
+    // Halka sayfa hizalı olmalı; mmap bunu sağlar
+    buf_ring->ring_size = entries * sizeof(struct io_uring_buf);
+    buf_ring->ring = mmap(NULL, buf_ring->ring_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring->ring == MAP_FAILED) {
+        buf_ring->ring = NULL;
+        return false;
+    }
+    buf_ring->buffers = mmap(NULL, (size_t)entries * buffer_size, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (buf_ring->buffers == MAP_FAILED) {
+        buf_ring->buffers = NULL;
+        uring_buf_ring_free(ring, buf_ring);
+        return false;
+    }
+    
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (unsigned long)buf_ring->ring;
+    reg.ring_entries = entries;
+    reg.bgid = group;
+    if (uring_register(ring, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        uring_buf_ring_free(ring, buf_ring);
+        return false;
+    }
+    
+    for (unsigned i = 0; i < entries; i++) {
+        uring_buf_ring_recycle(buf_ring, i);
+    }
+    return true;
+}
+
+void uring_buf_ring_free(Uring* ring, UringBufRing* buf_ring) {
+    if (buf_ring->ring && ring->fd >= 0) {
+        struct io_uring_buf_reg reg;
+        memset(&reg, 0, sizeof(reg));
+        reg.bgid = buf_ring->group;
+        uring_register(ring, IORING_UNREGISTER_PBUF_RING, &reg, 1);
+    }
+    if (buf_ring->ring) munmap(buf_ring->ring, buf_ring->ring_size);
+    if (buf_ring->buffers) munmap(buf_ring->buffers, (size_t)buf_ring->entries * buf_ring->buffer_size);
+    buf_ring->ring = NULL;
+    buf_ring->buffers = NULL;
+}
+
+char* uring_buf_ring_buffer(UringBufRing* buf_ring, unsigned id) {
+    return buf_ring->buffers + (size_t)id * buf_ring->buffer_size;
+}
+
+void uring_buf_ring_recycle(UringBufRing* buf_ring, unsigned id) {
+    struct io_uring_buf* buf = &buf_ring->ring->bufs[buf_ring->tail & (buf_ring->entries - 1)];
+    buf->addr = (unsigned long)uring_buf_ring_buffer(buf_ring, id);
+    buf->len = buf_ring->buffer_size;
+    buf->bid = (unsigned short)id;
+    
+    // Kernel yeni girdiyi ancak tail ilerleyince görür
+    buf_ring->tail++;
+    __atomic_store_n(&buf_ring->ring->tail, buf_ring->tail, __ATOMIC_RELEASE);
+}
+
+#endif // AYTDB_HAVE_URING_NET
+
+#endif // AYTDB_HAVE_IO_URING
@@ -0,0 +1,89 @@
+#ifndef URING_H
+#define URING_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <sys/uio.h>
+
+// liburing bağımlılığı olmadan, doğrudan sistem çağrıları üzerinden
+// minimal io_uring sarmalayıcısı. Sadece Linux'ta ve CMake'te
+// AYTDB_HAVE_IO_URING tanımlıysa derlenir.
+#ifdef AYTDB_HAVE_IO_URING
+
+#include <linux/io_uring.h>
+
+typedef struct {
+    int fd;
+    unsigned features;
+    
+    // Submission queue
+    unsigned* sq_head;
+    unsigned* sq_tail;
+    unsigned* sq_mask;
+    unsigned* sq_array;
+    struct io_uring_sqe* sqes;
+    unsigned sqe_tail;      // Henüz yayınlanmamış yerel kuyruk sonu
+    unsigned sqe_submitted; // Kernel'e bildirilmiş son indeks
+    
+    // Completion queue
+    unsigned* cq_head;
+    unsigned* cq_tail;
+    unsigned* cq_mask;
+    struct io_uring_cqe* cqes;
+    
+    // mmap bölgeleri
+    void* sq_ring;
+    size_t sq_ring_size;
+    void* cq_ring;
+    size_t cq_ring_size;
+    size_t sqes_size;
+} Uring;
+
+bool uring_init(Uring* ring, unsigned entries);
+void uring_exit(Uring* ring);
+
+// Boş bir SQE döner (sıfırlanmış), kuyruk doluysa NULL
+struct io_uring_sqe* uring_get_sqe(Uring* ring);
+
+// Bekleyen SQE'leri gönderir ve en az wait_nr tamamlanma bekler
+int uring_submit(Uring* ring, unsigned wait_nr);
+
+// Tamamlanmış bir CQE varsa döner, yoksa NULL
+struct io_uring_cqe* uring_peek_cqe(Uring* ring);
+void uring_cqe_seen(Uring* ring);
+
+int uring_register(Uring* ring, unsigned opcode, const void* arg, unsigned nr_args);
+int uring_register_buffers(Uring* ring, const struct iovec* iovecs, unsigned count);
+
+// Provided buffer ring (kernel 5.19+): okuma istekleri buffer'ı kernel'in seçtiği
+// ortak bir havuzdan alır, böylece bağlantı başına bekleyen okuma buffer'ı gerekmez.
+// Multishot recv ile aynı başlık sürümünde geldiği için onunla birlikte kontrol edilir.
+#ifdef IORING_RECV_MULTISHOT
+#define AYTDB_HAVE_URING_NET
+
+typedef struct {
+    struct io_uring_buf_ring* ring;
+    size_t ring_size;
+    char* buffers;          // entries * buffer_size baytlık tek bölge
+    unsigned entries;       // 2'nin kuvveti olmalı
+    unsigned buffer_size;
+    unsigned short group;   // SQE'deki buf_group
+    unsigned short tail;
+} UringBufRing;
+
+// Buffer'ları ayırır, kernel'e kaydeder ve hepsini havuza ekler
+bool uring_buf_ring_init(Uring* ring, UringBufRing* buf_ring, unsigned entries,
+                         unsigned buffer_size, unsigned short group);
+void uring_buf_ring_free(Uring* ring, UringBufRing* buf_ring);
+
+// CQE'deki buffer id'nin gösterdiği veri
+char* uring_buf_ring_buffer(UringBufRing* buf_ring, unsigned id);
+
+// İşlenen buffer'ı tekrar havuza verir
+void uring_buf_ring_recycle(UringBufRing* buf_ring, unsigned id);
+
+#endif // IORING_RECV_MULTISHOT
+
+#endif // AYTDB_HAVE_IO_URING
+
+#endif // URING_H